@@ -0,0 +1,47 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Htslib
+
+/// Whole-file per-base depth: columnar pileup against `CoverageEngine` at several worker counts.
+let coverageSuite = BenchmarkSuite(
+    name: "coverage",
+    usage: "coverage <file.bam> [workers...]"
+) { arguments in
+    guard let path = arguments.first else {
+        throw HTSError.invalidArgument(message: "coverage: missing BAM path")
+    }
+    let workerCounts = arguments.dropFirst().compactMap { Int($0) }
+    let excluded = CoverageEngine.Options.defaultExcludedFlags
+
+    var genomeLength = 0
+    do {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        for tid in 0..<header.nTargets { genomeLength += Int(header.targetLength(at: tid)) }
+    }
+
+    var pileupDepth = 0
+    try measure("pileup columns", unit: "bases", iterations: 1) {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try SAMHeader(from: file)
+        let pileup = PileupIterator(file: file.rawPointer, header: header.rawPointer)
+        pileup.setFilter(RecordFilter().excludingFlags(excluded))
+        pileup.setMaxDepth(Int32.max)
+        var depthSum = 0
+        pileup.forEachColumn { column in depthSum += column.depth }
+        pileupDepth = depthSum
+        return genomeLength
+    }
+    print("  mean depth \(format(Double(pileupDepth) / Double(max(genomeLength, 1)), digits: 2))")
+
+    for workers in workerCounts.isEmpty ? [1, 4] : workerCounts {
+        let engine = CoverageEngine(path: path, options: .init(workers: workers))
+        try measure("difference array, \(workers) workers", unit: "bases", iterations: 3) {
+            _ = try blockingWait {
+                try await engine.map { $0.meanDepth() }
+            }
+            return genomeLength
+        }
+    }
+}
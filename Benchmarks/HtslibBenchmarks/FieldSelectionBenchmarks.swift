@@ -0,0 +1,46 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Htslib
+
+/// Decode cost of a full unpack against field-selective readers on a wide VCF/BCF.
+let fieldSelectionSuite = BenchmarkSuite(
+    name: "fields",
+    usage: "fields <file.bcf|file.vcf.gz> [INFO key, default AF]"
+) { arguments in
+    guard let path = arguments.first else {
+        throw HTSError.invalidArgument(message: "fields: missing VCF/BCF path")
+    }
+    let key = arguments.count > 1 ? arguments[1] : "AF"
+
+    try measure("unpack(.all)", unit: "records", iterations: 1) {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.vcfHeader()
+        let iter = file.vcfIterator(header: header)
+        var count = 0
+        while var record = iter.next() {
+            try record.unpack(.all)
+            _ = record.infoFloat(forKey: key, header: header)
+            count += 1
+        }
+        return count
+    }
+
+    let selections: [(String, VCFFieldSelection)] = [
+        ("POS, ALT, INFO/\(key), FORMAT/GT", VCFFieldSelection(alleles: true, info: [key], format: ["GT"])),
+        ("POS, ALT, INFO/\(key)", VCFFieldSelection(alleles: true, info: [key])),
+    ]
+    for (name, fields) in selections {
+        try measure(name, unit: "records", iterations: 1) {
+            let file = try HTSFile(path: path, mode: "r")
+            let header = try file.vcfHeader()
+            let iter = try file.vcfIterator(header: header, fields: fields)
+            var count = 0
+            while let record = iter.next() {
+                _ = record.infoFloat(forKey: key, header: header)
+                count += 1
+            }
+            return count
+        }
+    }
+}
@@ -0,0 +1,55 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Htslib
+
+/// Per-site allele and genotype-class counts through `[Genotype]` against `GenotypeMatrix`.
+let genotypeSuite = BenchmarkSuite(
+    name: "genotypes",
+    usage: "genotypes <file.bcf|file.vcf.gz>"
+) { arguments in
+    guard let path = arguments.first else {
+        throw HTSError.invalidArgument(message: "genotypes: missing VCF/BCF path")
+    }
+    var checksums: [Int] = []
+
+    try measure("genotypes(header:) per sample", unit: "sites", iterations: 1) {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.vcfHeader()
+        let iter = file.vcfIterator(header: header)
+        var sites = 0
+        var checksum = 0
+        while var record = iter.next() {
+            try record.unpack(.fmt)
+            guard let genotypes = record.genotypes(header: header) else { continue }
+            var alt = 0, het = 0, missing = 0
+            for gt in genotypes {
+                alt += gt.alleles.reduce(0) { $0 + (($1 ?? 0) > 0 ? 1 : 0) }
+                het += gt.isHeterozygous ? 1 : 0
+                missing += gt.isMissing ? 1 : 0
+            }
+            checksum &+= alt &+ het &+ missing
+            sites += 1
+        }
+        checksums.append(checksum)
+        return sites
+    }
+
+    try measure("GenotypeMatrix decode + summary", unit: "sites", iterations: 1) {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.vcfHeader()
+        let iter = file.vcfIterator(header: header)
+        let matrix = GenotypeMatrix()
+        var sites = 0
+        var checksum = 0
+        while let record = iter.next() {
+            guard matrix.decode(record, header: header) else { continue }
+            let summary = matrix.summary()
+            checksum &+= summary.alleleCounts.dropFirst().reduce(0, +) &+ summary.het &+ summary.missing
+            sites += 1
+        }
+        checksums.append(checksum)
+        return sites
+    }
+    print("checksums agree: \(Set(checksums).count == 1)")
+}
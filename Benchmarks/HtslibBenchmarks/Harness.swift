@@ -0,0 +1,71 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+
+/// A named benchmark suite invoked from the command line.
+struct BenchmarkSuite: Sendable {
+    /// Suite name used on the command line.
+    let name: String
+    /// One-line usage string describing the suite's arguments.
+    let usage: String
+    /// Run the suite with the remaining command-line arguments.
+    let run: @Sendable ([String]) throws -> Void
+}
+
+/// Time `body` over several iterations and print the best throughput.
+///
+/// - Parameters:
+///   - name: Label printed with the result.
+///   - unit: Name of the item counted by `body` (e.g. `"records"`).
+///   - iterations: Number of timed runs; the fastest is reported.
+///   - body: Work to time. Returns the number of items processed.
+func measure(_ name: String, unit: String, iterations: Int = 3, _ body: () throws -> Int) rethrows {
+    let clock = ContinuousClock()
+    var best = Duration.seconds(Int64.max)
+    var items = 0
+    for _ in 0..<max(iterations, 1) {
+        var count = 0
+        let elapsed = try clock.measure { count = try body() }
+        if elapsed < best {
+            best = elapsed
+            items = count
+        }
+    }
+    let seconds = Double(best.components.seconds) + Double(best.components.attoseconds) * 1e-18
+    let rate = seconds > 0 ? Double(items) / seconds : 0
+    print("\(name.padding(to: 40)) \(items) \(unit) in \(format(seconds, digits: 3)) s  (\(format(rate, digits: 0)) \(unit)/s)")
+}
+
+/// Run an async operation to completion from synchronous benchmark code.
+func blockingWait<T: Sendable>(_ operation: @escaping @Sendable () async throws -> T) throws -> T {
+    let box = ResultBox<T>()
+    let done = DispatchSemaphore(value: 0)
+    Task {
+        do { box.result = .success(try await operation()) } catch { box.result = .failure(error) }
+        done.signal()
+    }
+    done.wait()
+    return try box.result!.get()
+}
+
+/// Holds the result of an async operation handed back across a semaphore.
+private final class ResultBox<T>: @unchecked Sendable {
+    var result: Result<T, Error>?
+}
+
+/// Format a floating-point value with a fixed number of fractional digits.
+func format(_ value: Double, digits: Int) -> String {
+    var scale = 1.0
+    for _ in 0..<digits { scale *= 10 }
+    let rounded = (value * scale).rounded() / scale
+    if digits == 0 { return String(Int64(rounded)) }
+    return String(rounded)
+}
+
+extension String {
+    /// Right-pad with spaces to at least `width` characters.
+    func padding(to width: Int) -> String {
+        count >= width ? self : self + String(repeating: " ", count: width - count)
+    }
+}
@@ -0,0 +1,61 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Htslib
+
+/// Multi-sample pileup columns/sec: entry-building `next()`, columnar `next(into:)` and
+/// `PrefetchingMultiPileup`, over one BAM opened once per simulated sample.
+let multiPileupSuite = BenchmarkSuite(
+    name: "multi-pileup",
+    usage: "multi-pileup <file.bam> [threads] [max-columns] [samples...]"
+) { arguments in
+    guard let path = arguments.first else {
+        throw HTSError.invalidArgument(message: "multi-pileup: missing BAM path")
+    }
+    let rest = Array(arguments.dropFirst())
+    let threads = rest.first.flatMap { Int32($0) } ?? 8
+    let maxColumns = rest.dropFirst().first.flatMap { Int($0) } ?? 200_000
+    let sampleCounts = rest.dropFirst(2).compactMap { Int($0) }
+
+    for samples in sampleCounts.isEmpty ? [10, 100, 1000] : sampleCounts {
+        print("\(samples) samples")
+        let paths = [String](repeating: path, count: samples)
+
+        try measure("  next()", unit: "columns", iterations: 1) {
+            let inputs = try paths.map { try SampleInput(path: $0) }
+            let pileup = MultiPileupIterator(files: inputs.map { ($0.file.rawPointer, $0.header.rawPointer) })
+            var columns = 0
+            while columns < maxColumns, pileup.next() != nil { columns += 1 }
+            return columns
+        }
+
+        try measure("  next(into:)", unit: "columns", iterations: 1) {
+            let inputs = try paths.map { try SampleInput(path: $0) }
+            let pileup = MultiPileupIterator(files: inputs.map { ($0.file.rawPointer, $0.header.rawPointer) })
+            let buffers = (0..<samples).map { _ in PileupColumnBuffer() }
+            var columns = 0
+            while columns < maxColumns, pileup.next(into: buffers) { columns += 1 }
+            return columns
+        }
+
+        let pool = try ThreadPool(threads: threads)
+        try measure("  prefetching, \(threads) threads", unit: "columns", iterations: 1) {
+            let pileup = try PrefetchingMultiPileup(paths: paths, pool: pool)
+            let buffers = (0..<samples).map { _ in PileupColumnBuffer() }
+            var columns = 0
+            while columns < maxColumns, pileup.next(into: buffers) { columns += 1 }
+            return columns
+        }
+    }
+}
+
+/// Keeps one move-only file handle and its header alive for the legacy iterator.
+private final class SampleInput {
+    let file: HTSFile
+    let header: SAMHeader
+
+    init(path: String) throws {
+        file = try HTSFile(path: path, mode: "r")
+        header = try SAMHeader(from: file)
+    }
+}
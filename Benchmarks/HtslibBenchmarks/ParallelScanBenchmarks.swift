@@ -0,0 +1,41 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Htslib
+
+/// Flagstat-style pass: sequential `forEach` against `ParallelBAMScanner` at several shard counts.
+let parallelScanSuite = BenchmarkSuite(
+    name: "parallel-scan",
+    usage: "parallel-scan <file.bam> [shards...]"
+) { arguments in
+    guard let path = arguments.first else {
+        throw HTSError.invalidArgument(message: "parallel-scan: missing BAM path")
+    }
+    let shardCounts = arguments.dropFirst().compactMap { Int($0) }
+
+    try measure("sequential forEach", unit: "records", iterations: 1) {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        var count = 0
+        try file.samIterator(header: header).forEach { record in
+            if !record.isSecondary { count += 1 }
+        }
+        return count
+    }
+
+    for shards in shardCounts.isEmpty ? [2, 4, 8] : shardCounts {
+        let scanner = ParallelBAMScanner(path: path, shardCount: shards)
+        let plan = try scanner.plan()
+        try measure("parallel \(shards) shards", unit: "records", iterations: 1) {
+            try blockingWait {
+                try await scanner.scan(
+                    shards: plan,
+                    initial: { 0 },
+                    process: { count, record in
+                        if !record.isSecondary { count += 1 }
+                    },
+                    merge: { $0 += $1 })
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Htslib
+
+/// Compares the per-record allocating `next()` loop against the reused-record `forEach` loop.
+let recordLoopSuite = BenchmarkSuite(
+    name: "records",
+    usage: "records <file.bam> [region]"
+) { arguments in
+    guard let path = arguments.first else {
+        throw HTSError.invalidArgument(message: "records: missing BAM path")
+    }
+    let region = arguments.count > 1 ? arguments[1] : nil
+    var mapped = 0
+
+    try measure("next() (allocate per record)", unit: "records") {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        var count = 0
+        if let region {
+            let index = try HTSIndex(path: path)
+            let iter = try file.samQueryIterator(header: header, index: index, region: region)
+            while let record = iter.next() {
+                count += 1
+                mapped += record.isUnmapped ? 0 : 1
+            }
+        } else {
+            let iter = file.samIterator(header: header)
+            while let record = iter.next() {
+                count += 1
+                mapped += record.isUnmapped ? 0 : 1
+            }
+        }
+        return count
+    }
+
+    try measure("forEach (reused record)", unit: "records") {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        var count = 0
+        if let region {
+            let index = try HTSIndex(path: path)
+            let iter = try file.samQueryIterator(header: header, index: index, region: region)
+            try iter.forEach { record in
+                count += 1
+                mapped += record.isUnmapped ? 0 : 1
+            }
+        } else {
+            let iter = file.samIterator(header: header)
+            try iter.forEach { record in
+                count += 1
+                mapped += record.isUnmapped ? 0 : 1
+            }
+        }
+        return count
+    }
+    print("mapped records observed: \(mapped)")
+}
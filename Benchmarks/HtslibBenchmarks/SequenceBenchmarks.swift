@@ -0,0 +1,54 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Htslib
+
+/// Per-base `Character` decoding against the bulk SIMD decoder for short and long reads.
+let sequenceSuite = BenchmarkSuite(
+    name: "sequence",
+    usage: "sequence [iterations]"
+) { arguments in
+    let iterations = arguments.first.flatMap { Int($0) } ?? 200_000
+    let alphabet = Array("ACGT")
+
+    for length in [150, 20_000] {
+        var record = try BAMRecord()
+        let bases = String((0..<length).map { alphabet[($0 * 2_654_435_761 >> 7) & 3] })
+        try record.set(qname: "bench", flag: 0, tid: -1, pos: -1, mapq: 0, cigar: [],
+                       mtid: -1, mpos: -1, isize: 0, seq: bases, qual: nil)
+        let reads = max(iterations * 150 / length, 10)
+        let sequence = record.sequence
+        var buffer = [UInt8](repeating: 0, count: length)
+        var checksum = 0
+
+        measure("\(length) bp per-base Character string", unit: "bases") {
+            for _ in 0..<reads {
+                checksum &+= String(sequence.map { $0 }).utf8.count
+            }
+            return reads * length
+        }
+        measure("\(length) bp BAMSequence.string", unit: "bases") {
+            for _ in 0..<reads {
+                checksum &+= sequence.string.utf8.count
+            }
+            return reads * length
+        }
+        measure("\(length) bp decode(into:)", unit: "bases") {
+            buffer.withUnsafeMutableBufferPointer { out in
+                for _ in 0..<reads {
+                    checksum &+= sequence.decode(into: out)
+                }
+            }
+            return reads * length
+        }
+        measure("\(length) bp decodeReverseComplement(into:)", unit: "bases") {
+            buffer.withUnsafeMutableBufferPointer { out in
+                for _ in 0..<reads {
+                    checksum &+= sequence.decodeReverseComplement(into: out)
+                }
+            }
+            return reads * length
+        }
+        print("checksum: \(checksum)")
+    }
+}
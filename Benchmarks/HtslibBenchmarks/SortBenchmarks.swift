@@ -0,0 +1,40 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Htslib
+
+/// Out-of-core sort: records per second, spilled runs and peak RSS at several thread counts.
+let sortSuite = BenchmarkSuite(
+    name: "sort",
+    usage: "sort <file.bam> [coordinate|queryname] [budget-MiB] [threads...]"
+) { arguments in
+    guard let path = arguments.first else {
+        throw HTSError.invalidArgument(message: "sort: missing BAM path")
+    }
+    let order: BAMSortOrder = arguments.count > 1 && arguments[1] == "queryname" ? .queryName : .coordinate
+    let budget = (arguments.count > 2 ? Int(arguments[2]) : nil) ?? 256
+    let threadCounts = arguments.dropFirst(3).compactMap { Int($0) }
+    let output = NSTemporaryDirectory() + "/htslib-sort-benchmark.bam"
+    defer { try? FileManager.default.removeItem(atPath: output) }
+
+    for threads in threadCounts.isEmpty ? [1, 4] : threadCounts {
+        var stats = BAMSorter.Statistics()
+        try measure("\(order.headerValue), \(budget) MiB, \(threads) threads", unit: "records", iterations: 1) {
+            let pool = try ThreadPool(threads: Int32(threads))
+            let file = try HTSFile(path: path, mode: "r")
+            _ = file.setThreadPool(pool)
+            let header = try file.samHeader()
+            let options = BAMSorter.Options(order: order, memoryBudget: budget << 20, sortThreads: threads,
+                                            temporaryDirectory: NSTemporaryDirectory())
+            let sorter = BAMSorter(header: header, options: options, pool: pool)
+            try sorter.add(contentsOf: file.samIterator(header: header))
+            stats = try sorter.finish(to: output)
+            return stats.records
+        }
+        print("  \(stats.spilledRuns) runs, \(stats.intermediateMerges) intermediate merges, "
+            + "sort \(stats.sortTime), spill \(stats.spillTime), merge \(stats.mergeTime)")
+        print("  \(format(stats.recordsPerSecond, digits: 0)) records/s, "
+            + "peak arena \(stats.peakArenaBytes >> 20) MiB, peak RSS \(stats.peakResidentBytes >> 20) MiB")
+    }
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Htslib
+
+/// One pass per statistic against a single `AlignmentStats` pass, sequential and sharded,
+/// plus idxstats from the index alone.
+let statsSuite = BenchmarkSuite(
+    name: "stats",
+    usage: "stats <file.bam> [shards]"
+) { arguments in
+    guard let path = arguments.first else {
+        throw HTSError.invalidArgument(message: "stats: missing BAM path")
+    }
+    let shards = arguments.dropFirst().first.flatMap { Int($0) } ?? 8
+    let single: [AlignmentStats.Collectors] = [.flags, .insertSize, .mappingQuality, .readLength, .baseQuality]
+
+    try measure("\(single.count) separate passes", unit: "records", iterations: 1) {
+        var records = 0
+        for collectors in single {
+            let file = try HTSFile(path: path, mode: "r")
+            let header = try file.samHeader()
+            let stats = try AlignmentStats.collect(file.samIterator(header: header), collectors: collectors)
+            records += Int(stats.passed.total + stats.failed.total)
+        }
+        return records
+    }
+
+    try measure("one pass, all collectors", unit: "records", iterations: 1) {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let stats = try AlignmentStats.collect(file.samIterator(header: header))
+        return Int(stats.passed.total + stats.failed.total)
+    }
+
+    let scanner = ParallelBAMScanner(path: path, shardCount: shards)
+    let plan = try scanner.plan()
+    try measure("one pass, \(shards) shards", unit: "records", iterations: 1) {
+        let stats = try blockingWait { try await AlignmentStats.collect(scanner, shards: plan) }
+        return Int(stats.passed.total + stats.failed.total)
+    }
+
+    try measure("idxstats from index", unit: "contigs", iterations: 3) {
+        try AlignmentStats.indexStatistics(path: path).contigs.count
+    }
+}
@@ -0,0 +1,38 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Htslib
+
+/// VCF text parsing: the serial `vcfIterator` against `ParallelVCFReader` at several pool sizes.
+let vcfParseSuite = BenchmarkSuite(
+    name: "vcfparse",
+    usage: "vcfparse <file.vcf.gz> [threads...]"
+) { arguments in
+    guard let path = arguments.first else {
+        throw HTSError.invalidArgument(message: "vcfparse: missing VCF path")
+    }
+    let threadCounts = arguments.dropFirst().compactMap { Int32($0) }
+
+    try measure("serial vcfIterator", unit: "records", iterations: 1) {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.vcfHeader()
+        let iter = file.vcfIterator(header: header)
+        var count = 0
+        while iter.next() != nil {
+            count += 1
+        }
+        return count
+    }
+
+    for threads in threadCounts.isEmpty ? [2, 4, 8] : threadCounts {
+        let pool = try ThreadPool(threads: threads)
+        try measure("parallel \(threads) threads", unit: "records", iterations: 1) {
+            let reader = try ParallelVCFReader(path: path, pool: pool, decompressionThreads: 1)
+            var count = 0
+            while try reader.next() != nil {
+                count += 1
+            }
+            return count
+        }
+    }
+}
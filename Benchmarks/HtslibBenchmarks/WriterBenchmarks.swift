@@ -0,0 +1,61 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Htslib
+
+/// BAM output: write-then-index against `AlignmentWriter` indexing on the fly.
+let writerSuite = BenchmarkSuite(
+    name: "writer",
+    usage: "writer <sorted.bam> [threads...]"
+) { arguments in
+    guard let path = arguments.first else {
+        throw HTSError.invalidArgument(message: "writer: missing BAM path")
+    }
+    let threadCounts = arguments.dropFirst().compactMap { Int32($0) }
+    let output = NSTemporaryDirectory() + "/htslib-writer-benchmark.bam"
+    defer {
+        try? FileManager.default.removeItem(atPath: output)
+        try? FileManager.default.removeItem(atPath: output + ".bai")
+    }
+
+    for threads in threadCounts.isEmpty ? [1, 4] : threadCounts {
+        var writeOnly = Duration.zero
+        try measure("write, then HTSIndex.build, \(threads) threads", unit: "records", iterations: 1) {
+            let clock = ContinuousClock()
+            let pool = try ThreadPool(threads: threads)
+            let input = try HTSFile(path: path, mode: "r")
+            _ = input.setThreadPool(pool)
+            let header = try input.samHeader()
+            let out = try HTSFile(path: output, mode: "wb")
+            _ = out.setThreadPool(pool)
+            try header.write(to: out)
+            var count = 0
+            let start = clock.now
+            try input.samIterator(header: header).forEach { record in
+                try out.write(record: record, header: header)
+                count += 1
+            }
+            try out.flush()
+            writeOnly = clock.now - start
+            _ = consume out
+            try HTSIndex.build(path: output, nThreads: threads)
+            return count
+        }
+        print("  of which writing \(writeOnly)")
+
+        var stats = WriterStatistics()
+        try measure("AlignmentWriter, index on the fly, \(threads) threads", unit: "records", iterations: 1) {
+            let pool = try ThreadPool(threads: threads)
+            let input = try HTSFile(path: path, mode: "r")
+            _ = input.setThreadPool(pool)
+            let header = try input.samHeader()
+            let writer = try AlignmentWriter(path: output, header: header,
+                                             options: .init(buildIndex: true), pool: pool)
+            try input.samIterator(header: header).forEach { try writer.write($0) }
+            stats = try writer.close()
+            return stats.records
+        }
+        print("  \(format(stats.recordsPerSecond, digits: 0)) records/s, \(stats.stalls) producer stalls")
+    }
+}
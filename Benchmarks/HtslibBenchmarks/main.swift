@@ -0,0 +1,36 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+// Usage: swift run -c release HtslibBenchmarks <suite> [arguments...]
+
+import Foundation
+
+let suites: [BenchmarkSuite] = [
+    recordLoopSuite,
+    parallelScanSuite,
+    sequenceSuite,
+    coverageSuite,
+    multiPileupSuite,
+    sortSuite,
+    writerSuite,
+    statsSuite,
+    genotypeSuite,
+    fieldSelectionSuite,
+    vcfParseSuite,
+]
+
+let arguments = Array(CommandLine.arguments.dropFirst())
+guard let name = arguments.first, let suite = suites.first(where: { $0.name == name }) else {
+    print("usage: HtslibBenchmarks <suite> [arguments...]")
+    for suite in suites {
+        print("  \(suite.usage)")
+    }
+    exit(1)
+}
+
+do {
+    try suite.run(Array(arguments.dropFirst()))
+} catch {
+    print("error: \(error)")
+    exit(1)
+}
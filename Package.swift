@@ -23,6 +23,11 @@ let package = Package(
             dependencies: ["CHtslib", "CHTSlibShims"],
             swiftSettings: [.enableExperimentalFeature("StrictConcurrency")]
         ),
+        .executableTarget(
+            name: "HtslibBenchmarks",
+            dependencies: ["Htslib"],
+            path: "Benchmarks/HtslibBenchmarks"
+        ),
         .testTarget(
             name: "HtslibTests",
             dependencies: ["Htslib"],
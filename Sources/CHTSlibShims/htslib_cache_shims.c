@@ -0,0 +1,85 @@
+/*
+ * htslib_cache_shims.c
+ *
+ * Mutex, file identity, header size and header skipping helpers for
+ * HTSResourceCache.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <htslib/bgzf.h>
+#include <htslib/kstring.h>
+#include "include/htslib_cache_shims.h"
+
+struct hts_shim_lock {
+    pthread_mutex_t mutex;
+};
+
+hts_shim_lock_t *hts_shim_lock_create(void) {
+    hts_shim_lock_t *lock = malloc(sizeof(*lock));
+    if (!lock) return NULL;
+    if (pthread_mutex_init(&lock->mutex, NULL) != 0) {
+        free(lock);
+        return NULL;
+    }
+    return lock;
+}
+
+hts_shim_lock_t *hts_shim_lock_static(void) {
+    static hts_shim_lock_t lock = { PTHREAD_MUTEX_INITIALIZER };
+    return &lock;
+}
+
+void hts_shim_lock_acquire(hts_shim_lock_t *lock) {
+    pthread_mutex_lock(&lock->mutex);
+}
+
+void hts_shim_lock_release(hts_shim_lock_t *lock) {
+    pthread_mutex_unlock(&lock->mutex);
+}
+
+void hts_shim_lock_destroy(hts_shim_lock_t *lock) {
+    if (!lock) return;
+    pthread_mutex_destroy(&lock->mutex);
+    free(lock);
+}
+
+int hts_shim_file_identity(const char *path, int64_t *mtime_ns, int64_t *size) {
+    struct stat st;
+    if (stat(path, &st) != 0) return -1;
+#ifdef __APPLE__
+    *mtime_ns = (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    *mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    *size = (int64_t)st.st_size;
+    return 0;
+}
+
+int64_t hts_shim_bcf_hdr_text_length(const bcf_hdr_t *hdr) {
+    kstring_t str = KS_INITIALIZE;
+    if (bcf_hdr_format(hdr, 0, &str) < 0) {
+        ks_free(&str);
+        return -1;
+    }
+    int64_t len = (int64_t)str.l;
+    ks_free(&str);
+    return len;
+}
+
+static int is_binary_bgzf(htsFile *fp) {
+    const htsFormat *fmt = hts_get_format(fp);
+    return (fmt->format == bam || fmt->format == bcf) && fmt->compression == bgzf;
+}
+
+int64_t hts_shim_header_end_offset(htsFile *fp) {
+    if (!is_binary_bgzf(fp)) return -1;
+    return (int64_t)bgzf_tell(fp->fp.bgzf);
+}
+
+int hts_shim_skip_header(htsFile *fp, int64_t offset) {
+    if (!is_binary_bgzf(fp) || offset < 0) return 1;
+    return bgzf_seek(fp->fp.bgzf, offset, SEEK_SET) < 0 ? -1 : 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * htslib_field_shims.c
+ *
+ * INFO and FORMAT value access by header ID. The conversion loops mirror
+ * bcf_get_info_values() and bcf_get_format_values() in htslib's vcf.c.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <htslib/hts_endian.h>
+#include "include/htslib_field_shims.h"
+
+int hts_shim_bcf_hdr_field_type(const bcf_hdr_t *hdr, int hl_type, int id)
+{
+    if (id < 0 || id >= hdr->n[BCF_DT_ID] || !hdr->id[BCF_DT_ID][id].val) return -1;
+    if (!bcf_hdr_idinfo_exists(hdr, hl_type, id)) return -1;
+    return (int)bcf_hdr_id2type(hdr, hl_type, id);
+}
+
+/* Grow `*dst` to hold `n` values of `size` bytes, keeping the larger buffer. */
+static int ensure_capacity(void **dst, int *ndst, int n, size_t size)
+{
+    if (n < 1) n = 1;
+    if (*ndst >= n && *dst) return 0;
+    void *grown = realloc(*dst, (size_t)n * size);
+    if (!grown) return -1;
+    *dst = grown;
+    *ndst = n;
+    return 0;
+}
+
+#define CONVERT_INT(type_t, read, missing, vector_end)                            \
+    for (j = 0; j < n; j++) {                                                     \
+        type_t v = read(src + j * sizeof(type_t));                                \
+        if (v == vector_end) break;                                               \
+        out[j] = v == missing ? bcf_int32_missing : (int32_t)v;                   \
+    }
+
+/* Convert `n` stored integers starting at `src` to int32. Returns the count before
+ * the first vector end when `stop_at_end` is set (INFO), otherwise pads the rest
+ * with vector end and returns `n` (FORMAT). */
+static int convert_ints(const uint8_t *src, int stored, int n, int32_t *out,
+                        int stop_at_end)
+{
+    int j;
+    switch (stored) {
+    case BCF_BT_INT8:
+        CONVERT_INT(int8_t, *(const int8_t *), bcf_int8_missing, bcf_int8_vector_end)
+        break;
+    case BCF_BT_INT16:
+        CONVERT_INT(int16_t, le_to_i16, bcf_int16_missing, bcf_int16_vector_end)
+        break;
+    case BCF_BT_INT32:
+        CONVERT_INT(int32_t, le_to_i32, bcf_int32_missing, bcf_int32_vector_end)
+        break;
+    default:
+        return -2;
+    }
+    if (stop_at_end) return j;
+    for (int k = j; k < n; k++) out[k] = bcf_int32_vector_end;
+    return n;
+}
+
+#undef CONVERT_INT
+
+/* Copy `n` floats bit-for-bit, with the same vector-end handling as convert_ints. */
+static int copy_floats(const uint8_t *src, int n, float *out, int stop_at_end)
+{
+    int j;
+    for (j = 0; j < n; j++) {
+        uint32_t bits = le_to_u32(src + j * sizeof(float));
+        if (bits == bcf_float_vector_end) break;
+        bcf_float_set(&out[j], bits);
+    }
+    if (stop_at_end) return j;
+    for (int k = j; k < n; k++) bcf_float_set(&out[k], bcf_float_vector_end);
+    return n;
+}
+
+int hts_shim_bcf_get_info_values_id(bcf1_t *line, int id, int type,
+                                    void **dst, int *ndst)
+{
+    if (!(line->unpacked & BCF_UN_INFO) && bcf_unpack(line, BCF_UN_INFO) < 0) return -2;
+    bcf_info_t *info = bcf_get_info_id(line, id);
+    if (!info || !info->vptr) return -3;
+
+    switch (type) {
+    case BCF_HT_STR:
+        if (info->type != BCF_BT_CHAR) return -2;
+        if (ensure_capacity(dst, ndst, info->len + 1, 1) < 0) return -4;
+        memcpy(*dst, info->vptr, info->len);
+        ((char *)*dst)[info->len] = 0;
+        return info->len;
+    case BCF_HT_REAL:
+        if (info->type != BCF_BT_FLOAT) return -2;
+        if (ensure_capacity(dst, ndst, info->len, sizeof(float)) < 0) return -4;
+        return copy_floats(info->vptr, info->len, (float *)*dst, 1);
+    case BCF_HT_INT:
+        if (ensure_capacity(dst, ndst, info->len, sizeof(int32_t)) < 0) return -4;
+        return convert_ints(info->vptr, info->type, info->len, (int32_t *)*dst, 1);
+    default:
+        return -2;
+    }
+}
+
+int hts_shim_bcf_get_format_values_id(const bcf_hdr_t *hdr, bcf1_t *line, int id,
+                                      int type, void **dst, int *ndst)
+{
+    if (!(line->unpacked & BCF_UN_FMT) && bcf_unpack(line, BCF_UN_FMT) < 0) return -2;
+    bcf_fmt_t *fmt = bcf_get_fmt_id(line, id);
+    if (!fmt || !fmt->p) return -3;
+
+    int n_samples = bcf_hdr_nsamples(hdr);
+    if (n_samples > (int)line->n_sample) n_samples = line->n_sample;
+    int total = n_samples * fmt->n;
+
+    switch (type) {
+    case BCF_HT_STR:
+        if (fmt->type != BCF_BT_CHAR) return -2;
+        if (ensure_capacity(dst, ndst, total, 1) < 0) return -4;
+        for (int s = 0; s < n_samples; s++) {
+            memcpy((char *)*dst + (size_t)s * fmt->n, fmt->p + (size_t)s * fmt->size, fmt->n);
+        }
+        return total;
+    case BCF_HT_REAL:
+        if (fmt->type != BCF_BT_FLOAT) return -2;
+        if (ensure_capacity(dst, ndst, total, sizeof(float)) < 0) return -4;
+        for (int s = 0; s < n_samples; s++) {
+            copy_floats(fmt->p + (size_t)s * fmt->size, fmt->n,
+                        (float *)*dst + (size_t)s * fmt->n, 0);
+        }
+        return total;
+    case BCF_HT_INT:
+        if (ensure_capacity(dst, ndst, total, sizeof(int32_t)) < 0) return -4;
+        for (int s = 0; s < n_samples; s++) {
+            if (convert_ints(fmt->p + (size_t)s * fmt->size, fmt->type, fmt->n,
+                             (int32_t *)*dst + (size_t)s * fmt->n, 0) < 0) return -2;
+        }
+        return total;
+    default:
+        return -2;
+    }
+}
@@ -0,0 +1,41 @@
+/*
+ * htslib_file_shims.c
+ *
+ * Temporary files, removal, renames and peak memory use.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "include/htslib_file_shims.h"
+
+int hts_shim_make_temp_path(const char *dir, const char *prefix, const char *suffix,
+                            char *out, size_t out_len) {
+    int len = snprintf(out, out_len, "%s/%sXXXXXX%s", dir, prefix, suffix);
+    if (len < 0 || (size_t)len >= out_len) return -1;
+    int fd = mkstemps(out, (int)strlen(suffix));
+    if (fd < 0) return -1;
+    close(fd);
+    return 0;
+}
+
+int hts_shim_remove_file(const char *path) {
+    return unlink(path) == 0 ? 0 : -1;
+}
+
+int hts_shim_rename_file(const char *from, const char *to) {
+    return rename(from, to) == 0 ? 0 : -errno;
+}
+
+int64_t hts_shim_peak_rss_bytes(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return (int64_t)usage.ru_maxrss;
+#else
+    return (int64_t)usage.ru_maxrss * 1024;
+#endif
+}
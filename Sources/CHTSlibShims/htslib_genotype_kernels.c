@@ -0,0 +1,196 @@
+/*
+ * htslib_genotype_kernels.c
+ *
+ * Packing and summary kernels for BCF GT fields.
+ *
+ * The packers read the typed GT bytes (int8, int16 or int32 per slot) once and
+ * write packed slots plus per-sample phase and missing bitmasks. The diploid
+ * 2-bit summary splits each 64-bit word into its low and high code bits and
+ * classifies 16 samples at a time with bitwise lane tests and popcounts.
+ */
+
+#include <string.h>
+#include "include/htslib_genotype_kernels.h"
+
+#define GT_MISSING (-1)
+#define GT_ABSENT  (-2)
+
+static const uint64_t LANES_2 = 0x5555555555555555ULL;  // bit 0 of every 2-bit slot
+static const uint64_t LANES_4 = 0x1111111111111111ULL;  // bit 0 of every diploid sample
+
+bcf_fmt_t *hts_shim_gt_field(bcf1_t *line, int gt_id) {
+    if (gt_id < 0 || bcf_unpack(line, BCF_UN_FMT) < 0) return NULL;
+    for (int i = 0; i < line->n_fmt; i++) {
+        bcf_fmt_t *fmt = &line->d.fmt[i];
+        if (fmt->id == gt_id) return fmt->p ? fmt : NULL;
+    }
+    return NULL;
+}
+
+static void clear_masks(int n_samples, uint64_t *phased, uint64_t *missing) {
+    size_t words = ((size_t)n_samples + 63) / 64;
+    memset(phased, 0, words * sizeof(uint64_t));
+    memset(missing, 0, words * sizeof(uint64_t));
+}
+
+/*
+ * Decode every slot of a GT field, running EMIT with `slot` (sample-major index)
+ * and `allele` (index, GT_MISSING or GT_ABSENT) set, and fill the sample masks.
+ * EMIT may `return` to abandon the packing.
+ */
+#define GT_DECODE_TYPED(type_t, vector_end, EMIT)                                   \
+    for (int s = 0; s < n_samples; s++) {                                           \
+        const type_t *p = (const type_t *)(fmt->p + (size_t)s * fmt->size);         \
+        int present = 0, called = 0, all_phased = 1;                                \
+        for (int k = 0; k < ploidy; k++) {                                          \
+            size_t slot = (size_t)s * ploidy + k;                                   \
+            int32_t allele;                                                         \
+            if (p[k] == vector_end) {                                               \
+                allele = GT_ABSENT;                                                 \
+            } else {                                                                \
+                allele = (int32_t)(p[k] >> 1) - 1;                                  \
+                present++;                                                          \
+                if (allele >= 0) called++; else allele = GT_MISSING;                \
+                if (k > 0 && !(p[k] & 1)) all_phased = 0;                           \
+            }                                                                       \
+            EMIT;                                                                   \
+        }                                                                           \
+        if (present >= 2 && all_phased) phased[s >> 6] |= 1ULL << (s & 63);         \
+        if (called == 0) missing[s >> 6] |= 1ULL << (s & 63);                       \
+    }
+
+#define GT_DECODE(EMIT)                                                             \
+    do {                                                                            \
+        int ploidy = fmt->n;                                                        \
+        switch (fmt->type) {                                                        \
+        case BCF_BT_INT8:  GT_DECODE_TYPED(int8_t, bcf_int8_vector_end, EMIT) break;   \
+        case BCF_BT_INT16: GT_DECODE_TYPED(int16_t, bcf_int16_vector_end, EMIT) break; \
+        default:           GT_DECODE_TYPED(int32_t, bcf_int32_vector_end, EMIT) break; \
+        }                                                                           \
+    } while (0)
+
+int hts_shim_gt_pack2(const bcf_fmt_t *fmt, int n_samples, uint64_t *words,
+                      uint64_t *phased, uint64_t *missing) {
+    size_t n_slots = (size_t)n_samples * fmt->n;
+    size_t n_words = (n_slots + 31) / 32;
+    memset(words, 0, n_words * sizeof(uint64_t));
+    clear_masks(n_samples, phased, missing);
+
+    GT_DECODE({
+        uint64_t code;
+        if (allele == GT_ABSENT) code = 3;
+        else if (allele == GT_MISSING) code = 2;
+        else if (allele > 1) return 1;
+        else code = (uint64_t)allele;
+        words[slot >> 5] |= code << ((slot & 31) * 2);
+    });
+
+    // Pad the last word with absent slots so the summaries can ignore the tail.
+    for (size_t slot = n_slots; slot < n_words * 32; slot++) {
+        words[slot >> 5] |= 3ULL << ((slot & 31) * 2);
+    }
+    return 0;
+}
+
+int hts_shim_gt_pack8(const bcf_fmt_t *fmt, int n_samples, uint8_t *codes,
+                      uint64_t *phased, uint64_t *missing) {
+    clear_masks(n_samples, phased, missing);
+    GT_DECODE({
+        if (allele > 253) return 1;
+        codes[slot] = allele == GT_ABSENT ? 0xFF : allele == GT_MISSING ? 0xFE : (uint8_t)allele;
+    });
+    return 0;
+}
+
+void hts_shim_gt_pack16(const bcf_fmt_t *fmt, int n_samples, uint16_t *codes,
+                        uint64_t *phased, uint64_t *missing) {
+    clear_masks(n_samples, phased, missing);
+    GT_DECODE({
+        codes[slot] = allele == GT_ABSENT ? 0xFFFF
+                    : allele == GT_MISSING || allele > 65533 ? 0xFFFE
+                    : (uint16_t)allele;
+    });
+}
+
+static int64_t count_missing(const uint64_t *missing, int n_samples) {
+    int64_t n = 0;
+    for (int i = 0; i < (n_samples + 63) / 64; i++) n += __builtin_popcountll(missing[i]);
+    return n;
+}
+
+/*
+ * Per-sample classification shared by the scalar summaries. CODE(i) yields the
+ * allele at slot i, or a negative value for missing and absent slots.
+ */
+#define GT_SUMMARIZE(CODE)                                                          \
+    do {                                                                            \
+        for (int s = 0; s < n_samples; s++) {                                       \
+            int called = 0, same = 1, first = -1;                                   \
+            for (int k = 0; k < ploidy; k++) {                                      \
+                int allele = CODE((size_t)s * ploidy + k);                          \
+                if (allele < 0) continue;                                           \
+                allele_counts[allele]++;                                            \
+                if (called++ == 0) first = allele; else if (allele != first) same = 0; \
+            }                                                                       \
+            out->allele_number += called;                                           \
+            if (called < 2) continue;                                               \
+            if (!same) out->het++;                                                  \
+            else if (first == 0) out->hom_ref++;                                    \
+            else out->hom_alt++;                                                    \
+        }                                                                           \
+        out->missing = count_missing(missing, n_samples);                           \
+    } while (0)
+
+void hts_shim_gt_summary2(const uint64_t *words, int n_samples, int ploidy,
+                          const uint64_t *missing, hts_shim_gt_summary_t *out,
+                          int64_t *allele_counts) {
+    memset(out, 0, sizeof(*out));
+    if (ploidy != 2) {
+#define GT_CODE2(i) ((int)((words[(i) >> 5] >> (((i) & 31) * 2)) & 3) > 1 \
+                     ? -1 : (int)((words[(i) >> 5] >> (((i) & 31) * 2)) & 3))
+        GT_SUMMARIZE(GT_CODE2);
+#undef GT_CODE2
+        return;
+    }
+
+    int64_t called = 0, alt = 0, hom_ref = 0, het = 0, hom_alt = 0;
+    size_t n_words = ((size_t)n_samples * 2 + 31) / 32;
+    for (size_t i = 0; i < n_words; i++) {
+        uint64_t w = words[i];
+        uint64_t lo = w & LANES_2, hi = (w >> 1) & LANES_2;
+        uint64_t is_alt = lo & ~hi;
+        uint64_t is_ref = LANES_2 & ~lo & ~hi;
+        uint64_t a0 = is_alt & LANES_4, a1 = (is_alt >> 2) & LANES_4;
+        uint64_t r0 = is_ref & LANES_4, r1 = (is_ref >> 2) & LANES_4;
+        called += __builtin_popcountll(LANES_2 & ~hi);
+        alt += __builtin_popcountll(is_alt);
+        hom_ref += __builtin_popcountll(r0 & r1);
+        hom_alt += __builtin_popcountll(a0 & a1);
+        het += __builtin_popcountll((a0 & r1) | (r0 & a1));
+    }
+    out->allele_number = called;
+    out->hom_ref = hom_ref;
+    out->het = het;
+    out->hom_alt = hom_alt;
+    out->missing = count_missing(missing, n_samples);
+    allele_counts[0] += called - alt;
+    allele_counts[1] += alt;
+}
+
+void hts_shim_gt_summary8(const uint8_t *codes, int n_samples, int ploidy, int n_alleles,
+                          const uint64_t *missing, hts_shim_gt_summary_t *out,
+                          int64_t *allele_counts) {
+    memset(out, 0, sizeof(*out));
+#define GT_CODE8(i) (codes[i] >= 0xFE || codes[i] >= n_alleles ? -1 : (int)codes[i])
+    GT_SUMMARIZE(GT_CODE8);
+#undef GT_CODE8
+}
+
+void hts_shim_gt_summary16(const uint16_t *codes, int n_samples, int ploidy, int n_alleles,
+                           const uint64_t *missing, hts_shim_gt_summary_t *out,
+                           int64_t *allele_counts) {
+    memset(out, 0, sizeof(*out));
+#define GT_CODE16(i) (codes[i] >= 0xFFFE || codes[i] >= n_alleles ? -1 : (int)codes[i])
+    GT_SUMMARIZE(GT_CODE16);
+#undef GT_CODE16
+}
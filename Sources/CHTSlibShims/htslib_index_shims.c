@@ -21,6 +21,23 @@ int hts_shim_hts_bin_level(int bin) {
     return hts_bin_level(bin);
 }
 
+int hts_shim_idx_window_offsets(const hts_idx_t *idx, int tid, hts_pos_t window,
+                                int64_t n_windows, uint64_t *offsets) {
+    for (int64_t w = 0; w < n_windows; w++) {
+        hts_pos_t beg = w * window;
+        hts_pos_t end = w == n_windows - 1 ? HTS_POS_MAX : beg + window;
+        hts_itr_t *itr = hts_itr_query(idx, tid, beg, end, NULL);
+        if (!itr) return -1;
+        uint64_t first = UINT64_MAX;
+        for (int i = 0; i < itr->n_off; i++) {
+            if (itr->off[i].u < first) first = itr->off[i].u;
+        }
+        offsets[w] = first;
+        hts_itr_destroy(itr);
+    }
+    return 0;
+}
+
 // ---------------------------------------------------------------------------
 // Endianness detection and byte swapping
 // ---------------------------------------------------------------------------
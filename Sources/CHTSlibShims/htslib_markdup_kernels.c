@@ -0,0 +1,149 @@
+/*
+ * htslib_markdup_kernels.c
+ *
+ * Per-record key extraction for duplicate marking.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "include/htslib_markdup_kernels.h"
+
+uint64_t hts_shim_hash_bytes(const void *data, size_t n) {
+    const uint8_t *p = data;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/// Unclipped 5' position from leftmost pos, reference length and the clips at each end.
+static int64_t unclipped_5prime(int64_t pos, int64_t ref_len, int64_t lead_clip,
+                                int64_t trail_clip, int reverse) {
+    return reverse ? pos + ref_len - 1 + trail_clip : pos - lead_clip;
+}
+
+/// Reference length and leading/trailing soft+hard clips of a binary CIGAR.
+static void cigar_extent(const uint32_t *cigar, uint32_t n, int64_t *ref_len,
+                         int64_t *lead, int64_t *trail) {
+    *ref_len = *lead = *trail = 0;
+    uint32_t i = 0;
+    for (; i < n; i++) {
+        int op = bam_cigar_op(cigar[i]);
+        if (op != BAM_CSOFT_CLIP && op != BAM_CHARD_CLIP) break;
+        *lead += bam_cigar_oplen(cigar[i]);
+    }
+    uint32_t j = n;
+    for (; j > i; j--) {
+        int op = bam_cigar_op(cigar[j - 1]);
+        if (op != BAM_CSOFT_CLIP && op != BAM_CHARD_CLIP) break;
+        *trail += bam_cigar_oplen(cigar[j - 1]);
+    }
+    for (uint32_t k = i; k < j; k++) {
+        if (bam_cigar_type(bam_cigar_op(cigar[k])) & 2) *ref_len += bam_cigar_oplen(cigar[k]);
+    }
+}
+
+/// The same extent parsed from a text CIGAR (the MC tag). Returns -1 if malformed.
+static int text_cigar_extent(const char *s, int64_t *ref_len, int64_t *lead, int64_t *trail) {
+    *ref_len = *lead = *trail = 0;
+    int seen_match = 0;
+    int64_t pending_clip = 0;
+    while (*s) {
+        char *end;
+        long len = strtol(s, &end, 10);
+        if (end == s || !*end) return -1;
+        char op = *end;
+        s = end + 1;
+        switch (op) {
+        case 'S': case 'H':
+            if (seen_match) pending_clip += len;
+            else *lead += len;
+            break;
+        case 'M': case 'D': case 'N': case '=': case 'X':
+            seen_match = 1;
+            pending_clip = 0;
+            *ref_len += len;
+            break;
+        case 'I': case 'P':
+            seen_match = 1;
+            pending_clip = 0;
+            break;
+        default:
+            return -1;
+        }
+    }
+    *trail = pending_clip;
+    return 0;
+}
+
+/// Parse the last three ':'-separated integer fields of name as tile, x and y.
+static void parse_optical(const char *name, int32_t *tile, int32_t *x, int32_t *y) {
+    *tile = -1;
+    *x = *y = 0;
+    const char *fields[3] = {NULL, NULL, NULL};
+    int found = 0;
+    for (const char *p = name + strlen(name); p > name && found < 3; p--) {
+        if (p[-1] == ':') fields[2 - found++] = p;
+    }
+    if (found < 3) return;
+    char *end;
+    long t = strtol(fields[0], &end, 10);
+    if (end == fields[0] || *end != ':') return;
+    long xv = strtol(fields[1], &end, 10);
+    if (end == fields[1] || *end != ':') return;
+    long yv = strtol(fields[2], &end, 10);
+    if (end == fields[2] || (*end && *end != ' ' && *end != '/')) return;
+    *tile = (int32_t)t;
+    *x = (int32_t)xv;
+    *y = (int32_t)yv;
+}
+
+int hts_shim_dup_info(const bam1_t *b, hts_shim_dup_info_t *info) {
+    const bam1_core_t *c = &b->core;
+    memset(info, 0, sizeof(*info));
+    if (c->tid < 0 || (c->flag & BAM_FUNMAP)) return -1;
+
+    int64_t ref_len, lead, trail;
+    cigar_extent(bam_get_cigar(b), c->n_cigar, &ref_len, &lead, &trail);
+    if (ref_len == 0) ref_len = 1;
+    info->tid = c->tid;
+    info->reverse = (c->flag & BAM_FREVERSE) != 0;
+    info->pos = unclipped_5prime(c->pos, ref_len, lead, trail, info->reverse);
+
+    info->mate_tid = c->mtid;
+    info->mate_reverse = (c->flag & BAM_FMREVERSE) != 0;
+    info->mate_pos = c->mpos;
+    const uint8_t *mc = bam_aux_get(b, "MC");
+    if (mc && *mc == 'Z') {
+        int64_t mref, mlead, mtrail;
+        if (text_cigar_extent((const char *)mc + 1, &mref, &mlead, &mtrail) == 0) {
+            if (mref == 0) mref = 1;
+            info->mate_pos = unclipped_5prime(c->mpos, mref, mlead, mtrail, info->mate_reverse);
+            info->has_mate_cigar = 1;
+        }
+    }
+
+    const char *qname = bam_get_qname(b);
+    info->qname_hash = hts_shim_hash_bytes(qname, strlen(qname));
+    const uint8_t *rg = bam_aux_get(b, "RG");
+    if (rg && *rg == 'Z') {
+        const char *value = (const char *)rg + 1;
+        info->rg_hash = hts_shim_hash_bytes(value, strlen(value));
+    }
+
+    int32_t score = 0;
+    const uint8_t *qual = bam_get_qual(b);
+    if (c->l_qseq > 0 && qual[0] != 0xff) {
+        for (int32_t i = 0; i < c->l_qseq; i++) {
+            if (qual[i] >= 15) score += qual[i];
+        }
+    }
+    const uint8_t *ms = bam_aux_get(b, "ms");
+    if (ms) score += (int32_t)bam_aux2i(ms);
+    info->score = score;
+
+    parse_optical(qname, &info->tile, &info->x, &info->y);
+    return 0;
+}
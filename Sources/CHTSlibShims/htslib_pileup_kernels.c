@@ -0,0 +1,46 @@
+/*
+ * htslib_pileup_kernels.c
+ *
+ * Columnar decoding of a pileup column.
+ */
+
+#include <string.h>
+#include "include/htslib_pileup_kernels.h"
+
+/// nt16 code -> count category (A=0, C=1, G=2, T=3, anything else N=4).
+static const uint8_t nt16_category[16] = {
+    4, 0, 1, 4, 2, 4, 4, 4, 3, 4, 4, 4, 4, 4, 4, 4
+};
+
+void hts_shim_pileup_fill(const bam_pileup1_t *plp, int n, const hts_shim_pileup_columns_t *out) {
+    int32_t counts[HTS_SHIM_PLP_NCOUNTS] = {0};
+    for (int i = 0; i < n; i++) {
+        const bam_pileup1_t *p = &plp[i];
+        const bam1_t *b = p->b;
+        uint16_t flag = b->core.flag;
+        uint8_t rev = (flag & BAM_FREVERSE) ? 1 : 0;
+        uint8_t state = (p->is_del ? HTS_SHIM_PLP_DEL : 0)
+                      | (p->is_refskip ? HTS_SHIM_PLP_REFSKIP : 0)
+                      | (p->is_head ? HTS_SHIM_PLP_HEAD : 0)
+                      | (p->is_tail ? HTS_SHIM_PLP_TAIL : 0);
+        uint8_t base = 0, qual = 0;
+        if (p->is_refskip) {
+            // not counted
+        } else if (p->is_del) {
+            counts[5 * 2 + rev]++;
+        } else {
+            base = bam_seqi(bam_get_seq(b), p->qpos);
+            qual = bam_get_qual(b)[p->qpos];
+            counts[nt16_category[base] * 2 + rev]++;
+        }
+        out->bases[i] = base;
+        out->quals[i] = qual;
+        out->flags[i] = flag;
+        out->mapq[i] = b->core.qual;
+        out->strand[i] = rev;
+        out->qpos[i] = p->qpos;
+        out->indel[i] = p->indel;
+        out->state[i] = state;
+    }
+    memcpy(out->counts, counts, sizeof(counts));
+}
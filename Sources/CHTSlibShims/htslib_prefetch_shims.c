@@ -0,0 +1,191 @@
+/*
+ * htslib_prefetch_shims.c
+ *
+ * Read-ahead alignment decoding on an htslib thread pool.
+ *
+ * Batches cycle FREE -> FILLING -> READY -> FREE. The decoding job fills
+ * batches starting at fill_idx for as long as the next one is FREE, then
+ * exits; the consumer re-dispatches it whenever it frees a batch and no job
+ * is running. Records are handed over by swapping bam1_t contents, so data
+ * buffers circulate between the ring and the caller without copies.
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "include/htslib_prefetch_shims.h"
+
+enum { BATCH_FREE, BATCH_FILLING, BATCH_READY };
+
+typedef struct {
+    bam1_t **recs;
+    int n;          // records filled
+    int status;     // 0, or the sam_read1 result that ended the stream
+    int state;
+} prefetch_batch_t;
+
+struct hts_shim_prefetch {
+    htsFile *fp;
+    sam_hdr_t *hdr;
+    hts_tpool *pool;
+    hts_tpool_process *q;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    prefetch_batch_t *batches;
+    int n_batches, batch_size;
+    int fill_idx, read_idx, read_pos;
+    int job_running, finished, shutdown;
+};
+
+static void *prefetch_job(void *arg) {
+    hts_shim_prefetch_t *pf = arg;
+    pthread_mutex_lock(&pf->lock);
+    for (;;) {
+        prefetch_batch_t *bt = &pf->batches[pf->fill_idx];
+        if (pf->shutdown || pf->finished || bt->state != BATCH_FREE) break;
+        bt->state = BATCH_FILLING;
+        pthread_mutex_unlock(&pf->lock);
+
+        int n = 0, status = 0;
+        while (n < pf->batch_size) {
+            int ret = sam_read1(pf->fp, pf->hdr, bt->recs[n]);
+            if (ret < 0) { status = ret; break; }
+            n++;
+        }
+
+        pthread_mutex_lock(&pf->lock);
+        bt->n = n;
+        bt->status = status;
+        bt->state = BATCH_READY;
+        if (status != 0) pf->finished = 1;
+        pf->fill_idx = (pf->fill_idx + 1) % pf->n_batches;
+        pthread_cond_broadcast(&pf->cond);
+    }
+    pf->job_running = 0;
+    pthread_cond_broadcast(&pf->cond);
+    pthread_mutex_unlock(&pf->lock);
+    return NULL;
+}
+
+/// Start the decoding job if it is idle and there is work. Called with lock held;
+/// returns with lock held.
+static void prefetch_kick(hts_shim_prefetch_t *pf) {
+    if (pf->job_running || pf->finished || pf->shutdown) return;
+    if (pf->batches[pf->fill_idx].state != BATCH_FREE) return;
+    pf->job_running = 1;
+    pthread_mutex_unlock(&pf->lock);
+    if (hts_tpool_dispatch(pf->pool, pf->q, prefetch_job, pf) < 0) {
+        pthread_mutex_lock(&pf->lock);
+        pf->job_running = 0;
+        pf->finished = 1;
+        pf->batches[pf->fill_idx].status = -2;
+        pf->batches[pf->fill_idx].n = 0;
+        pf->batches[pf->fill_idx].state = BATCH_READY;
+        return;
+    }
+    pthread_mutex_lock(&pf->lock);
+}
+
+hts_shim_prefetch_t *hts_shim_prefetch_init(htsFile *fp, sam_hdr_t *hdr, hts_tpool *pool,
+                                            int batch_size, int n_batches) {
+    if (batch_size < 1) batch_size = 1;
+    if (n_batches < 2) n_batches = 2;
+    hts_shim_prefetch_t *pf = calloc(1, sizeof(*pf));
+    if (!pf) return NULL;
+    pf->fp = fp;
+    pf->hdr = hdr;
+    pf->pool = pool;
+    pf->batch_size = batch_size;
+    pf->n_batches = n_batches;
+    pthread_mutex_init(&pf->lock, NULL);
+    pthread_cond_init(&pf->cond, NULL);
+
+    pf->batches = calloc(n_batches, sizeof(*pf->batches));
+    if (!pf->batches) goto fail;
+    for (int i = 0; i < n_batches; i++) {
+        pf->batches[i].recs = calloc(batch_size, sizeof(bam1_t *));
+        if (!pf->batches[i].recs) goto fail;
+        for (int j = 0; j < batch_size; j++) {
+            if (!(pf->batches[i].recs[j] = bam_init1())) goto fail;
+        }
+    }
+    if (pool) {
+        // One job at a time per prefetcher; results are not collected.
+        pf->q = hts_tpool_process_init(pool, 1, 1);
+        if (!pf->q) goto fail;
+        pthread_mutex_lock(&pf->lock);
+        prefetch_kick(pf);
+        pthread_mutex_unlock(&pf->lock);
+    }
+    return pf;
+
+fail:
+    hts_shim_prefetch_destroy(pf);
+    return NULL;
+}
+
+int hts_shim_prefetch_read(hts_shim_prefetch_t *pf, bam1_t *b) {
+    if (!pf->pool) {
+        int ret = sam_read1(pf->fp, pf->hdr, b);
+        return ret >= 0 ? 0 : ret;
+    }
+    pthread_mutex_lock(&pf->lock);
+    for (;;) {
+        prefetch_batch_t *bt = &pf->batches[pf->read_idx];
+        if (bt->state == BATCH_READY) {
+            if (pf->read_pos < bt->n) {
+                bam1_t *src = bt->recs[pf->read_pos++];
+                bam1_t tmp = *b;
+                *b = *src;
+                *src = tmp;
+                pthread_mutex_unlock(&pf->lock);
+                return 0;
+            }
+            if (bt->status != 0) {
+                int status = bt->status;
+                pthread_mutex_unlock(&pf->lock);
+                return status;
+            }
+            bt->state = BATCH_FREE;
+            bt->n = 0;
+            pf->read_pos = 0;
+            pf->read_idx = (pf->read_idx + 1) % pf->n_batches;
+            prefetch_kick(pf);
+            continue;
+        }
+        prefetch_kick(pf);
+        pthread_cond_wait(&pf->cond, &pf->lock);
+    }
+}
+
+int hts_shim_prefetch_buffered(hts_shim_prefetch_t *pf) {
+    int total = 0;
+    pthread_mutex_lock(&pf->lock);
+    for (int i = 0; i < pf->n_batches; i++) {
+        if (pf->batches[i].state == BATCH_READY) total += pf->batches[i].n;
+    }
+    total -= pf->read_pos;
+    pthread_mutex_unlock(&pf->lock);
+    return total;
+}
+
+void hts_shim_prefetch_destroy(hts_shim_prefetch_t *pf) {
+    if (!pf) return;
+    pthread_mutex_lock(&pf->lock);
+    pf->shutdown = 1;
+    while (pf->job_running) pthread_cond_wait(&pf->cond, &pf->lock);
+    pthread_mutex_unlock(&pf->lock);
+    if (pf->q) hts_tpool_process_destroy(pf->q);
+    if (pf->batches) {
+        for (int i = 0; i < pf->n_batches; i++) {
+            if (!pf->batches[i].recs) continue;
+            for (int j = 0; j < pf->batch_size; j++) {
+                if (pf->batches[i].recs[j]) bam_destroy1(pf->batches[i].recs[j]);
+            }
+            free(pf->batches[i].recs);
+        }
+        free(pf->batches);
+    }
+    pthread_cond_destroy(&pf->cond);
+    pthread_mutex_destroy(&pf->lock);
+    free(pf);
+}
@@ -0,0 +1,132 @@
+/*
+ * htslib_qual_kernels.c
+ *
+ * Bulk kernels over raw BAM base-quality arrays.
+ *
+ * The summary kernel processes 16 qualities per step: a sum of absolute
+ * differences against zero for the running total, an unsigned byte min/max,
+ * and a saturating compare for the below-threshold count.
+ */
+
+#include "include/htslib_qual_kernels.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define HTS_SHIM_QUAL_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HTS_SHIM_QUAL_NEON 1
+#endif
+
+void hts_shim_qual_stats(const uint8_t *qual, int64_t len, uint8_t threshold,
+                         hts_shim_qual_stats_t *out) {
+    uint64_t sum = 0;
+    int64_t below = 0, i = 0;
+    uint8_t mn = 255, mx = 0;
+
+#if defined(HTS_SHIM_QUAL_SSE2)
+    if (len >= 16) {
+        const __m128i zero = _mm_setzero_si128();
+        // x < t  <=>  min(x, t - 1) == x, for t > 0.
+        const __m128i limit = _mm_set1_epi8((char)(threshold ? threshold - 1 : 0));
+        __m128i vsum = zero, vmin = _mm_set1_epi8((char)0xFF), vmax = zero;
+        for (; i + 16 <= len; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(qual + i));
+            vsum = _mm_add_epi64(vsum, _mm_sad_epu8(v, zero));
+            vmin = _mm_min_epu8(vmin, v);
+            vmax = _mm_max_epu8(vmax, v);
+            if (threshold) {
+                __m128i lt = _mm_cmpeq_epi8(_mm_min_epu8(v, limit), v);
+                below += __builtin_popcount((unsigned)_mm_movemask_epi8(lt));
+            }
+        }
+        uint64_t lanes[2];
+        _mm_storeu_si128((__m128i *)lanes, vsum);
+        sum = lanes[0] + lanes[1];
+        uint8_t bytes[16];
+        _mm_storeu_si128((__m128i *)bytes, vmin);
+        for (int k = 0; k < 16; k++) if (bytes[k] < mn) mn = bytes[k];
+        _mm_storeu_si128((__m128i *)bytes, vmax);
+        for (int k = 0; k < 16; k++) if (bytes[k] > mx) mx = bytes[k];
+    }
+#elif defined(HTS_SHIM_QUAL_NEON)
+    if (len >= 16) {
+        const uint8x16_t t = vdupq_n_u8(threshold);
+        uint64x2_t vsum = vdupq_n_u64(0);
+        uint8x16_t vmin = vdupq_n_u8(0xFF), vmax = vdupq_n_u8(0);
+        for (; i + 16 <= len; i += 16) {
+            uint8x16_t v = vld1q_u8(qual + i);
+            vsum = vpadalq_u32(vsum, vpaddlq_u16(vpaddlq_u8(v)));
+            vmin = vminq_u8(vmin, v);
+            vmax = vmaxq_u8(vmax, v);
+            // Each lane below the threshold contributes 1.
+            below += vaddvq_u8(vshrq_n_u8(vcltq_u8(v, t), 7));
+        }
+        sum = vaddvq_u64(vsum);
+        mn = vminvq_u8(vmin);
+        mx = vmaxvq_u8(vmax);
+    }
+#endif
+
+    for (; i < len; i++) {
+        uint8_t q = qual[i];
+        sum += q;
+        if (q < mn) mn = q;
+        if (q > mx) mx = q;
+        below += q < threshold;
+    }
+    out->sum = sum;
+    out->below = below;
+    out->min = mn;
+    out->max = mx;
+}
+
+void hts_shim_qual_bin(uint8_t *qual, int64_t len, const uint8_t *table) {
+    for (int64_t i = 0; i < len; i++) {
+        qual[i] = table[qual[i]];
+    }
+}
+
+void hts_shim_qual_histogram(const uint8_t *qual, int64_t len, uint64_t *hist) {
+    int64_t i = 0;
+    if (len >= 1024) {
+        // Long reads: four interleaved tables so runs of equal qualities don't serialize
+        // on one counter. Not worth clearing and folding 4 KiB for short reads.
+        uint32_t h[4][256] = {{0}};
+        for (; i + 4 <= len; i += 4) {
+            h[0][qual[i]]++;
+            h[1][qual[i + 1]]++;
+            h[2][qual[i + 2]]++;
+            h[3][qual[i + 3]]++;
+        }
+        for (int q = 0; q < 256; q++)
+            hist[q] += (uint64_t)h[0][q] + h[1][q] + h[2][q] + h[3][q];
+    }
+    for (; i < len; i++) hist[qual[i]]++;
+}
+
+int64_t hts_shim_qual_trim3(const uint8_t *qual, int64_t len, int threshold) {
+    int64_t s = 0, best = 0, keep = len;
+    for (int64_t i = len - 1; i >= 0; i--) {
+        s += threshold - qual[i];
+        if (s < 0) break;
+        if (s > best) {
+            best = s;
+            keep = i;
+        }
+    }
+    return keep;
+}
+
+int64_t hts_shim_qual_trim5(const uint8_t *qual, int64_t len, int threshold) {
+    int64_t s = 0, best = 0, drop = 0;
+    for (int64_t i = 0; i < len; i++) {
+        s += threshold - qual[i];
+        if (s < 0) break;
+        if (s > best) {
+            best = s;
+            drop = i + 1;
+        }
+    }
+    return drop;
+}
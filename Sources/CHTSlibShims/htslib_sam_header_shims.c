@@ -68,3 +68,15 @@ int hts_shim_sam_hdr_add_pg_3(sam_hdr_t *h, const char *name,
 {
     return sam_hdr_add_pg(h, name, k1, v1, k2, v2, k3, v3, NULL);
 }
+
+int hts_shim_sam_hdr_set_sort_order(sam_hdr_t *h, const char *so, const char *ss)
+{
+    if (sam_hdr_count_lines(h, "HD") <= 0) {
+        if (sam_hdr_add_line(h, "HD", "VN", SAM_FORMAT_VERSION, "SO", so, NULL) < 0) return -1;
+    } else if (sam_hdr_update_line(h, "HD", NULL, NULL, "SO", so, NULL) < 0) {
+        return -1;
+    }
+    if (ss) return sam_hdr_update_line(h, "HD", NULL, NULL, "SS", ss, NULL);
+    sam_hdr_remove_tag_id(h, "HD", NULL, NULL, "SS");
+    return 0;
+}
@@ -7,6 +7,7 @@
  * Each function delegates to the original macro or inline function.
  */
 
+#include <stdlib.h>
 #include "include/htslib_sam_shims.h"
 
 // ---------------------------------------------------------------------------
@@ -144,3 +145,49 @@ void hts_shim_bam_hdr_destroy(sam_hdr_t *h) {
 sam_hdr_t *hts_shim_bam_hdr_dup(const sam_hdr_t *h0) {
     return bam_hdr_dup(h0);
 }
+
+// ---------------------------------------------------------------------------
+// Multi-region iterators
+// ---------------------------------------------------------------------------
+
+hts_itr_t *hts_shim_sam_itr_intervals(const hts_idx_t *idx, sam_hdr_t *hdr,
+                                      const int *tids, const hts_pos_t *begs,
+                                      const hts_pos_t *ends, int n) {
+    if (n <= 0) return NULL;
+    int nlists = 0;
+    for (int i = 0; i < n; i++) {
+        if (i == 0 || tids[i] != tids[i - 1]) nlists++;
+    }
+    hts_reglist_t *reglist = calloc(nlists, sizeof(*reglist));
+    if (!reglist) return NULL;
+
+    int li = 0;
+    for (int i = 0; i < n; li++) {
+        int j = i;
+        while (j < n && tids[j] == tids[i]) j++;
+        hts_reglist_t *r = &reglist[li];
+        r->tid = tids[i];
+        r->reg = sam_hdr_tid2name(hdr, tids[i]);
+        r->intervals = malloc((size_t)(j - i) * sizeof(hts_pair_pos_t));
+        if (!r->intervals) {
+            hts_reglist_free(reglist, nlists);
+            return NULL;
+        }
+        uint32_t count = 0;
+        for (int k = i; k < j; k++) {
+            if (count > 0 && begs[k] <= r->intervals[count - 1].end) {
+                if (ends[k] > r->intervals[count - 1].end) r->intervals[count - 1].end = ends[k];
+            } else {
+                r->intervals[count].beg = begs[k];
+                r->intervals[count].end = ends[k];
+                count++;
+            }
+        }
+        r->count = count;
+        r->min_beg = r->intervals[0].beg;
+        r->max_end = r->intervals[count - 1].end;
+        i = j;
+    }
+    // reglist now belongs to the iterator and is freed by hts_itr_destroy().
+    return sam_itr_regions(idx, hdr, reglist, (unsigned int)nlists);
+}
@@ -0,0 +1,185 @@
+/*
+ * htslib_seq_kernels.c
+ *
+ * Bulk kernels over the 4-bit packed BAM query sequence encoding.
+ *
+ * Each packed byte holds two bases, the first in the high nibble. Decoding
+ * splits 16 packed bytes into high and low nibble vectors, maps both through
+ * a 16-entry table with a byte shuffle, and interleaves them into 32 ASCII
+ * bases. Reverse complement uses the complement table and reverses lanes
+ * before interleaving.
+ */
+
+#include "include/htslib_seq_kernels.h"
+
+#include <htslib/hts.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#define HTS_SHIM_SEQ_SSSE3 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HTS_SHIM_SEQ_NEON 1
+#endif
+
+static const uint8_t seq_nt16_ascii[16] = {
+    '=', 'A', 'C', 'M', 'G', 'R', 'S', 'V', 'T', 'W', 'Y', 'H', 'K', 'D', 'B', 'N'
+};
+
+static const uint8_t seq_nt16_comp_ascii[16] = {
+    '=', 'T', 'G', 'K', 'C', 'Y', 'S', 'B', 'A', 'W', 'R', 'D', 'M', 'H', 'V', 'N'
+};
+
+static inline uint8_t seq_base(const uint8_t *seq, int64_t i) {
+    return (seq[i >> 1] >> ((~i & 1) << 2)) & 0xF;
+}
+
+// ---------------------------------------------------------------------------
+// Vector blocks: 16 packed bytes <-> 32 bases
+// ---------------------------------------------------------------------------
+
+#if defined(HTS_SHIM_SEQ_SSSE3)
+
+__attribute__((target("ssse3")))
+static void decode_blocks_ssse3(const uint8_t *src, int64_t nblocks, uint8_t *out) {
+    const __m128i table = _mm_loadu_si128((const __m128i *)seq_nt16_ascii);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    for (int64_t b = 0; b < nblocks; b++) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + 16 * b));
+        __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(v, mask));
+        _mm_storeu_si128((__m128i *)(out + 32 * b), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(out + 32 * b + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+}
+
+// `src` points at the last packed block; blocks are consumed towards lower addresses.
+__attribute__((target("ssse3")))
+static void revcomp_blocks_ssse3(const uint8_t *src, int64_t nblocks, uint8_t *out) {
+    const __m128i table = _mm_loadu_si128((const __m128i *)seq_nt16_comp_ascii);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    for (int64_t b = 0; b < nblocks; b++) {
+        __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src - 16 * b)), reverse);
+        __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(v, mask));
+        _mm_storeu_si128((__m128i *)(out + 32 * b), _mm_unpacklo_epi8(lo, hi));
+        _mm_storeu_si128((__m128i *)(out + 32 * b + 16), _mm_unpackhi_epi8(lo, hi));
+    }
+}
+
+static int have_ssse3(void) {
+#if defined(__SSSE3__)
+    return 1;
+#else
+    static int cached = -1;
+    if (cached < 0) cached = __builtin_cpu_supports("ssse3") ? 1 : 0;
+    return cached;
+#endif
+}
+
+#elif defined(HTS_SHIM_SEQ_NEON)
+
+static void decode_blocks_neon(const uint8_t *src, int64_t nblocks, uint8_t *out) {
+    const uint8x16_t table = vld1q_u8(seq_nt16_ascii);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    for (int64_t b = 0; b < nblocks; b++) {
+        uint8x16_t v = vld1q_u8(src + 16 * b);
+        uint8x16x2_t pair;
+        pair.val[0] = vqtbl1q_u8(table, vshrq_n_u8(v, 4));
+        pair.val[1] = vqtbl1q_u8(table, vandq_u8(v, mask));
+        vst2q_u8(out + 32 * b, pair);
+    }
+}
+
+static void revcomp_blocks_neon(const uint8_t *src, int64_t nblocks, uint8_t *out) {
+    const uint8x16_t table = vld1q_u8(seq_nt16_comp_ascii);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    for (int64_t b = 0; b < nblocks; b++) {
+        uint8x16_t v = vrev64q_u8(vld1q_u8(src - 16 * b));
+        v = vextq_u8(v, v, 8);
+        uint8x16x2_t pair;
+        pair.val[0] = vqtbl1q_u8(table, vandq_u8(v, mask));
+        pair.val[1] = vqtbl1q_u8(table, vshrq_n_u8(v, 4));
+        vst2q_u8(out + 32 * b, pair);
+    }
+}
+
+#endif
+
+// Decode whole packed blocks; returns the number of blocks handled.
+static int64_t decode_blocks(const uint8_t *src, int64_t nblocks, uint8_t *out) {
+#if defined(HTS_SHIM_SEQ_SSSE3)
+    if (have_ssse3()) { decode_blocks_ssse3(src, nblocks, out); return nblocks; }
+#elif defined(HTS_SHIM_SEQ_NEON)
+    decode_blocks_neon(src, nblocks, out);
+    return nblocks;
+#endif
+    (void)src; (void)nblocks; (void)out;
+    return 0;
+}
+
+static int64_t revcomp_blocks(const uint8_t *src, int64_t nblocks, uint8_t *out) {
+#if defined(HTS_SHIM_SEQ_SSSE3)
+    if (have_ssse3()) { revcomp_blocks_ssse3(src, nblocks, out); return nblocks; }
+#elif defined(HTS_SHIM_SEQ_NEON)
+    revcomp_blocks_neon(src, nblocks, out);
+    return nblocks;
+#endif
+    (void)src; (void)nblocks; (void)out;
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Public kernels
+// ---------------------------------------------------------------------------
+
+void hts_shim_seq_decode(const uint8_t *seq, int64_t start, int64_t len, uint8_t *out) {
+    int64_t i = 0, pos = start;
+    if (len > 0 && (pos & 1)) {
+        out[i++] = seq_nt16_ascii[seq_base(seq, pos++)];
+    }
+    int64_t blocks = decode_blocks(seq + (pos >> 1), (len - i) / 32, out + i);
+    i += 32 * blocks;
+    pos += 32 * blocks;
+    // Scalar path: two bases per packed byte.
+    for (; len - i >= 2; i += 2, pos += 2) {
+        uint8_t byte = seq[pos >> 1];
+        out[i] = seq_nt16_ascii[byte >> 4];
+        out[i + 1] = seq_nt16_ascii[byte & 0xF];
+    }
+    if (i < len) {
+        out[i] = seq_nt16_ascii[seq_base(seq, pos)];
+    }
+}
+
+void hts_shim_seq_decode_revcomp(const uint8_t *seq, int64_t start, int64_t len, uint8_t *out) {
+    int64_t i = 0, end = start + len;  // exclusive
+    if (len > 0 && (end & 1)) {
+        out[i++] = seq_nt16_comp_ascii[seq_base(seq, --end)];
+    }
+    int64_t nblocks = (len - i) / 32;
+    if (nblocks > 0) {
+        int64_t blocks = revcomp_blocks(seq + (end >> 1) - 16, nblocks, out + i);
+        i += 32 * blocks;
+        end -= 32 * blocks;
+    }
+    for (; len - i >= 2; i += 2, end -= 2) {
+        uint8_t byte = seq[(end >> 1) - 1];
+        out[i] = seq_nt16_comp_ascii[byte & 0xF];
+        out[i + 1] = seq_nt16_comp_ascii[byte >> 4];
+    }
+    if (i < len) {
+        out[i] = seq_nt16_comp_ascii[seq_base(seq, end - 1)];
+    }
+}
+
+void hts_shim_seq_encode(const uint8_t *ascii, int64_t len, uint8_t *out) {
+    int64_t i = 0;
+    for (; i + 1 < len; i += 2) {
+        out[i >> 1] = (uint8_t)(seq_nt16_table[ascii[i]] << 4 | seq_nt16_table[ascii[i + 1]]);
+    }
+    if (i < len) {
+        out[i >> 1] = (uint8_t)(seq_nt16_table[ascii[i]] << 4);
+    }
+}
@@ -0,0 +1,200 @@
+/*
+ * htslib_sort_kernels.c
+ *
+ * Record comparison and in-memory chunk sorting for BAMSorter.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/htslib_sort_kernels.h"
+
+// ---------------------------------------------------------------------------
+// Comparators
+// ---------------------------------------------------------------------------
+
+static inline int cmp_coordinate(const bam1_t *a, const bam1_t *b) {
+    // Unmapped reads with tid -1 sort last.
+    uint32_t ta = (uint32_t)a->core.tid, tb = (uint32_t)b->core.tid;
+    if (ta != tb) return ta < tb ? -1 : 1;
+    if (a->core.pos != b->core.pos) return a->core.pos < b->core.pos ? -1 : 1;
+    int ra = bam_is_rev(a), rb = bam_is_rev(b);
+    return ra - rb;
+}
+
+/// Natural string order: runs of digits compare numerically.
+static int strnum_cmp(const char *sa, const char *sb) {
+    const unsigned char *a = (const unsigned char *)sa, *b = (const unsigned char *)sb;
+    while (*a && *b) {
+        if (!isdigit(*a) || !isdigit(*b)) {
+            if (*a != *b) return (int)*a - (int)*b;
+            a++, b++;
+        } else {
+            while (*a == '0') a++;
+            while (*b == '0') b++;
+            while (isdigit(*a) && *a == *b) a++, b++;
+            int diff = (int)*a - (int)*b;
+            while (isdigit(*a) && isdigit(*b)) a++, b++;
+            if (isdigit(*a)) return 1;
+            if (isdigit(*b)) return -1;
+            if (diff) return diff;
+        }
+    }
+    return *a ? 1 : *b ? -1 : 0;
+}
+
+static inline int cmp_queryname(const bam1_t *a, const bam1_t *b) {
+    int c = strnum_cmp(bam_get_qname(a), bam_get_qname(b));
+    if (c) return c;
+    int fa = a->core.flag & (BAM_FREAD1 | BAM_FREAD2), fb = b->core.flag & (BAM_FREAD1 | BAM_FREAD2);
+    if (fa != fb) return fa - fb;
+    fa = a->core.flag & (BAM_FSECONDARY | BAM_FSUPPLEMENTARY);
+    fb = b->core.flag & (BAM_FSECONDARY | BAM_FSUPPLEMENTARY);
+    return fa - fb;
+}
+
+/// Missing tags sort first, then numeric values, then strings.
+static int cmp_tag(const bam1_t *a, const bam1_t *b, const char *tag) {
+    uint8_t *ta = bam_aux_get(a, tag), *tb = bam_aux_get(b, tag);
+    if (!ta || !tb) {
+        if (ta || tb) return ta ? 1 : -1;
+        return cmp_coordinate(a, b);
+    }
+    int sa = (*ta == 'Z' || *ta == 'H'), sb = (*tb == 'Z' || *tb == 'H');
+    if (sa != sb) return sa - sb;
+    int c;
+    if (sa) {
+        c = strcmp(bam_aux2Z(ta), bam_aux2Z(tb));
+    } else if (*ta == 'f' || *ta == 'd' || *tb == 'f' || *tb == 'd') {
+        double da = bam_aux2f(ta), db = bam_aux2f(tb);
+        c = da < db ? -1 : da > db;
+    } else if (*ta == 'A' || *tb == 'A') {
+        c = (int)bam_aux2A(ta) - (int)bam_aux2A(tb);
+    } else {
+        int64_t ia = bam_aux2i(ta), ib = bam_aux2i(tb);
+        c = ia < ib ? -1 : ia > ib;
+    }
+    return c ? c : cmp_coordinate(a, b);
+}
+
+int hts_shim_sort_compare(const bam1_t *a, const bam1_t *b, int order, const char *tag) {
+    switch (order) {
+    case HTS_SHIM_SORT_QUERYNAME: return cmp_queryname(a, b);
+    case HTS_SHIM_SORT_TAG:       return cmp_tag(a, b, tag);
+    default:                      return cmp_coordinate(a, b);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Stable merge sort over record pointers
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    int order;
+    const char *tag;
+} sort_spec_t;
+
+/// Merge src[lo..mid) and src[mid..hi) into dst[lo..hi); ties take the left run.
+static void merge_runs(bam1_t **src, bam1_t **dst, size_t lo, size_t mid, size_t hi,
+                       const sort_spec_t *spec) {
+    size_t i = lo, j = mid, k = lo;
+    while (i < mid && j < hi) {
+        if (hts_shim_sort_compare(src[j], src[i], spec->order, spec->tag) < 0) dst[k++] = src[j++];
+        else dst[k++] = src[i++];
+    }
+    while (i < mid) dst[k++] = src[i++];
+    while (j < hi) dst[k++] = src[j++];
+}
+
+/// Sort a[lo..hi) using tmp[lo..hi) as scratch; the result ends up in a.
+static void merge_sort(bam1_t **a, bam1_t **tmp, size_t lo, size_t hi, const sort_spec_t *spec) {
+    if (hi - lo <= 16) {
+        for (size_t i = lo + 1; i < hi; i++) {
+            bam1_t *x = a[i];
+            size_t j = i;
+            while (j > lo && hts_shim_sort_compare(x, a[j - 1], spec->order, spec->tag) < 0) {
+                a[j] = a[j - 1];
+                j--;
+            }
+            a[j] = x;
+        }
+        return;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    merge_sort(a, tmp, lo, mid, spec);
+    merge_sort(a, tmp, mid, hi, spec);
+    // Already ordered across the boundary: nothing to merge.
+    if (hts_shim_sort_compare(a[mid], a[mid - 1], spec->order, spec->tag) >= 0) return;
+    merge_runs(a, tmp, lo, mid, hi, spec);
+    memcpy(a + lo, tmp + lo, (hi - lo) * sizeof(*a));
+}
+
+typedef struct {
+    bam1_t **recs, **scratch;
+    size_t lo, mid, hi;
+    const sort_spec_t *spec;
+    int merge;              // 0: sort [lo, hi); 1: merge [lo, mid) and [mid, hi) into scratch
+} sort_job_t;
+
+static void *sort_job(void *arg) {
+    sort_job_t *job = arg;
+    if (job->merge) merge_runs(job->recs, job->scratch, job->lo, job->mid, job->hi, job->spec);
+    else merge_sort(job->recs, job->scratch, job->lo, job->hi, job->spec);
+    return NULL;
+}
+
+int hts_shim_sort_records(bam1_t **recs, bam1_t **scratch, size_t n, int order,
+                          const char *tag, hts_tpool *pool, int n_parts) {
+    sort_spec_t spec = { order, tag };
+    if (n < 2) return 0;
+    if (!pool || n_parts <= 1 || n < (size_t)n_parts * 64) {
+        merge_sort(recs, scratch, 0, n, &spec);
+        return 0;
+    }
+
+    size_t parts = (size_t)n_parts;
+    size_t *bounds = malloc((parts + 1) * sizeof(size_t));
+    sort_job_t *jobs = malloc(parts * sizeof(sort_job_t));
+    hts_tpool_process *q = hts_tpool_process_init(pool, n_parts, 1);
+    if (!bounds || !jobs || !q) {
+        free(bounds);
+        free(jobs);
+        if (q) hts_tpool_process_destroy(q);
+        merge_sort(recs, scratch, 0, n, &spec);
+        return 0;
+    }
+    for (size_t p = 0; p <= parts; p++) bounds[p] = n * p / parts;
+
+    int ret = 0;
+    for (size_t p = 0; p < parts; p++) {
+        jobs[p] = (sort_job_t){ recs, scratch, bounds[p], 0, bounds[p + 1], &spec, 0 };
+        if (hts_tpool_dispatch(pool, q, sort_job, &jobs[p]) < 0) { ret = -1; break; }
+    }
+    hts_tpool_process_flush(q);
+
+    // Pairwise merge rounds, ping-ponging between recs and scratch.
+    bam1_t **src = recs, **dst = scratch;
+    size_t runs = parts;
+    while (ret == 0 && runs > 1) {
+        size_t out = 0;
+        for (size_t r = 0; r < runs; r += 2, out++) {
+            size_t lo = bounds[r];
+            size_t mid = bounds[r + 1 < runs ? r + 1 : runs];
+            size_t hi = bounds[r + 2 < runs ? r + 2 : runs];
+            jobs[out] = (sort_job_t){ src, dst, lo, mid, hi, &spec, 1 };
+            if (hts_tpool_dispatch(pool, q, sort_job, &jobs[out]) < 0) { ret = -1; break; }
+            bounds[out] = lo;
+        }
+        hts_tpool_process_flush(q);
+        bounds[out] = n;
+        runs = out;
+        bam1_t **t = src; src = dst; dst = t;
+    }
+    if (ret == 0 && src != recs) memcpy(recs, src, n * sizeof(*recs));
+
+    hts_tpool_process_destroy(q);
+    free(jobs);
+    free(bounds);
+    return ret;
+}
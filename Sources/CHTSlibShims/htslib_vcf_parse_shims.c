@@ -0,0 +1,375 @@
+/*
+ * htslib_vcf_parse_shims.c
+ *
+ * Parallel VCF text parsing on an htslib thread pool.
+ *
+ * Chunks cycle FREE -> READING -> PARSING -> READY -> FREE. The reading job
+ * fills chunks starting at fill_idx with whole lines for as long as the next
+ * one is FREE, dispatching a parse job for each chunk it fills, then exits;
+ * the consumer re-dispatches it whenever it frees a chunk and no reading job
+ * is running. The consumer drains chunks strictly in ring order, so records
+ * come back in file order however the parse jobs finish. Records are handed
+ * over by swapping bcf1_t contents, so a consumer that reads into the same
+ * record keeps buffers circulating without copies.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <htslib/kstring.h>
+#include "include/htslib_vcf_parse_shims.h"
+
+enum { CHUNK_FREE, CHUNK_READING, CHUNK_PARSING, CHUNK_READY };
+
+// Stop filling a chunk once it holds this much text, however few lines it has.
+#define CHUNK_MAX_BYTES (4 << 20)
+
+typedef struct vcf_chunk {
+    struct hts_shim_vcf_parser *owner;
+    kstring_t text;         // lines, each NUL-terminated
+    size_t *offsets;        // start of each line in text
+    int *lengths;           // length of each line
+    char *deferred;         // 1 if the consumer must parse the line
+    bcf1_t **recs;
+    int cap;                // capacity of the per-line arrays
+    int n;                  // lines filled, then records valid
+    int status;             // 0, -1 at end of file, -2 read error, -3 parse error
+    int state;
+    kstring_t name;         // scratch for header lookups
+    kstring_t hdr_mem;      // vcf_parse() scratch for this chunk's header view
+} vcf_chunk_t;
+
+struct hts_shim_vcf_parser {
+    htsFile *fp;
+    bcf_hdr_t *hdr;
+    hts_tpool *pool;
+    hts_tpool_process *read_q, *parse_q;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_rwlock_t hdr_lock;  // parse jobs read hdr; the consumer may extend it
+    vcf_chunk_t *chunks;
+    kstring_t line;
+    int n_chunks, chunk_lines, unpack_flags;
+    int fill_idx, read_idx, read_pos;
+    int job_running, parsing, finished, shutdown, error;
+};
+
+// ── Header lookups ────────────────────────────────────────────────────────
+
+/// Whether name[0..len) is defined in the header as `hl_type` (BCF_HL_CTG for contigs).
+static int name_defined(const bcf_hdr_t *hdr, int hl_type, const char *name, size_t len,
+                        kstring_t *tmp) {
+    tmp->l = 0;
+    if (kputsn(name, len, tmp) < 0) return 0;
+    if (hl_type == BCF_HL_CTG) return bcf_hdr_name2id(hdr, tmp->s) >= 0;
+    int id = bcf_hdr_id2int(hdr, BCF_DT_ID, tmp->s);
+    return id >= 0 && bcf_hdr_idinfo_exists(hdr, hl_type, id);
+}
+
+/// Whether every `sep`-separated name in field[0..len) is defined; names end at `stop`.
+static int names_defined(const bcf_hdr_t *hdr, int hl_type, const char *field, size_t len,
+                         char sep, char stop, kstring_t *tmp) {
+    if (len == 1 && field[0] == '.') return 1;
+    const char *end = field + len;
+    while (field < end) {
+        const char *next = memchr(field, sep, end - field);
+        if (!next) next = end;
+        const char *name_end = stop ? memchr(field, stop, next - field) : NULL;
+        if (!name_end) name_end = next;
+        if (name_end > field && !name_defined(hdr, hl_type, field, name_end - field, tmp)) return 0;
+        field = next + 1;
+    }
+    return 1;
+}
+
+/// Whether vcf_parse() can parse the line without adding header records: its CHROM,
+/// FILTER names, INFO keys and FORMAT keys are all declared.
+static int line_names_defined(const bcf_hdr_t *hdr, const char *line, size_t len,
+                              kstring_t *tmp) {
+    const char *end = line + len, *col = line;
+    for (int i = 0; i <= 8 && col < end; i++) {
+        const char *tab = memchr(col, '\t', end - col);
+        if (!tab) tab = end;
+        size_t n = tab - col;
+        int ok = 1;
+        switch (i) {
+        case 0: ok = name_defined(hdr, BCF_HL_CTG, col, n, tmp); break;
+        case 6: ok = names_defined(hdr, BCF_HL_FLT, col, n, ';', 0, tmp); break;
+        case 7: ok = names_defined(hdr, BCF_HL_INFO, col, n, ';', '=', tmp); break;
+        case 8: ok = names_defined(hdr, BCF_HL_FMT, col, n, ':', 0, tmp); break;
+        }
+        if (!ok) return 0;
+        col = tab + 1;
+    }
+    return 1;
+}
+
+// ── Jobs ──────────────────────────────────────────────────────────────────
+
+static int parse_line(hts_shim_vcf_parser_t *p, const bcf_hdr_t *hdr, vcf_chunk_t *ch, int i) {
+    // vcf_parse() tokenizes in place; the line is not used again afterwards.
+    kstring_t ks = { (size_t)ch->lengths[i], (size_t)ch->lengths[i] + 1,
+                     ch->text.s + ch->offsets[i] };
+    if (vcf_parse(&ks, hdr, ch->recs[i]) < 0) return -1;
+    if (p->unpack_flags && bcf_unpack(ch->recs[i], p->unpack_flags) < 0) return -1;
+    return 0;
+}
+
+static void *parse_job(void *arg) {
+    vcf_chunk_t *ch = arg;
+    hts_shim_vcf_parser_t *p = ch->owner;
+
+    pthread_rwlock_rdlock(&p->hdr_lock);
+    // vcf_parse() only reads the header's dictionaries but formats FORMAT values in its
+    // `mem` buffer, so each job parses through a shallow copy with a scratch of its own.
+    bcf_hdr_t view = *p->hdr;
+    view.mem = ch->hdr_mem;
+    for (int i = 0; i < ch->n; i++) {
+        const char *line = ch->text.s + ch->offsets[i];
+        ch->deferred[i] = !line_names_defined(&view, line, ch->lengths[i], &ch->name);
+        if (!ch->deferred[i] && parse_line(p, &view, ch, i) < 0) {
+            ch->n = i;
+            ch->status = -3;
+            break;
+        }
+    }
+    ch->hdr_mem = view.mem;
+    pthread_rwlock_unlock(&p->hdr_lock);
+
+    pthread_mutex_lock(&p->lock);
+    ch->state = CHUNK_READY;
+    if (ch->status < -1) p->finished = 1;
+    p->parsing--;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+static int grow_chunk(vcf_chunk_t *ch) {
+    int cap = ch->cap ? ch->cap * 2 : 64;
+    size_t *offsets = realloc(ch->offsets, cap * sizeof(*offsets));
+    if (offsets) ch->offsets = offsets;
+    int *lengths = realloc(ch->lengths, cap * sizeof(*lengths));
+    if (lengths) ch->lengths = lengths;
+    char *deferred = realloc(ch->deferred, cap);
+    if (deferred) ch->deferred = deferred;
+    bcf1_t **recs = realloc(ch->recs, cap * sizeof(*recs));
+    if (recs) ch->recs = recs;
+    if (!offsets || !lengths || !deferred || !recs) return -1;
+    for (int i = ch->cap; i < cap; i++) {
+        if (!(ch->recs[i] = bcf_init())) {
+            ch->cap = i;
+            return -1;
+        }
+    }
+    ch->cap = cap;
+    return 0;
+}
+
+/// Read whole lines into ch until it is full or the stream ends.
+static void fill_chunk(hts_shim_vcf_parser_t *p, vcf_chunk_t *ch) {
+    ch->text.l = 0;
+    ch->n = 0;
+    ch->status = 0;
+    while (ch->n < p->chunk_lines && ch->text.l < CHUNK_MAX_BYTES) {
+        int ret = hts_getline(p->fp, KS_SEP_LINE, &p->line);
+        if (ret < 0) {
+            ch->status = ret == -1 ? -1 : -2;
+            return;
+        }
+        if (p->line.l == 0 || p->line.s[0] == '#') continue;
+        if (ch->n == ch->cap && grow_chunk(ch) < 0) {
+            ch->status = -2;
+            return;
+        }
+        ch->offsets[ch->n] = ch->text.l;
+        ch->lengths[ch->n] = (int)p->line.l;
+        // kputsn() leaves room for the NUL it writes; keep it as the line terminator.
+        if (kputsn(p->line.s, p->line.l, &ch->text) < 0) {
+            ch->status = -2;
+            return;
+        }
+        ch->text.l++;
+        ch->n++;
+    }
+}
+
+static void *read_job(void *arg) {
+    hts_shim_vcf_parser_t *p = arg;
+    pthread_mutex_lock(&p->lock);
+    for (;;) {
+        vcf_chunk_t *ch = &p->chunks[p->fill_idx];
+        if (p->shutdown || p->finished || ch->state != CHUNK_FREE) break;
+        ch->state = CHUNK_READING;
+        pthread_mutex_unlock(&p->lock);
+
+        fill_chunk(p, ch);
+
+        pthread_mutex_lock(&p->lock);
+        if (ch->status != 0) p->finished = 1;
+        p->fill_idx = (p->fill_idx + 1) % p->n_chunks;
+        ch->state = CHUNK_PARSING;
+        p->parsing++;
+        pthread_mutex_unlock(&p->lock);
+
+        // parse_q holds n_chunks jobs, so this never blocks.
+        int ret = hts_tpool_dispatch(p->pool, p->parse_q, parse_job, ch);
+
+        pthread_mutex_lock(&p->lock);
+        if (ret < 0) {
+            ch->n = 0;
+            ch->status = -2;
+            ch->state = CHUNK_READY;
+            p->parsing--;
+            p->finished = 1;
+            pthread_cond_broadcast(&p->cond);
+        }
+    }
+    p->job_running = 0;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+/// Start the reading job if it is idle and there is work. Called with lock held;
+/// returns with lock held.
+static void parser_kick(hts_shim_vcf_parser_t *p) {
+    if (p->job_running || p->finished || p->shutdown) return;
+    if (p->chunks[p->fill_idx].state != CHUNK_FREE) return;
+    p->job_running = 1;
+    pthread_mutex_unlock(&p->lock);
+    if (hts_tpool_dispatch(p->pool, p->read_q, read_job, p) < 0) {
+        pthread_mutex_lock(&p->lock);
+        vcf_chunk_t *ch = &p->chunks[p->fill_idx];
+        p->job_running = 0;
+        p->finished = 1;
+        ch->n = 0;
+        ch->status = -2;
+        ch->state = CHUNK_READY;
+        return;
+    }
+    pthread_mutex_lock(&p->lock);
+}
+
+// ── Public API ────────────────────────────────────────────────────────────
+
+hts_shim_vcf_parser_t *hts_shim_vcf_parser_init(htsFile *fp, bcf_hdr_t *hdr, hts_tpool *pool,
+                                                int chunk_lines, int n_chunks, int unpack_flags) {
+    if (!pool) return NULL;
+    if (chunk_lines < 1) chunk_lines = 1;
+    if (n_chunks < 2) n_chunks = 2;
+    hts_shim_vcf_parser_t *p = calloc(1, sizeof(*p));
+    if (!p) return NULL;
+    p->fp = fp;
+    p->hdr = hdr;
+    p->pool = pool;
+    p->chunk_lines = chunk_lines;
+    p->n_chunks = n_chunks;
+    p->unpack_flags = unpack_flags;
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->cond, NULL);
+    pthread_rwlock_init(&p->hdr_lock, NULL);
+
+    p->chunks = calloc(n_chunks, sizeof(*p->chunks));
+    if (!p->chunks) goto fail;
+    for (int i = 0; i < n_chunks; i++) p->chunks[i].owner = p;
+
+    // One reading job at a time; parse jobs for every chunk may be queued at once.
+    p->read_q = hts_tpool_process_init(pool, 1, 1);
+    p->parse_q = hts_tpool_process_init(pool, n_chunks, 1);
+    if (!p->read_q || !p->parse_q) goto fail;
+    pthread_mutex_lock(&p->lock);
+    parser_kick(p);
+    pthread_mutex_unlock(&p->lock);
+    return p;
+
+fail:
+    hts_shim_vcf_parser_destroy(p);
+    return NULL;
+}
+
+int hts_shim_vcf_parser_read(hts_shim_vcf_parser_t *p, bcf1_t *v) {
+    pthread_mutex_lock(&p->lock);
+    for (;;) {
+        if (p->error) {
+            pthread_mutex_unlock(&p->lock);
+            return p->error;
+        }
+        vcf_chunk_t *ch = &p->chunks[p->read_idx];
+        if (ch->state == CHUNK_READY) {
+            if (p->read_pos < ch->n) {
+                int i = p->read_pos++;
+                pthread_mutex_unlock(&p->lock);
+                if (ch->deferred[i]) {
+                    // May add header records: parse with no parse job reading the header.
+                    pthread_rwlock_wrlock(&p->hdr_lock);
+                    int ret = parse_line(p, p->hdr, ch, i);
+                    pthread_rwlock_unlock(&p->hdr_lock);
+                    if (ret < 0) {
+                        pthread_mutex_lock(&p->lock);
+                        p->error = -3;
+                        p->finished = 1;
+                        pthread_mutex_unlock(&p->lock);
+                        return -3;
+                    }
+                }
+                bcf1_t tmp = *v;
+                *v = *ch->recs[i];
+                *ch->recs[i] = tmp;
+                return 0;
+            }
+            if (ch->status != 0) {
+                p->error = ch->status;
+                continue;
+            }
+            ch->state = CHUNK_FREE;
+            ch->n = 0;
+            p->read_pos = 0;
+            p->read_idx = (p->read_idx + 1) % p->n_chunks;
+            parser_kick(p);
+            continue;
+        }
+        parser_kick(p);
+        pthread_cond_wait(&p->cond, &p->lock);
+    }
+}
+
+int hts_shim_vcf_parser_buffered(hts_shim_vcf_parser_t *p) {
+    int total = 0;
+    pthread_mutex_lock(&p->lock);
+    for (int i = 0; i < p->n_chunks; i++) {
+        if (p->chunks[i].state == CHUNK_READY) total += p->chunks[i].n;
+    }
+    total -= p->read_pos;
+    pthread_mutex_unlock(&p->lock);
+    return total;
+}
+
+void hts_shim_vcf_parser_destroy(hts_shim_vcf_parser_t *p) {
+    if (!p) return;
+    pthread_mutex_lock(&p->lock);
+    p->shutdown = 1;
+    while (p->job_running || p->parsing) pthread_cond_wait(&p->cond, &p->lock);
+    pthread_mutex_unlock(&p->lock);
+    if (p->read_q) hts_tpool_process_destroy(p->read_q);
+    if (p->parse_q) hts_tpool_process_destroy(p->parse_q);
+    if (p->chunks) {
+        for (int i = 0; i < p->n_chunks; i++) {
+            vcf_chunk_t *ch = &p->chunks[i];
+            for (int j = 0; j < ch->cap; j++) bcf_destroy(ch->recs[j]);
+            free(ch->recs);
+            free(ch->offsets);
+            free(ch->lengths);
+            free(ch->deferred);
+            free(ch->text.s);
+            free(ch->name.s);
+            free(ch->hdr_mem.s);
+        }
+        free(p->chunks);
+    }
+    free(p->line.s);
+    pthread_rwlock_destroy(&p->hdr_lock);
+    pthread_cond_destroy(&p->cond);
+    pthread_mutex_destroy(&p->lock);
+    free(p);
+}
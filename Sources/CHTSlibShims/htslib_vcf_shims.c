@@ -16,6 +16,14 @@ int32_t hts_shim_bcf_hdr_nsamples(const bcf_hdr_t *hdr)
     return bcf_hdr_nsamples(hdr);
 }
 
+int64_t hts_shim_bcf_hdr_contig_length(const bcf_hdr_t *hdr, const char *name)
+{
+    int rid = bcf_hdr_name2id(hdr, name);
+    if (rid < 0 || rid >= hdr->n[BCF_DT_CTG] || !hdr->id[BCF_DT_CTG][rid].val) return -1;
+    int64_t len = (int64_t)hdr->id[BCF_DT_CTG][rid].val->info[0];
+    return len > 0 ? len : -1;
+}
+
 htsFile *hts_shim_bcf_open(const char *fn, const char *mode)
 {
     return bcf_open(fn, mode);
@@ -271,6 +279,11 @@ int hts_shim_bcf_itr_next(htsFile *htsfp, hts_itr_t *itr, bcf1_t *r)
     return bcf_itr_next(htsfp, itr, r);
 }
 
+int hts_shim_bcf_subset_format(const bcf_hdr_t *hdr, bcf1_t *rec)
+{
+    return hdr->keep_samples ? bcf_subset_format(hdr, rec) : 0;
+}
+
 /* ── Synced BCF reader macro/variadic wrappers ──────────────────────────── */
 
 int hts_shim_bcf_sr_has_line(bcf_srs_t *readers, int i)
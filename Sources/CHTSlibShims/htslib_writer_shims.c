@@ -0,0 +1,217 @@
+/*
+ * htslib_writer_shims.c
+ *
+ * Write-behind record output.
+ *
+ * Batches cycle FREE -> FILLING -> READY -> FREE. The producer fills the
+ * batch at fill_idx and marks it READY when full (or on flush); the writer
+ * thread writes the batch at write_idx once it is READY and frees it. After
+ * a write error the thread keeps freeing batches without writing, so the
+ * producer never waits forever, and slot() starts returning NULL.
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "include/htslib_writer_shims.h"
+
+enum { BATCH_FREE, BATCH_FILLING, BATCH_READY };
+
+typedef struct {
+    void **recs;
+    int n;
+    int state;
+} writer_batch_t;
+
+struct hts_shim_writer {
+    htsFile *fp;
+    void *hdr;
+    int kind;
+    int background;
+    pthread_t thread;
+    int thread_started;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    writer_batch_t *batches;
+    int n_batches, batch_size;
+    int fill_idx, write_idx;
+    int error, shutdown;
+    int64_t written, stalls;
+};
+
+static int writer_write1(hts_shim_writer_t *w, void *rec) {
+    if (w->kind == HTS_SHIM_WRITER_BCF) return bcf_write(w->fp, (bcf_hdr_t *)w->hdr, (bcf1_t *)rec);
+    return sam_write1(w->fp, (sam_hdr_t *)w->hdr, (bam1_t *)rec);
+}
+
+static void *writer_thread(void *arg) {
+    hts_shim_writer_t *w = arg;
+    pthread_mutex_lock(&w->lock);
+    for (;;) {
+        writer_batch_t *bt = &w->batches[w->write_idx];
+        if (bt->state != BATCH_READY) {
+            if (w->shutdown) break;
+            pthread_cond_wait(&w->cond, &w->lock);
+            continue;
+        }
+        int failed = w->error;
+        pthread_mutex_unlock(&w->lock);
+
+        int i = 0, ret = 0;
+        if (!failed) {
+            for (; i < bt->n; i++) {
+                if ((ret = writer_write1(w, bt->recs[i])) < 0) break;
+            }
+        }
+
+        pthread_mutex_lock(&w->lock);
+        if (ret < 0 && !w->error) w->error = ret;
+        w->written += i;
+        bt->n = 0;
+        bt->state = BATCH_FREE;
+        w->write_idx = (w->write_idx + 1) % w->n_batches;
+        pthread_cond_broadcast(&w->cond);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+hts_shim_writer_t *hts_shim_writer_init(htsFile *fp, void *hdr, int kind,
+                                        int batch_size, int n_batches, int background) {
+    if (batch_size < 1) batch_size = 1;
+    if (n_batches < 2) n_batches = 2;
+    if (!background) batch_size = 1, n_batches = 1;
+    hts_shim_writer_t *w = calloc(1, sizeof(*w));
+    if (!w) return NULL;
+    w->fp = fp;
+    w->hdr = hdr;
+    w->kind = kind;
+    w->background = background;
+    w->batch_size = batch_size;
+    w->n_batches = n_batches;
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->cond, NULL);
+
+    w->batches = calloc(n_batches, sizeof(*w->batches));
+    if (!w->batches) goto fail;
+    for (int i = 0; i < n_batches; i++) {
+        w->batches[i].recs = calloc(batch_size, sizeof(void *));
+        if (!w->batches[i].recs) goto fail;
+        for (int j = 0; j < batch_size; j++) {
+            void *rec = kind == HTS_SHIM_WRITER_BCF ? (void *)bcf_init() : (void *)bam_init1();
+            if (!(w->batches[i].recs[j] = rec)) goto fail;
+        }
+    }
+    if (background) {
+        if (pthread_create(&w->thread, NULL, writer_thread, w) != 0) goto fail;
+        w->thread_started = 1;
+    }
+    return w;
+
+fail:
+    hts_shim_writer_destroy(w);
+    return NULL;
+}
+
+void *hts_shim_writer_slot(hts_shim_writer_t *w) {
+    if (!w->background) return w->error ? NULL : w->batches[0].recs[0];
+    pthread_mutex_lock(&w->lock);
+    writer_batch_t *bt = &w->batches[w->fill_idx];
+    if (bt->state != BATCH_FILLING) {
+        if (bt->state != BATCH_FREE && !w->error) w->stalls++;
+        while (bt->state != BATCH_FREE && !w->error) pthread_cond_wait(&w->cond, &w->lock);
+        if (!w->error) bt->state = BATCH_FILLING;
+    }
+    void *slot = w->error ? NULL : bt->recs[bt->n];
+    pthread_mutex_unlock(&w->lock);
+    return slot;
+}
+
+/// Hand the current batch to the writer thread. Called with lock held.
+static void writer_publish(hts_shim_writer_t *w) {
+    writer_batch_t *bt = &w->batches[w->fill_idx];
+    if (bt->state != BATCH_FILLING) return;
+    if (bt->n == 0) {
+        bt->state = BATCH_FREE;
+        return;
+    }
+    bt->state = BATCH_READY;
+    w->fill_idx = (w->fill_idx + 1) % w->n_batches;
+    pthread_cond_broadcast(&w->cond);
+}
+
+int hts_shim_writer_commit(hts_shim_writer_t *w) {
+    if (!w->background) {
+        if (w->error) return w->error;
+        int ret = writer_write1(w, w->batches[0].recs[0]);
+        if (ret < 0) return w->error = ret;
+        w->written++;
+        return 0;
+    }
+    pthread_mutex_lock(&w->lock);
+    writer_batch_t *bt = &w->batches[w->fill_idx];
+    if (bt->state == BATCH_FILLING && ++bt->n == w->batch_size) writer_publish(w);
+    int error = w->error;
+    pthread_mutex_unlock(&w->lock);
+    return error;
+}
+
+int hts_shim_writer_flush(hts_shim_writer_t *w) {
+    if (!w->background) return w->error;
+    pthread_mutex_lock(&w->lock);
+    writer_publish(w);
+    for (;;) {
+        int busy = 0;
+        for (int i = 0; i < w->n_batches; i++) busy |= w->batches[i].state == BATCH_READY;
+        if (!busy) break;
+        pthread_cond_wait(&w->cond, &w->lock);
+    }
+    int error = w->error;
+    pthread_mutex_unlock(&w->lock);
+    return error;
+}
+
+int64_t hts_shim_writer_written(hts_shim_writer_t *w) {
+    pthread_mutex_lock(&w->lock);
+    int64_t n = w->written;
+    pthread_mutex_unlock(&w->lock);
+    return n;
+}
+
+int64_t hts_shim_writer_stalls(hts_shim_writer_t *w) {
+    pthread_mutex_lock(&w->lock);
+    int64_t n = w->stalls;
+    pthread_mutex_unlock(&w->lock);
+    return n;
+}
+
+int hts_shim_writer_destroy(hts_shim_writer_t *w) {
+    if (!w) return 0;
+    int error = 0;
+    if (w->thread_started) {
+        error = hts_shim_writer_flush(w);
+        pthread_mutex_lock(&w->lock);
+        w->shutdown = 1;
+        pthread_cond_broadcast(&w->cond);
+        pthread_mutex_unlock(&w->lock);
+        pthread_join(w->thread, NULL);
+    } else {
+        error = w->error;
+    }
+    if (w->batches) {
+        for (int i = 0; i < w->n_batches; i++) {
+            if (!w->batches[i].recs) continue;
+            for (int j = 0; j < w->batch_size; j++) {
+                void *rec = w->batches[i].recs[j];
+                if (!rec) continue;
+                if (w->kind == HTS_SHIM_WRITER_BCF) bcf_destroy((bcf1_t *)rec);
+                else bam_destroy1((bam1_t *)rec);
+            }
+            free(w->batches[i].recs);
+        }
+        free(w->batches);
+    }
+    pthread_cond_destroy(&w->cond);
+    pthread_mutex_destroy(&w->lock);
+    free(w);
+    return error;
+}
@@ -0,0 +1,64 @@
+/*
+ * htslib_cache_shims.h
+ *
+ * Support for HTSResourceCache: a mutex Swift can hold without Foundation,
+ * file identity (modification time and size) for cache keys, size estimates
+ * for parsed headers, and skipping a BAM/BCF header whose parsed form is
+ * already cached.
+ *
+ * All shim functions use the hts_shim_ prefix.
+ */
+
+#ifndef HTSLIB_CACHE_SHIMS_H
+#define HTSLIB_CACHE_SHIMS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <htslib/hts.h>
+#include <htslib/vcf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// An opaque mutex.
+typedef struct hts_shim_lock hts_shim_lock_t;
+
+/// Create a mutex, or return NULL on allocation failure.
+hts_shim_lock_t *hts_shim_lock_create(void);
+
+/// A statically allocated mutex for process-wide state. It is never NULL and must
+/// not be passed to hts_shim_lock_destroy.
+hts_shim_lock_t *hts_shim_lock_static(void);
+
+/// Lock the mutex, blocking until it is available.
+void hts_shim_lock_acquire(hts_shim_lock_t *lock);
+
+/// Unlock the mutex.
+void hts_shim_lock_release(hts_shim_lock_t *lock);
+
+/// Destroy an unlocked mutex.
+void hts_shim_lock_destroy(hts_shim_lock_t *lock);
+
+/// Read a file's modification time (nanoseconds since the epoch) and size in bytes.
+/// Returns 0 on success, -1 if the file cannot be stat'ed.
+int hts_shim_file_identity(const char *path, int64_t *mtime_ns, int64_t *size);
+
+/// The length in bytes of a VCF header's text, as written by bcf_hdr_format().
+/// Returns -1 on failure.
+int64_t hts_shim_bcf_hdr_text_length(const bcf_hdr_t *hdr);
+
+/// The virtual offset just past the header of a BAM or BCF file whose header has just
+/// been read, or -1 for other formats.
+int64_t hts_shim_header_end_offset(htsFile *fp);
+
+/// Position a freshly opened BAM or BCF file at `offset`, skipping its header.
+/// Returns 0 after seeking, 1 if the file is another format (read the header instead),
+/// or -1 if the seek failed.
+int hts_shim_skip_header(htsFile *fp, int64_t offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTSLIB_CACHE_SHIMS_H */
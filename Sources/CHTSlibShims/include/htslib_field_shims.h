@@ -0,0 +1,48 @@
+/*
+ * htslib_field_shims.h
+ *
+ * INFO and FORMAT value access by header ID. bcf_get_info_values() and
+ * bcf_get_format_values() take the tag as a string and resolve it against
+ * the header dictionary on every call; these take the integer ID resolved
+ * once with bcf_hdr_id2int() and otherwise follow the same conventions:
+ * `*dst` is grown with realloc() only when `*ndst` (in output values) is too
+ * small, and integers are widened to int32 with the missing and vector-end
+ * sentinels preserved.
+ *
+ * All shim functions use the hts_shim_ prefix.
+ */
+
+#ifndef HTSLIB_FIELD_SHIMS_H
+#define HTSLIB_FIELD_SHIMS_H
+
+#include <htslib/vcf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Return the declared type (BCF_HT_FLAG, BCF_HT_INT, BCF_HT_REAL or BCF_HT_STR) of
+/// header ID `id` as a BCF_HL_INFO or BCF_HL_FMT field, or -1 if it is not defined as one.
+/// Wraps: bcf_hdr_idinfo_exists(hdr,hl_type,id), bcf_hdr_id2type(hdr,hl_type,id)
+int hts_shim_bcf_hdr_field_type(const bcf_hdr_t *hdr, int hl_type, int id);
+
+/// Copy the INFO values with header ID `id` into `*dst` as BCF_HT_INT (int32),
+/// BCF_HT_REAL (float) or BCF_HT_STR (NUL-terminated bytes).
+/// Returns the number of values (bytes for strings, excluding the NUL), -3 if the
+/// record has no such field, -2 if its stored type does not match `type`, or -4 on
+/// allocation failure.
+int hts_shim_bcf_get_info_values_id(bcf1_t *line, int id, int type,
+                                    void **dst, int *ndst);
+
+/// Copy the FORMAT values with header ID `id` for every sample into `*dst`, sample-major
+/// with the same number of values per sample. Short samples are padded with the
+/// vector-end sentinel; strings are copied as fixed-width byte blocks.
+/// Returns the total number of values, or -3, -2 or -4 as for the INFO variant.
+int hts_shim_bcf_get_format_values_id(const bcf_hdr_t *hdr, bcf1_t *line, int id,
+                                      int type, void **dst, int *ndst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTSLIB_FIELD_SHIMS_H */
@@ -0,0 +1,41 @@
+/*
+ * htslib_file_shims.h
+ *
+ * File utilities for code that spills to temporary files: BAMSorter,
+ * DuplicateMarker, MateCollator and AlignmentSplitter. Without Foundation,
+ * Swift has no way to create a unique temporary path, remove or rename a
+ * file, or read the process's peak memory use.
+ *
+ * All shim functions use the hts_shim_ prefix.
+ */
+
+#ifndef HTSLIB_FILE_SHIMS_H
+#define HTSLIB_FILE_SHIMS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Create a unique empty file named <dir>/<prefix>XXXXXX<suffix> and write its path
+/// to out (out_len bytes). Returns 0 on success, -1 on failure.
+int hts_shim_make_temp_path(const char *dir, const char *prefix, const char *suffix,
+                            char *out, size_t out_len);
+
+/// Remove a file. Returns 0 on success, -1 on failure.
+int hts_shim_remove_file(const char *path);
+
+/// Rename a file, replacing any file at the destination. Returns 0 on success or -errno
+/// on failure; EXDEV means the two paths are on different filesystems.
+int hts_shim_rename_file(const char *from, const char *to);
+
+/// Peak resident set size of this process in bytes, or 0 if unavailable.
+int64_t hts_shim_peak_rss_bytes(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTSLIB_FILE_SHIMS_H */
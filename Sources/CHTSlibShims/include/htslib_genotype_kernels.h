@@ -0,0 +1,75 @@
+/*
+ * htslib_genotype_kernels.h
+ *
+ * Packing and summary kernels for BCF GT fields. Genotypes are read straight
+ * from the typed FORMAT bytes, without expanding them to int32 per allele.
+ *
+ * Packed slots, one per allele position (sample-major, `ploidy` per sample):
+ *   2-bit:  0 = REF, 1 = ALT, 2 = missing, 3 = absent (vector end / padding)
+ *   8-bit:  allele index, 0xFE = missing, 0xFF = absent
+ *   16-bit: allele index, 0xFFFE = missing, 0xFFFF = absent
+ *
+ * All kernel functions use the hts_shim_ prefix.
+ */
+
+#ifndef HTSLIB_GENOTYPE_KERNELS_H
+#define HTSLIB_GENOTYPE_KERNELS_H
+
+#include <stdint.h>
+#include <htslib/vcf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Per-site genotype summary produced by the hts_shim_gt_summary kernels.
+typedef struct {
+    int64_t allele_number;  ///< Called (non-missing) alleles: INFO/AN.
+    int64_t hom_ref;        ///< Samples with >= 2 called alleles, all REF.
+    int64_t het;            ///< Samples with >= 2 called alleles that differ.
+    int64_t hom_alt;        ///< Samples with >= 2 called alleles, all the same ALT.
+    int64_t missing;        ///< Samples whose alleles are all missing.
+} hts_shim_gt_summary_t;
+
+/// Unpack the FORMAT block of `line` and return its field with header ID `gt_id`,
+/// or NULL if the record has no such field.
+bcf_fmt_t *hts_shim_gt_field(bcf1_t *line, int gt_id);
+
+/// Pack a GT field at 2 bits per slot into `words`, 32 slots per word; the tail of the
+/// last word is padded with absent slots. Sets bit s of `phased` when sample s has at
+/// least two present slots and every slot after the first is phased, and bit s of
+/// `missing` when every present slot of sample s is missing.
+/// Returns 0, or 1 if an allele index above 1 was found (use a wide packing instead).
+int hts_shim_gt_pack2(const bcf_fmt_t *fmt, int n_samples, uint64_t *words,
+                      uint64_t *phased, uint64_t *missing);
+
+/// Pack a GT field at 8 bits per slot. Returns 0, or 1 if an allele index above 253
+/// was found (use the 16-bit packing instead).
+int hts_shim_gt_pack8(const bcf_fmt_t *fmt, int n_samples, uint8_t *codes,
+                      uint64_t *phased, uint64_t *missing);
+
+/// Pack a GT field at 16 bits per slot. Allele indexes above 65533 are stored as missing.
+void hts_shim_gt_pack16(const bcf_fmt_t *fmt, int n_samples, uint16_t *codes,
+                        uint64_t *phased, uint64_t *missing);
+
+/// Summarize 2-bit slots. Diploid sites are counted 16 samples per 64-bit word with
+/// bitwise lane tests and popcounts. `allele_counts` receives the REF and ALT counts.
+void hts_shim_gt_summary2(const uint64_t *words, int n_samples, int ploidy,
+                          const uint64_t *missing, hts_shim_gt_summary_t *out,
+                          int64_t *allele_counts);
+
+/// Summarize 8-bit slots. `allele_counts` has `n_alleles` entries and is added to.
+void hts_shim_gt_summary8(const uint8_t *codes, int n_samples, int ploidy, int n_alleles,
+                          const uint64_t *missing, hts_shim_gt_summary_t *out,
+                          int64_t *allele_counts);
+
+/// Summarize 16-bit slots. `allele_counts` has `n_alleles` entries and is added to.
+void hts_shim_gt_summary16(const uint16_t *codes, int n_samples, int ploidy, int n_alleles,
+                           const uint64_t *missing, hts_shim_gt_summary_t *out,
+                           int64_t *allele_counts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTSLIB_GENOTYPE_KERNELS_H */
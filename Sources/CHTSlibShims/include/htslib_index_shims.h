@@ -26,6 +26,13 @@ int hts_shim_hts_reg2bin(hts_pos_t beg, hts_pos_t end, int min_shift, int n_lvls
 /// Compute the level of a given bin.
 int hts_shim_hts_bin_level(int bin);
 
+/// Smallest virtual offset of the chunks overlapping each of `n_windows` consecutive
+/// windows of `window` bases on `tid`, resolved through the bins and linear index.
+/// The last window runs to `HTS_POS_MAX`. Windows with no chunk get UINT64_MAX.
+/// Returns 0 on success or -1 if an iterator cannot be created.
+int hts_shim_idx_window_offsets(const hts_idx_t *idx, int tid, hts_pos_t window,
+                                int64_t n_windows, uint64_t *offsets);
+
 // ---------------------------------------------------------------------------
 // Endianness detection and byte swapping
 // ---------------------------------------------------------------------------
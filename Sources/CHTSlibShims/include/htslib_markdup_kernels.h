@@ -0,0 +1,50 @@
+/*
+ * htslib_markdup_kernels.h
+ *
+ * Per-record key extraction for duplicate marking. One call computes every
+ * field the duplicate marker keys on: unclipped 5' positions of the read and
+ * (from the MC tag) its mate, orientations, a hash of the read name and read
+ * group, the Picard-style base-quality score and the flowcell tile/x/y used
+ * for optical-duplicate detection.
+ *
+ * All kernel functions use the hts_shim_ prefix.
+ */
+
+#ifndef HTSLIB_MARKDUP_KERNELS_H
+#define HTSLIB_MARKDUP_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <htslib/sam.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Duplicate-marking keys for one record, filled by hts_shim_dup_info().
+typedef struct {
+    int64_t pos;            ///< Unclipped 5' position of the read.
+    int64_t mate_pos;       ///< Unclipped 5' position of the mate (MC tag), else its leftmost position.
+    uint64_t qname_hash;    ///< FNV-1a hash of the read name.
+    uint64_t rg_hash;       ///< FNV-1a hash of the RG tag value, or 0 without one.
+    int32_t tid;
+    int32_t mate_tid;
+    int32_t score;          ///< Sum of base qualities >= 15, plus the ms tag when present.
+    int32_t tile;           ///< Flowcell tile parsed from the read name, or -1.
+    int32_t x, y;           ///< Flowcell coordinates parsed from the read name.
+    uint8_t reverse;
+    uint8_t mate_reverse;
+    uint8_t has_mate_cigar; ///< 1 if mate_pos came from the MC tag.
+} hts_shim_dup_info_t;
+
+/// Fill info for b. Returns 0, or -1 if the record has no usable alignment.
+int hts_shim_dup_info(const bam1_t *b, hts_shim_dup_info_t *info);
+
+/// 64-bit FNV-1a hash of n bytes.
+uint64_t hts_shim_hash_bytes(const void *data, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTSLIB_MARKDUP_KERNELS_H */
@@ -0,0 +1,54 @@
+/*
+ * htslib_pileup_kernels.h
+ *
+ * Columnar (struct-of-arrays) decoding of a pileup column. One call walks
+ * the bam_pileup1_t array returned by bam_plp64_auto()/bam_mplp64_auto()
+ * and writes every per-read field plus the column's base/strand counts into
+ * caller-owned buffers, replacing several shim calls per read.
+ *
+ * All kernel functions use the hts_shim_ prefix.
+ */
+
+#ifndef HTSLIB_PILEUP_KERNELS_H
+#define HTSLIB_PILEUP_KERNELS_H
+
+#include <stdint.h>
+#include <htslib/sam.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Per-entry state bits written to hts_shim_pileup_columns_t.state.
+enum {
+    HTS_SHIM_PLP_DEL     = 1,  ///< Deletion at this position.
+    HTS_SHIM_PLP_REFSKIP = 2,  ///< Reference skip (N) at this position.
+    HTS_SHIM_PLP_HEAD    = 4,  ///< First base of the read.
+    HTS_SHIM_PLP_TAIL    = 8,  ///< Last base of the read.
+};
+
+/// Number of count slots: (A, C, G, T, N, deletion) x (forward, reverse).
+#define HTS_SHIM_PLP_NCOUNTS 12
+
+/// Destination buffers for hts_shim_pileup_fill(); each holds at least n entries.
+typedef struct {
+    uint8_t *bases;     ///< 4-bit nt16 base code (0 for deletions and ref skips).
+    uint8_t *quals;     ///< Base quality (0 for deletions and ref skips).
+    uint16_t *flags;    ///< Alignment FLAG.
+    uint8_t *mapq;      ///< Mapping quality.
+    uint8_t *strand;    ///< 1 if the read is reverse-strand, else 0.
+    int32_t *qpos;      ///< Position in the query sequence.
+    int32_t *indel;     ///< Indel length following this position (+ins, -del).
+    uint8_t *state;     ///< HTS_SHIM_PLP_* bits.
+    int32_t *counts;    ///< HTS_SHIM_PLP_NCOUNTS slots, index category * 2 + strand.
+} hts_shim_pileup_columns_t;
+
+/// Decode n pileup entries into columnar buffers and tally base/strand counts.
+/// Ref skips are not counted. counts is overwritten, not accumulated.
+void hts_shim_pileup_fill(const bam_pileup1_t *plp, int n, const hts_shim_pileup_columns_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTSLIB_PILEUP_KERNELS_H */
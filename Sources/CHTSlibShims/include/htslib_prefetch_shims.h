@@ -0,0 +1,47 @@
+/*
+ * htslib_prefetch_shims.h
+ *
+ * Read-ahead alignment decoding on an htslib thread pool. A prefetcher owns
+ * a ring of record batches for one file; a decoding job on the pool fills
+ * free batches in order with sam_read1() while the consumer drains ready
+ * ones. At most one job per prefetcher runs at a time, so the file handle
+ * is never read concurrently, and the ring bounds memory per file.
+ *
+ * All wrapper functions use the hts_shim_ prefix.
+ */
+
+#ifndef HTSLIB_PREFETCH_SHIMS_H
+#define HTSLIB_PREFETCH_SHIMS_H
+
+#include <htslib/hts.h>
+#include <htslib/sam.h>
+#include <htslib/thread_pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hts_shim_prefetch hts_shim_prefetch_t;
+
+/// Create a prefetcher reading fp/hdr on pool with n_batches of batch_size records.
+/// fp must not be read by anyone else while the prefetcher exists. The pool must not
+/// also be used for fp's BGZF decompression, or jobs may wait on each other.
+/// Returns NULL on allocation failure.
+hts_shim_prefetch_t *hts_shim_prefetch_init(htsFile *fp, sam_hdr_t *hdr, hts_tpool *pool,
+                                            int batch_size, int n_batches);
+
+/// Move the next record into b (by swapping buffers, not copying).
+/// Returns 0 on success, -1 at end of file, < -1 on a read error.
+int hts_shim_prefetch_read(hts_shim_prefetch_t *pf, bam1_t *b);
+
+/// Number of decoded records currently buffered ahead of the consumer.
+int hts_shim_prefetch_buffered(hts_shim_prefetch_t *pf);
+
+/// Stop decoding, wait for any running job, and free the prefetcher.
+void hts_shim_prefetch_destroy(hts_shim_prefetch_t *pf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTSLIB_PREFETCH_SHIMS_H */
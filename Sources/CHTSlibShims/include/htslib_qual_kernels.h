@@ -0,0 +1,48 @@
+/*
+ * htslib_qual_kernels.h
+ *
+ * Bulk kernels over raw BAM base-quality arrays (Phred values, not ASCII+33).
+ * Summaries are vectorized with SSE2 on x86 and NEON on AArch64, with a
+ * scalar fallback.
+ *
+ * All kernel functions use the hts_shim_ prefix.
+ */
+
+#ifndef HTSLIB_QUAL_KERNELS_H
+#define HTSLIB_QUAL_KERNELS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Summary of a quality array produced by hts_shim_qual_stats().
+typedef struct {
+    uint64_t sum;       ///< Sum of all quality values.
+    int64_t below;      ///< Number of values strictly below the threshold.
+    uint8_t min;        ///< Minimum quality (255 for an empty array).
+    uint8_t max;        ///< Maximum quality (0 for an empty array).
+} hts_shim_qual_stats_t;
+
+/// Compute sum, minimum, maximum and below-threshold count in one pass.
+void hts_shim_qual_stats(const uint8_t *qual, int64_t len, uint8_t threshold,
+                         hts_shim_qual_stats_t *out);
+
+/// Add each quality to `hist`, a 256-entry count array indexed by quality.
+void hts_shim_qual_histogram(const uint8_t *qual, int64_t len, uint64_t *hist);
+
+/// Replace every quality with `table[quality]` in place.
+void hts_shim_qual_bin(uint8_t *qual, int64_t len, const uint8_t *table);
+
+/// BWA-style 3' quality trimming. Returns the number of leading bases to keep.
+int64_t hts_shim_qual_trim3(const uint8_t *qual, int64_t len, int threshold);
+
+/// Mirror of hts_shim_qual_trim3() for the 5' end. Returns the number of bases to drop.
+int64_t hts_shim_qual_trim5(const uint8_t *qual, int64_t len, int threshold);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTSLIB_QUAL_KERNELS_H */
@@ -61,6 +61,10 @@ int hts_shim_sam_hdr_add_pg_3(sam_hdr_t *h, const char *name,
                               const char *k2, const char *v2,
                               const char *k3, const char *v3);
 
+/// Set the @HD SO field, adding an @HD line if the header has none.
+/// When ss is non-NULL the SS sub-sort field is set too; otherwise any SS is removed.
+int hts_shim_sam_hdr_set_sort_order(sam_hdr_t *h, const char *so, const char *ss);
+
 #ifdef __cplusplus
 }
 #endif
@@ -125,6 +125,18 @@ void hts_shim_bam_hdr_destroy(sam_hdr_t *h);
 /// Duplicate a SAM header (deprecated compatibility wrapper).
 sam_hdr_t *hts_shim_bam_hdr_dup(const sam_hdr_t *h0);
 
+// ---------------------------------------------------------------------------
+// Multi-region iterators
+// ---------------------------------------------------------------------------
+
+/// Build one multi-region iterator (hts_itr_multi) over n intervals.
+/// Intervals are 0-based half-open and must be sorted by (tid, beg); overlapping
+/// or abutting intervals on a contig are merged before the chunk list is built.
+/// Returns NULL on failure.
+hts_itr_t *hts_shim_sam_itr_intervals(const hts_idx_t *idx, sam_hdr_t *hdr,
+                                      const int *tids, const hts_pos_t *begs,
+                                      const hts_pos_t *ends, int n);
+
 #ifdef __cplusplus
 }
 #endif
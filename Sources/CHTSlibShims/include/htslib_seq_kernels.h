@@ -0,0 +1,34 @@
+/*
+ * htslib_seq_kernels.h
+ *
+ * Bulk kernels over the 4-bit packed BAM query sequence encoding.
+ * Vectorized with SSSE3 on x86 and NEON on AArch64, with a scalar fallback.
+ *
+ * All kernel functions use the hts_shim_ prefix.
+ */
+
+#ifndef HTSLIB_SEQ_KERNELS_H
+#define HTSLIB_SEQ_KERNELS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Decode `len` bases starting at base `start` of a packed sequence into ASCII.
+void hts_shim_seq_decode(const uint8_t *seq, int64_t start, int64_t len, uint8_t *out);
+
+/// Decode the reverse complement of `len` bases starting at base `start` into ASCII.
+/// `out[0]` receives the complement of base `start + len - 1`.
+void hts_shim_seq_decode_revcomp(const uint8_t *seq, int64_t start, int64_t len, uint8_t *out);
+
+/// Encode `len` ASCII bases into the 4-bit packed BAM encoding (two bases per byte).
+/// `out` must hold `(len + 1) / 2` bytes; an odd trailing low nibble is zeroed.
+void hts_shim_seq_encode(const uint8_t *ascii, int64_t len, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTSLIB_SEQ_KERNELS_H */
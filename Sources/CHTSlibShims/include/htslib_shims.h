@@ -12,5 +12,17 @@
 #include "htslib_tabix_shims.h"
 #include "htslib_index_shims.h"
 #include "htslib_cram_shims.h"
+#include "htslib_seq_kernels.h"
+#include "htslib_qual_kernels.h"
+#include "htslib_pileup_kernels.h"
+#include "htslib_prefetch_shims.h"
+#include "htslib_sort_kernels.h"
+#include "htslib_file_shims.h"
+#include "htslib_writer_shims.h"
+#include "htslib_markdup_kernels.h"
+#include "htslib_cache_shims.h"
+#include "htslib_genotype_kernels.h"
+#include "htslib_field_shims.h"
+#include "htslib_vcf_parse_shims.h"
 
 #endif /* HTSLIB_SHIMS_H */
@@ -0,0 +1,47 @@
+/*
+ * htslib_sort_kernels.h
+ *
+ * Record comparison and in-memory chunk sorting for BAMSorter. Orders match
+ * samtools sort: coordinate (tid, pos, strand; unmapped last), queryname
+ * (natural order of QNAME, then READ1/READ2, then secondary/supplementary),
+ * and tag (tag value, then coordinate). All sorts are stable with respect to
+ * input order, so equal records keep their original relative order.
+ *
+ * All kernel functions use the hts_shim_ prefix.
+ */
+
+#ifndef HTSLIB_SORT_KERNELS_H
+#define HTSLIB_SORT_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <htslib/sam.h>
+#include <htslib/thread_pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Sort orders accepted by the kernels.
+enum {
+    HTS_SHIM_SORT_COORDINATE = 0,
+    HTS_SHIM_SORT_QUERYNAME  = 1,
+    HTS_SHIM_SORT_TAG        = 2,
+};
+
+/// Compare two records under order (tag is the 2-character tag for HTS_SHIM_SORT_TAG).
+/// Returns < 0, 0 or > 0.
+int hts_shim_sort_compare(const bam1_t *a, const bam1_t *b, int order, const char *tag);
+
+/// Stable-sort recs[0..n) in place. The array is split into n_parts runs that are
+/// merge-sorted concurrently as jobs on pool (or on the caller when pool is NULL
+/// or n_parts <= 1), then merged pairwise. scratch must hold n pointers.
+/// Returns 0 on success, -1 if the pool rejects a job.
+int hts_shim_sort_records(bam1_t **recs, bam1_t **scratch, size_t n, int order,
+                          const char *tag, hts_tpool *pool, int n_parts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTSLIB_SORT_KERNELS_H */
@@ -0,0 +1,55 @@
+/*
+ * htslib_vcf_parse_shims.h
+ *
+ * Parallel VCF text parsing on an htslib thread pool. A reading job splits
+ * the decompressed stream into chunks of whole lines; each chunk is parsed
+ * into bcf1_t records by its own job on the pool. Chunks live in a ring that
+ * the consumer drains in file order, so the ring doubles as a bounded reorder
+ * buffer: parsing runs at most n_chunks chunks ahead of the consumer.
+ *
+ * vcf_parse() adds header records for contigs, FILTERs and INFO/FORMAT tags
+ * the header does not declare, and formats FORMAT values in the header's
+ * scratch buffer. Parse jobs therefore parse through a shallow header copy
+ * with their own scratch, and lines that would add header records are left
+ * to the consumer, which parses them in order while holding the header
+ * exclusively.
+ *
+ * All wrapper functions use the hts_shim_ prefix.
+ */
+
+#ifndef HTSLIB_VCF_PARSE_SHIMS_H
+#define HTSLIB_VCF_PARSE_SHIMS_H
+
+#include <htslib/hts.h>
+#include <htslib/vcf.h>
+#include <htslib/thread_pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hts_shim_vcf_parser hts_shim_vcf_parser_t;
+
+/// Create a parser for the VCF text body of fp, whose header hdr has already been read.
+/// fp must not be read by anyone else while the parser exists, and pool must not also
+/// be used for fp's BGZF decompression. Each record is bcf_unpack()ed with
+/// `unpack_flags` on the pool when non-zero. Returns NULL on allocation failure.
+hts_shim_vcf_parser_t *hts_shim_vcf_parser_init(htsFile *fp, bcf_hdr_t *hdr, hts_tpool *pool,
+                                                int chunk_lines, int n_chunks, int unpack_flags);
+
+/// Move the next record into v (by swapping buffers, not copying).
+/// Returns 0 on success, -1 at end of file, -2 on a read error, or -3 if a line
+/// failed to parse. Errors are sticky.
+int hts_shim_vcf_parser_read(hts_shim_vcf_parser_t *p, bcf1_t *v);
+
+/// Number of parsed records buffered ahead of the consumer.
+int hts_shim_vcf_parser_buffered(hts_shim_vcf_parser_t *p);
+
+/// Stop reading, wait for running jobs, and free the parser.
+void hts_shim_vcf_parser_destroy(hts_shim_vcf_parser_t *p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTSLIB_VCF_PARSE_SHIMS_H */
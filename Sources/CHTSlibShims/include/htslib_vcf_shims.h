@@ -22,6 +22,10 @@ extern "C" {
 /// Wraps: bcf_hdr_nsamples(hdr) -> (hdr)->n[BCF_DT_SAMPLE]
 int32_t hts_shim_bcf_hdr_nsamples(const bcf_hdr_t *hdr);
 
+/// Return the declared length of a contig, or -1 if it is absent or has no length.
+/// Reads: hdr->id[BCF_DT_CTG][bcf_hdr_name2id(hdr, name)].val->info[0]
+int64_t hts_shim_bcf_hdr_contig_length(const bcf_hdr_t *hdr, const char *name);
+
 /// Open a VCF/BCF file.
 /// Wraps: bcf_open(fn, mode) -> hts_open((fn), (mode))
 htsFile *hts_shim_bcf_open(const char *fn, const char *mode);
@@ -222,6 +226,12 @@ hts_itr_t *hts_shim_bcf_itr_querys(const hts_idx_t *idx, bcf_hdr_t *hdr, const c
 /// Wraps: bcf_itr_next(htsfp, itr, r)
 int hts_shim_bcf_itr_next(htsFile *htsfp, hts_itr_t *itr, bcf1_t *r);
 
+/// Drop the FORMAT data of samples excluded by bcf_hdr_set_samples from a BCF record.
+/// bcf_read does this itself; records from bcf_itr_next need it. A no-op without a
+/// sample subset. Returns 0 on success, negative on failure.
+/// Wraps: bcf_subset_format(hdr, rec)
+int hts_shim_bcf_subset_format(const bcf_hdr_t *hdr, bcf1_t *rec);
+
 /* ── Synced BCF reader macro/variadic wrappers ──────────────────────────── */
 
 /// Check if reader i has a line at current position.
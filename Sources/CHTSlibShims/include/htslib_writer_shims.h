@@ -0,0 +1,67 @@
+/*
+ * htslib_writer_shims.h
+ *
+ * Write-behind record output. A writer owns a ring of record batches for
+ * one output file; the producer copies records into free slots and a
+ * dedicated writer thread drains full batches in order with sam_write1()
+ * or bcf_write(). BGZF compression of the encoded blocks runs on whatever
+ * thread pool is attached to the file, so encoding, indexing and
+ * compression all overlap with the producer.
+ *
+ * The writer thread is a plain pthread rather than a pool job: it blocks on
+ * BGZF compression jobs queued on the same pool, which a pool job must not do.
+ *
+ * All wrapper functions use the hts_shim_ prefix.
+ */
+
+#ifndef HTSLIB_WRITER_SHIMS_H
+#define HTSLIB_WRITER_SHIMS_H
+
+#include <stdint.h>
+#include <htslib/hts.h>
+#include <htslib/sam.h>
+#include <htslib/vcf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Record kinds accepted by a writer.
+#define HTS_SHIM_WRITER_SAM 0
+#define HTS_SHIM_WRITER_BCF 1
+
+typedef struct hts_shim_writer hts_shim_writer_t;
+
+/// Create a writer for fp/hdr (a sam_hdr_t* or bcf_hdr_t* matching kind) with n_batches
+/// of batch_size records. With background == 0 no thread is started and each committed
+/// record is written immediately. The header must already be written.
+/// Returns NULL on allocation or thread-creation failure.
+hts_shim_writer_t *hts_shim_writer_init(htsFile *fp, void *hdr, int kind,
+                                        int batch_size, int n_batches, int background);
+
+/// The record (bam1_t* or bcf1_t*) to copy the next output record into, waiting for a
+/// free batch if all are queued. Returns NULL once a write has failed.
+void *hts_shim_writer_slot(hts_shim_writer_t *w);
+
+/// Queue the record in the current slot. Returns 0, or the first write error.
+int hts_shim_writer_commit(hts_shim_writer_t *w);
+
+/// Queue any partial batch and wait until every queued record is written.
+/// Returns 0, or the first write error.
+int hts_shim_writer_flush(hts_shim_writer_t *w);
+
+/// Number of records written to the file so far.
+int64_t hts_shim_writer_written(hts_shim_writer_t *w);
+
+/// Number of times the producer waited because every batch was queued.
+int64_t hts_shim_writer_stalls(hts_shim_writer_t *w);
+
+/// Flush, stop the writer thread and free the writer. Does not close fp.
+/// Returns 0, or the first write error.
+int hts_shim_writer_destroy(hts_shim_writer_t *w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTSLIB_WRITER_SHIMS_H */
@@ -42,6 +42,9 @@ public actor AsyncBAMReader {
     // Optional owned thread pool
     private nonisolated(unsafe) var ownedPool: OpaquePointer?  // hts_tpool*
 
+    // Cache entry owning `indexPointer` when the index came from an HTSResourceCache
+    private var sharedIndex: CachedIndex?
+
     // MARK: - Initialization
 
     /// Open a SAM/BAM/CRAM file for async reading.
@@ -119,9 +122,82 @@ public actor AsyncBAMReader {
         hts_set_thread_pool(fp, &tp)
     }
 
+    /// Open a SAM/BAM/CRAM file for async reading, sharing its header and index through a cache.
+    ///
+    /// For BAM the cached header is used and the file is positioned past its header without
+    /// parsing it; other formats read their header from the file as usual. The index is
+    /// shared for BAM (BAI/CSI); CRAM indexes are tied to their file handle and are loaded
+    /// per reader.
+    ///
+    /// - Parameters:
+    ///   - path: Path to the file.
+    ///   - cache: The cache to share the header and index through, e.g. ``HTSResourceCache/shared``.
+    ///   - loadIndex: If `true`, load the associated index (required for region queries).
+    ///   - threads: Number of threads for an owned pool, or 0 for none.
+    /// - Throws: `HTSError.openFailed` if the file cannot be opened,
+    ///           `HTSError.headerReadFailed` if the header cannot be read,
+    ///           `HTSError.indexLoadFailed` if `loadIndex` is true and the index is missing.
+    public init(path: String, cache: HTSResourceCache, loadIndex: Bool = false, threads: Int32 = 0) throws {
+        let cached = try cache.samHeaderEntry(for: path)
+        guard let fp = hts_open(path, "r") else {
+            throw HTSError.openFailed(path: path, mode: "r")
+        }
+        self.filePointer = fp
+        self.path = path
+
+        switch hts_shim_skip_header(fp, cached.recordOffset) {
+        case 0:
+            self.header = cached.header
+        case 1:
+            guard let hdr = sam_hdr_read(fp) else {
+                hts_close(fp)
+                throw HTSError.headerReadFailed
+            }
+            self.header = SAMHeader(pointer: hdr)
+        default:
+            hts_close(fp)
+            throw HTSError.seekFailed
+        }
+
+        self.record = bam_init1()
+
+        if loadIndex {
+            if HTSFileFormat(from: fp.pointee.format.format) == .cram {
+                guard let idx = sam_index_load(fp, path) else {
+                    bam_destroy1(self.record!)
+                    hts_close(fp)
+                    throw HTSError.indexLoadFailed(path: path)
+                }
+                self.indexPointer = idx
+            } else {
+                do {
+                    let shared = try cache.index(for: path, format: .auto)
+                    self.sharedIndex = shared
+                    self.indexPointer = shared.pointer
+                } catch {
+                    bam_destroy1(self.record!)
+                    hts_close(fp)
+                    throw error
+                }
+            }
+        }
+
+        if threads > 0 {
+            guard let pool = hts_tpool_init(threads) else {
+                if let idx = self.indexPointer, self.sharedIndex == nil { hts_idx_destroy(idx) }
+                bam_destroy1(self.record!)
+                hts_close(fp)
+                throw HTSError.outOfMemory
+            }
+            self.ownedPool = pool
+            var tp = htsThreadPool(pool: pool, qsize: 0)
+            hts_set_thread_pool(fp, &tp)
+        }
+    }
+
     deinit {
         if let iter = queryIterator { hts_itr_destroy(iter) }
-        if let idx = indexPointer { hts_idx_destroy(idx) }
+        if let idx = indexPointer, sharedIndex == nil { hts_idx_destroy(idx) }
         if let rec = record { bam_destroy1(rec) }
         if let pool = ownedPool { hts_tpool_destroy(pool) }
         hts_close(filePointer)
@@ -159,6 +235,61 @@ public actor AsyncBAMReader {
         }
     }
 
+    // MARK: - Batches
+
+    /// Reset `batch` and fill it with up to ``BAMRecordBatch/capacity`` records.
+    ///
+    /// Reads from the active region query if one was started, otherwise sequentially.
+    /// Filling a whole batch costs one actor hop instead of one per record.
+    ///
+    /// - Parameter batch: The batch to refill.
+    /// - Returns: The number of records read; 0 at end-of-file/region.
+    /// - Throws: `HTSError.readFailed` on I/O error.
+    @discardableResult
+    public func readBatch(into batch: BAMRecordBatch) throws -> Int {
+        batch.reset()
+        guard let rec = record else { return 0 }
+        while !exhausted, !batch.isFull {
+            let ret: Int32
+            if inQuery, let iter = queryIterator {
+                ret = hts_shim_sam_itr_next(filePointer, iter, rec)
+            } else {
+                ret = sam_read1(filePointer, header.pointer, rec)
+            }
+            if ret >= 0 {
+                batch.append(rec)
+            } else {
+                exhausted = true
+                if ret < -1 { throw HTSError.readFailed(code: ret) }
+            }
+        }
+        return batch.count
+    }
+
+    /// Iterate the remaining records as batches decoded ahead in the background.
+    ///
+    /// A producer task refills a ring of `prefetch` reusable batches and suspends once
+    /// all of them are waiting to be consumed. Each batch is valid until the next
+    /// iteration. Start a region query first to iterate only that region:
+    /// ```swift
+    /// try await reader.query(region: "chr1:1000-2000")
+    /// for try await batch in reader.batches(size: 4096) {
+    ///     for i in 0..<batch.count where batch.mappingQualities[i] >= 30 { ... }
+    /// }
+    /// ```
+    /// Don't call ``next()`` or change the query while the sequence is being iterated.
+    ///
+    /// - Parameters:
+    ///   - size: Records per batch.
+    ///   - prefetch: Number of batches in the ring.
+    /// - Returns: An `AsyncSequence` of ``BAMRecordBatch``.
+    public nonisolated func batches(size: Int = 4096, prefetch: Int = 4) -> AsyncBatchSequence<BAMRecordBatch> {
+        AsyncBatchSequence(
+            prefetch: prefetch,
+            makeBatch: { BAMRecordBatch(capacity: size) },
+            fill: { batch in try await self.readBatch(into: batch) })
+    }
+
     // MARK: - Region Queries
 
     /// Start a region query using a string like "chr1:1000-2000".
@@ -215,6 +346,38 @@ public actor AsyncBAMReader {
         self.exhausted = false
     }
 
+    /// Start one query over many regions, merged into a single chunk list.
+    ///
+    /// Records overlapping several regions are returned once. Requires that the reader
+    /// was opened with `loadIndex: true`.
+    ///
+    /// - Parameter regions: Region strings (e.g. `"chr1:1000-2000"`).
+    /// - Throws: `HTSError.invalidArgument` if no index is loaded or `regions` is empty,
+    ///           `HTSError.regionParseFailed` if a region cannot be parsed.
+    public func query(regions: [String]) throws {
+        try startMultiRegionQuery(QueryInterval.resolve(regions, header: header))
+    }
+
+    /// Start one query over the BED `regions`, merged into a single chunk list.
+    ///
+    /// - Parameter regions: BED intervals, for example from ``BEDRegion/read(path:)``.
+    /// - Throws: `HTSError.invalidArgument` if no index is loaded or `regions` is empty,
+    ///           `HTSError.regionParseFailed` if a contig is missing from the header.
+    public func query(regions: [BEDRegion]) throws {
+        try startMultiRegionQuery(QueryInterval.resolve(regions, header: header))
+    }
+
+    private func startMultiRegionQuery(_ intervals: [QueryInterval]) throws {
+        guard let idx = indexPointer else {
+            throw HTSError.invalidArgument(message: "No index loaded; open with loadIndex: true")
+        }
+        let iter = try makeMultiRegionIterator(index: idx, header: header, intervals: intervals)
+        if let old = queryIterator { hts_itr_destroy(old) }
+        self.queryIterator = iter
+        self.inQuery = true
+        self.exhausted = false
+    }
+
     /// Reset the reader to sequential mode, abandoning any active region query.
     public func resetQuery() {
         if let iter = queryIterator {
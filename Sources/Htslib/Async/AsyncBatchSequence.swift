@@ -0,0 +1,206 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+// MARK: - BatchRing
+
+/// A bounded single-producer, single-consumer handoff of reusable batches.
+///
+/// All batches start on the free list. The producer takes a free batch, fills it and
+/// publishes it; the consumer receives filled batches in order and recycles each one
+/// once it is done with it. With every batch in flight the producer suspends in
+/// ``acquire()``, so the consumer's pace bounds how far decoding runs ahead.
+actor BatchRing<Batch: AnyObject & Sendable> {
+    private var free: [Batch]
+    private var filled: [Batch] = []
+    private var finished = false
+    private var failure: (any Error)?
+    private var closed = false
+    private var producerWaiter: CheckedContinuation<Batch?, Never>?
+    private var consumerWaiter: CheckedContinuation<Batch?, any Error>?
+
+    init(batches: [Batch]) {
+        free = batches
+    }
+
+    /// Take a free batch to fill, suspending until one is recycled.
+    ///
+    /// - Returns: A batch, or `nil` once the ring is closed.
+    func acquire() async -> Batch? {
+        if closed { return nil }
+        if !free.isEmpty { return free.removeFirst() }
+        return await withCheckedContinuation { producerWaiter = $0 }
+    }
+
+    /// Hand a filled batch to the consumer.
+    func publish(_ batch: Batch) {
+        if let waiter = consumerWaiter {
+            consumerWaiter = nil
+            waiter.resume(returning: batch)
+        } else {
+            filled.append(batch)
+        }
+    }
+
+    /// Mark the end of input, optionally with the error that stopped the producer.
+    func finish(throwing error: (any Error)? = nil) {
+        finished = true
+        failure = error
+        if let waiter = consumerWaiter {
+            consumerWaiter = nil
+            resumeFinished(waiter)
+        }
+    }
+
+    /// Receive the next filled batch, suspending until the producer publishes one.
+    ///
+    /// - Returns: The next batch, or `nil` at the end of input or once the ring is closed.
+    /// - Throws: The producer's error, once, after all earlier batches were received.
+    func receive() async throws -> Batch? {
+        if !filled.isEmpty { return filled.removeFirst() }
+        if closed { return nil }
+        if finished {
+            let error = failure
+            failure = nil
+            if let error { throw error }
+            return nil
+        }
+        return try await withCheckedThrowingContinuation { consumerWaiter = $0 }
+    }
+
+    /// Return a consumed batch to the free list.
+    func recycle(_ batch: Batch) {
+        if let waiter = producerWaiter {
+            producerWaiter = nil
+            waiter.resume(returning: batch)
+        } else {
+            free.append(batch)
+        }
+    }
+
+    /// Stop both sides: pending and future calls return `nil`.
+    func close() {
+        closed = true
+        filled.removeAll()
+        producerWaiter?.resume(returning: nil)
+        producerWaiter = nil
+        consumerWaiter?.resume(returning: nil)
+        consumerWaiter = nil
+    }
+
+    private func resumeFinished(_ waiter: CheckedContinuation<Batch?, any Error>) {
+        let error = failure
+        failure = nil
+        if let error {
+            waiter.resume(throwing: error)
+        } else {
+            waiter.resume(returning: nil)
+        }
+    }
+}
+
+// MARK: - AsyncBatchSequence
+
+/// An `AsyncSequence` of record batches decoded ahead by a background producer.
+///
+/// Returned by ``AsyncBAMReader/batches(size:prefetch:)`` and
+/// ``AsyncVCFReader/batches(size:prefetch:)``. A producer task refills a fixed ring of
+/// `prefetch` batches with one actor hop per batch rather than per record, and suspends
+/// when every batch is waiting to be consumed.
+///
+/// Each batch is only valid until the next iteration, when it is recycled for refilling.
+/// Cancelling the consuming task, or dropping the iterator, cancels the producer.
+public struct AsyncBatchSequence<Batch: AnyObject & Sendable>: AsyncSequence, Sendable {
+    public typealias Element = Batch
+
+    private let prefetch: Int
+    private let makeBatch: @Sendable () throws -> Batch
+    private let fill: @Sendable (Batch) async throws -> Int
+
+    internal init(prefetch: Int,
+                  makeBatch: @escaping @Sendable () throws -> Batch,
+                  fill: @escaping @Sendable (Batch) async throws -> Int) {
+        self.prefetch = max(prefetch, 1)
+        self.makeBatch = makeBatch
+        self.fill = fill
+    }
+
+    public func makeAsyncIterator() -> AsyncIterator {
+        AsyncIterator(storage: Storage(prefetch: prefetch, makeBatch: makeBatch, fill: fill))
+    }
+
+    /// Iterates filled batches, recycling each one when the next is requested.
+    public struct AsyncIterator: AsyncIteratorProtocol {
+        fileprivate let storage: Storage
+
+        public mutating func next() async throws -> Batch? {
+            try await storage.next()
+        }
+    }
+
+    /// Owns the ring and producer task; cancels the producer when the iterator is dropped.
+    fileprivate final class Storage: @unchecked Sendable {
+        private let ring: BatchRing<Batch>
+        private let fill: @Sendable (Batch) async throws -> Int
+        private var producer: Task<Void, Never>?
+        private var current: Batch?
+        // Thrown by the first next() if the ring's batches could not be allocated
+        private let setupError: Error?
+
+        init(prefetch: Int, makeBatch: @Sendable () throws -> Batch,
+             fill: @escaping @Sendable (Batch) async throws -> Int) {
+            do {
+                ring = BatchRing(batches: try (0..<prefetch).map { _ in try makeBatch() })
+                setupError = nil
+            } catch {
+                ring = BatchRing(batches: [])
+                setupError = error
+            }
+            self.fill = fill
+        }
+
+        deinit {
+            producer?.cancel()
+            let ring = self.ring
+            Task { await ring.close() }
+        }
+
+        func next() async throws -> Batch? {
+            if let setupError { throw setupError }
+            if producer == nil { startProducer() }
+            if let batch = current {
+                current = nil
+                await ring.recycle(batch)
+            }
+            let ring = self.ring
+            let producer = self.producer
+            let batch = try await withTaskCancellationHandler {
+                try await ring.receive()
+            } onCancel: {
+                producer?.cancel()
+                Task { await ring.close() }
+            }
+            current = batch
+            return batch
+        }
+
+        private func startProducer() {
+            let ring = self.ring
+            let fill = self.fill
+            producer = Task {
+                do {
+                    while !Task.isCancelled, let batch = await ring.acquire() {
+                        let n = try await fill(batch)
+                        if n == 0 {
+                            await ring.recycle(batch)
+                            break
+                        }
+                        await ring.publish(batch)
+                    }
+                    await ring.finish()
+                } catch {
+                    await ring.finish(throwing: error)
+                }
+            }
+        }
+    }
+}
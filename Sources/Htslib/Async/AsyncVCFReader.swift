@@ -17,6 +17,8 @@ import CHTSlibShims
 /// // Region query
 /// try await reader.query(region: "chr1:1000-2000")
 /// while let record = try await reader.next() { ... }
+/// // Sites only: skip per-sample data entirely
+/// let sites = try AsyncVCFReader(path: "cohort.bcf", fields: VCFFieldSelection(alleles: true, info: ["AF"]))
 /// ```
 public actor AsyncVCFReader {
 
@@ -34,6 +36,9 @@ public actor AsyncVCFReader {
     private nonisolated(unsafe) var record: UnsafeMutablePointer<bcf1_t>?
     private var exhausted: Bool = false
 
+    // bcf_unpack flags applied to each record read; 0 leaves records packed
+    private let unpackFlags: Int32
+
     // Optional index for region queries
     private nonisolated(unsafe) var indexPointer: OpaquePointer?  // hts_idx_t*
     private nonisolated(unsafe) var queryIterator: UnsafeMutablePointer<hts_itr_t>?
@@ -42,6 +47,9 @@ public actor AsyncVCFReader {
     // Optional owned thread pool
     private nonisolated(unsafe) var ownedPool: OpaquePointer?  // hts_tpool*
 
+    // Cache entry owning `indexPointer` when the index came from an HTSResourceCache
+    private var sharedIndex: CachedIndex?
+
     // MARK: - Initialization
 
     /// Open a VCF/BCF file for async reading.
@@ -49,10 +57,13 @@ public actor AsyncVCFReader {
     /// - Parameters:
     ///   - path: Path to the file.
     ///   - loadIndex: If `true`, load the associated index (required for region queries).
+    ///   - fields: If set, decode only these fields; records are returned unpacked to the
+    ///     levels they need and ``header``'s samples are subset. See ``VCFFieldSelection``.
     /// - Throws: `HTSError.openFailed` if the file cannot be opened,
     ///           `HTSError.headerReadFailed` if the header cannot be read,
+    ///           `HTSError.tagNotFound` if a selected key is not in the header,
     ///           `HTSError.indexLoadFailed` if `loadIndex` is true and the index is missing.
-    public init(path: String, loadIndex: Bool = false) throws {
+    public init(path: String, loadIndex: Bool = false, fields: VCFFieldSelection? = nil) throws {
         guard let fp = hts_open(path, "r") else {
             throw HTSError.openFailed(path: path, mode: "r")
         }
@@ -64,6 +75,13 @@ public actor AsyncVCFReader {
             throw HTSError.headerReadFailed
         }
         self.header = VCFHeader(pointer: hdr)
+        do {
+            try fields?.apply(to: hdr, strict: true)
+        } catch {
+            hts_close(fp)
+            throw error
+        }
+        self.unpackFlags = fields?.unpackFlags ?? 0
 
         self.record = bcf_init()
 
@@ -82,8 +100,9 @@ public actor AsyncVCFReader {
     /// - Parameters:
     ///   - path: Path to the file.
     ///   - loadIndex: If `true`, load the associated index.
+    ///   - fields: If set, decode only these fields. See ``VCFFieldSelection``.
     ///   - threads: Number of threads for the owned pool.
-    public init(path: String, loadIndex: Bool = false, threads: Int32) throws {
+    public init(path: String, loadIndex: Bool = false, fields: VCFFieldSelection? = nil, threads: Int32) throws {
         guard let fp = hts_open(path, "r") else {
             throw HTSError.openFailed(path: path, mode: "r")
         }
@@ -95,6 +114,13 @@ public actor AsyncVCFReader {
             throw HTSError.headerReadFailed
         }
         self.header = VCFHeader(pointer: hdr)
+        do {
+            try fields?.apply(to: hdr, strict: true)
+        } catch {
+            hts_close(fp)
+            throw error
+        }
+        self.unpackFlags = fields?.unpackFlags ?? 0
 
         self.record = bcf_init()
 
@@ -119,9 +145,71 @@ public actor AsyncVCFReader {
         hts_set_thread_pool(fp, &tp)
     }
 
+    /// Open a VCF/BCF file for async reading, sharing its header and index through a cache.
+    ///
+    /// For BCF the cached header is used and the file is positioned past its header without
+    /// parsing it; VCF text reads its header from the file as usual. The index is shared.
+    ///
+    /// - Parameters:
+    ///   - path: Path to the file.
+    ///   - cache: The cache to share the header and index through, e.g. ``HTSResourceCache/shared``.
+    ///   - loadIndex: If `true`, load the associated index (required for region queries).
+    ///   - threads: Number of threads for an owned pool, or 0 for none.
+    /// - Throws: `HTSError.openFailed` if the file cannot be opened,
+    ///           `HTSError.headerReadFailed` if the header cannot be read,
+    ///           `HTSError.indexLoadFailed` if `loadIndex` is true and the index is missing.
+    public init(path: String, cache: HTSResourceCache, loadIndex: Bool = false, threads: Int32 = 0) throws {
+        let cached = try cache.vcfHeaderEntry(for: path)
+        guard let fp = hts_open(path, "r") else {
+            throw HTSError.openFailed(path: path, mode: "r")
+        }
+        self.filePointer = fp
+        self.path = path
+
+        switch hts_shim_skip_header(fp, cached.recordOffset) {
+        case 0:
+            self.header = cached.header
+        case 1:
+            guard let hdr = bcf_hdr_read(fp) else {
+                hts_close(fp)
+                throw HTSError.headerReadFailed
+            }
+            self.header = VCFHeader(pointer: hdr)
+        default:
+            hts_close(fp)
+            throw HTSError.seekFailed
+        }
+        self.unpackFlags = 0
+
+        self.record = bcf_init()
+
+        if loadIndex {
+            do {
+                let shared = try cache.index(for: path, format: .auto)
+                self.sharedIndex = shared
+                self.indexPointer = shared.pointer
+            } catch {
+                bcf_destroy(self.record!)
+                hts_close(fp)
+                throw error
+            }
+        }
+
+        if threads > 0 {
+            guard let pool = hts_tpool_init(threads) else {
+                bcf_destroy(self.record!)
+                hts_close(fp)
+                throw HTSError.outOfMemory
+            }
+            self.ownedPool = pool
+            var tp = htsThreadPool(pool: pool, qsize: 0)
+            hts_set_thread_pool(fp, &tp)
+        }
+    }
+
     deinit {
         if let iter = queryIterator { hts_itr_destroy(iter) }
-        if let idx = indexPointer { hts_idx_destroy(idx) }
+        if let idx = indexPointer, sharedIndex == nil { hts_idx_destroy(idx) }
         if let rec = record { bcf_destroy(rec) }
         if let pool = ownedPool { hts_tpool_destroy(pool) }
         hts_close(filePointer)
@@ -141,12 +229,16 @@ public actor AsyncVCFReader {
 
         let ret: Int32
         if inQuery, let iter = queryIterator {
-            ret = hts_shim_bcf_itr_next(filePointer, iter, rec)
+            ret = readQueried(iter, into: rec)
         } else {
             ret = bcf_read(filePointer, header.pointer, rec)
         }
 
         if ret >= 0 {
+            if unpackFlags != 0, bcf_unpack(rec, unpackFlags) < 0 {
+                exhausted = true
+                throw HTSError.readFailed(code: -2)
+            }
             let result = rec
             self.record = bcf_init()
             return VCFRecord(pointer: result)
@@ -159,6 +251,74 @@ public actor AsyncVCFReader {
         }
     }
 
+    /// Read the next record of a region query, subset to the header's samples.
+    ///
+    /// Unlike `bcf_read`, `bcf_itr_next` returns every sample's FORMAT data.
+    private func readQueried(_ iter: UnsafeMutablePointer<hts_itr_t>, into rec: UnsafeMutablePointer<bcf1_t>) -> Int32 {
+        let ret = hts_shim_bcf_itr_next(filePointer, iter, rec)
+        guard ret >= 0 else { return ret }
+        return hts_shim_bcf_subset_format(header.pointer, rec) < 0 ? -2 : ret
+    }
+
+    // MARK: - Batches
+
+    /// Reset `batch` and fill it with up to ``VCFRecordBatch/capacity`` records.
+    ///
+    /// Reads from the active region query if one was started, otherwise sequentially.
+    /// Filling a whole batch costs one actor hop instead of one per record.
+    ///
+    /// - Parameter batch: The batch to refill.
+    /// - Returns: The number of records read; 0 at end-of-file/region.
+    /// - Throws: `HTSError.readFailed` on I/O error.
+    @discardableResult
+    public func readBatch(into batch: VCFRecordBatch) throws -> Int {
+        batch.reset()
+        while !exhausted, !batch.isFull {
+            let slot = batch.nextSlot
+            let ret: Int32
+            if inQuery, let iter = queryIterator {
+                ret = readQueried(iter, into: slot)
+            } else {
+                ret = bcf_read(filePointer, header.pointer, slot)
+            }
+            if ret >= 0 {
+                if unpackFlags != 0, bcf_unpack(slot, unpackFlags) < 0 {
+                    exhausted = true
+                    throw HTSError.readFailed(code: -2)
+                }
+                batch.commit()
+            } else {
+                exhausted = true
+                if ret < -1 { throw HTSError.readFailed(code: ret) }
+            }
+        }
+        return batch.count
+    }
+
+    /// Iterate the remaining records as batches decoded ahead in the background.
+    ///
+    /// A producer task refills a ring of `prefetch` reusable batches and suspends once
+    /// all of them are waiting to be consumed. Each batch is valid until the next
+    /// iteration. Start a region query first to iterate only that region:
+    /// ```swift
+    /// try await reader.query(region: "chr1:1000-2000")
+    /// for try await batch in reader.batches(size: 1024) {
+    ///     for i in 0..<batch.count { print(batch[i].position) }
+    /// }
+    /// ```
+    /// Don't call ``next()`` or change the query while the sequence is being iterated.
+    ///
+    /// - Parameters:
+    ///   - size: Records per batch.
+    ///   - prefetch: Number of batches in the ring.
+    /// - Returns: An `AsyncSequence` of ``VCFRecordBatch``.
+    public nonisolated func batches(size: Int = 1024, prefetch: Int = 4) -> AsyncBatchSequence<VCFRecordBatch> {
+        AsyncBatchSequence(
+            prefetch: prefetch,
+            makeBatch: { try VCFRecordBatch(capacity: size) },
+            fill: { batch in try await self.readBatch(into: batch) })
+    }
+
     // MARK: - Region Queries
 
     /// Start a region query using a string like "chr1:1000-2000".
@@ -241,11 +241,29 @@ public struct HTSFile: ~Copyable, @unchecked Sendable {
         VCFRecordIterator(file: pointer, header: header.pointer)
     }
 
+    /// Create a sequential iterator that decodes only the fields in `fields`.
+    ///
+    /// Records are returned unpacked to the levels the selection needs, and per-sample
+    /// data is subset on `header` before anything is read. Call this before reading any
+    /// record from the file.
+    ///
+    /// - Parameters:
+    ///   - header: The ``VCFHeader`` obtained from ``vcfHeader()``; its samples may be subset.
+    ///   - fields: The fields to decode.
+    /// - Returns: A ``VCFRecordIterator`` yielding all records.
+    /// - Throws: ``HTSError/tagNotFound(tag:)`` if a selected key is not in the header,
+    ///   ``HTSError/invalidArgument(message:)`` if a selected sample is not.
+    public func vcfIterator(header: VCFHeader, fields: VCFFieldSelection) throws -> VCFRecordIterator {
+        try fields.apply(to: header.pointer, strict: true)
+        return VCFRecordIterator(file: pointer, header: header.pointer, unpackFlags: fields.unpackFlags)
+    }
+
     deinit {
         hts_close(pointer)
     }
 
-    // Internal access for other types
-    @usableFromInline
-    var rawPointer: UnsafeMutablePointer<htsFile> { pointer }
+    /// The underlying `htsFile` pointer, for APIs such as ``PileupIterator`` that take raw handles.
+    ///
+    /// The pointer is owned by this handle and is only valid while it is alive.
+    public var rawPointer: UnsafeMutablePointer<htsFile> { pointer }
 }
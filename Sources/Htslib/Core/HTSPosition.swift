@@ -0,0 +1,7 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+/// Largest representable position, mirroring htslib's `HTS_POS_MAX`.
+///
+/// Used as the open end of whole-contig queries and of a contig's last window.
+let htsPosMax: Int64 = 0x7fff_ffff_7fff_ffff
@@ -0,0 +1,341 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - HTSResourceCache
+
+/// A thread-safe cache of parsed indexes and headers, shared by every reader of a file.
+///
+/// Opening the same indexed file from many places normally loads and parses its index and
+/// header each time. Through a cache, the first open loads them and later opens share the
+/// same read-only `hts_idx_t`, `sam_hdr_t` or `bcf_hdr_t`:
+///
+/// ```swift
+/// let cache = HTSResourceCache.shared
+/// let reader = try AsyncBAMReader(path: "sample.bam", cache: cache, loadIndex: true)
+/// let index = try HTSIndex(path: "sample.bam", cache: cache)
+/// print(cache.statistics.hits, cache.statistics.misses)
+/// ```
+///
+/// Entries are keyed by path and the file's modification time and size, so a rewritten
+/// file is reloaded. Concurrent first requests for one entry load it once; the others wait
+/// for that load. Shared instances are reference counted: they stay alive while any reader
+/// holds them, whether or not the cache still does.
+///
+/// The cache keeps its estimated size under ``byteBudget`` by evicting the least recently
+/// used entries that no reader currently holds. If every entry is in use, the cache can
+/// exceed its budget until readers release them.
+///
+/// Cached headers are shared: don't modify a header obtained from a cache.
+public final class HTSResourceCache: @unchecked Sendable {
+    /// A process-wide cache with a 256 MiB budget.
+    ///
+    /// Its lock is statically allocated, so creating it cannot fail.
+    public static let shared = HTSResourceCache(lock: hts_shim_lock_static(), ownsLock: false, byteBudget: 256 << 20)
+
+    /// Counters since the cache was created.
+    public struct Statistics: Sendable {
+        /// Requests served from the cache.
+        public internal(set) var hits = 0
+        /// Requests that loaded from disk.
+        public internal(set) var misses = 0
+        /// Entries dropped to stay within the byte budget.
+        public internal(set) var evictions = 0
+        /// Entries dropped because their file changed.
+        public internal(set) var invalidations = 0
+        /// Entries currently cached.
+        public internal(set) var entries = 0
+        /// Cached entries currently held by at least one reader.
+        public internal(set) var entriesInUse = 0
+        /// Estimated bytes of cached entries.
+        public internal(set) var bytes = 0
+        /// The budget at the time the statistics were taken.
+        public internal(set) var byteBudget = 0
+    }
+
+    private enum Kind: Hashable {
+        case index(Int32)
+        case samHeader
+        case vcfHeader
+    }
+
+    private struct Key: Hashable {
+        let path: String
+        let kind: Kind
+    }
+
+    private struct Identity: Equatable {
+        let modified: Int64
+        let size: Int64
+    }
+
+    /// One cached object. `load` serializes the first load so concurrent requests share it,
+    /// and guards `object`. It may be taken while holding the cache's lock, never the reverse.
+    private final class Entry {
+        let identity: Identity
+        let load: OpaquePointer  // hts_shim_lock_t*
+        var object: AnyObject?
+        var bytes = 0
+        // Where records begin in a BAM or BCF, so a reader can skip the header; -1 otherwise.
+        var recordOffset: Int64 = -1
+        var lastUse = 0
+        var accounted = false
+
+        init(identity: Identity) throws {
+            guard let lock = hts_shim_lock_create() else { throw HTSError.outOfMemory }
+            self.identity = identity
+            load = lock
+        }
+
+        deinit {
+            hts_shim_lock_destroy(load)
+        }
+    }
+
+    private let lock: OpaquePointer  // hts_shim_lock_t*
+    private let ownsLock: Bool
+    private var entries: [Key: Entry] = [:]
+    private var counters = Statistics()
+    private var budget: Int
+    private var tick = 0
+
+    /// Create an empty cache.
+    ///
+    /// - Parameter byteBudget: The estimated size the cache keeps its entries within.
+    /// - Throws: ``HTSError/outOfMemory`` if the cache's lock cannot be created.
+    public convenience init(byteBudget: Int = 256 << 20) throws {
+        guard let lock = hts_shim_lock_create() else { throw HTSError.outOfMemory }
+        self.init(lock: lock, ownsLock: true, byteBudget: byteBudget)
+    }
+
+    private init(lock: OpaquePointer, ownsLock: Bool, byteBudget: Int) {
+        self.lock = lock
+        self.ownsLock = ownsLock
+        budget = byteBudget
+    }
+
+    deinit {
+        if ownsLock { hts_shim_lock_destroy(lock) }
+    }
+
+    /// The estimated size the cache keeps its entries within. Lowering it evicts at once.
+    public var byteBudget: Int {
+        get { locked { budget } }
+        set { locked { budget = newValue; evict() } }
+    }
+
+    /// A snapshot of the counters.
+    public var statistics: Statistics {
+        locked {
+            var snapshot = counters
+            snapshot.entries = entries.count
+            snapshot.entriesInUse = entries.values.reduce(0) { $0 + ($1.accounted && Self.isInUse($1) ? 1 : 0) }
+            snapshot.byteBudget = budget
+            return snapshot
+        }
+    }
+
+    /// Drop every entry for `path`. Readers holding its objects keep them.
+    ///
+    /// - Parameter path: The data file's path.
+    public func remove(path: String) {
+        locked {
+            for key in entries.keys where key.path == path {
+                drop(key)
+            }
+        }
+    }
+
+    /// Drop every entry. Readers holding cached objects keep them.
+    public func removeAll() {
+        locked {
+            for key in Array(entries.keys) { drop(key) }
+        }
+    }
+
+    // MARK: - Lookups
+
+    /// The shared SAM/BAM/CRAM header of `path`.
+    ///
+    /// - Parameter path: Path to the alignment file.
+    /// - Returns: The shared header; don't modify it.
+    /// - Throws: ``HTSError/openFailed(path:mode:)`` or ``HTSError/headerReadFailed``.
+    public func samHeader(for path: String) throws -> SAMHeader {
+        try samHeaderEntry(for: path).header
+    }
+
+    /// The shared VCF/BCF header of `path`.
+    ///
+    /// - Parameter path: Path to the variant file.
+    /// - Returns: The shared header; don't modify it.
+    /// - Throws: ``HTSError/openFailed(path:mode:)`` or ``HTSError/headerReadFailed``.
+    public func vcfHeader(for path: String) throws -> VCFHeader {
+        try vcfHeaderEntry(for: path).header
+    }
+
+    /// The shared index of `path`, loaded with `hts_idx_load3`.
+    func index(for path: String, format: HTSIndex.IndexFormat) throws -> CachedIndex {
+        let (_, object) = try lookup(Key(path: path, kind: .index(format.rawValue))) { entry in
+            guard let idx = path.withCString({ hts_idx_load3($0, nil, format.rawValue, 0) }) else {
+                throw HTSError.indexLoadFailed(path: path)
+            }
+            entry.object = CachedIndex(pointer: idx)
+            entry.bytes = Self.indexBytes(dataPath: path)
+        }
+        return object as! CachedIndex
+    }
+
+    /// The shared header of `path` and, for BAM, the offset of its first record.
+    func samHeaderEntry(for path: String) throws -> (header: SAMHeader, recordOffset: Int64) {
+        let (entry, object) = try lookup(Key(path: path, kind: .samHeader)) { entry in
+            guard let fp = hts_open(path, "r") else { throw HTSError.openFailed(path: path, mode: "r") }
+            defer { hts_close(fp) }
+            guard let hdr = sam_hdr_read(fp) else { throw HTSError.headerReadFailed }
+            // Parse the header records now; later lookups from many threads only read them.
+            _ = sam_hdr_count_lines(hdr, "SQ")
+            let header = SAMHeader(pointer: hdr)
+            entry.object = header
+            entry.recordOffset = hts_shim_header_end_offset(fp)
+            entry.bytes = 2 * max(header.length, 0) + 64 * Int(max(header.nTargets, 0))
+        }
+        return (object as! SAMHeader, entry.recordOffset)
+    }
+
+    /// The shared header of `path` and, for BCF, the offset of its first record.
+    func vcfHeaderEntry(for path: String) throws -> (header: VCFHeader, recordOffset: Int64) {
+        let (entry, object) = try lookup(Key(path: path, kind: .vcfHeader)) { entry in
+            guard let fp = hts_open(path, "r") else { throw HTSError.openFailed(path: path, mode: "r") }
+            defer { hts_close(fp) }
+            guard let hdr = bcf_hdr_read(fp) else { throw HTSError.headerReadFailed }
+            entry.object = VCFHeader(pointer: hdr)
+            entry.recordOffset = hts_shim_header_end_offset(fp)
+            entry.bytes = 3 * Int(max(hts_shim_bcf_hdr_text_length(hdr), 0))
+        }
+        return (object as! VCFHeader, entry.recordOffset)
+    }
+
+    /// Find or load the entry for `key`, loading at most once across concurrent callers.
+    ///
+    /// - Returns: The entry and its object, read under the entry's load lock.
+    private func lookup(_ key: Key, load: (Entry) throws -> Void) throws -> (Entry, AnyObject) {
+        var modified: Int64 = 0
+        var size: Int64 = 0
+        guard hts_shim_file_identity(key.path, &modified, &size) == 0 else {
+            throw HTSError.openFailed(path: key.path, mode: "r")
+        }
+        let identity = Identity(modified: modified, size: size)
+
+        let entry: Entry = try locked {
+            if let existing = entries[key] {
+                if existing.identity == identity {
+                    tick += 1
+                    existing.lastUse = tick
+                    return existing
+                }
+                drop(key)
+                counters.invalidations += 1
+            }
+            let created = try Entry(identity: identity)
+            tick += 1
+            created.lastUse = tick
+            entries[key] = created
+            return created
+        }
+
+        hts_shim_lock_acquire(entry.load)
+        let loaded = entry.object == nil
+        let object: AnyObject
+        do {
+            if loaded { try load(entry) }
+            object = entry.object!
+        } catch {
+            hts_shim_lock_release(entry.load)
+            locked {
+                if entries[key] === entry { entries[key] = nil }
+            }
+            throw error
+        }
+        hts_shim_lock_release(entry.load)
+
+        locked {
+            if loaded {
+                counters.misses += 1
+                if entries[key] === entry {
+                    entry.accounted = true
+                    counters.bytes += entry.bytes
+                    evict()
+                }
+            } else {
+                counters.hits += 1
+            }
+        }
+        return (entry, object)
+    }
+
+    // MARK: - Eviction
+
+    /// Drop least recently used entries no reader holds until within budget. Lock held.
+    private func evict() {
+        while counters.bytes > budget {
+            var victim: (key: Key, entry: Entry)?
+            for (key, entry) in entries where entry.accounted && !Self.isInUse(entry) {
+                if victim == nil || entry.lastUse < victim!.entry.lastUse { victim = (key, entry) }
+            }
+            guard let victim else { return }
+            drop(victim.key)
+            counters.evictions += 1
+        }
+    }
+
+    /// Remove an entry and its bytes. Lock held.
+    private func drop(_ key: Key) {
+        guard let entry = entries.removeValue(forKey: key) else { return }
+        if entry.accounted { counters.bytes -= entry.bytes }
+    }
+
+    /// Whether anything besides the cache holds a loaded entry's object. Lock held.
+    ///
+    /// Lookups read and retain the object under the entry's load lock, so the reference
+    /// count is checked under it too. The entry is loaded, so the lock is held only briefly.
+    private static func isInUse(_ entry: Entry) -> Bool {
+        hts_shim_lock_acquire(entry.load)
+        defer { hts_shim_lock_release(entry.load) }
+        return !isKnownUniquelyReferenced(&entry.object)
+    }
+
+    /// Estimated in-memory size of the index beside `dataPath`: BAI loads at about its file
+    /// size; CSI and TBI are BGZF-compressed and expand several times.
+    private static func indexBytes(dataPath: String) -> Int {
+        for (ext, factor) in [(".csi", 4), (".bai", 1), (".tbi", 4)] {
+            var modified: Int64 = 0
+            var size: Int64 = 0
+            if hts_shim_file_identity(dataPath + ext, &modified, &size) == 0 {
+                return Int(size) * factor
+            }
+        }
+        return 0
+    }
+
+    private func locked<T>(_ body: () throws -> T) rethrows -> T {
+        hts_shim_lock_acquire(lock)
+        defer { hts_shim_lock_release(lock) }
+        return try body()
+    }
+}
+
+// MARK: - CachedIndex
+
+/// An `hts_idx_t` shared through an ``HTSResourceCache``, destroyed with its last holder.
+final class CachedIndex: @unchecked Sendable {
+    let pointer: OpaquePointer  // hts_idx_t*
+
+    init(pointer: OpaquePointer) {
+        self.pointer = pointer
+    }
+
+    deinit {
+        hts_idx_destroy(pointer)
+    }
+}
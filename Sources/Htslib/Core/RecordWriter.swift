@@ -0,0 +1,215 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - WriterOptions
+
+/// Queueing and indexing settings shared by ``AlignmentWriter`` and ``VariantWriter``.
+public struct WriterOptions: Sendable {
+    /// Build an index while writing, saved when the writer is closed. Records must then
+    /// arrive in coordinate order.
+    public var buildIndex: Bool
+    /// Minimum bit-shift for a CSI index, or 0 for BAI (alignments) or TBI (bgzipped VCF).
+    /// BCF is always indexed as CSI and uses 14 when this is 0.
+    public var minShift: Int32
+    /// Where to save the index, or `nil` for the output path plus the usual extension.
+    public var indexPath: String?
+    /// Records per queued batch.
+    public var batchSize: Int
+    /// Batches that can be queued ahead of the writer thread.
+    public var queueDepth: Int
+    /// Encode and write on a background thread; when `false`, each record is written
+    /// before the writer's `write(_:)` returns.
+    public var background: Bool
+
+    public init(buildIndex: Bool = false,
+                minShift: Int32 = 0,
+                indexPath: String? = nil,
+                batchSize: Int = 1024,
+                queueDepth: Int = 4,
+                background: Bool = true) {
+        self.buildIndex = buildIndex
+        self.minShift = minShift
+        self.indexPath = indexPath
+        self.batchSize = batchSize
+        self.queueDepth = queueDepth
+        self.background = background
+    }
+}
+
+// MARK: - WriterStatistics
+
+/// Counters reported when a writer is closed.
+public struct WriterStatistics: Sendable {
+    /// Records written.
+    public internal(set) var records = 0
+    /// Times the producer waited because every queued batch was still being written.
+    public internal(set) var stalls = 0
+    /// The index that was saved, if any.
+    public internal(set) var indexPath: String?
+    /// Time from opening the writer to closing the file, including saving the index.
+    public internal(set) var elapsed: Duration = .zero
+
+    /// Records written per second of ``elapsed``.
+    public var recordsPerSecond: Double {
+        let seconds = Double(elapsed.components.seconds) + Double(elapsed.components.attoseconds) * 1e-18
+        return seconds > 0 ? Double(records) / seconds : 0
+    }
+}
+
+// MARK: - RecordWriterCore
+
+/// The file, write-behind queue and index state behind ``AlignmentWriter`` and ``VariantWriter``.
+final class RecordWriterCore {
+    enum Kind {
+        case alignment
+        case variant
+    }
+
+    let path: String
+    let kind: Kind
+    let file: UnsafeMutablePointer<htsFile>
+    private(set) var statistics = WriterStatistics()
+    private var writer: OpaquePointer?  // hts_shim_writer_t*
+    private let indexPath: UnsafeMutablePointer<CChar>?
+    private let clock = ContinuousClock()
+    private let started: ContinuousClock.Instant
+    private var closed = false
+
+    /// Creates the write-behind queue; replaced in tests to exercise its failure.
+    typealias QueueFactory = (UnsafeMutablePointer<htsFile>, UnsafeMutableRawPointer,
+                              Int32, Int32, Int32, Int32) -> OpaquePointer?
+
+    /// Open `path`, attach `pool`, and write the header with `writeHeader`.
+    init(path: String, mode: String, kind: Kind, options: WriterOptions, pool: OpaquePointer?,
+         header: UnsafeMutableRawPointer,
+         writeHeader: (UnsafeMutablePointer<htsFile>) -> Int32,
+         makeQueue: QueueFactory = { hts_shim_writer_init($0, $1, $2, $3, $4, $5) }) throws {
+        self.path = path
+        self.kind = kind
+        started = clock.now
+        guard let fp = hts_open(path, mode) else {
+            throw HTSError.openFailed(path: path, mode: mode)
+        }
+        if let pool {
+            var tp = htsThreadPool(pool: pool, qsize: 0)
+            hts_set_thread_pool(fp, &tp)
+        }
+        if writeHeader(fp) < 0 {
+            hts_close(fp)
+            throw HTSError.headerWriteFailed
+        }
+
+        var indexPath: UnsafeMutablePointer<CChar>?
+        if options.buildIndex {
+            let (target, minShift) = Self.index(for: path, mode: mode, kind: kind, options: options)
+            indexPath = strdup(target)
+            let ret: Int32
+            switch kind {
+            case .alignment:
+                ret = sam_idx_init(fp, header.assumingMemoryBound(to: sam_hdr_t.self), minShift, indexPath)
+            case .variant:
+                ret = bcf_idx_init(fp, header.assumingMemoryBound(to: bcf_hdr_t.self), minShift, indexPath)
+            }
+            if ret < 0 {
+                free(indexPath)
+                hts_close(fp)
+                throw HTSError.indexBuildFailed(path: target, code: ret)
+            }
+            statistics.indexPath = target
+        }
+        self.indexPath = indexPath
+        file = fp
+
+        let writerKind = kind == .alignment ? HTS_SHIM_WRITER_SAM : HTS_SHIM_WRITER_BCF
+        // Every stored property is set, so deinit closes the file and frees the index path.
+        guard let writer = makeQueue(fp, header, Int32(writerKind), Int32(options.batchSize),
+                                     Int32(options.queueDepth), options.background ? 1 : 0) else {
+            throw HTSError.outOfMemory
+        }
+        self.writer = writer
+    }
+
+    deinit {
+        _ = finish()
+        free(indexPath)
+    }
+
+    /// The index path and min-shift for an output, following htslib's extensions.
+    private static func index(for path: String, mode: String, kind: Kind,
+                              options: WriterOptions) -> (String, Int32) {
+        switch kind {
+        case .alignment:
+            let ext = mode.contains("c") ? ".crai" : options.minShift > 0 ? ".csi" : ".bai"
+            return (options.indexPath ?? path + ext, options.minShift)
+        case .variant:
+            if mode.contains("b") {
+                let minShift = options.minShift > 0 ? options.minShift : 14
+                return (options.indexPath ?? path + ".csi", minShift)
+            }
+            let ext = options.minShift > 0 ? ".csi" : ".tbi"
+            return (options.indexPath ?? path + ext, options.minShift)
+        }
+    }
+
+    /// The record to copy the next output record into.
+    func slot() throws -> UnsafeMutableRawPointer {
+        guard let writer else { throw HTSError.writeFailed(code: -1) }
+        guard let slot = hts_shim_writer_slot(writer) else {
+            // The queue only refuses slots after a failed write; report that error.
+            throw HTSError.writeFailed(code: hts_shim_writer_flush(writer))
+        }
+        return slot
+    }
+
+    /// Queue the record in the current slot.
+    func commit() throws {
+        guard let writer else { throw HTSError.writeFailed(code: -1) }
+        let ret = hts_shim_writer_commit(writer)
+        if ret < 0 { throw HTSError.writeFailed(code: ret) }
+    }
+
+    var recordsWritten: Int {
+        guard let writer else { return statistics.records }
+        return Int(hts_shim_writer_written(writer))
+    }
+
+    func flush() throws {
+        guard let writer else { return }
+        let ret = hts_shim_writer_flush(writer)
+        if ret < 0 { throw HTSError.writeFailed(code: ret) }
+    }
+
+    func close() throws -> WriterStatistics {
+        precondition(!closed, "Writer already closed")
+        if let error = finish() { throw error }
+        return statistics
+    }
+
+    /// Drain the queue, save the index and close the file, returning the first error.
+    ///
+    /// Without a queue the writer never finished opening, so no index is saved.
+    private func finish() -> HTSError? {
+        if closed { return nil }
+        closed = true
+        var failure: HTSError? = writer == nil ? .writeFailed(code: -1) : nil
+        if let writer {
+            _ = hts_shim_writer_flush(writer)
+            statistics.records = Int(hts_shim_writer_written(writer))
+            statistics.stalls = Int(hts_shim_writer_stalls(writer))
+            let ret = hts_shim_writer_destroy(writer)
+            if ret < 0 { failure = .writeFailed(code: ret) }
+            self.writer = nil
+        }
+        if indexPath != nil, failure == nil {
+            let ret = kind == .alignment ? sam_idx_save(file) : bcf_idx_save(file)
+            if ret < 0 { failure = .indexBuildFailed(path: statistics.indexPath ?? path, code: ret) }
+        }
+        let ret = hts_close(file)
+        if ret < 0, failure == nil { failure = .closeFailed(code: ret) }
+        statistics.elapsed = clock.now - started
+        return failure
+    }
+}
@@ -7,10 +7,26 @@ import CHtslib
 ///
 /// Create a single `ThreadPool` and attach it to multiple file handles
 /// via ``HTSFile/setThreadPool(_:queueSize:)`` to share threads across files.
-/// This is a move-only type that destroys the pool on deinitialization.
+/// This is a move-only type that destroys the pool on deinitialization, or once the
+/// last reader holding it (such as ``ParallelVCFReader``) is released, if that is later.
 public struct ThreadPool: ~Copyable, @unchecked Sendable {
+    /// The htslib pool, destroyed with the last reference.
+    final class Storage: @unchecked Sendable {
+        let pointer: OpaquePointer
+
+        init(pointer: OpaquePointer) {
+            self.pointer = pointer
+        }
+
+        deinit {
+            hts_tpool_destroy(pointer)
+        }
+    }
+
+    let storage: Storage
+
     @usableFromInline
-    nonisolated(unsafe) var pointer: OpaquePointer
+    var pointer: OpaquePointer { storage.pointer }
 
     /// Create a thread pool with the specified number of worker threads.
     ///
@@ -20,15 +36,11 @@ public struct ThreadPool: ~Copyable, @unchecked Sendable {
         guard let pool = hts_tpool_init(threads) else {
             throw HTSError.outOfMemory
         }
-        self.pointer = pool
+        self.storage = Storage(pointer: pool)
     }
 
     /// The number of worker threads in this pool.
     public var size: Int32 {
         hts_tpool_size(pointer)
     }
-
-    deinit {
-        hts_tpool_destroy(pointer)
-    }
 }
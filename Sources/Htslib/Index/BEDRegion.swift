@@ -0,0 +1,74 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+/// A single interval from a BED file.
+///
+/// Coordinates are BED's 0-based half-open `[start, end)`.
+public struct BEDRegion: Sendable, Hashable {
+    /// Contig name (BED column 1).
+    public let contig: String
+    /// 0-based inclusive start (column 2).
+    public let start: Int64
+    /// 0-based exclusive end (column 3).
+    public let end: Int64
+    /// Optional feature name (column 4).
+    public let name: String?
+
+    public init(contig: String, start: Int64, end: Int64, name: String? = nil) {
+        self.contig = contig
+        self.start = start
+        self.end = end
+        self.name = name
+    }
+
+    /// Length of the interval in bases.
+    public var length: Int64 { end - start }
+
+    /// Parse one BED line.
+    ///
+    /// - Parameter line: A tab-separated line with at least three columns.
+    /// - Returns: The region, or `nil` for blank, `#`, `track` and `browser` lines.
+    /// - Throws: ``HTSError/parseFailed(message:)`` if the coordinates are malformed.
+    public static func parse(line: Substring) throws -> BEDRegion? {
+        let line = line.last == "\r" ? line.dropLast() : line
+        if line.isEmpty || line.hasPrefix("#") || line.hasPrefix("track") || line.hasPrefix("browser") {
+            return nil
+        }
+        let columns = line.split(separator: "\t", maxSplits: 4, omittingEmptySubsequences: false)
+        guard columns.count >= 3,
+              let start = Int64(columns[1]), let end = Int64(columns[2]),
+              start >= 0, end >= start else {
+            throw HTSError.parseFailed(message: "Invalid BED line: \(line)")
+        }
+        let name = columns.count > 3 && !columns[3].isEmpty ? String(columns[3]) : nil
+        return BEDRegion(contig: String(columns[0]), start: start, end: end, name: name)
+    }
+
+    /// Read every region from a BED file (plain or BGZF-compressed).
+    ///
+    /// - Parameter path: Path to the BED file.
+    /// - Returns: The regions in file order.
+    /// - Throws: ``HTSError/openFailed(path:mode:)``, ``HTSError/readFailed(code:)`` or
+    ///   ``HTSError/parseFailed(message:)``.
+    public static func read(path: String) throws -> [BEDRegion] {
+        let file = try HTSFile(path: path, mode: "r")
+        var line = kstring_t()
+        hts_shim_ks_initialize(&line)
+        defer { hts_shim_ks_free(&line) }
+
+        var regions: [BEDRegion] = []
+        while true {
+            let ret = hts_getline(file.pointer, Int32(KS_SEP_LINE), &line)
+            if ret == -1 { break }
+            if ret < -1 { throw HTSError.readFailed(code: ret) }
+            guard let text = line.swiftString else { continue }
+            if let region = try parse(line: Substring(text)) {
+                regions.append(region)
+            }
+        }
+        return regions
+    }
+}
@@ -10,6 +10,8 @@ import CHtslib
 public struct HTSIndex: ~Copyable, @unchecked Sendable {
     @usableFromInline
     nonisolated(unsafe) var pointer: OpaquePointer  // hts_idx_t*
+    // The cache entry keeping a shared index alive; `nil` when this value owns the index.
+    private let shared: CachedIndex?
 
     /// Load an index for the given file.
     ///
@@ -22,10 +24,28 @@ public struct HTSIndex: ~Copyable, @unchecked Sendable {
             throw HTSError.indexLoadFailed(path: path)
         }
         self.pointer = idx
+        self.shared = nil
+    }
+
+    /// Use the index for the given file from a shared cache, loading it on first use.
+    ///
+    /// The index is shared read-only with every other user of the cache entry and stays
+    /// loaded while any of them holds it.
+    ///
+    /// - Parameters:
+    ///   - path: Path to the data file (the index is located automatically).
+    ///   - format: The expected index format, or `.auto` to auto-detect.
+    ///   - cache: The cache to share the index through, e.g. ``HTSResourceCache/shared``.
+    /// - Throws: ``HTSError/indexLoadFailed(path:)`` if the index cannot be loaded.
+    public init(path: String, format: IndexFormat = .auto, cache: HTSResourceCache) throws {
+        let entry = try cache.index(for: path, format: format)
+        self.pointer = entry.pointer
+        self.shared = entry
     }
 
     internal init(pointer: OpaquePointer) {
         self.pointer = pointer
+        self.shared = nil
     }
 
     /// The index file format.
@@ -45,6 +65,24 @@ public struct HTSIndex: ~Copyable, @unchecked Sendable {
         hts_idx_nseq(pointer)
     }
 
+    /// Mapped and unmapped record counts for a contig, read from the index metadata.
+    ///
+    /// BAI and CSI indexes store these counts; TBI and CRAI do not.
+    ///
+    /// - Parameter contigID: The reference sequence ID.
+    /// - Returns: The counts, or `nil` if the index does not record them for this contig.
+    public func recordCounts(contigID: Int32) -> (mapped: UInt64, unmapped: UInt64)? {
+        var mapped: UInt64 = 0
+        var unmapped: UInt64 = 0
+        guard hts_idx_get_stat(pointer, contigID, &mapped, &unmapped) == 0 else { return nil }
+        return (mapped, unmapped)
+    }
+
+    /// The number of unplaced records (no reference or position), from the index metadata.
+    public var unplacedRecords: UInt64 {
+        hts_idx_get_n_no_coor(pointer)
+    }
+
     /// Build an index for a SAM/BAM/CRAM file.
     ///
     /// - Parameters:
@@ -74,6 +112,6 @@ public struct HTSIndex: ~Copyable, @unchecked Sendable {
     }
 
     deinit {
-        hts_idx_destroy(pointer)
+        if shared == nil { hts_idx_destroy(pointer) }
     }
 }
@@ -0,0 +1,560 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - ShardPlan
+
+/// A split of an indexed file into shards of roughly equal compressed size.
+///
+/// A plan is produced by ``ShardPlanner`` and can be written to a small text file with
+/// ``write(to:)`` and loaded by workers with ``read(path:)``. Each shard lists the
+/// genomic regions it owns: a record belongs to the region containing its start position,
+/// so records crossing a shard boundary are processed once, by the shard in which they start.
+public struct ShardPlan: Sendable, Hashable {
+    /// The data format the plan was computed for.
+    public enum Format: String, Sendable {
+        /// BAM with a BAI or CSI index.
+        case bam
+        /// CRAM with a CRAI index.
+        case cram
+        /// BCF with a CSI index.
+        case bcf
+        /// BGZF-compressed VCF with a TBI or CSI index.
+        case vcf
+    }
+
+    /// One unit of work.
+    public struct Shard: Sendable, Hashable {
+        /// The regions owned by the shard, in file order. Coordinates are 0-based
+        /// half-open; the last region of a contig ends at `HTS_POS_MAX`, and unplaced
+        /// reads are a region on contig `"*"`.
+        public let regions: [BEDRegion]
+        /// Offset of the first chunk overlapping the shard's first region: a BGZF virtual
+        /// offset for BAM, BCF and VCF, or a container byte offset for CRAM.
+        public let startOffset: UInt64
+        /// The next shard's ``startOffset``, or the end of the data for the last shard.
+        /// Records owned by this shard can extend a little past it.
+        public let endOffset: UInt64
+        /// Estimated compressed bytes in the shard.
+        public let estimatedBytes: Int64
+        /// Estimated records in the shard, or `nil` if the index records no counts (CRAI).
+        public let estimatedRecords: Int64?
+
+        /// The regions as htslib region strings, suitable for `query(region:)`.
+        public var regionStrings: [String] {
+            regions.map { region in
+                if region.contig == "*" { return "*" }
+                let contig = region.contig.contains(":") ? "{\(region.contig)}" : region.contig
+                if region.end >= htsPosMax {
+                    return region.start == 0 ? contig : "\(contig):\(region.start + 1)"
+                }
+                return "\(contig):\(region.start + 1)-\(region.end)"
+            }
+        }
+    }
+
+    /// Path to the data file.
+    public let path: String
+    /// The data file's format.
+    public let format: Format
+    /// The shards, in file order.
+    public let shards: [Shard]
+
+    /// Estimated compressed bytes across all shards.
+    public var totalBytes: Int64 {
+        shards.reduce(0) { $0 + $1.estimatedBytes }
+    }
+
+    public init(path: String, format: Format, shards: [Shard]) {
+        self.path = path
+        self.format = format
+        self.shards = shards
+    }
+
+    // MARK: - Serialization
+
+    private static let magic = "#shard-plan\t1"
+
+    /// The plan as tab-separated text.
+    ///
+    /// After `#` header lines for the path and format, each shard is a `shard` line
+    /// (index, start offset, end offset, bytes, records or `.`) followed by one `region`
+    /// line per region (index, contig, start, end). Backslashes, tabs and line breaks in
+    /// the path and contig names are written as `\\`, `\t`, `\n` and `\r`.
+    public func serialized() -> String {
+        var text = "\(Self.magic)\n#path\t\(Self.escape(path))\n#format\t\(format.rawValue)\n"
+        for (i, shard) in shards.enumerated() {
+            let records = shard.estimatedRecords.map { String($0) } ?? "."
+            text += "shard\t\(i)\t\(shard.startOffset)\t\(shard.endOffset)\t\(shard.estimatedBytes)\t\(records)\n"
+            for region in shard.regions {
+                text += "region\t\(i)\t\(Self.escape(region.contig))\t\(region.start)\t\(region.end)\n"
+            }
+        }
+        return text
+    }
+
+    /// Escape the characters that would break a tab-separated line.
+    private static func escape(_ field: String) -> String {
+        guard field.unicodeScalars.contains(where: { $0 == "\\" || $0 == "\t" || $0 == "\n" || $0 == "\r" }) else {
+            return field
+        }
+        var out = ""
+        for c in field.unicodeScalars {
+            switch c {
+            case "\\": out += "\\\\"
+            case "\t": out += "\\t"
+            case "\n": out += "\\n"
+            case "\r": out += "\\r"
+            default: out.unicodeScalars.append(c)
+            }
+        }
+        return out
+    }
+
+    /// Undo ``escape(_:)``; `nil` for an invalid escape.
+    private static func unescape(_ field: Substring) -> String? {
+        guard field.contains("\\") else { return String(field) }
+        var out = ""
+        var escaped = false
+        for c in field.unicodeScalars {
+            if escaped {
+                switch c {
+                case "\\": out += "\\"
+                case "t": out += "\t"
+                case "n": out += "\n"
+                case "r": out += "\r"
+                default: return nil
+                }
+                escaped = false
+            } else if c == "\\" {
+                escaped = true
+            } else {
+                out.unicodeScalars.append(c)
+            }
+        }
+        return escaped ? nil : out
+    }
+
+    /// Parse a plan produced by ``serialized()``.
+    ///
+    /// - Parameter text: The serialized plan.
+    /// - Throws: ``HTSError/parseFailed(message:)`` if the text is not a valid plan.
+    public init(serialized text: String) throws {
+        let lines = text.split(separator: "\n", omittingEmptySubsequences: true)
+        guard lines.first == Substring(Self.magic) else {
+            throw HTSError.parseFailed(message: "Not a shard plan")
+        }
+        var path: String?
+        var format: Format?
+        var shards: [Shard] = []
+        var pending: (start: UInt64, end: UInt64, bytes: Int64, records: Int64?)?
+        var regions: [BEDRegion] = []
+
+        func flush() {
+            if let p = pending {
+                shards.append(Shard(regions: regions, startOffset: p.start, endOffset: p.end,
+                                    estimatedBytes: p.bytes, estimatedRecords: p.records))
+            }
+            pending = nil
+            regions = []
+        }
+
+        for line in lines.dropFirst() {
+            let fields = line.split(separator: "\t", omittingEmptySubsequences: false)
+            switch fields[0] {
+            case "#path" where fields.count == 2:
+                guard let value = Self.unescape(fields[1]) else {
+                    throw HTSError.parseFailed(message: "Invalid path line: \(line)")
+                }
+                path = value
+            case "#format" where fields.count == 2:
+                format = Format(rawValue: String(fields[1]))
+            case "shard" where fields.count == 6:
+                flush()
+                guard Int(fields[1]) == shards.count,
+                      let start = UInt64(fields[2]), let end = UInt64(fields[3]),
+                      let bytes = Int64(fields[4]) else {
+                    throw HTSError.parseFailed(message: "Invalid shard line: \(line)")
+                }
+                let records = fields[5] == "." ? nil : Int64(fields[5])
+                if records == nil && fields[5] != "." {
+                    throw HTSError.parseFailed(message: "Invalid shard line: \(line)")
+                }
+                pending = (start, end, bytes, records)
+            case "region" where fields.count == 5:
+                guard pending != nil, Int(fields[1]) == shards.count, let contig = Self.unescape(fields[2]),
+                      let start = Int64(fields[3]), let end = Int64(fields[4]) else {
+                    throw HTSError.parseFailed(message: "Invalid region line: \(line)")
+                }
+                regions.append(BEDRegion(contig: contig, start: start, end: end))
+            default:
+                if !fields[0].hasPrefix("#") {
+                    throw HTSError.parseFailed(message: "Invalid shard plan line: \(line)")
+                }
+            }
+        }
+        flush()
+        guard let path, let format else {
+            throw HTSError.parseFailed(message: "Shard plan is missing its path or format")
+        }
+        self.init(path: path, format: format, shards: shards)
+    }
+
+    /// Write the plan to a file in the ``serialized()`` format.
+    ///
+    /// - Parameter path: Destination path.
+    /// - Throws: ``HTSError/openFailed(path:mode:)`` or ``HTSError/writeFailed(code:)``.
+    public func write(to path: String) throws {
+        let file = try HFile(path: path, mode: "w")
+        var text = serialized()
+        try text.withUTF8 { bytes in
+            guard let base = bytes.baseAddress else { return }
+            _ = try file.write(from: base, length: bytes.count)
+        }
+        try file.flush()
+    }
+
+    /// Read a plan written by ``write(to:)``.
+    ///
+    /// - Parameter path: Path to the plan file.
+    /// - Returns: The plan.
+    /// - Throws: ``HTSError/openFailed(path:mode:)``, ``HTSError/readFailed(code:)`` or
+    ///   ``HTSError/parseFailed(message:)``.
+    public static func read(path: String) throws -> ShardPlan {
+        // Plain bytes through hFILE, as written; no format detection on the plan file.
+        let file = try HFile(path: path, mode: "r")
+        var bytes: [UInt8] = []
+        let chunk = 64 * 1024
+        while true {
+            let count = bytes.count
+            bytes.append(contentsOf: repeatElement(0, count: chunk))
+            let n = try bytes.withUnsafeMutableBytes { buffer in
+                try file.read(into: buffer.baseAddress! + count, length: chunk)
+            }
+            bytes.removeLast(chunk - n)
+            if n == 0 { break }
+        }
+        return try ShardPlan(serialized: String(decoding: bytes, as: UTF8.self))
+    }
+}
+
+// MARK: - ShardPlanner
+
+/// Plans byte-balanced shards of an indexed BAM, CRAM, BCF or tabix-indexed VCF.
+///
+/// Splitting by genomic span balances work poorly: sparse contigs and deep amplicons hold
+/// very different amounts of data per base. The planner instead cuts each contig into
+/// windows, estimates each window's compressed bytes from the index, and groups
+/// consecutive windows into shards of roughly equal size.
+///
+/// For BAI, CSI and TBI indexes a window's bytes are the distance between the first chunk
+/// offsets of it and the next window, found through the index's bins and linear offsets.
+/// For CRAI the slice sizes recorded in the index are summed per window. Record estimates
+/// spread each contig's indexed record count over its windows by bytes.
+///
+/// ```swift
+/// let plan = try ShardPlanner(path: "cohort.bcf", shardCount: 64).plan()
+/// try plan.write(to: "cohort.plan")
+///
+/// // On a worker:
+/// let shard = try ShardPlan.read(path: "cohort.plan").shards[workerIndex]
+/// for region in shard.regionStrings { ... }
+/// ```
+public struct ShardPlanner: Sendable {
+    /// Path to the indexed data file.
+    public let path: String
+    /// The number of shards to plan.
+    public let shardCount: Int
+    /// Genomic window size used when estimating bytes per region.
+    public let windowSize: Int64
+
+    /// Create a planner for an indexed file.
+    ///
+    /// - Parameters:
+    ///   - path: Path to the data file (its index is located automatically).
+    ///   - shardCount: Number of shards to split the file into.
+    ///   - windowSize: Planning granularity in bases.
+    public init(path: String, shardCount: Int, windowSize: Int64 = 1 << 20) {
+        precondition(shardCount > 0, "shardCount must be positive")
+        precondition(windowSize > 0, "windowSize must be positive")
+        self.path = path
+        self.shardCount = shardCount
+        self.windowSize = windowSize
+    }
+
+    private struct Contig {
+        let tid: Int32
+        let name: String
+        let length: Int64?
+        let records: UInt64?
+    }
+
+    private struct Window {
+        let region: BEDRegion
+        var offset: UInt64?
+        var bytes: Int64
+        var records: Double
+        let bases: Int64
+    }
+
+    // MARK: - Planning
+
+    /// Split the file into at most ``shardCount`` byte-balanced shards.
+    ///
+    /// - Returns: The plan.
+    /// - Throws: ``HTSError/openFailed(path:mode:)``, ``HTSError/headerReadFailed``,
+    ///   ``HTSError/indexLoadFailed(path:)``, or ``HTSError/invalidArgument(message:)``
+    ///   for formats without a supported index.
+    public func plan() throws -> ShardPlan {
+        let file = try HTSFile(path: path, mode: "r")
+        var identityTime: Int64 = 0
+        var fileSize: Int64 = 0
+        guard hts_shim_file_identity(path, &identityTime, &fileSize) == 0 else {
+            throw HTSError.openFailed(path: path, mode: "r")
+        }
+
+        let format: ShardPlan.Format
+        var windows: [Window]
+        var unplaced: UInt64 = 0
+        let dataEnd: UInt64
+        switch file.format {
+        case .bam:
+            format = .bam
+            let header = try file.samHeader()
+            let index = try HTSIndex(path: path)
+            let contigs = (0..<header.nTargets).map { tid in
+                Contig(tid: tid, name: header.targetName(at: tid) ?? "", length: header.targetLength(at: tid),
+                       records: index.recordCounts(contigID: tid).map { $0.mapped + $0.unmapped })
+            }
+            unplaced = index.unplacedRecords
+            windows = try binnedWindows(index: index.pointer, contigs: contigs)
+            dataEnd = UInt64(fileSize) << 16
+        case .bcf:
+            format = .bcf
+            let header = try file.vcfHeader()
+            let index = try HTSIndex(path: path)
+            let contigs = header.sequenceNames.enumerated().map { rid, name in
+                Contig(tid: Int32(rid), name: name, length: contigLength(header, name),
+                       records: index.recordCounts(contigID: Int32(rid)).map { $0.mapped + $0.unmapped })
+            }
+            windows = try binnedWindows(index: index.pointer, contigs: contigs)
+            dataEnd = UInt64(fileSize) << 16
+        case .vcf:
+            format = .vcf
+            let header = try file.vcfHeader()
+            let tabix = try TabixIndex(path: path)
+            guard let idx = tabix.pointer.pointee.idx else { throw HTSError.indexLoadFailed(path: path) }
+            let contigs = tabix.sequenceNames.enumerated().map { tid, name in
+                var mapped: UInt64 = 0
+                var unmapped: UInt64 = 0
+                let counted = hts_idx_get_stat(idx, Int32(tid), &mapped, &unmapped) == 0
+                return Contig(tid: Int32(tid), name: name, length: contigLength(header, name),
+                              records: counted ? mapped + unmapped : nil)
+            }
+            windows = try binnedWindows(index: idx, contigs: contigs)
+            dataEnd = UInt64(fileSize) << 16
+        case .cram:
+            format = .cram
+            let header = try file.samHeader()
+            let contigs = (0..<header.nTargets).map { tid in
+                Contig(tid: tid, name: header.targetName(at: tid) ?? "",
+                       length: header.targetLength(at: tid), records: nil)
+            }
+            var unplacedBytes: Int64 = 0
+            windows = try craiWindows(contigs: contigs, unplacedBytes: &unplacedBytes)
+            if unplacedBytes > 0 {
+                windows.append(Window(region: BEDRegion(contig: "*", start: 0, end: 0), offset: nil,
+                                      bytes: unplacedBytes, records: 0, bases: 0))
+            }
+            dataEnd = UInt64(fileSize)
+        default:
+            throw HTSError.invalidArgument(message: "Shard planning needs an indexed BAM, CRAM, BCF or VCF: \(path)")
+        }
+
+        if format != .cram {
+            weighByOffsets(&windows, dataEnd: dataEnd, unplaced: unplaced)
+        }
+        return ShardPlan(path: path, format: format,
+                         shards: group(windows, dataEnd: dataEnd, counted: format != .cram))
+    }
+
+    // MARK: - Window estimates
+
+    /// Windows for each contig with their first chunk offsets from a binning index.
+    private func binnedWindows(index: OpaquePointer, contigs: [Contig]) throws -> [Window] {
+        var windows: [Window] = []
+        var offsets: [UInt64] = []
+        for contig in contigs {
+            // BAI/CSI/TBI record per-contig counts; skip contigs known to be empty.
+            if contig.records == 0 { continue }
+            let length = max(contig.length ?? 1, 1)
+            let count = contig.length == nil ? 1 : Int((length + windowSize - 1) / windowSize)
+            offsets = [UInt64](repeating: 0, count: count)
+            let ret = offsets.withUnsafeMutableBufferPointer {
+                hts_shim_idx_window_offsets(index, contig.tid, windowSize, Int64(count), $0.baseAddress)
+            }
+            // The index is unusable if it cannot be queried for a contig it lists.
+            guard ret == 0 else { throw HTSError.indexLoadFailed(path: path) }
+            for w in 0..<count {
+                let start = Int64(w) * windowSize
+                let end = w == count - 1 ? htsPosMax : start + windowSize
+                windows.append(Window(region: BEDRegion(contig: contig.name, start: start, end: end),
+                                      offset: offsets[w] == .max ? nil : offsets[w], bytes: 0,
+                                      records: Double(contig.records ?? 0),
+                                      bases: min(windowSize, max(length - start, 1))))
+            }
+        }
+        return windows
+    }
+
+    /// Set window bytes from consecutive offsets and spread contig record counts by bytes.
+    ///
+    /// On entry each window's `records` holds its whole contig's count.
+    private func weighByOffsets(_ windows: inout [Window], dataEnd: UInt64, unplaced: UInt64) {
+        var nextOffset = dataEnd
+        for i in windows.indices.reversed() {
+            if let offset = windows[i].offset {
+                windows[i].bytes = Int64(nextOffset >> 16) - Int64(offset >> 16)
+                windows[i].bytes = max(windows[i].bytes, 0)
+                nextOffset = offset
+            }
+        }
+
+        let placedRecords = windows.reduce(into: [String: Double]()) { $0[$1.region.contig] = $1.records }
+            .values.reduce(0, +)
+        if unplaced > 0 {
+            // Unplaced reads follow the placed data: move their estimated share off the
+            // last placed window, using the average placed record size.
+            let placedBytes = windows.reduce(0) { $0 + $1.bytes }
+            let perRecord = placedRecords > 0 ? Double(placedBytes) / (placedRecords + Double(unplaced)) : 0
+            var unplacedBytes = Int64(perRecord * Double(unplaced))
+            if let last = windows.lastIndex(where: { $0.offset != nil }) {
+                unplacedBytes = min(unplacedBytes, windows[last].bytes)
+                windows[last].bytes -= unplacedBytes
+            }
+            windows.append(Window(region: BEDRegion(contig: "*", start: 0, end: 0), offset: nil,
+                                  bytes: unplacedBytes, records: Double(unplaced), bases: 0))
+        }
+
+        var start = 0
+        while start < windows.count {
+            var end = start + 1
+            while end < windows.count && windows[end].region.contig == windows[start].region.contig { end += 1 }
+            if windows[start].region.contig != "*" {
+                let total = windows[start].records
+                let bytes = windows[start..<end].reduce(0) { $0 + $1.bytes }
+                for i in start..<end {
+                    let share = bytes > 0 ? Double(windows[i].bytes) / Double(bytes) : 1 / Double(end - start)
+                    windows[i].records = total * share
+                }
+            }
+            start = end
+        }
+    }
+
+    /// Windows for each contig with bytes summed from the `.crai` slice entries.
+    private func craiWindows(contigs: [Contig], unplacedBytes: inout Int64) throws -> [Window] {
+        var firstWindow: [Int32: Int] = [:]
+        var windows: [Window] = []
+        for contig in contigs {
+            firstWindow[contig.tid] = windows.count
+            let length = max(contig.length ?? 1, 1)
+            let count = Int((length + windowSize - 1) / windowSize)
+            for w in 0..<count {
+                let start = Int64(w) * windowSize
+                let end = w == count - 1 ? htsPosMax : start + windowSize
+                windows.append(Window(region: BEDRegion(contig: contig.name, start: start, end: end),
+                                      offset: nil, bytes: 0, records: 0,
+                                      bases: min(windowSize, length - start)))
+            }
+        }
+
+        let crai = try BGZFFile(path: path + ".crai", mode: "r")
+        var line = kstring_t()
+        hts_shim_ks_initialize(&line)
+        defer { hts_shim_ks_free(&line) }
+        while true {
+            let ret = bgzf_getline(crai.pointer, Int32(UInt8(ascii: "\n")), &line)
+            if ret == -1 { break }
+            if ret < -1 { throw HTSError.readFailed(code: ret) }
+            guard let text = line.swiftString else { continue }
+            // refid, alignment start (1-based), span, container offset, slice offset, slice size
+            let fields = text.split(separator: "\t")
+            guard fields.count >= 6, let refID = Int32(fields[0]), let start = Int64(fields[1]),
+                  let container = UInt64(fields[3]), let size = Int64(fields[5]) else {
+                throw HTSError.parseFailed(message: "Invalid CRAI line: \(text)")
+            }
+            guard refID >= 0, let first = firstWindow[refID] else {
+                unplacedBytes += size
+                continue
+            }
+            let last = refID + 1 < Int32(contigs.count) ? firstWindow[refID + 1] ?? windows.count : windows.count
+            let i = min(first + Int(max(start - 1, 0) / windowSize), last - 1)
+            windows[i].bytes += size
+            windows[i].offset = min(windows[i].offset ?? .max, container)
+        }
+
+        // Contigs without slices hold no records; drop them unless nothing was located.
+        let located = Set(windows.filter { $0.bytes > 0 }.map(\.region.contig))
+        return located.isEmpty ? windows : windows.filter { located.contains($0.region.contig) }
+    }
+
+    // MARK: - Grouping
+
+    /// Group consecutive windows into shards of roughly equal bytes.
+    private func group(_ windows: [Window], dataEnd: UInt64, counted: Bool) -> [ShardPlan.Shard] {
+        var weights = windows.map(\.bytes)
+        var totalBytes = weights.reduce(0, +)
+        if totalBytes == 0 {
+            // No usable offsets: balance by genomic span instead.
+            weights = windows.map(\.bases)
+            totalBytes = weights.reduce(0, +)
+        }
+        let target = max(totalBytes / Int64(shardCount), 1)
+
+        var groups: [(windows: Range<Int>, weight: Int64)] = []
+        var start = 0
+        var weight: Int64 = 0
+        for i in windows.indices {
+            weight += weights[i]
+            let isUnplacedNext = i + 1 < windows.count && windows[i + 1].region.contig == "*"
+            if weight >= target && groups.count < shardCount - 1 && !isUnplacedNext {
+                groups.append((start..<(i + 1), weight))
+                start = i + 1
+                weight = 0
+            }
+        }
+        if start < windows.count {
+            groups.append((start..<windows.count, weight))
+        }
+
+        // A shard starts at its first located window; empty shards inherit the next start.
+        var shards: [ShardPlan.Shard] = []
+        var nextStart = dataEnd
+        for g in groups.reversed() {
+            let offset = windows[g.windows].first(where: { $0.offset != nil })?.offset ?? nextStart
+            var regions: [BEDRegion] = []
+            for window in windows[g.windows] {
+                let region = window.region
+                if let last = regions.last, last.contig == region.contig, last.end == region.start {
+                    regions[regions.count - 1] = BEDRegion(contig: last.contig, start: last.start, end: region.end)
+                } else {
+                    regions.append(region)
+                }
+            }
+            let records = windows[g.windows].reduce(0) { $0 + $1.records }
+            shards.append(ShardPlan.Shard(regions: regions, startOffset: offset, endOffset: nextStart,
+                                          estimatedBytes: windows[g.windows].reduce(0) { $0 + $1.bytes },
+                                          estimatedRecords: counted ? Int64(records.rounded()) : nil))
+            nextStart = offset
+        }
+        return shards.reversed()
+    }
+
+    private func contigLength(_ header: VCFHeader, _ name: String) -> Int64? {
+        let length = hts_shim_bcf_hdr_contig_length(header.pointer, name)
+        return length > 0 ? length : nil
+    }
+}
@@ -0,0 +1,399 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - AlignmentSplitter
+
+/// Splits one alignment stream into one output per read group, contig or custom key.
+///
+/// Records are read once and routed to an ``AlignmentWriter`` per key, opened the first
+/// time the key is seen. All writers share one ``ThreadPool`` for BGZF compression, so
+/// splitting into many files keeps every worker busy instead of one compressor per file.
+///
+/// ```swift
+/// let pool = try ThreadPool(threads: 8)
+/// let splitter = AlignmentSplitter(header: header, key: .readGroup,
+///                                  options: .init(directory: "split", prefix: "sample-"),
+///                                  pool: pool)
+/// let stats = try splitter.run(input.samIterator(header: header))
+/// for output in splitter.outputs { print(output.key, output.path, output.records) }
+/// ```
+///
+/// Each output's header is a ``SAMHeader/copy()`` of the input header; when splitting by
+/// read group, the other `@RG` lines are removed. `@SQ` lines are always kept so contig IDs
+/// stay valid.
+///
+/// At most ``Options/maxOpenOutputs`` writers are open at once. When a new key needs a
+/// writer beyond that, the least recently used one is closed; if its key appears again,
+/// further records go to a temporary segment, and ``finish()`` rewrites that output with
+/// its segments appended in order. High-cardinality keys therefore cost one extra pass
+/// over only the outputs that were evicted. The pool must outlive the splitter.
+public final class AlignmentSplitter {
+    /// How records are assigned to outputs.
+    public enum Key {
+        /// The `RG` tag's value.
+        case readGroup
+        /// The reference name of the record's contig.
+        case contig
+        /// A caller-computed key, or `nil` for an unassigned record.
+        case custom((borrowing BAMRecord) -> String?)
+    }
+
+    /// Output naming, open-file and writer settings.
+    public struct Options: Sendable {
+        /// Directory the outputs are written to.
+        public var directory: String
+        /// Prefix for output file names, which are the prefix, the key and an extension.
+        public var prefix: String
+        /// The htslib open mode for outputs; `"wb"` gives `.bam`, `"wc"` `.cram`, `"w"` `.sam`.
+        public var mode: String
+        /// Most writers open at once.
+        public var maxOpenOutputs: Int
+        /// Settings for every output's writer. Defaults to writing on the caller's thread,
+        /// since compression already runs on the pool and each background writer is a thread.
+        public var writer: WriterOptions
+        /// Key for records with no key (no `RG` tag, or unmapped when splitting by contig),
+        /// or `nil` to drop them.
+        public var unassignedKey: String?
+        /// Directory for segments of evicted outputs.
+        public var temporaryDirectory: String
+
+        public init(directory: String = ".",
+                    prefix: String = "",
+                    mode: String = "wb",
+                    maxOpenOutputs: Int = 64,
+                    writer: WriterOptions = WriterOptions(background: false),
+                    unassignedKey: String? = "unassigned",
+                    temporaryDirectory: String = "/tmp") {
+            self.directory = directory
+            self.prefix = prefix
+            self.mode = mode
+            self.maxOpenOutputs = maxOpenOutputs
+            self.writer = writer
+            self.unassignedKey = unassignedKey
+            self.temporaryDirectory = temporaryDirectory
+        }
+    }
+
+    /// One output file.
+    public struct Output: Sendable {
+        /// The key routed to this output.
+        public let key: String
+        /// The output path.
+        public let path: String
+        /// Records routed to this output.
+        public internal(set) var records: Int
+    }
+
+    /// Counters for one pass.
+    public struct Statistics: Sendable {
+        /// Records read.
+        public internal(set) var records = 0
+        /// Records with no key that were dropped.
+        public internal(set) var dropped = 0
+        /// Outputs created.
+        public internal(set) var outputs = 0
+        /// Writers closed to stay within ``Options/maxOpenOutputs``.
+        public internal(set) var evictions = 0
+        /// Outputs rewritten by ``AlignmentSplitter/finish()`` to append segments.
+        public internal(set) var mergedOutputs = 0
+        /// Records rewritten while merging segments.
+        public internal(set) var mergedRecords = 0
+        /// Largest number of writers open at once.
+        public internal(set) var peakOpenOutputs = 0
+    }
+
+    /// The input header.
+    public let header: SAMHeader
+    /// The options the splitter was created with.
+    public let options: Options
+    /// Counters so far; complete after ``finish()``.
+    public private(set) var statistics = Statistics()
+
+    /// Outputs in the order their keys were first seen.
+    public var outputs: [Output] {
+        sinks.map { Output(key: $0.key, path: $0.path, records: $0.records) }
+    }
+
+    private let key: Key
+    private let pool: OpaquePointer?  // hts_tpool*
+    private var sinks: [Sink] = []
+    private var sinksByName: [String: Int] = [:]
+    // Read-group lookup by hash of the tag bytes, so routing needs no String per record.
+    private var sinksByHash: [UInt64: Int] = [:]
+    // Contig lookup by tid; -1 until the contig's output is created.
+    private var sinksByTid: [Int]
+    private var usedPaths: Set<String> = []
+    private var openCount = 0
+    private var tick = 0
+    private var finished = false
+
+    /// Create a splitter whose writers compress on their own.
+    ///
+    /// - Parameters:
+    ///   - header: The input header.
+    ///   - key: How records are assigned to outputs.
+    ///   - options: Output naming, open-file and writer settings.
+    public init(header: SAMHeader, key: Key, options: Options = Options()) {
+        self.header = header
+        self.key = key
+        self.options = options
+        pool = nil
+        sinksByTid = Array(repeating: -1, count: Int(max(header.nTargets, 0)))
+    }
+
+    /// Create a splitter whose writers all compress on a shared thread pool.
+    ///
+    /// - Parameters:
+    ///   - header: The input header.
+    ///   - key: How records are assigned to outputs.
+    ///   - options: Output naming, open-file and writer settings.
+    ///   - pool: The pool for every writer's BGZF compression. It must outlive the splitter.
+    public init(header: SAMHeader, key: Key, options: Options = Options(), pool: borrowing ThreadPool) {
+        self.header = header
+        self.key = key
+        self.options = options
+        self.pool = pool.pointer
+        sinksByTid = Array(repeating: -1, count: Int(max(header.nTargets, 0)))
+    }
+
+    deinit {
+        for sink in sinks {
+            _ = try? sink.writer?.close()
+            for segment in sink.segments { _ = hts_shim_remove_file(segment) }
+        }
+    }
+
+    // MARK: - Routing
+
+    /// Route a record to its key's output.
+    ///
+    /// - Parameter record: The record to write; the caller may reuse it immediately.
+    /// - Throws: Errors from opening, evicting or writing an output.
+    public func write(_ record: borrowing BAMRecord) throws {
+        precondition(!finished, "AlignmentSplitter already finished")
+        statistics.records += 1
+        guard let index = try route(record.pointer, record) else {
+            statistics.dropped += 1
+            return
+        }
+        let sink = sinks[index]
+        tick += 1
+        sink.lastUse = tick
+        if sink.writer == nil { try reopen(sink) }
+        try sink.writer!.write(record)
+        sink.records += 1
+    }
+
+    /// Route every remaining record from `iterator`, then finish.
+    ///
+    /// - Parameter iterator: The source; its filter, if any, applies.
+    /// - Returns: The final ``Statistics``.
+    /// - Throws: Any error from reading, writing or finishing.
+    @discardableResult
+    public func run(_ iterator: SAMRecordIterator) throws -> Statistics {
+        var record = try BAMRecord()
+        while try iterator.read(into: &record) {
+            try write(record)
+        }
+        return try finish()
+    }
+
+    /// Close every output, appending the segments of evicted outputs.
+    ///
+    /// - Returns: The final ``Statistics``.
+    /// - Throws: Errors from closing, reading segments or rewriting an output.
+    @discardableResult
+    public func finish() throws -> Statistics {
+        precondition(!finished, "AlignmentSplitter already finished")
+        finished = true
+        for sink in sinks {
+            if let writer = sink.writer {
+                try writer.close()
+                sink.writer = nil
+                openCount -= 1
+            }
+            if !sink.segments.isEmpty { try merge(sink) }
+        }
+        return statistics
+    }
+
+    /// The output index for `b`, creating the output on first sight of its key.
+    private func route(_ b: UnsafeMutablePointer<bam1_t>, _ record: borrowing BAMRecord) throws -> Int? {
+        switch key {
+        case .readGroup:
+            guard let aux = bam_aux_get(b, "RG"), aux.pointee == UInt8(ascii: "Z") else {
+                return try unassigned()
+            }
+            let value = UnsafeRawPointer(aux + 1)
+            let length = strlen(value.assumingMemoryBound(to: CChar.self))
+            let hash = hts_shim_hash_bytes(value, length)
+            if let index = sinksByHash[hash], sinks[index].matches(value, length) { return index }
+            let name = String(decoding: UnsafeRawBufferPointer(start: value, count: length), as: UTF8.self)
+            let index = try sink(for: name)
+            if sinksByHash[hash] == nil { sinksByHash[hash] = index }
+            return index
+        case .contig:
+            let tid = Int(b.pointee.core.tid)
+            guard tid >= 0, tid < sinksByTid.count else { return try unassigned() }
+            if sinksByTid[tid] >= 0 { return sinksByTid[tid] }
+            guard let name = header.targetName(at: Int32(tid)) else { return try unassigned() }
+            let index = try sink(for: name)
+            sinksByTid[tid] = index
+            return index
+        case .custom(let body):
+            guard let name = body(record) else { return try unassigned() }
+            return try sink(for: name)
+        }
+    }
+
+    private func unassigned() throws -> Int? {
+        guard let name = options.unassignedKey else { return nil }
+        return try sink(for: name)
+    }
+
+    private func sink(for name: String) throws -> Int {
+        if let index = sinksByName[name] { return index }
+        let outputHeader = try self.outputHeader(for: name)
+        let sink = Sink(key: name, path: uniquePath(for: name), header: outputHeader)
+        try open(sink, path: sink.path, mode: options.mode, writerOptions: options.writer)
+        sinks.append(sink)
+        sinksByName[name] = sinks.count - 1
+        statistics.outputs += 1
+        return sinks.count - 1
+    }
+
+    /// A copy of the input header, keeping only the output's `@RG` line for read groups.
+    private func outputHeader(for name: String) throws -> SAMHeader {
+        guard let copy = header.copy() else { throw HTSError.outOfMemory }
+        if case .readGroup = key {
+            // With no matching line (the unassigned output) every @RG line is removed.
+            try copy.removeLines(type: "RG", keeping: "ID", name)
+        }
+        return copy
+    }
+
+    /// `<directory>/<prefix><key><extension>`, with unsafe characters in the key replaced.
+    private func uniquePath(for name: String) -> String {
+        let ext = options.mode.contains("c") ? ".cram" : options.mode.contains("b") ? ".bam" : ".sam"
+        let safe = String(name.unicodeScalars.map { scalar -> Character in
+            switch scalar {
+            case "a"..."z", "A"..."Z", "0"..."9", ".", "-", "_": return Character(scalar)
+            default: return "_"
+            }
+        })
+        let base = options.directory + "/" + options.prefix + safe
+        var path = base + ext
+        var n = 1
+        while usedPaths.contains(path) {
+            n += 1
+            path = base + "-\(n)" + ext
+        }
+        usedPaths.insert(path)
+        return path
+    }
+
+    // MARK: - Open outputs
+
+    private func open(_ sink: Sink, path: String, mode: String, writerOptions: WriterOptions) throws {
+        if openCount >= max(options.maxOpenOutputs, 1) { try evict() }
+        sink.writer = try AlignmentWriter(path: path, header: sink.header, mode: mode,
+                                          options: writerOptions, poolPointer: pool)
+        openCount += 1
+        statistics.peakOpenOutputs = max(statistics.peakOpenOutputs, openCount)
+    }
+
+    /// Continue an evicted output in a new temporary segment.
+    private func reopen(_ sink: Sink) throws {
+        var buffer = [CChar](repeating: 0, count: 4096)
+        guard hts_shim_make_temp_path(options.temporaryDirectory, "htslib-split-", ".bam", &buffer, buffer.count) == 0 else {
+            throw HTSError.openFailed(path: options.temporaryDirectory, mode: "w")
+        }
+        let path = buffer.withUnsafeBufferPointer { String(cString: $0.baseAddress!) }
+        sink.segments.append(path)
+        try open(sink, path: path, mode: "wb1", writerOptions: WriterOptions(background: false))
+    }
+
+    /// Close the least recently used open writer.
+    private func evict() throws {
+        var victim: Sink?
+        for sink in sinks where sink.writer != nil {
+            if victim == nil || sink.lastUse < victim!.lastUse { victim = sink }
+        }
+        guard let victim, let writer = victim.writer else { return }
+        try writer.close()
+        victim.writer = nil
+        openCount -= 1
+        statistics.evictions += 1
+    }
+
+    /// Rewrite an evicted output with its segments appended, then remove the segments.
+    ///
+    /// The first part is moved aside next to the output, since a rename cannot cross
+    /// filesystems and ``Options/temporaryDirectory`` is often on another one.
+    /// - Throws: ``HTSError/writeFailed(code:)`` with the negated `errno` if the first
+    ///   part cannot be moved aside.
+    private func merge(_ sink: Sink) throws {
+        var buffer = [CChar](repeating: 0, count: 4096)
+        guard hts_shim_make_temp_path(options.directory, ".htslib-split-", ".tmp", &buffer, buffer.count) == 0 else {
+            throw HTSError.openFailed(path: options.directory, mode: "w")
+        }
+        let first = buffer.withUnsafeBufferPointer { String(cString: $0.baseAddress!) }
+        let ret = hts_shim_rename_file(sink.path, first)
+        guard ret == 0 else {
+            _ = hts_shim_remove_file(first)
+            throw HTSError.writeFailed(code: ret)
+        }
+        let sources = [first] + sink.segments
+        sink.segments = []
+
+        let writer = try AlignmentWriter(path: sink.path, header: sink.header, mode: options.mode,
+                                         options: options.writer, poolPointer: pool)
+        var record = try BAMRecord()
+        for path in sources {
+            let input = try HTSFile(path: path, mode: "r")
+            if let pool {
+                var tp = htsThreadPool(pool: pool, qsize: 0)
+                hts_set_thread_pool(input.pointer, &tp)
+            }
+            let header = try input.samHeader()
+            let iterator = input.samIterator(header: header)
+            while try iterator.read(into: &record) {
+                try writer.write(record)
+                statistics.mergedRecords += 1
+            }
+        }
+        try writer.close()
+        // Sources are kept if the rewrite fails, so no records are lost.
+        for path in sources { _ = hts_shim_remove_file(path) }
+        statistics.mergedOutputs += 1
+    }
+}
+
+// MARK: - Sink
+
+/// One output's key, header, open writer and segments.
+private final class Sink {
+    let key: String
+    let path: String
+    let header: SAMHeader
+    private let keyBytes: [UInt8]
+    var writer: AlignmentWriter?
+    var segments: [String] = []
+    var records = 0
+    var lastUse = 0
+
+    init(key: String, path: String, header: SAMHeader) {
+        self.key = key
+        self.path = path
+        self.header = header
+        keyBytes = Array(key.utf8)
+    }
+
+    /// Whether the key is exactly `length` bytes at `bytes`.
+    func matches(_ bytes: UnsafeRawPointer, _ length: Int) -> Bool {
+        keyBytes.count == length && keyBytes.withUnsafeBytes { memcmp($0.baseAddress!, bytes, length) == 0 }
+    }
+}
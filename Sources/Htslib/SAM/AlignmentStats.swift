@@ -0,0 +1,477 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - AlignmentStats
+
+/// Flag counts and insert-size, mapping-quality, read-length and base-quality histograms,
+/// gathered in one pass over an alignment file.
+///
+/// `AlignmentStats` is an accumulator: ``add(_:)`` folds in one record and ``merge(_:)``
+/// combines two accumulators, so a sharded scan keeps one per task and merges them at the
+/// end. Only the selected ``Collectors`` do any work per record.
+///
+/// ```swift
+/// // Sequentially:
+/// let stats = try AlignmentStats.collect(file.samIterator(header: header))
+///
+/// // Across shards of an indexed file, one accumulator per task:
+/// let scanner = ParallelBAMScanner(path: "sample.bam", shardCount: 16)
+/// let stats = try await AlignmentStats.collect(scanner, collectors: [.flags, .insertSize])
+/// print(stats.passed.mapped, stats.insertSize.mean)
+/// print(stats.tsv())
+/// ```
+///
+/// Flag counts follow `samtools flagstat`, split by the QC-fail flag. The histograms count
+/// primary records only: mapping quality over mapped reads, insert size once per pair
+/// (from the leftmost mate of a pair mapped to one contig), and read length and base
+/// quality over all primary reads.
+///
+/// Per-contig mapped and unmapped counts need no pass at all; see
+/// ``indexStatistics(path:)``.
+public struct AlignmentStats: Sendable {
+    /// The statistics gathered per record.
+    public struct Collectors: OptionSet, Sendable {
+        public let rawValue: UInt8
+        public init(rawValue: UInt8) { self.rawValue = rawValue }
+
+        /// `flagstat`-style flag counts.
+        public static let flags          = Collectors(rawValue: 1 << 0)
+        /// Insert-size histogram.
+        public static let insertSize     = Collectors(rawValue: 1 << 1)
+        /// Mapping-quality histogram.
+        public static let mappingQuality = Collectors(rawValue: 1 << 2)
+        /// Read-length histogram.
+        public static let readLength     = Collectors(rawValue: 1 << 3)
+        /// Base-quality histogram.
+        public static let baseQuality    = Collectors(rawValue: 1 << 4)
+
+        /// Every collector.
+        public static let all: Collectors = [.flags, .insertSize, .mappingQuality, .readLength, .baseQuality]
+    }
+
+    /// Record counts by flag, as reported by `samtools flagstat`.
+    public struct FlagCounts: Sendable, Equatable {
+        public internal(set) var total: UInt64 = 0
+        public internal(set) var primary: UInt64 = 0
+        public internal(set) var secondary: UInt64 = 0
+        public internal(set) var supplementary: UInt64 = 0
+        public internal(set) var duplicates: UInt64 = 0
+        public internal(set) var primaryDuplicates: UInt64 = 0
+        public internal(set) var mapped: UInt64 = 0
+        public internal(set) var primaryMapped: UInt64 = 0
+        /// Primary records flagged as paired; the pair counts below are all primary.
+        public internal(set) var paired: UInt64 = 0
+        public internal(set) var read1: UInt64 = 0
+        public internal(set) var read2: UInt64 = 0
+        /// Mapped reads flagged as properly paired.
+        public internal(set) var properlyPaired: UInt64 = 0
+        /// Reads mapped with their mate mapped.
+        public internal(set) var bothMapped: UInt64 = 0
+        /// Reads mapped with their mate unmapped.
+        public internal(set) var singletons: UInt64 = 0
+        /// Reads mapped with their mate mapped to a different contig.
+        public internal(set) var mateOnDifferentContig: UInt64 = 0
+        /// As ``mateOnDifferentContig``, with mapping quality at least 5.
+        public internal(set) var mateOnDifferentContigMapQ5: UInt64 = 0
+
+        mutating func merge(_ other: FlagCounts) {
+            total += other.total
+            primary += other.primary
+            secondary += other.secondary
+            supplementary += other.supplementary
+            duplicates += other.duplicates
+            primaryDuplicates += other.primaryDuplicates
+            mapped += other.mapped
+            primaryMapped += other.primaryMapped
+            paired += other.paired
+            read1 += other.read1
+            read2 += other.read2
+            properlyPaired += other.properlyPaired
+            bothMapped += other.bothMapped
+            singletons += other.singletons
+            mateOnDifferentContig += other.mateOnDifferentContig
+            mateOnDifferentContigMapQ5 += other.mateOnDifferentContigMapQ5
+        }
+
+        /// Field names and values in `flagstat` order, for the text and JSON reports.
+        var fields: [(String, UInt64)] {
+            [("total", total), ("primary", primary), ("secondary", secondary),
+             ("supplementary", supplementary), ("duplicates", duplicates),
+             ("primary_duplicates", primaryDuplicates), ("mapped", mapped),
+             ("primary_mapped", primaryMapped), ("paired", paired), ("read1", read1),
+             ("read2", read2), ("properly_paired", properlyPaired), ("both_mapped", bothMapped),
+             ("singletons", singletons), ("mate_on_different_contig", mateOnDifferentContig),
+             ("mate_on_different_contig_mapq5", mateOnDifferentContigMapQ5)]
+        }
+    }
+
+    /// Counts of non-negative integer values, with values at or above ``limit`` pooled.
+    public struct Histogram: Sendable, Equatable {
+        /// Counts indexed by value; trailing zero bins may be absent.
+        public private(set) var counts: [UInt64] = []
+        /// Values at or above ``limit``.
+        public private(set) var overflow: UInt64 = 0
+        /// One past the largest value counted individually.
+        public let limit: Int
+
+        init(limit: Int) {
+            self.limit = limit
+        }
+
+        @inline(__always)
+        mutating func add(_ value: Int) {
+            guard value < limit else {
+                overflow += 1
+                return
+            }
+            if value >= counts.count {
+                counts.append(contentsOf: repeatElement(0, count: value + 1 - counts.count))
+            }
+            counts[value] += 1
+        }
+
+        /// Add a read's raw Phred qualities with the histogram kernel.
+        mutating func addQualities(_ qualities: UnsafeBufferPointer<UInt8>) {
+            if counts.count < 256 {
+                counts.append(contentsOf: repeatElement(0, count: 256 - counts.count))
+            }
+            counts.withUnsafeMutableBufferPointer { bins in
+                hts_shim_qual_histogram(qualities.baseAddress, Int64(qualities.count), bins.baseAddress)
+            }
+        }
+
+        mutating func merge(_ other: Histogram) {
+            if other.counts.count > counts.count {
+                counts.append(contentsOf: repeatElement(0, count: other.counts.count - counts.count))
+            }
+            for (value, n) in other.counts.enumerated() where n > 0 {
+                counts[value] += n
+            }
+            overflow += other.overflow
+        }
+
+        /// Values counted, including ``overflow``.
+        public var total: UInt64 {
+            counts.reduce(overflow, +)
+        }
+
+        /// The mean of the individually counted values, or 0 if there are none.
+        public var mean: Double {
+            var n: UInt64 = 0
+            var sum: Double = 0
+            for (value, count) in counts.enumerated() where count > 0 {
+                n += count
+                sum += Double(value) * Double(count)
+            }
+            return n > 0 ? sum / Double(n) : 0
+        }
+
+        /// The smallest value with at least `fraction` of the individually counted values
+        /// at or below it, or `nil` if there are none.
+        public func percentile(_ fraction: Double) -> Int? {
+            let n = counts.reduce(0, +)
+            guard n > 0 else { return nil }
+            let target = max(UInt64((Double(n) * fraction).rounded(.up)), 1)
+            var seen: UInt64 = 0
+            for (value, count) in counts.enumerated() {
+                seen += count
+                if seen >= target { return value }
+            }
+            return counts.count - 1
+        }
+
+        /// `(value, count)` for every non-empty bin.
+        var nonEmptyBins: [(Int, UInt64)] {
+            counts.enumerated().compactMap { $0.element > 0 ? ($0.offset, $0.element) : nil }
+        }
+    }
+
+    /// The collectors this accumulator runs.
+    public let collectors: Collectors
+    /// Flag counts for records that passed QC.
+    public private(set) var passed = FlagCounts()
+    /// Flag counts for records flagged as failing QC.
+    public private(set) var failed = FlagCounts()
+    /// Absolute template length, once per mapped pair.
+    public private(set) var insertSize: Histogram
+    /// Mapping quality of mapped primary reads.
+    public private(set) var mappingQuality = Histogram(limit: 256)
+    /// Sequence length of primary reads.
+    public private(set) var readLength = Histogram(limit: Int(Int32.max))
+    /// Base quality over every base of primary reads with qualities.
+    public private(set) var baseQuality = Histogram(limit: 256)
+
+    /// Create an empty accumulator.
+    ///
+    /// - Parameters:
+    ///   - collectors: The statistics to gather.
+    ///   - maxInsertSize: Insert sizes at or above this are counted as overflow.
+    public init(collectors: Collectors = .all, maxInsertSize: Int = 8000) {
+        self.collectors = collectors
+        insertSize = Histogram(limit: maxInsertSize)
+    }
+
+    // MARK: - Accumulating
+
+    /// Fold one record into the statistics.
+    ///
+    /// - Parameter record: The record to count.
+    public mutating func add(_ record: borrowing BAMRecord) {
+        let core = record.pointer.pointee.core
+        let flag = UInt32(core.flag)
+        let unmapped = flag & UInt32(BAM_FUNMAP) != 0
+        let primary = flag & UInt32(BAM_FSECONDARY | BAM_FSUPPLEMENTARY) == 0
+
+        if collectors.contains(.flags) {
+            if flag & UInt32(BAM_FQCFAIL) != 0 {
+                Self.count(&failed, core: core, flag: flag)
+            } else {
+                Self.count(&passed, core: core, flag: flag)
+            }
+        }
+        guard primary else { return }
+
+        if collectors.contains(.mappingQuality) && !unmapped {
+            mappingQuality.add(Int(core.qual))
+        }
+        if collectors.contains(.insertSize) && core.isize > 0 && !unmapped
+            && flag & UInt32(BAM_FPAIRED | BAM_FMUNMAP) == UInt32(BAM_FPAIRED) && core.tid == core.mtid {
+            insertSize.add(core.isize > Int64(Int.max) ? Int.max : Int(core.isize))
+        }
+        if collectors.contains(.readLength) {
+            readLength.add(Int(core.l_qseq))
+        }
+        if collectors.contains(.baseQuality) {
+            let qualities = record.qualities
+            if qualities.isAvailable {
+                baseQuality.addQualities(qualities.buffer)
+            }
+        }
+    }
+
+    @inline(__always)
+    private static func count(_ c: inout FlagCounts, core: bam1_core_t, flag: UInt32) {
+        let unmapped = flag & UInt32(BAM_FUNMAP) != 0
+        let duplicate = flag & UInt32(BAM_FDUP) != 0
+        c.total += 1
+        if flag & UInt32(BAM_FSECONDARY) != 0 {
+            c.secondary += 1
+        } else if flag & UInt32(BAM_FSUPPLEMENTARY) != 0 {
+            c.supplementary += 1
+        } else {
+            c.primary += 1
+            if flag & UInt32(BAM_FPAIRED) != 0 {
+                c.paired += 1
+                if flag & UInt32(BAM_FPROPER_PAIR) != 0 && !unmapped { c.properlyPaired += 1 }
+                if flag & UInt32(BAM_FREAD1) != 0 { c.read1 += 1 }
+                if flag & UInt32(BAM_FREAD2) != 0 { c.read2 += 1 }
+                if !unmapped {
+                    if flag & UInt32(BAM_FMUNMAP) != 0 {
+                        c.singletons += 1
+                    } else {
+                        c.bothMapped += 1
+                        if core.mtid != core.tid {
+                            c.mateOnDifferentContig += 1
+                            if core.qual >= 5 { c.mateOnDifferentContigMapQ5 += 1 }
+                        }
+                    }
+                }
+            }
+            if !unmapped { c.primaryMapped += 1 }
+            if duplicate { c.primaryDuplicates += 1 }
+        }
+        if !unmapped { c.mapped += 1 }
+        if duplicate { c.duplicates += 1 }
+    }
+
+    /// Add another accumulator's counts to this one.
+    ///
+    /// - Parameter other: Statistics from another part of the input, gathered with the
+    ///   same collectors.
+    public mutating func merge(_ other: AlignmentStats) {
+        passed.merge(other.passed)
+        failed.merge(other.failed)
+        insertSize.merge(other.insertSize)
+        mappingQuality.merge(other.mappingQuality)
+        readLength.merge(other.readLength)
+        baseQuality.merge(other.baseQuality)
+    }
+
+    // MARK: - Collecting
+
+    /// Gather statistics from every remaining record of an iterator.
+    ///
+    /// - Parameters:
+    ///   - iterator: The source; its filter, if any, applies.
+    ///   - collectors: The statistics to gather.
+    ///   - maxInsertSize: Insert sizes at or above this are counted as overflow.
+    /// - Returns: The statistics.
+    /// - Throws: ``HTSError/readFailed(code:)`` on a read error.
+    public static func collect(_ iterator: SAMRecordIterator, collectors: Collectors = .all,
+                               maxInsertSize: Int = 8000) throws -> AlignmentStats {
+        var stats = AlignmentStats(collectors: collectors, maxInsertSize: maxInsertSize)
+        var record = try BAMRecord()
+        while try iterator.read(into: &record) {
+            stats.add(record)
+        }
+        return stats
+    }
+
+    /// Gather statistics across the shards of an indexed file, one accumulator per task.
+    ///
+    /// - Parameters:
+    ///   - scanner: The scanner for the indexed file.
+    ///   - shards: A precomputed plan, or `nil` to plan with the scanner.
+    ///   - collectors: The statistics to gather.
+    ///   - maxInsertSize: Insert sizes at or above this are counted as overflow.
+    /// - Returns: The merged statistics.
+    /// - Throws: Any error from planning or scanning.
+    public static func collect(_ scanner: ParallelBAMScanner, shards: [BAMShard]? = nil,
+                               collectors: Collectors = .all,
+                               maxInsertSize: Int = 8000) async throws -> AlignmentStats {
+        try await scanner.scan(
+            shards: shards,
+            initial: { AlignmentStats(collectors: collectors, maxInsertSize: maxInsertSize) },
+            process: { stats, record in stats.add(record) },
+            merge: { total, part in total.merge(part) })
+    }
+
+    // MARK: - Index statistics
+
+    /// Per-contig record counts from an index, like `samtools idxstats`.
+    public struct IndexStatistics: Sendable {
+        /// One contig's counts.
+        public struct Contig: Sendable, Equatable {
+            public let name: String
+            public let length: Int64
+            public let mapped: UInt64
+            public let unmapped: UInt64
+        }
+
+        /// Every contig in header order.
+        public let contigs: [Contig]
+        /// Unplaced records (no reference or position).
+        public let unplaced: UInt64
+
+        /// Mapped records over all contigs.
+        public var mapped: UInt64 { contigs.reduce(0) { $0 + $1.mapped } }
+
+        /// Unmapped records, placed and unplaced.
+        public var unmapped: UInt64 { contigs.reduce(unplaced) { $0 + $1.unmapped } }
+
+        /// `samtools idxstats` text: name, length, mapped and unmapped per line, with the
+        /// unplaced count on a final `*` line.
+        public func tsv() -> String {
+            var text = ""
+            for contig in contigs {
+                text += "\(contig.name)\t\(contig.length)\t\(contig.mapped)\t\(contig.unmapped)\n"
+            }
+            text += "*\t0\t0\t\(unplaced)\n"
+            return text
+        }
+
+        /// A JSON object with a `contigs` array and an `unplaced` count.
+        public func json() -> String {
+            let rows = contigs.map {
+                "{\"name\":\(AlignmentStats.jsonString($0.name)),\"length\":\($0.length),"
+                    + "\"mapped\":\($0.mapped),\"unmapped\":\($0.unmapped)}"
+            }
+            return "{\"contigs\":[" + rows.joined(separator: ",") + "],\"unplaced\":\(unplaced)}"
+        }
+    }
+
+    /// Read per-contig mapped and unmapped counts from a BAM's BAI or CSI index, without
+    /// reading any records.
+    ///
+    /// - Parameter path: Path to the indexed alignment file.
+    /// - Returns: The counts for every contig in the header.
+    /// - Throws: ``HTSError/indexLoadFailed(path:)`` if the index is missing or is a CRAI,
+    ///   which does not record counts, or errors from reading the header.
+    public static func indexStatistics(path: String) throws -> IndexStatistics {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: path)
+        guard hts_idx_fmt(index.pointer) != HTS_FMT_CRAI else { throw HTSError.indexLoadFailed(path: path) }
+        var contigs: [IndexStatistics.Contig] = []
+        contigs.reserveCapacity(Int(max(header.nTargets, 0)))
+        for tid in 0..<header.nTargets {
+            // Contigs with no records may be absent from the index.
+            let counts = index.recordCounts(contigID: tid) ?? (0, 0)
+            contigs.append(IndexStatistics.Contig(name: header.targetName(at: tid) ?? "",
+                                                  length: header.targetLength(at: tid),
+                                                  mapped: counts.mapped, unmapped: counts.unmapped))
+        }
+        return IndexStatistics(contigs: contigs, unplaced: index.unplacedRecords)
+    }
+
+    // MARK: - Reports
+
+    /// A tab-separated report in the style of `samtools stats`: one section per line prefix.
+    ///
+    /// `FS` lines hold flag counts (`name`, passed, failed); `IS`, `MAPQ`, `RL` and `BQ`
+    /// lines hold non-empty histogram bins (value, count); an `SN` line per histogram gives
+    /// its overflow count. Sections for collectors that did not run are omitted.
+    public func tsv() -> String {
+        var text = ""
+        if collectors.contains(.flags) {
+            for ((name, pass), (_, fail)) in zip(passed.fields, failed.fields) {
+                text += "FS\t\(name)\t\(pass)\t\(fail)\n"
+            }
+        }
+        for (collector, prefix, _, histogram) in reportedHistograms {
+            guard collectors.contains(collector) else { continue }
+            text += "SN\t\(prefix) overflow\t\(histogram.overflow)\n"
+            for (value, count) in histogram.nonEmptyBins {
+                text += "\(prefix)\t\(value)\t\(count)\n"
+            }
+        }
+        return text
+    }
+
+    /// A JSON object with `flags` (`passed` and `failed` objects) and one object per
+    /// histogram holding `overflow`, `mean` and `counts` as `[value, count]` pairs.
+    public func json() -> String {
+        var members: [String] = []
+        if collectors.contains(.flags) {
+            func object(_ counts: FlagCounts) -> String {
+                "{" + counts.fields.map { "\"\($0.0)\":\($0.1)" }.joined(separator: ",") + "}"
+            }
+            members.append("\"flags\":{\"passed\":\(object(passed)),\"failed\":\(object(failed))}")
+        }
+        for (collector, _, key, histogram) in reportedHistograms where collectors.contains(collector) {
+            let bins = histogram.nonEmptyBins.map { "[\($0.0),\($0.1)]" }.joined(separator: ",")
+            members.append("\"\(key)\":{\"overflow\":\(histogram.overflow),\"mean\":\(histogram.mean),"
+                           + "\"counts\":[\(bins)]}")
+        }
+        return "{" + members.joined(separator: ",") + "}"
+    }
+
+    /// Each histogram with its collector, text prefix and JSON key.
+    private var reportedHistograms: [(Collectors, String, String, Histogram)] {
+        [(.insertSize, "IS", "insert_size", insertSize),
+         (.mappingQuality, "MAPQ", "mapping_quality", mappingQuality),
+         (.readLength, "RL", "read_length", readLength),
+         (.baseQuality, "BQ", "base_quality", baseQuality)]
+    }
+
+    /// `value` as a quoted JSON string.
+    static func jsonString(_ value: String) -> String {
+        var out = "\""
+        for scalar in value.unicodeScalars {
+            switch scalar {
+            case "\"": out += "\\\""
+            case "\\": out += "\\\\"
+            case "\n": out += "\\n"
+            case "\t": out += "\\t"
+            case _ where scalar.value < 0x20:
+                let hex = String(scalar.value, radix: 16)
+                out += "\\u" + String(repeating: "0", count: 4 - hex.count) + hex
+            default: out.unicodeScalars.append(scalar)
+            }
+        }
+        return out + "\""
+    }
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - AlignmentWriter
+
+/// A write-behind SAM/BAM/CRAM writer that can index its output as it goes.
+///
+/// ``HTSFile/write(record:header:)`` encodes and writes on the caller, and indexing the
+/// result takes a second pass with ``HTSIndex/build(path:minShift:nThreads:)``. Here each
+/// record is copied into a queued batch and returned to the caller straight away; a writer
+/// thread drains batches in order, and BGZF compression runs on the attached
+/// ``ThreadPool``. With ``WriterOptions/buildIndex`` the BAI/CSI/CRAI index is built from
+/// the records as they are written and saved by ``close()``.
+///
+/// ```swift
+/// let pool = try ThreadPool(threads: 8)
+/// let writer = try AlignmentWriter(path: "out.bam", header: header,
+///                                  options: .init(buildIndex: true), pool: pool)
+/// try input.samIterator(header: header).forEach { try writer.write($0) }
+/// let stats = try writer.close()   // out.bam and out.bam.bai are complete
+/// ```
+///
+/// A writer takes records from one thread at a time. The pool must outlive the writer.
+/// A writer that is not closed is closed on deinitialization, ignoring errors.
+public final class AlignmentWriter {
+    /// The header written to the output.
+    public let header: SAMHeader
+    private let core: RecordWriterCore
+
+    /// The output path.
+    public var path: String { core.path }
+
+    /// Records written to the file so far; queued records are not counted until written.
+    public var recordsWritten: Int { core.recordsWritten }
+
+    /// Open an output whose compression runs on the writer thread.
+    ///
+    /// - Parameters:
+    ///   - path: The output path.
+    ///   - header: The header to write; it must outlive the writer.
+    ///   - mode: The htslib open mode, e.g. `"wb"` for BAM or `"wc"` for CRAM.
+    ///   - options: Queueing and indexing settings.
+    /// - Throws: ``HTSError/openFailed(path:mode:)``, ``HTSError/headerWriteFailed`` or
+    ///   ``HTSError/indexBuildFailed(path:code:)``.
+    public init(path: String, header: SAMHeader, mode: String = "wb", options: WriterOptions = WriterOptions()) throws {
+        self.header = header
+        core = try RecordWriterCore(path: path, mode: mode, kind: .alignment, options: options, pool: nil,
+                                    header: UnsafeMutableRawPointer(header.pointer)) { sam_hdr_write($0, header.pointer) }
+    }
+
+    /// Open an output whose BGZF compression runs on a shared thread pool.
+    ///
+    /// - Parameters:
+    ///   - path: The output path.
+    ///   - header: The header to write; it must outlive the writer.
+    ///   - mode: The htslib open mode, e.g. `"wb"` for BAM or `"wc"` for CRAM.
+    ///   - options: Queueing and indexing settings.
+    ///   - pool: The pool for compression. It must outlive the writer.
+    /// - Throws: ``HTSError/openFailed(path:mode:)``, ``HTSError/headerWriteFailed`` or
+    ///   ``HTSError/indexBuildFailed(path:code:)``.
+    public init(path: String, header: SAMHeader, mode: String = "wb", options: WriterOptions = WriterOptions(),
+                pool: borrowing ThreadPool) throws {
+        try self.init(path: path, header: header, mode: mode, options: options, poolPointer: pool.pointer)
+    }
+
+    /// Open an output attached to a pool held elsewhere, or to none when `poolPointer` is `nil`.
+    init(path: String, header: SAMHeader, mode: String, options: WriterOptions, poolPointer: OpaquePointer?) throws {
+        self.header = header
+        core = try RecordWriterCore(path: path, mode: mode, kind: .alignment, options: options, pool: poolPointer,
+                                    header: UnsafeMutableRawPointer(header.pointer)) { sam_hdr_write($0, header.pointer) }
+    }
+
+    /// Queue a copy of a record for writing.
+    ///
+    /// - Parameter record: The record to write; the caller may reuse it immediately.
+    /// - Throws: ``HTSError/writeFailed(code:)`` if this or an earlier queued write failed.
+    public func write(_ record: borrowing BAMRecord) throws {
+        try write(pointer: record.pointer)
+    }
+
+    /// Queue a copy of every record in a batch.
+    ///
+    /// - Parameter batch: The records to write; the caller may refill the batch immediately.
+    /// - Throws: ``HTSError/writeFailed(code:)`` if a write failed.
+    public func write(_ batch: BAMRecordBatch) throws {
+        for i in 0..<batch.count {
+            try write(pointer: batch[i].pointer)
+        }
+    }
+
+    private func write(pointer: UnsafePointer<bam1_t>) throws {
+        let slot = try core.slot().assumingMemoryBound(to: bam1_t.self)
+        guard bam_copy1(slot, pointer) != nil else { throw HTSError.outOfMemory }
+        try core.commit()
+    }
+
+    /// Wait until every queued record has been written.
+    ///
+    /// - Throws: ``HTSError/writeFailed(code:)`` if a write failed.
+    public func flush() throws {
+        try core.flush()
+    }
+
+    /// Write the remaining records, save the index if one is being built, and close the file.
+    ///
+    /// - Returns: The writer's ``WriterStatistics``.
+    /// - Throws: ``HTSError/writeFailed(code:)``, ``HTSError/indexBuildFailed(path:code:)``
+    ///   or ``HTSError/closeFailed(code:)``.
+    @discardableResult
+    public func close() throws -> WriterStatistics {
+        try core.close()
+    }
+}
@@ -0,0 +1,155 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+
+// MARK: - AuxTag
+
+/// A two-character auxiliary tag key, stored as the two raw bytes of the tag.
+///
+/// Using an `AuxTag` instead of a `String` avoids bridging the tag to a C string on
+/// every lookup. Common SAM tags are available as static members; any other tag can be
+/// written as a string literal.
+///
+/// ```swift
+/// let nm = record.auxiliaryData.integer(forTag: .NM)
+/// let custom: AuxTag = "XT"
+/// ```
+public struct AuxTag: RawRepresentable, Hashable, Sendable, ExpressibleByStringLiteral, CustomStringConvertible {
+    /// The tag bytes, first character in the low byte (the in-memory BAM layout).
+    public let rawValue: UInt16
+
+    public init(rawValue: UInt16) {
+        self.rawValue = rawValue
+    }
+
+    /// Create a tag from its two ASCII bytes.
+    public init(_ first: UInt8, _ second: UInt8) {
+        self.rawValue = UInt16(first) | UInt16(second) << 8
+    }
+
+    /// Create a tag from a string, or `nil` if it is not exactly two bytes.
+    public init?(_ string: String) {
+        var utf8 = string.utf8.makeIterator()
+        guard let first = utf8.next(), let second = utf8.next(), utf8.next() == nil else { return nil }
+        self.init(first, second)
+    }
+
+    public init(stringLiteral value: StaticString) {
+        precondition(value.utf8CodeUnitCount == 2, "Aux tags must be exactly 2 characters")
+        self.init(value.utf8Start[0], value.utf8Start[1])
+    }
+
+    /// The first character of the tag.
+    public var first: UInt8 { UInt8(truncatingIfNeeded: rawValue) }
+
+    /// The second character of the tag.
+    public var second: UInt8 { UInt8(truncatingIfNeeded: rawValue >> 8) }
+
+    public var description: String {
+        String(decoding: [first, second], as: UTF8.self)
+    }
+
+    /// Call `body` with the tag as a two-byte C character array.
+    @inline(__always)
+    internal func withCTag<R>(_ body: (UnsafePointer<CChar>) throws -> R) rethrows -> R {
+        try withUnsafeBytes(of: rawValue.littleEndian) { bytes in
+            try body(bytes.baseAddress!.assumingMemoryBound(to: CChar.self))
+        }
+    }
+}
+
+// MARK: - Standard tags
+
+extension AuxTag {
+    /// Alignment score.
+    public static let AS: AuxTag = "AS"
+    /// Sample barcode sequence.
+    public static let BC: AuxTag = "BC"
+    /// Barcode for linked/10x reads.
+    public static let BX: AuxTag = "BX"
+    /// Cell identifier.
+    public static let CB: AuxTag = "CB"
+    /// Mate CIGAR.
+    public static let MC: AuxTag = "MC"
+    /// Mismatching positions string.
+    public static let MD: AuxTag = "MD"
+    /// Molecular identifier.
+    public static let MI: AuxTag = "MI"
+    /// Base modification probabilities.
+    public static let ML: AuxTag = "ML"
+    /// Base modifications.
+    public static let MM: AuxTag = "MM"
+    /// Mate mapping quality.
+    public static let MQ: AuxTag = "MQ"
+    /// Number of reported alignments.
+    public static let NH: AuxTag = "NH"
+    /// Edit distance to the reference.
+    public static let NM: AuxTag = "NM"
+    /// Original base qualities.
+    public static let OQ: AuxTag = "OQ"
+    /// Program.
+    public static let PG: AuxTag = "PG"
+    /// Phase set.
+    public static let PS: AuxTag = "PS"
+    /// Read group.
+    public static let RG: AuxTag = "RG"
+    /// Raw UMI sequence.
+    public static let RX: AuxTag = "RX"
+    /// Supplementary alignments.
+    public static let SA: AuxTag = "SA"
+    /// Corrected UMI.
+    public static let UB: AuxTag = "UB"
+    /// Suboptimal alignment score (BWA/minimap2).
+    public static let XS: AuxTag = "XS"
+}
+
+// MARK: - AuxArray
+
+/// An element type of a BAM `B` (numeric array) tag.
+public protocol AuxArrayElement: BitwiseCopyable, Sendable {
+    /// The BAM array subtype character (`c`, `C`, `s`, `S`, `i`, `I`, `f`).
+    static var auxSubtype: UInt8 { get }
+}
+
+extension Int8: AuxArrayElement { public static var auxSubtype: UInt8 { UInt8(ascii: "c") } }
+extension UInt8: AuxArrayElement { public static var auxSubtype: UInt8 { UInt8(ascii: "C") } }
+extension Int16: AuxArrayElement { public static var auxSubtype: UInt8 { UInt8(ascii: "s") } }
+extension UInt16: AuxArrayElement { public static var auxSubtype: UInt8 { UInt8(ascii: "S") } }
+extension Int32: AuxArrayElement { public static var auxSubtype: UInt8 { UInt8(ascii: "i") } }
+extension UInt32: AuxArrayElement { public static var auxSubtype: UInt8 { UInt8(ascii: "I") } }
+extension Float: AuxArrayElement { public static var auxSubtype: UInt8 { UInt8(ascii: "f") } }
+
+/// A zero-copy view of a `B` array tag's elements.
+///
+/// The view points into the record's auxiliary block and is valid only while the record
+/// is unchanged. Array data in BAM is not aligned, so elements are read with unaligned
+/// loads; use ``copy(into:)`` to move the whole array into aligned storage in one go.
+public struct AuxArray<Element: AuxArrayElement>: RandomAccessCollection, @unchecked Sendable {
+    /// The raw element bytes.
+    public let bytes: UnsafeRawBufferPointer
+
+    internal init(bytes: UnsafeRawBufferPointer) {
+        self.bytes = bytes
+    }
+
+    public var startIndex: Int { 0 }
+    public var endIndex: Int { bytes.count / MemoryLayout<Element>.size }
+
+    public subscript(position: Int) -> Element {
+        precondition(position >= 0 && position < endIndex, "Index out of range")
+        return bytes.loadUnaligned(fromByteOffset: position * MemoryLayout<Element>.size, as: Element.self)
+    }
+
+    /// Copy the elements into `destination`.
+    ///
+    /// - Parameter destination: A buffer with room for at least ``count`` elements.
+    /// - Returns: The number of elements copied.
+    @discardableResult
+    public func copy(into destination: UnsafeMutableBufferPointer<Element>) -> Int {
+        let n = Swift.min(count, destination.count)
+        guard n > 0, let dst = destination.baseAddress, let src = bytes.baseAddress else { return 0 }
+        UnsafeMutableRawPointer(dst).copyMemory(from: src, byteCount: n * MemoryLayout<Element>.size)
+        return n
+    }
+}
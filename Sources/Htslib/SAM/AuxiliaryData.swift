@@ -6,8 +6,10 @@ import CHTSlibShims
 
 /// Provides typed access to the auxiliary (tag) data of a BAM record.
 ///
-/// Each auxiliary tag is identified by a two-character string (e.g. `"NM"`, `"RG"`).
-/// Use the typed accessors to retrieve values by tag name.
+/// Each auxiliary tag is identified by a two-character key: an ``AuxTag`` (e.g. `.NM`,
+/// `.RG`) or a `String`. Use the typed accessors to retrieve values by tag. Each lookup
+/// scans the auxiliary block; to read several tags from the same record, load it into an
+/// ``AuxiliaryIndex`` once instead.
 public struct AuxiliaryData: @unchecked Sendable {
     nonisolated(unsafe) private let record: UnsafePointer<bam1_t>
 
@@ -15,14 +17,20 @@ public struct AuxiliaryData: @unchecked Sendable {
         self.record = record
     }
 
-    /// Get raw aux tag data. Returns nil if tag not found.
-    private func rawGet(_ tag: String) -> UnsafePointer<UInt8>? {
-        precondition(tag.count == 2, "Aux tags must be exactly 2 characters")
-        return tag.withCString { tagPtr in
+    /// Get raw aux tag data (pointing at the type byte). Returns nil if tag not found.
+    private func rawGet(_ tag: AuxTag) -> UnsafePointer<UInt8>? {
+        tag.withCTag { tagPtr in
             bam_aux_get(record, tagPtr).map { UnsafePointer($0) }
         }
     }
 
+    private func rawGet(_ tag: String) -> UnsafePointer<UInt8>? {
+        guard let key = AuxTag(tag) else {
+            preconditionFailure("Aux tags must be exactly 2 characters")
+        }
+        return rawGet(key)
+    }
+
     /// Check whether the given auxiliary tag is present on this record.
     ///
     /// - Parameter tag: A two-character tag name (e.g. `"NM"`).
@@ -31,16 +39,29 @@ public struct AuxiliaryData: @unchecked Sendable {
         rawGet(tag) != nil
     }
 
+    /// Check whether the given auxiliary tag is present on this record.
+    ///
+    /// - Parameter tag: The tag key.
+    /// - Returns: `true` if the tag exists.
+    public func contains(_ tag: AuxTag) -> Bool {
+        rawGet(tag) != nil
+    }
+
     /// Get an integer value for the given tag.
     ///
     /// Works with BAM types `c`, `C`, `s`, `S`, `i`, `I`.
     /// - Parameter tag: A two-character tag name.
     /// - Returns: The integer value, or `nil` if the tag is absent or not an integer type.
     public func integer(forTag tag: String) -> Int64? {
-        guard let data = rawGet(tag) else { return nil }
-        errno = 0
-        let val = bam_aux2i(UnsafeMutablePointer(mutating: data))
-        return errno == EINVAL ? nil : val
+        rawGet(tag).flatMap(AuxDecoder.integer)
+    }
+
+    /// Get an integer value for the given tag.
+    ///
+    /// - Parameter tag: The tag key.
+    /// - Returns: The integer value, or `nil` if the tag is absent or not an integer type.
+    public func integer(forTag tag: AuxTag) -> Int64? {
+        rawGet(tag).flatMap(AuxDecoder.integer)
     }
 
     /// Get a floating-point value for the given tag.
@@ -49,10 +70,15 @@ public struct AuxiliaryData: @unchecked Sendable {
     /// - Parameter tag: A two-character tag name.
     /// - Returns: The float value, or `nil` if the tag is absent or not a float type.
     public func float(forTag tag: String) -> Double? {
-        guard let data = rawGet(tag) else { return nil }
-        errno = 0
-        let val = bam_aux2f(UnsafeMutablePointer(mutating: data))
-        return errno == EINVAL ? nil : val
+        rawGet(tag).flatMap(AuxDecoder.float)
+    }
+
+    /// Get a floating-point value for the given tag.
+    ///
+    /// - Parameter tag: The tag key.
+    /// - Returns: The float value, or `nil` if the tag is absent or not a float type.
+    public func float(forTag tag: AuxTag) -> Double? {
+        rawGet(tag).flatMap(AuxDecoder.float)
     }
 
     /// Get a single character value for the given tag.
@@ -61,9 +87,15 @@ public struct AuxiliaryData: @unchecked Sendable {
     /// - Parameter tag: A two-character tag name.
     /// - Returns: The character, or `nil` if the tag is absent or not a character type.
     public func character(forTag tag: String) -> Character? {
-        guard let data = rawGet(tag) else { return nil }
-        let val = bam_aux2A(UnsafeMutablePointer(mutating: data))
-        return val == 0 ? nil : Character(UnicodeScalar(UInt8(bitPattern: val)))
+        rawGet(tag).flatMap(AuxDecoder.character)
+    }
+
+    /// Get a single character value for the given tag.
+    ///
+    /// - Parameter tag: The tag key.
+    /// - Returns: The character, or `nil` if the tag is absent or not a character type.
+    public func character(forTag tag: AuxTag) -> Character? {
+        rawGet(tag).flatMap(AuxDecoder.character)
     }
 
     /// Get a string value for the given tag.
@@ -72,9 +104,15 @@ public struct AuxiliaryData: @unchecked Sendable {
     /// - Parameter tag: A two-character tag name.
     /// - Returns: The string value, or `nil` if the tag is absent or not a string type.
     public func string(forTag tag: String) -> String? {
-        guard let data = rawGet(tag) else { return nil }
-        guard let str = bam_aux2Z(UnsafeMutablePointer(mutating: data)) else { return nil }
-        return String(cString: str)
+        rawGet(tag).flatMap(AuxDecoder.string)
+    }
+
+    /// Get a string value for the given tag.
+    ///
+    /// - Parameter tag: The tag key.
+    /// - Returns: The string value, or `nil` if the tag is absent or not a string type.
+    public func string(forTag tag: AuxTag) -> String? {
+        rawGet(tag).flatMap(AuxDecoder.string)
     }
 
     /// Get the length of an array-typed tag.
@@ -83,9 +121,7 @@ public struct AuxiliaryData: @unchecked Sendable {
     /// - Parameter tag: A two-character tag name.
     /// - Returns: The number of elements, or `nil` if the tag is absent or not an array.
     public func arrayLength(forTag tag: String) -> UInt32? {
-        guard let data = rawGet(tag) else { return nil }
-        let len = bam_auxB_len(UnsafeMutablePointer(mutating: data))
-        return len == 0 && errno == EINVAL ? nil : len
+        rawGet(tag).flatMap(AuxDecoder.arrayLength)
     }
 
     /// Get an integer element from an array-typed tag.
@@ -113,6 +149,63 @@ public struct AuxiliaryData: @unchecked Sendable {
         let val = bam_auxB2f(UnsafeMutablePointer(mutating: data), index)
         return errno == EINVAL ? nil : val
     }
+
+    /// Get a zero-copy view of a `B` array tag.
+    ///
+    /// ```swift
+    /// if let probs = record.auxiliaryData.array(forTag: .ML, as: UInt8.self) {
+    ///     for p in probs { ... }
+    /// }
+    /// ```
+    ///
+    /// - Parameters:
+    ///   - tag: The tag key.
+    ///   - type: The element type; must match the array's subtype exactly.
+    /// - Returns: The elements, or `nil` if the tag is absent, not an array, or has a
+    ///   different subtype.
+    public func array<Element: AuxArrayElement>(forTag tag: AuxTag, as type: Element.Type = Element.self) -> AuxArray<Element>? {
+        rawGet(tag).flatMap { AuxDecoder.array($0, as: type) }
+    }
+}
+
+// MARK: - AuxDecoder
+
+/// Typed decoders for a single aux field, given a pointer to its type byte.
+internal enum AuxDecoder {
+    static func integer(_ data: UnsafePointer<UInt8>) -> Int64? {
+        errno = 0
+        let val = bam_aux2i(UnsafeMutablePointer(mutating: data))
+        return errno == EINVAL ? nil : val
+    }
+
+    static func float(_ data: UnsafePointer<UInt8>) -> Double? {
+        errno = 0
+        let val = bam_aux2f(UnsafeMutablePointer(mutating: data))
+        return errno == EINVAL ? nil : val
+    }
+
+    static func character(_ data: UnsafePointer<UInt8>) -> Character? {
+        let val = bam_aux2A(UnsafeMutablePointer(mutating: data))
+        return val == 0 ? nil : Character(UnicodeScalar(UInt8(bitPattern: val)))
+    }
+
+    static func string(_ data: UnsafePointer<UInt8>) -> String? {
+        guard let str = bam_aux2Z(UnsafeMutablePointer(mutating: data)) else { return nil }
+        return String(cString: str)
+    }
+
+    static func arrayLength(_ data: UnsafePointer<UInt8>) -> UInt32? {
+        errno = 0
+        let len = bam_auxB_len(UnsafeMutablePointer(mutating: data))
+        return len == 0 && errno == EINVAL ? nil : len
+    }
+
+    static func array<Element: AuxArrayElement>(_ data: UnsafePointer<UInt8>, as _: Element.Type) -> AuxArray<Element>? {
+        guard data[0] == UInt8(ascii: "B"), data[1] == Element.auxSubtype else { return nil }
+        let count = UnsafeRawPointer(data + 2).loadUnaligned(as: UInt32.self)
+        return AuxArray(bytes: UnsafeRawBufferPointer(start: data + 6,
+                                                      count: Int(count) * MemoryLayout<Element>.size))
+    }
 }
 
 // MARK: - MutableAuxiliaryData
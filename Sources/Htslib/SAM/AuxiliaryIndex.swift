@@ -0,0 +1,189 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+/// A one-pass index of a record's auxiliary tags.
+///
+/// ``AuxiliaryData`` lookups each rescan the auxiliary block with `bam_aux_get`. Loading a
+/// record into an `AuxiliaryIndex` walks the block once and records the tag, type, and
+/// offset of every field, so any number of lookups afterwards are a short search over the
+/// recorded keys. The index keeps grow-only storage and can be reused across records
+/// without allocating.
+///
+/// ```swift
+/// let tags = AuxiliaryIndex()
+/// try iterator.forEach { record in
+///     tags.load(record)
+///     let nm = tags.integer(forTag: .NM)
+///     let rg = tags.string(forTag: .RG)
+/// }
+/// ```
+///
+/// The index points into the loaded record and is valid only until that record is
+/// modified, reused, or freed.
+public final class AuxiliaryIndex {
+    private var keys: UnsafeMutablePointer<UInt16>
+    private var offsets: UnsafeMutablePointer<Int32>
+    private var capacity: Int
+    private var base: UnsafePointer<UInt8>?
+    /// The number of tags on the loaded record.
+    public private(set) var count: Int = 0
+    /// Whether the last load stopped at a malformed field.
+    public private(set) var isTruncated = false
+
+    /// Create an index with room for `capacity` tags before it needs to grow.
+    public init(capacity: Int = 16) {
+        self.capacity = max(capacity, 1)
+        self.keys = .allocate(capacity: self.capacity)
+        self.offsets = .allocate(capacity: self.capacity)
+    }
+
+    deinit {
+        keys.deallocate()
+        offsets.deallocate()
+    }
+
+    /// Index the auxiliary fields of a record, replacing the previous one.
+    public func load(_ record: borrowing BAMRecord) {
+        load(UnsafePointer(record.pointer))
+    }
+
+    /// Index the auxiliary fields of a batch record, replacing the previous one.
+    public func load(_ record: BAMRecordView) {
+        load(record.pointer)
+    }
+
+    private func load(_ record: UnsafePointer<bam1_t>) {
+        count = 0
+        isTruncated = false
+        let length = Int(hts_shim_bam_get_l_aux(record))
+        guard length > 0, let aux = hts_shim_bam_get_aux(record) else {
+            base = nil
+            return
+        }
+        let data = UnsafePointer(aux)
+        base = data
+        var p = 0
+        while p + 3 <= length {
+            guard let size = Self.valueSize(data + p + 2, available: length - p - 3) else {
+                isTruncated = true
+                return
+            }
+            append(key: UInt16(data[p]) | UInt16(data[p + 1]) << 8, offset: Int32(p + 2))
+            p += 3 + size
+        }
+        if p != length { isTruncated = true }
+    }
+
+    private func append(key: UInt16, offset: Int32) {
+        if count == capacity {
+            let newCapacity = capacity * 2
+            let newKeys = UnsafeMutablePointer<UInt16>.allocate(capacity: newCapacity)
+            let newOffsets = UnsafeMutablePointer<Int32>.allocate(capacity: newCapacity)
+            newKeys.update(from: keys, count: count)
+            newOffsets.update(from: offsets, count: count)
+            keys.deallocate()
+            offsets.deallocate()
+            keys = newKeys
+            offsets = newOffsets
+            capacity = newCapacity
+        }
+        keys[count] = key
+        offsets[count] = offset
+        count += 1
+    }
+
+    /// Bytes following the type byte at `type`, or `nil` if the field is malformed.
+    private static func valueSize(_ type: UnsafePointer<UInt8>, available: Int) -> Int? {
+        let size: Int
+        switch type[0] {
+        case UInt8(ascii: "A"), UInt8(ascii: "c"), UInt8(ascii: "C"): size = 1
+        case UInt8(ascii: "s"), UInt8(ascii: "S"): size = 2
+        case UInt8(ascii: "i"), UInt8(ascii: "I"), UInt8(ascii: "f"): size = 4
+        case UInt8(ascii: "d"): size = 8
+        case UInt8(ascii: "Z"), UInt8(ascii: "H"):
+            var n = 0
+            while n < available, type[1 + n] != 0 { n += 1 }
+            size = n + 1
+        case UInt8(ascii: "B"):
+            guard available >= 5 else { return nil }
+            let elementSize: Int
+            switch type[1] {
+            case UInt8(ascii: "c"), UInt8(ascii: "C"): elementSize = 1
+            case UInt8(ascii: "s"), UInt8(ascii: "S"): elementSize = 2
+            case UInt8(ascii: "i"), UInt8(ascii: "I"), UInt8(ascii: "f"): elementSize = 4
+            default: return nil
+            }
+            let n = UnsafeRawPointer(type + 2).loadUnaligned(as: UInt32.self)
+            size = 5 + Int(n) * elementSize
+        default:
+            return nil
+        }
+        return size <= available ? size : nil
+    }
+
+    // MARK: - Lookup
+
+    /// The tags on the loaded record, in file order.
+    public var tags: [AuxTag] {
+        (0..<count).map { AuxTag(rawValue: keys[$0]) }
+    }
+
+    /// Pointer to the type byte of `tag`, or `nil` if absent.
+    private func field(_ tag: AuxTag) -> UnsafePointer<UInt8>? {
+        guard let base else { return nil }
+        let key = tag.rawValue
+        for i in 0..<count where keys[i] == key {
+            return base + Int(offsets[i])
+        }
+        return nil
+    }
+
+    /// Check whether the loaded record has `tag`.
+    public func contains(_ tag: AuxTag) -> Bool {
+        field(tag) != nil
+    }
+
+    /// The BAM type character of `tag` (`A`, `c`, `C`, `s`, `S`, `i`, `I`, `f`, `d`, `Z`, `H`, `B`).
+    public func type(ofTag tag: AuxTag) -> Character? {
+        field(tag).map { Character(UnicodeScalar($0[0])) }
+    }
+
+    /// Get an integer value for the given tag.
+    ///
+    /// - Returns: The integer value, or `nil` if the tag is absent or not an integer type.
+    public func integer(forTag tag: AuxTag) -> Int64? {
+        field(tag).flatMap(AuxDecoder.integer)
+    }
+
+    /// Get a floating-point value for the given tag.
+    ///
+    /// - Returns: The float value, or `nil` if the tag is absent or not a float type.
+    public func float(forTag tag: AuxTag) -> Double? {
+        field(tag).flatMap(AuxDecoder.float)
+    }
+
+    /// Get a single character value for the given tag.
+    ///
+    /// - Returns: The character, or `nil` if the tag is absent or not a character type.
+    public func character(forTag tag: AuxTag) -> Character? {
+        field(tag).flatMap(AuxDecoder.character)
+    }
+
+    /// Get a string value for the given tag.
+    ///
+    /// - Returns: The string value, or `nil` if the tag is absent or not a string type.
+    public func string(forTag tag: AuxTag) -> String? {
+        field(tag).flatMap(AuxDecoder.string)
+    }
+
+    /// Get a zero-copy view of a `B` array tag.
+    ///
+    /// - Returns: The elements, or `nil` if the tag is absent, not an array, or has a
+    ///   different subtype.
+    public func array<Element: AuxArrayElement>(forTag tag: AuxTag, as type: Element.Type = Element.self) -> AuxArray<Element>? {
+        field(tag).flatMap { AuxDecoder.array($0, as: type) }
+    }
+}
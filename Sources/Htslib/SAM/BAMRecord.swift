@@ -58,6 +58,12 @@ public struct BAMRecord: ~Copyable, @unchecked Sendable {
         String(cString: hts_shim_bam_get_qname(pointer))
     }
 
+    /// A 64-bit FNV-1a hash of the query name, computed without creating a `String`.
+    public var queryNameHash: UInt64 {
+        let length = Int(pointer.pointee.core.l_qname) - Int(pointer.pointee.core.l_extranul) - 1
+        return hts_shim_hash_bytes(pointer.pointee.data, max(length, 0))
+    }
+
     /// Whether the read is mapped to the reverse strand.
     public var isReverse: Bool {
         hts_shim_bam_is_rev(pointer) != 0
@@ -171,6 +177,33 @@ public struct BAMRecord: ~Copyable, @unchecked Sendable {
         if ret < 0 { throw HTSError.writeFailed(code: Int32(ret)) }
     }
 
+    /// Overwrite the query sequence in place, keeping its length.
+    ///
+    /// Encodes with ``BAMSequence/encode(_:into:)`` directly into the record's storage,
+    /// avoiding the reallocation performed by ``set(qname:flag:tid:pos:mapq:cigar:mtid:mpos:isize:seq:qual:)``.
+    ///
+    /// - Parameters:
+    ///   - bases: ASCII bases; must have exactly ``sequenceLength`` elements.
+    ///   - qualities: Raw Phred qualities (not ASCII+33) of the same length, or `nil`
+    ///     to leave the existing qualities unchanged.
+    /// - Throws: ``HTSError/invalidArgument(message:)`` if a length does not match.
+    public mutating func setSequence(_ bases: UnsafeBufferPointer<UInt8>,
+                                     qualities: UnsafeBufferPointer<UInt8>? = nil) throws {
+        let length = Int(sequenceLength)
+        guard bases.count == length else {
+            throw HTSError.invalidArgument(message: "Sequence length \(bases.count) does not match record length \(length)")
+        }
+        if let qualities = qualities, qualities.count != length {
+            throw HTSError.invalidArgument(message: "Quality length \(qualities.count) does not match record length \(length)")
+        }
+        guard length > 0 else { return }
+        BAMSequence.encode(bases, into: UnsafeMutableBufferPointer(start: hts_shim_bam_get_seq(pointer),
+                                                                   count: (length + 1) / 2))
+        if let qualities = qualities, let src = qualities.baseAddress {
+            hts_shim_bam_get_qual(pointer).update(from: src, count: length)
+        }
+    }
+
     /// Set the query name of this record.
     ///
     /// - Parameter name: The new query name.
@@ -288,7 +321,63 @@ public struct BAMSequence: RandomAccessCollection, @unchecked Sendable {
 
     /// The full sequence as a `String`.
     public var string: String {
-        String(self.map { $0 })
+        String(unsafeUninitializedCapacity: count) { decode(into: $0) }
+    }
+
+    /// The reverse complement of the full sequence as a `String`.
+    public var reverseComplementString: String {
+        String(unsafeUninitializedCapacity: count) { decodeReverseComplement(into: $0) }
+    }
+
+    // MARK: Bulk decode / encode
+
+    /// Decode bases to ASCII into a caller-provided buffer.
+    ///
+    /// Decodes 32 bases per step with SIMD byte shuffles where available, two bases
+    /// per packed byte otherwise.
+    ///
+    /// - Parameters:
+    ///   - buffer: Destination; must hold at least `range.count` bytes.
+    ///   - range: Base positions to decode, or `nil` for the whole sequence.
+    /// - Returns: The number of bases written.
+    @discardableResult
+    public func decode(into buffer: UnsafeMutableBufferPointer<UInt8>, range: Range<Int>? = nil) -> Int {
+        let r = range ?? 0..<count
+        precondition(r.lowerBound >= 0 && r.upperBound <= count, "Range out of bounds")
+        precondition(buffer.count >= r.count, "Buffer too small for decoded bases")
+        guard !r.isEmpty, let out = buffer.baseAddress else { return 0 }
+        hts_shim_seq_decode(seqPointer, Int64(r.lowerBound), Int64(r.count), out)
+        return r.count
+    }
+
+    /// Decode the reverse complement of bases to ASCII into a caller-provided buffer.
+    ///
+    /// `buffer[0]` receives the complement of the last base in `range`.
+    ///
+    /// - Parameters:
+    ///   - buffer: Destination; must hold at least `range.count` bytes.
+    ///   - range: Base positions to decode, or `nil` for the whole sequence.
+    /// - Returns: The number of bases written.
+    @discardableResult
+    public func decodeReverseComplement(into buffer: UnsafeMutableBufferPointer<UInt8>,
+                                        range: Range<Int>? = nil) -> Int {
+        let r = range ?? 0..<count
+        precondition(r.lowerBound >= 0 && r.upperBound <= count, "Range out of bounds")
+        precondition(buffer.count >= r.count, "Buffer too small for decoded bases")
+        guard !r.isEmpty, let out = buffer.baseAddress else { return 0 }
+        hts_shim_seq_decode_revcomp(seqPointer, Int64(r.lowerBound), Int64(r.count), out)
+        return r.count
+    }
+
+    /// Encode ASCII bases into the 4-bit BAM encoding, two bases per byte.
+    ///
+    /// - Parameters:
+    ///   - bases: ASCII bases (IUPAC codes; anything else encodes as `N`).
+    ///   - packed: Destination; must hold at least `(bases.count + 1) / 2` bytes.
+    public static func encode(_ bases: UnsafeBufferPointer<UInt8>, into packed: UnsafeMutableBufferPointer<UInt8>) {
+        precondition(packed.count >= (bases.count + 1) / 2, "Buffer too small for packed bases")
+        guard let src = bases.baseAddress, let dst = packed.baseAddress else { return }
+        hts_shim_seq_encode(src, Int64(bases.count), dst)
     }
 }
 
@@ -315,4 +404,67 @@ public struct BAMQualities: RandomAccessCollection, @unchecked Sendable {
         precondition(position >= 0 && position < count)
         return qualPointer[position]
     }
+
+    /// The raw quality bytes, valid while the owning record is alive and unmodified.
+    public var buffer: UnsafeBufferPointer<UInt8> {
+        UnsafeBufferPointer(start: qualPointer, count: count)
+    }
+
+    /// Whether qualities are present. BAM stores `0xFF` in the first byte when they are not.
+    public var isAvailable: Bool {
+        count > 0 && qualPointer[0] != 0xFF
+    }
+
+    // MARK: Bulk kernels
+
+    /// Compute mean, minimum, maximum and a below-threshold count in a single pass.
+    ///
+    /// - Parameter threshold: Qualities strictly below this value are counted.
+    /// - Returns: The summary, or `nil` if qualities are unavailable.
+    public func statistics(threshold: UInt8 = 20) -> QualityStatistics? {
+        guard isAvailable else { return nil }
+        var stats = hts_shim_qual_stats_t()
+        hts_shim_qual_stats(qualPointer, Int64(count), threshold, &stats)
+        return QualityStatistics(count: count, sum: stats.sum, minimum: stats.min,
+                                 maximum: stats.max, belowThreshold: Int(stats.below),
+                                 threshold: threshold)
+    }
+
+    /// The mean quality, or `nil` if qualities are unavailable.
+    public var mean: Double? {
+        statistics(threshold: 0)?.mean
+    }
+
+    /// The minimum quality, or `nil` if qualities are unavailable.
+    public var minimum: UInt8? {
+        statistics(threshold: 0)?.minimum
+    }
+
+    /// The number of bases with quality strictly below `threshold` (0 if unavailable).
+    public func count(below threshold: UInt8) -> Int {
+        statistics(threshold: threshold)?.belowThreshold ?? 0
+    }
+
+    /// The read length to keep after BWA-style 3' quality trimming.
+    ///
+    /// Walks back from the 3' end accumulating `threshold - quality` and cuts where the
+    /// running sum peaks, as `bwa aln -q` does.
+    ///
+    /// - Parameter threshold: Quality threshold for trimming.
+    /// - Returns: The number of leading bases to keep (``count`` if unavailable).
+    public func trimmedLength(threshold: Int) -> Int {
+        guard isAvailable else { return count }
+        return Int(hts_shim_qual_trim3(qualPointer, Int64(count), Int32(threshold)))
+    }
+
+    /// The range of bases to keep after BWA-style trimming of both ends.
+    ///
+    /// - Parameter threshold: Quality threshold for trimming.
+    /// - Returns: The retained range; empty if the whole read falls below the threshold.
+    public func trimmedRange(threshold: Int) -> Range<Int> {
+        guard isAvailable else { return 0..<count }
+        let end = Int(hts_shim_qual_trim3(qualPointer, Int64(count), Int32(threshold)))
+        let start = Int(hts_shim_qual_trim5(qualPointer, Int64(end), Int32(threshold)))
+        return start..<max(start, end)
+    }
 }
@@ -0,0 +1,292 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - BAMRecordBatch
+
+/// A batch of alignment records decoded into one contiguous arena.
+///
+/// Core fields are stored struct-of-arrays so filters and histograms can run as tight
+/// loops over ``positions``, ``flags``, ``mappingQualities`` and friends. Variable-length
+/// data (query name, CIGAR, sequence, qualities, aux) for every record is packed into a
+/// single arena and reached through ``subscript(_:)``, which returns a non-owning
+/// ``BAMRecordView``.
+///
+/// The batch is reset (not freed) each time it is refilled, so a scan that reuses one
+/// batch keeps its memory flat once the arena has grown to fit the largest batch.
+///
+/// ```swift
+/// let batch = BAMRecordBatch(capacity: 16_384)
+/// let iter = file.samIterator(header: header)
+/// while try iter.readBatch(into: batch) > 0 {
+///     for (i, mapq) in batch.mappingQualities.enumerated() where mapq >= 30 {
+///         print(batch[i].queryName)
+///     }
+/// }
+/// ```
+public final class BAMRecordBatch: @unchecked Sendable {
+    /// The maximum number of records held by one batch.
+    public let capacity: Int
+    /// The number of records currently in the batch.
+    public private(set) var count: Int = 0
+
+    private let positionStorage: UnsafeMutablePointer<Int64>
+    private let endPositionStorage: UnsafeMutablePointer<Int64>
+    private let contigIDStorage: UnsafeMutablePointer<Int32>
+    private let sequenceLengthStorage: UnsafeMutablePointer<Int32>
+    private let flagStorage: UnsafeMutablePointer<UInt16>
+    private let mappingQualityStorage: UnsafeMutablePointer<UInt8>
+    private let arenaOffsetStorage: UnsafeMutablePointer<Int>
+
+    // Per-record bam1_t headers whose data pointers alias the arena.
+    private let records: UnsafeMutablePointer<bam1_t>
+
+    private var arena: UnsafeMutableRawPointer
+    private var arenaCapacity: Int
+    private var arenaUsed: Int = 0
+
+    /// Create an empty batch.
+    ///
+    /// - Parameters:
+    ///   - capacity: Maximum number of records per batch (typically 4k–64k).
+    ///   - arenaCapacity: Initial arena size in bytes; the arena grows on demand and is
+    ///     never shrunk. Defaults to 512 bytes per record.
+    public init(capacity: Int = 16_384, arenaCapacity: Int? = nil) {
+        precondition(capacity > 0, "Batch capacity must be positive")
+        self.capacity = capacity
+        positionStorage = .allocate(capacity: capacity)
+        endPositionStorage = .allocate(capacity: capacity)
+        contigIDStorage = .allocate(capacity: capacity)
+        sequenceLengthStorage = .allocate(capacity: capacity)
+        flagStorage = .allocate(capacity: capacity)
+        mappingQualityStorage = .allocate(capacity: capacity)
+        arenaOffsetStorage = .allocate(capacity: capacity)
+        records = .allocate(capacity: capacity)
+        records.initialize(repeating: bam1_t(), count: capacity)
+        self.arenaCapacity = max(arenaCapacity ?? capacity * 512, 64)
+        arena = .allocate(byteCount: self.arenaCapacity, alignment: 8)
+    }
+
+    deinit {
+        positionStorage.deallocate()
+        endPositionStorage.deallocate()
+        contigIDStorage.deallocate()
+        sequenceLengthStorage.deallocate()
+        flagStorage.deallocate()
+        mappingQualityStorage.deallocate()
+        arenaOffsetStorage.deallocate()
+        records.deinitialize(count: capacity)
+        records.deallocate()
+        arena.deallocate()
+    }
+
+    // MARK: - Columnar core fields
+
+    /// 0-based leftmost mapping positions, one per record.
+    public var positions: UnsafeBufferPointer<Int64> {
+        UnsafeBufferPointer(start: positionStorage, count: count)
+    }
+
+    /// 0-based exclusive end positions computed from CIGAR, one per record.
+    public var endPositions: UnsafeBufferPointer<Int64> {
+        UnsafeBufferPointer(start: endPositionStorage, count: count)
+    }
+
+    /// Reference sequence IDs, one per record (-1 if unmapped).
+    public var contigIDs: UnsafeBufferPointer<Int32> {
+        UnsafeBufferPointer(start: contigIDStorage, count: count)
+    }
+
+    /// Query sequence lengths in bases, one per record.
+    public var sequenceLengths: UnsafeBufferPointer<Int32> {
+        UnsafeBufferPointer(start: sequenceLengthStorage, count: count)
+    }
+
+    /// Raw SAM FLAG values, one per record. Wrap in ``AlignmentFlag`` for named bits.
+    public var flags: UnsafeBufferPointer<UInt16> {
+        UnsafeBufferPointer(start: flagStorage, count: count)
+    }
+
+    /// Mapping qualities, one per record.
+    public var mappingQualities: UnsafeBufferPointer<UInt8> {
+        UnsafeBufferPointer(start: mappingQualityStorage, count: count)
+    }
+
+    // MARK: - Per-record access
+
+    /// A non-owning view of the record at `index`, valid until the batch is refilled.
+    public subscript(index: Int) -> BAMRecordView {
+        precondition(index >= 0 && index < count, "Batch index out of range")
+        return BAMRecordView(pointer: UnsafePointer(records + index))
+    }
+
+    /// The byte range of record `index`'s variable-length data within the arena.
+    ///
+    /// The data is laid out as in `bam1_t.data`: query name, CIGAR, 4-bit sequence,
+    /// qualities, then aux fields.
+    public func variableData(at index: Int) -> UnsafeRawBufferPointer {
+        precondition(index >= 0 && index < count, "Batch index out of range")
+        return UnsafeRawBufferPointer(start: arena + arenaOffsetStorage[index],
+                                      count: Int(records[index].l_data))
+    }
+
+    /// Copy the record at `index` into a new, independently owned ``BAMRecord``.
+    ///
+    /// - Throws: ``HTSError/outOfMemory`` if allocation fails.
+    public func copyRecord(at index: Int) throws -> BAMRecord {
+        precondition(index >= 0 && index < count, "Batch index out of range")
+        guard let dst = bam_init1() else { throw HTSError.outOfMemory }
+        guard bam_copy1(dst, records + index) != nil else {
+            bam_destroy1(dst)
+            throw HTSError.outOfMemory
+        }
+        return BAMRecord(pointer: dst)
+    }
+
+    // MARK: - Filling
+
+    /// Whether the batch has reached ``capacity``.
+    internal var isFull: Bool { count == capacity }
+
+    /// Discard all records, keeping the arena and column storage for reuse.
+    public func reset() {
+        count = 0
+        arenaUsed = 0
+    }
+
+    /// Append a decoded record, copying its variable-length data into the arena.
+    internal func append(_ b: UnsafePointer<bam1_t>) {
+        precondition(!isFull, "Batch is full")
+        let length = Int(b.pointee.l_data)
+        // Keep each record 8-byte aligned so its CIGAR array stays 4-byte aligned.
+        let offset = (arenaUsed + 7) & ~7
+        if offset + length > arenaCapacity {
+            growArena(toFit: offset + length)
+        }
+        if length > 0, let src = b.pointee.data {
+            (arena + offset).copyMemory(from: src, byteCount: length)
+        }
+        arenaUsed = offset + length
+
+        let i = count
+        let core = b.pointee.core
+        positionStorage[i] = core.pos
+        endPositionStorage[i] = bam_endpos(b)
+        contigIDStorage[i] = core.tid
+        sequenceLengthStorage[i] = core.l_qseq
+        flagStorage[i] = core.flag
+        mappingQualityStorage[i] = core.qual
+        arenaOffsetStorage[i] = offset
+
+        var view = bam1_t()
+        view.core = core
+        view.id = b.pointee.id
+        view.data = (arena + offset).assumingMemoryBound(to: UInt8.self)
+        view.l_data = b.pointee.l_data
+        view.m_data = UInt32(length)
+        records[i] = view
+        count += 1
+    }
+
+    private func growArena(toFit required: Int) {
+        var newCapacity = arenaCapacity
+        while newCapacity < required { newCapacity *= 2 }
+        let newArena = UnsafeMutableRawPointer.allocate(byteCount: newCapacity, alignment: 8)
+        newArena.copyMemory(from: arena, byteCount: arenaUsed)
+        arena.deallocate()
+        arena = newArena
+        arenaCapacity = newCapacity
+        // Re-point existing records at the relocated arena.
+        for i in 0..<count {
+            records[i].data = (arena + arenaOffsetStorage[i]).assumingMemoryBound(to: UInt8.self)
+        }
+    }
+}
+
+// MARK: - BAMRecordView
+
+/// A non-owning, read-only view of one record inside a ``BAMRecordBatch``.
+///
+/// Exposes the same field accessors as ``BAMRecord``. The view is invalidated when
+/// its batch is reset or refilled; use ``BAMRecordBatch/copyRecord(at:)`` to keep a record.
+public struct BAMRecordView: @unchecked Sendable {
+    nonisolated(unsafe) internal let pointer: UnsafePointer<bam1_t>
+
+    internal init(pointer: UnsafePointer<bam1_t>) {
+        self.pointer = pointer
+    }
+
+    /// 0-based leftmost mapping position on the reference.
+    public var position: Int64 { pointer.pointee.core.pos }
+    /// 0-based exclusive end position on the reference (computed from CIGAR).
+    public var endPosition: Int64 { bam_endpos(pointer) }
+    /// Reference sequence ID, or -1 if unmapped.
+    public var contigID: Int32 { pointer.pointee.core.tid }
+    /// Mate's reference sequence ID, or -1 if unavailable.
+    public var mateContigID: Int32 { pointer.pointee.core.mtid }
+    /// 0-based leftmost mapping position of the mate.
+    public var matePosition: Int64 { pointer.pointee.core.mpos }
+    /// Observed template length (TLEN field).
+    public var insertSize: Int64 { pointer.pointee.core.isize }
+    /// Phred-scaled mapping quality (255 if unavailable).
+    public var mappingQuality: UInt8 { pointer.pointee.core.qual }
+    /// The SAM FLAG field as an ``AlignmentFlag`` option set.
+    public var flag: AlignmentFlag { AlignmentFlag(rawValue: pointer.pointee.core.flag) }
+    /// Length of the query sequence in bases.
+    public var sequenceLength: Int32 { pointer.pointee.core.l_qseq }
+
+    /// The query template name (QNAME).
+    public var queryName: String {
+        String(cString: hts_shim_bam_get_qname(pointer))
+    }
+
+    /// The CIGAR operations for this alignment.
+    public var cigar: CIGARSequence { CIGARSequence(record: pointer) }
+
+    /// The query sequence.
+    public var sequence: BAMSequence { BAMSequence(record: pointer) }
+
+    /// The per-base Phred quality scores.
+    public var qualities: BAMQualities { BAMQualities(record: pointer) }
+
+    /// Read-only accessor for auxiliary (tag) data.
+    public var auxiliaryData: AuxiliaryData { AuxiliaryData(record: pointer) }
+}
+
+// MARK: - Batch reading
+
+extension SAMRecordIterator {
+    /// Reset `batch` and fill it with up to ``BAMRecordBatch/capacity`` records.
+    ///
+    /// - Parameter batch: The batch to refill.
+    /// - Returns: The number of records read; 0 at end-of-file.
+    /// - Throws: ``HTSError/readFailed(code:)`` on a decoding or I/O error.
+    @discardableResult
+    public func readBatch(into batch: BAMRecordBatch) throws -> Int {
+        batch.reset()
+        var record = try BAMRecord()
+        while !batch.isFull, try read(into: &record) {
+            batch.append(record.pointer)
+        }
+        return batch.count
+    }
+}
+
+extension SAMQueryIterator {
+    /// Reset `batch` and fill it with up to ``BAMRecordBatch/capacity`` records from the region.
+    ///
+    /// - Parameter batch: The batch to refill.
+    /// - Returns: The number of records read; 0 when the region is exhausted.
+    /// - Throws: ``HTSError/readFailed(code:)`` on a decoding or I/O error.
+    @discardableResult
+    public func readBatch(into batch: BAMRecordBatch) throws -> Int {
+        batch.reset()
+        var record = try BAMRecord()
+        while !batch.isFull, try read(into: &record) {
+            batch.append(record.pointer)
+        }
+        return batch.count
+    }
+}
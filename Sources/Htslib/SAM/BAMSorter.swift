@@ -0,0 +1,504 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - BAMSortOrder
+
+/// The record order produced by ``BAMSorter``. Orders match `samtools sort`.
+public enum BAMSortOrder: Sendable, Hashable {
+    /// By contig, position, then strand, with unplaced unmapped reads last (`SO:coordinate`).
+    case coordinate
+    /// By read name in natural order (digit runs compare numerically), then READ1 before
+    /// READ2, then primary before secondary/supplementary (`SO:queryname`).
+    case queryName
+    /// By the value of an aux tag, then coordinate (`SO:unknown`). Records without the tag
+    /// come first, then numeric values, then strings.
+    case tag(AuxTag)
+
+    /// The `@HD SO` value written to the sorted output.
+    public var headerValue: String {
+        switch self {
+        case .coordinate: return "coordinate"
+        case .queryName: return "queryname"
+        case .tag: return "unknown"
+        }
+    }
+
+    var kernelOrder: Int32 {
+        switch self {
+        case .coordinate: return Int32(HTS_SHIM_SORT_COORDINATE)
+        case .queryName: return Int32(HTS_SHIM_SORT_QUERYNAME)
+        case .tag: return Int32(HTS_SHIM_SORT_TAG)
+        }
+    }
+}
+
+// MARK: - BAMSorter
+
+/// An out-of-core, parallel BAM sorter.
+///
+/// Records passed to ``add(_:)`` are copied into one arena sized by
+/// ``Options/memoryBudget``. When the arena is full, its records are sorted as
+/// ``Options/sortThreads`` parts on the thread pool, merged, and spilled to a temporary
+/// BGZF run at ``Options/spillCompressionLevel``. ``finish(to:mode:)`` sorts the last chunk
+/// in memory and k-way merges it with the spilled runs into the output, with the `@HD SO`
+/// field updated to match the order. All sorts are stable: equal records keep their input order.
+///
+/// ```swift
+/// let pool = try ThreadPool(threads: 8)
+/// let sorter = BAMSorter(header: header, options: .init(memoryBudget: 2 << 30), pool: pool)
+/// try sorter.add(contentsOf: input.samIterator(header: header))
+/// let stats = try sorter.finish(to: "sorted.bam")
+/// print(stats.spilledRuns, stats.recordsPerSecond, stats.peakResidentBytes)
+/// ```
+///
+/// Peak memory is roughly the budget plus the BGZF buffers of the open runs; raise the
+/// budget for fewer runs and a faster merge, lower it to bound RSS. The pool must outlive
+/// the sorter.
+public final class BAMSorter {
+    /// Tuning knobs for memory, parallelism and temporary files.
+    public struct Options: Sendable {
+        /// The record order.
+        public var order: BAMSortOrder
+        /// Bytes of record data and bookkeeping held in memory before a chunk is spilled.
+        public var memoryBudget: Int
+        /// Number of parts each chunk is split into and sorted concurrently on the pool.
+        public var sortThreads: Int
+        /// Directory for spilled runs.
+        public var temporaryDirectory: String
+        /// BGZF level for spilled runs (0-9); low levels trade disk for speed.
+        public var spillCompressionLevel: Int
+        /// BGZF level for the output, or `nil` for the htslib default.
+        public var outputCompressionLevel: Int?
+        /// Maximum runs merged at once; more runs are first merged in groups.
+        public var mergeFanIn: Int
+
+        public init(order: BAMSortOrder = .coordinate,
+                    memoryBudget: Int = 768 << 20,
+                    sortThreads: Int = 4,
+                    temporaryDirectory: String = "/tmp",
+                    spillCompressionLevel: Int = 1,
+                    outputCompressionLevel: Int? = nil,
+                    mergeFanIn: Int = 256) {
+            self.order = order
+            self.memoryBudget = memoryBudget
+            self.sortThreads = sortThreads
+            self.temporaryDirectory = temporaryDirectory
+            self.spillCompressionLevel = spillCompressionLevel
+            self.outputCompressionLevel = outputCompressionLevel
+            self.mergeFanIn = mergeFanIn
+        }
+    }
+
+    /// Counters and timings for one sort.
+    public struct Statistics: Sendable {
+        /// Records added.
+        public internal(set) var records = 0
+        /// Bytes of variable-length record data added.
+        public internal(set) var recordBytes: Int64 = 0
+        /// Chunks sorted in memory, including the final one.
+        public internal(set) var chunks = 0
+        /// Runs spilled to temporary files.
+        public internal(set) var spilledRuns = 0
+        /// Intermediate merges needed to respect ``Options/mergeFanIn``.
+        public internal(set) var intermediateMerges = 0
+        /// Largest arena footprint reached, in bytes.
+        public internal(set) var peakArenaBytes = 0
+        /// Peak resident set size of the process when the sort finished, in bytes.
+        public internal(set) var peakResidentBytes: Int64 = 0
+        /// Time spent sorting chunks.
+        public internal(set) var sortTime: Duration = .zero
+        /// Time spent writing runs.
+        public internal(set) var spillTime: Duration = .zero
+        /// Time spent merging into the output.
+        public internal(set) var mergeTime: Duration = .zero
+        /// Time from creating the sorter to finishing it.
+        public internal(set) var totalTime: Duration = .zero
+
+        /// Records sorted per second of ``totalTime``.
+        public var recordsPerSecond: Double {
+            let seconds = Double(totalTime.components.seconds) + Double(totalTime.components.attoseconds) * 1e-18
+            return seconds > 0 ? Double(records) / seconds : 0
+        }
+    }
+
+    /// The input header; runs are written with it and the output gets a copy with `SO` updated.
+    public let header: SAMHeader
+    /// The options the sorter was created with.
+    public let options: Options
+    /// Counters so far; complete after ``finish(to:mode:)``.
+    public private(set) var statistics = Statistics()
+
+    private let pool: OpaquePointer?  // hts_tpool*
+    private let tag: UnsafeMutablePointer<CChar>
+    private let arena: UnsafeMutableRawPointer
+    private var arenaUsed = 0
+    private var records: [UnsafeMutablePointer<bam1_t>?] = []
+    private var scratch: [UnsafeMutablePointer<bam1_t>?] = []
+    private var runPaths: [String] = []
+    private var finished = false
+    private let clock = ContinuousClock()
+    private let started: ContinuousClock.Instant
+
+    /// Arena bytes taken by each record's `bam1_t`, rounded to keep data 8-byte aligned.
+    private static let headerStride = (MemoryLayout<bam1_t>.stride + 7) & ~7
+    /// Bookkeeping per record: one slot in `records` and one in `scratch`.
+    private static let pointerCost = 2 * MemoryLayout<UnsafeMutablePointer<bam1_t>?>.stride
+
+    /// Create a sorter that sorts each chunk on the calling thread.
+    ///
+    /// - Parameters:
+    ///   - header: The header of the records that will be added.
+    ///   - options: Order, memory and temporary-file settings.
+    public init(header: SAMHeader, options: Options = Options()) {
+        self.header = header
+        self.options = options
+        self.pool = nil
+        self.started = clock.now
+        tag = .allocate(capacity: 3)
+        arena = .allocate(byteCount: max(options.memoryBudget, 4096), alignment: 8)
+        storeTag()
+    }
+
+    /// Create a sorter that sorts chunks and compresses runs on a shared thread pool.
+    ///
+    /// - Parameters:
+    ///   - header: The header of the records that will be added.
+    ///   - options: Order, memory and temporary-file settings.
+    ///   - pool: The pool for chunk sorting and BGZF work. It must outlive the sorter.
+    public init(header: SAMHeader, options: Options = Options(), pool: borrowing ThreadPool) {
+        self.header = header
+        self.options = options
+        self.pool = pool.pointer
+        self.started = clock.now
+        tag = .allocate(capacity: 3)
+        arena = .allocate(byteCount: max(options.memoryBudget, 4096), alignment: 8)
+        storeTag()
+    }
+
+    deinit {
+        removeRuns()
+        arena.deallocate()
+        tag.deallocate()
+    }
+
+    private func storeTag() {
+        if case .tag(let auxTag) = options.order {
+            tag[0] = CChar(bitPattern: auxTag.first)
+            tag[1] = CChar(bitPattern: auxTag.second)
+        } else {
+            tag[0] = 0
+            tag[1] = 0
+        }
+        tag[2] = 0
+    }
+
+    private var budget: Int { max(options.memoryBudget, 4096) }
+
+    // MARK: - Adding records
+
+    /// Copy a record into the sorter, spilling a sorted run first if the arena is full.
+    ///
+    /// - Parameter record: The record to add.
+    /// - Throws: ``HTSError/invalidArgument(message:)`` if one record exceeds the budget, or
+    ///   any error from spilling a run.
+    public func add(_ record: borrowing BAMRecord) throws {
+        try add(pointer: record.pointer)
+    }
+
+    /// Add every remaining record from an iterator.
+    ///
+    /// - Parameter iterator: The source of records; its filter, if any, applies.
+    /// - Throws: Any error from reading or adding.
+    public func add(contentsOf iterator: SAMRecordIterator) throws {
+        try iterator.forEach { record in try add(record) }
+    }
+
+    internal func add(pointer b: UnsafePointer<bam1_t>) throws {
+        precondition(!finished, "BAMSorter already finished")
+        let length = Int(b.pointee.l_data)
+        let need = (Self.headerStride + length + 7) & ~7
+        if arenaUsed + need + (records.count + 1) * Self.pointerCost > budget {
+            guard !records.isEmpty else {
+                throw HTSError.invalidArgument(message: "A \(length)-byte record exceeds the sort memory budget")
+            }
+            try spill()
+        }
+        let slot = arena + arenaUsed
+        let data = slot + Self.headerStride
+        if length > 0, let src = b.pointee.data {
+            data.copyMemory(from: src, byteCount: length)
+        }
+        var copy = bam1_t()
+        copy.core = b.pointee.core
+        copy.id = b.pointee.id
+        copy.data = data.assumingMemoryBound(to: UInt8.self)
+        copy.l_data = b.pointee.l_data
+        copy.m_data = UInt32(length)
+        let stored = slot.bindMemory(to: bam1_t.self, capacity: 1)
+        stored.initialize(to: copy)
+        arenaUsed += need
+        records.append(stored)
+        statistics.records += 1
+        statistics.recordBytes += Int64(length)
+    }
+
+    // MARK: - Chunks and runs
+
+    private func sortChunk() throws {
+        let start = clock.now
+        if scratch.count < records.count {
+            scratch = Array(repeating: nil, count: records.count)
+        }
+        let ret = records.withUnsafeMutableBufferPointer { recs in
+            scratch.withUnsafeMutableBufferPointer { tmp in
+                hts_shim_sort_records(recs.baseAddress, tmp.baseAddress, recs.count,
+                                      options.order.kernelOrder, tag, pool, Int32(max(options.sortThreads, 1)))
+            }
+        }
+        if ret < 0 { throw HTSError.internal(code: ret) }
+        statistics.chunks += 1
+        statistics.sortTime += clock.now - start
+        statistics.peakArenaBytes = max(statistics.peakArenaBytes, arenaUsed + records.count * Self.pointerCost)
+    }
+
+    /// Sort the arena, write it as a run, and empty the arena.
+    private func spill() throws {
+        try sortChunk()
+        let start = clock.now
+        let path = try makeTemporaryPath()
+        runPaths.append(path)
+        let fp = try openOutput(path: path, level: options.spillCompressionLevel)
+        var ret = sam_hdr_write(fp, header.pointer)
+        for record in records where ret >= 0 {
+            ret = sam_write1(fp, header.pointer, record)
+        }
+        let closed = hts_close(fp)
+        if ret < 0 { throw HTSError.writeFailed(code: ret) }
+        if closed < 0 { throw HTSError.closeFailed(code: closed) }
+        statistics.spilledRuns += 1
+        statistics.spillTime += clock.now - start
+        arenaUsed = 0
+        records.removeAll(keepingCapacity: true)
+    }
+
+    private func makeTemporaryPath() throws -> String {
+        var buffer = [CChar](repeating: 0, count: 4096)
+        let ret = hts_shim_make_temp_path(options.temporaryDirectory, "htslib-sort-", ".bam", &buffer, buffer.count)
+        guard ret == 0 else {
+            throw HTSError.openFailed(path: options.temporaryDirectory, mode: "w")
+        }
+        return buffer.withUnsafeBufferPointer { String(cString: $0.baseAddress!) }
+    }
+
+    private func openOutput(path: String, level: Int?) throws -> UnsafeMutablePointer<htsFile> {
+        let mode = level.map { "wb\(min(max($0, 0), 9))" } ?? "wb"
+        guard let fp = hts_open(path, mode) else {
+            throw HTSError.openFailed(path: path, mode: mode)
+        }
+        attachPool(fp)
+        return fp
+    }
+
+    private func attachPool(_ fp: UnsafeMutablePointer<htsFile>) {
+        guard let pool else { return }
+        var tp = htsThreadPool(pool: pool, qsize: 0)
+        hts_set_thread_pool(fp, &tp)
+    }
+
+    private func removeRuns() {
+        for path in runPaths { _ = hts_shim_remove_file(path) }
+        runPaths.removeAll()
+    }
+
+    // MARK: - Finishing
+
+    /// Sort what remains and write all records, in order, to a new BAM file.
+    ///
+    /// - Parameters:
+    ///   - path: The output path.
+    ///   - mode: An explicit htslib open mode (e.g. `"wc"` for CRAM), or `nil` for BAM at
+    ///     ``Options/outputCompressionLevel``.
+    /// - Returns: The final ``Statistics``.
+    /// - Throws: ``HTSError/openFailed(path:mode:)``, ``HTSError/writeFailed(code:)``,
+    ///   ``HTSError/readFailed(code:)`` or ``HTSError/headerWriteFailed``.
+    @discardableResult
+    public func finish(to path: String, mode: String? = nil) throws -> Statistics {
+        let fp: UnsafeMutablePointer<htsFile>
+        if let mode {
+            guard let opened = hts_open(path, mode) else { throw HTSError.openFailed(path: path, mode: mode) }
+            attachPool(opened)
+            fp = opened
+        } else {
+            fp = try openOutput(path: path, level: options.outputCompressionLevel)
+        }
+        do {
+            try finish(into: fp)
+        } catch {
+            hts_close(fp)
+            throw error
+        }
+        let closed = hts_close(fp)
+        if closed < 0 { throw HTSError.closeFailed(code: closed) }
+        return statistics
+    }
+
+    /// Sort what remains and write the header and all records, in order, to an open file.
+    ///
+    /// - Parameter file: An output ``HTSFile``; the sorter writes its header.
+    /// - Returns: The final ``Statistics``.
+    /// - Throws: ``HTSError/writeFailed(code:)``, ``HTSError/readFailed(code:)`` or
+    ///   ``HTSError/headerWriteFailed``.
+    @discardableResult
+    public func finish(writingTo file: borrowing HTSFile) throws -> Statistics {
+        try finish(into: file.pointer)
+        return statistics
+    }
+
+    private func finish(into out: UnsafeMutablePointer<htsFile>) throws {
+        precondition(!finished, "BAMSorter already finished")
+        finished = true
+        defer { removeRuns() }
+
+        guard let outHeader = header.copy() else { throw HTSError.outOfMemory }
+        try outHeader.setSortOrder(options.order.headerValue)
+        if sam_hdr_write(out, outHeader.pointer) < 0 { throw HTSError.headerWriteFailed }
+
+        if !records.isEmpty { try sortChunk() }
+
+        let start = clock.now
+        let fanIn = max(options.mergeFanIn, 2)
+        // Merge the oldest runs first so a merged run keeps its place in input order.
+        while runPaths.count + (records.isEmpty ? 0 : 1) > fanIn {
+            let group = Array(runPaths.prefix(fanIn))
+            let path = try makeTemporaryPath()
+            runPaths.insert(path, at: fanIn)
+            let fp = try openOutput(path: path, level: options.spillCompressionLevel)
+            var failure: (any Error)?
+            if sam_hdr_write(fp, header.pointer) < 0 {
+                failure = HTSError.headerWriteFailed
+            } else {
+                do { try merge(runs: group, includeMemory: false, into: fp, header: header) } catch { failure = error }
+            }
+            let closed = hts_close(fp)
+            if let failure { throw failure }
+            if closed < 0 { throw HTSError.closeFailed(code: closed) }
+            for old in group { _ = hts_shim_remove_file(old) }
+            runPaths.removeFirst(fanIn)
+            statistics.intermediateMerges += 1
+        }
+        try merge(runs: runPaths, includeMemory: true, into: out, header: outHeader)
+        statistics.mergeTime += clock.now - start
+
+        arenaUsed = 0
+        records.removeAll()
+        scratch.removeAll()
+        statistics.peakResidentBytes = hts_shim_peak_rss_bytes()
+        statistics.totalTime = clock.now - started
+    }
+
+    /// K-way heap merge of sorted runs (in input order) and, optionally, the sorted arena last.
+    private func merge(runs: [String], includeMemory: Bool,
+                       into out: UnsafeMutablePointer<htsFile>, header outHeader: SAMHeader) throws {
+        var readers: [RunReader] = []
+        readers.reserveCapacity(runs.count)
+        for path in runs { readers.append(try RunReader(path: path, pool: pool)) }
+
+        // heads[s] is the current record of source s; sources == readers + memory chunk.
+        var heads: [UnsafeMutablePointer<bam1_t>] = []
+        var heap: [Int] = []
+        for (s, reader) in readers.enumerated() {
+            heads.append(reader.record)
+            if try reader.advance() { heap.append(s) }
+        }
+        let memorySource = readers.count
+        var memoryIndex = 0
+        if includeMemory, let first = records.first, let first {
+            heads.append(first)
+            heap.append(memorySource)
+        }
+
+        let order = options.order.kernelOrder
+        let tag = self.tag
+        func less(_ a: Int, _ b: Int) -> Bool {
+            let c = hts_shim_sort_compare(heads[a], heads[b], order, tag)
+            return c < 0 || (c == 0 && a < b)
+        }
+        func siftDown(_ start: Int) {
+            var i = start
+            while true {
+                let l = 2 * i + 1
+                if l >= heap.count { return }
+                var m = l
+                if l + 1 < heap.count, less(heap[l + 1], heap[l]) { m = l + 1 }
+                if !less(heap[m], heap[i]) { return }
+                heap.swapAt(i, m)
+                i = m
+            }
+        }
+        for i in stride(from: heap.count / 2 - 1, through: 0, by: -1) { siftDown(i) }
+
+        while let s = heap.first {
+            let ret = sam_write1(out, outHeader.pointer, heads[s])
+            if ret < 0 { throw HTSError.writeFailed(code: ret) }
+            let more: Bool
+            if s == memorySource {
+                memoryIndex += 1
+                more = memoryIndex < records.count
+                if more, let next = records[memoryIndex] { heads[s] = next }
+            } else {
+                more = try readers[s].advance()
+            }
+            if !more {
+                heap[0] = heap[heap.count - 1]
+                heap.removeLast()
+            }
+            if !heap.isEmpty { siftDown(0) }
+        }
+    }
+}
+
+// MARK: - RunReader
+
+/// Sequential reader over one spilled run, decoding into a single reused record.
+private final class RunReader {
+    private let file: UnsafeMutablePointer<htsFile>
+    private let header: UnsafeMutablePointer<sam_hdr_t>
+    let record: UnsafeMutablePointer<bam1_t>
+
+    init(path: String, pool: OpaquePointer?) throws {
+        guard let fp = hts_open(path, "r") else { throw HTSError.openFailed(path: path, mode: "r") }
+        if let pool {
+            var tp = htsThreadPool(pool: pool, qsize: 0)
+            hts_set_thread_pool(fp, &tp)
+        }
+        guard let hdr = sam_hdr_read(fp) else {
+            hts_close(fp)
+            throw HTSError.headerReadFailed
+        }
+        guard let rec = bam_init1() else {
+            sam_hdr_destroy(hdr)
+            hts_close(fp)
+            throw HTSError.outOfMemory
+        }
+        file = fp
+        header = hdr
+        record = rec
+    }
+
+    /// Read the next record into ``record``; `false` at the end of the run.
+    func advance() throws -> Bool {
+        let ret = sam_read1(file, header, record)
+        if ret >= 0 { return true }
+        if ret == -1 { return false }
+        throw HTSError.readFailed(code: ret)
+    }
+
+    deinit {
+        bam_destroy1(record)
+        sam_hdr_destroy(header)
+        hts_close(file)
+    }
+}
@@ -0,0 +1,198 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - AlignedBlock
+
+/// A run of one CIGAR operation with its query and reference start coordinates.
+public struct AlignedBlock: Sendable, Hashable {
+    /// 0-based position in the query sequence where the block starts.
+    public let queryStart: Int32
+    /// 0-based position on the reference where the block starts.
+    public let referenceStart: Int64
+    /// Length of the operation in bases.
+    public let length: Int32
+    /// The CIGAR operation.
+    public let op: CIGAROperation.Op
+
+    /// Whether the operation consumes query bases (M, I, S, =, X).
+    public var consumesQuery: Bool { cigarConsumes(op.rawValue) & 1 != 0 }
+
+    /// Whether the operation consumes reference bases (M, D, N, =, X).
+    public var consumesReference: Bool { cigarConsumes(op.rawValue) & 2 != 0 }
+
+    /// Whether query and reference bases are paired one-to-one (M, =, X).
+    public var isAligned: Bool { cigarConsumes(op.rawValue) == 3 }
+
+    /// 0-based exclusive query end.
+    public var queryEnd: Int32 { consumesQuery ? queryStart + length : queryStart }
+
+    /// 0-based exclusive reference end.
+    public var referenceEnd: Int64 { consumesReference ? referenceStart + Int64(length) : referenceStart }
+}
+
+/// Query/reference consumption bits for a CIGAR op (bit 0: query, bit 1: reference),
+/// mirroring htslib's `BAM_CIGAR_TYPE` table.
+@inline(__always)
+internal func cigarConsumes(_ op: UInt8) -> UInt32 {
+    (0x3C1A7 >> (UInt32(op & 0xF) << 1)) & 3
+}
+
+// MARK: - CIGAR walking
+
+extension BAMRecord {
+    /// Visit each CIGAR operation with its query and reference coordinates.
+    ///
+    /// Decodes the packed CIGAR directly, without building ``CIGAROperation`` values or
+    /// allocating. Hard clips and padding are skipped.
+    ///
+    /// - Parameter body: Called once per block, in CIGAR order.
+    public func forEachAlignedBlock(_ body: (AlignedBlock) throws -> Void) rethrows {
+        try walkCIGAR(UnsafePointer(pointer), body)
+    }
+}
+
+extension BAMRecordView {
+    /// Visit each CIGAR operation with its query and reference coordinates.
+    ///
+    /// - Parameter body: Called once per block, in CIGAR order.
+    public func forEachAlignedBlock(_ body: (AlignedBlock) throws -> Void) rethrows {
+        try walkCIGAR(pointer, body)
+    }
+}
+
+@inline(__always)
+internal func walkCIGAR(_ record: UnsafePointer<bam1_t>, _ body: (AlignedBlock) throws -> Void) rethrows {
+    let n = Int(record.pointee.core.n_cigar)
+    guard n > 0, let cigar = hts_shim_bam_get_cigar(record) else { return }
+    var qpos: Int32 = 0
+    var rpos = record.pointee.core.pos
+    for i in 0..<n {
+        let raw = cigar[i]
+        let opCode = UInt8(raw & 0xF)
+        let length = Int32(bitPattern: raw >> 4)
+        let consumes = cigarConsumes(opCode)
+        guard let op = CIGAROperation.Op(rawValue: opCode),
+              op != .hardClip, op != .padding else { continue }
+        try body(AlignedBlock(queryStart: qpos, referenceStart: rpos, length: length, op: op))
+        if consumes & 1 != 0 { qpos += length }
+        if consumes & 2 != 0 { rpos += Int64(length) }
+    }
+}
+
+// MARK: - CIGARWalker
+
+/// A reusable CIGAR walker with O(log n) query/reference coordinate lookup.
+///
+/// The walker keeps a grow-only block buffer, so loading one read after another in a
+/// hot loop allocates only when a read has more CIGAR operations than any before it.
+///
+/// ```swift
+/// let walker = CIGARWalker()
+/// try iterator.forEach { record in
+///     walker.load(record)
+///     if let qpos = walker.queryPosition(forReference: variantPosition) {
+///         // base at qpos supports or refutes the variant
+///     }
+/// }
+/// ```
+public final class CIGARWalker {
+    private var storage: UnsafeMutablePointer<AlignedBlock>
+    private var capacity: Int
+    /// The number of blocks for the loaded record.
+    public private(set) var count: Int = 0
+
+    /// Create a walker with room for `capacity` blocks before it needs to grow.
+    public init(capacity: Int = 32) {
+        self.capacity = max(capacity, 1)
+        self.storage = .allocate(capacity: self.capacity)
+    }
+
+    deinit {
+        storage.deinitialize(count: count)
+        storage.deallocate()
+    }
+
+    /// The aligned blocks of the loaded record, valid until the next ``load(_:)``.
+    public var blocks: UnsafeBufferPointer<AlignedBlock> {
+        UnsafeBufferPointer(start: storage, count: count)
+    }
+
+    /// Load the CIGAR of a record, replacing the previous one.
+    public func load(_ record: borrowing BAMRecord) {
+        load(UnsafePointer(record.pointer))
+    }
+
+    /// Load the CIGAR of a batch record, replacing the previous one.
+    public func load(_ record: BAMRecordView) {
+        load(record.pointer)
+    }
+
+    private func load(_ record: UnsafePointer<bam1_t>) {
+        storage.deinitialize(count: count)
+        count = 0
+        let needed = Int(record.pointee.core.n_cigar)
+        if needed > capacity {
+            storage.deallocate()
+            capacity = max(needed, capacity * 2)
+            storage = .allocate(capacity: capacity)
+        }
+        walkCIGAR(record) { block in
+            (storage + count).initialize(to: block)
+            count += 1
+        }
+    }
+
+    // MARK: Coordinate mapping
+
+    /// Map a query position to its aligned reference position.
+    ///
+    /// - Parameter queryPosition: 0-based position in the query sequence.
+    /// - Returns: The reference position, or `nil` if the base is soft-clipped, inserted,
+    ///   or outside the read.
+    public func referencePosition(forQuery queryPosition: Int32) -> Int64? {
+        // Last block starting at or before the position; zero-length (D/N) blocks share
+        // their query start with the following block and so are never selected over it.
+        guard let i = lastIndex(where: { storage[$0].queryStart <= queryPosition }) else { return nil }
+        let block = storage[i]
+        guard block.isAligned, queryPosition < block.queryEnd else { return nil }
+        return block.referenceStart + Int64(queryPosition - block.queryStart)
+    }
+
+    /// Map a reference position to the aligned query position.
+    ///
+    /// - Parameter referencePosition: 0-based reference position.
+    /// - Returns: The query position, or `nil` if the position is deleted, skipped, or not
+    ///   covered by the read.
+    public func queryPosition(forReference referencePosition: Int64) -> Int32? {
+        guard let i = lastIndex(where: { storage[$0].referenceStart <= referencePosition }) else { return nil }
+        let block = storage[i]
+        guard block.isAligned, referencePosition < block.referenceEnd else { return nil }
+        return block.queryStart + Int32(referencePosition - block.referenceStart)
+    }
+
+    /// Visit every aligned (query, reference) position pair of the loaded record.
+    ///
+    /// - Parameter body: Called with each paired query and reference position.
+    public func forEachAlignedPair(_ body: (Int32, Int64) throws -> Void) rethrows {
+        for block in blocks where block.isAligned {
+            for k in 0..<block.length {
+                try body(block.queryStart + k, block.referenceStart + Int64(k))
+            }
+        }
+    }
+
+    /// Binary search for the last block index satisfying a monotone predicate.
+    @inline(__always)
+    private func lastIndex(where isBefore: (Int) -> Bool) -> Int? {
+        var lo = 0
+        var hi = count
+        while lo < hi {
+            let mid = (lo + hi) >> 1
+            if isBefore(mid) { lo = mid + 1 } else { hi = mid }
+        }
+        return lo > 0 ? lo - 1 : nil
+    }
+}
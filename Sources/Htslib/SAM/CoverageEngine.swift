@@ -0,0 +1,434 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - DepthAccumulator
+
+/// Accumulates per-base depth for one contig with a CIGAR difference array.
+///
+/// Each record adds `+1` at the start and `-1` at the end of every run of counted CIGAR
+/// blocks; ``finish()`` turns the difference array into per-base depth with one prefix
+/// sum. Cost per record is proportional to its CIGAR length, not its aligned length,
+/// and the array is reused (grow-only) across contigs.
+///
+/// ```swift
+/// let depth = DepthAccumulator()
+/// depth.reset(contigID: tid, length: Int(header.targetLength(at: tid)))
+/// try query.forEach { depth.add($0) }
+/// let perBase = depth.finish()
+/// ```
+public final class DepthAccumulator {
+    /// Whether deletions (`D`) count towards depth.
+    public let countDeletions: Bool
+    /// Whether reference skips (`N`) count towards depth.
+    public let countRefSkips: Bool
+    /// The contig being accumulated.
+    public private(set) var contigID: Int32 = -1
+    /// Length of the contig being accumulated.
+    public private(set) var length: Int = 0
+
+    private var storage: UnsafeMutablePointer<Int32>
+    private var capacity: Int
+
+    /// Create an accumulator.
+    ///
+    /// - Parameters:
+    ///   - countDeletions: Count `D` operations as covered.
+    ///   - countRefSkips: Count `N` operations as covered.
+    public init(countDeletions: Bool = false, countRefSkips: Bool = false) {
+        self.countDeletions = countDeletions
+        self.countRefSkips = countRefSkips
+        self.capacity = 1
+        self.storage = .allocate(capacity: 1)
+    }
+
+    deinit {
+        storage.deallocate()
+    }
+
+    /// Start a new contig, clearing all depth.
+    ///
+    /// - Parameters:
+    ///   - contigID: The contig's reference ID.
+    ///   - length: The contig length in bases.
+    public func reset(contigID: Int32, length: Int) {
+        if length + 1 > capacity {
+            storage.deallocate()
+            capacity = length + 1
+            storage = .allocate(capacity: capacity)
+        }
+        self.contigID = contigID
+        self.length = length
+        storage.initialize(repeating: 0, count: length + 1)
+    }
+
+    /// Add a record's aligned blocks. Records on other contigs are ignored.
+    public func add(_ record: borrowing BAMRecord) {
+        add(UnsafePointer(record.pointer))
+    }
+
+    /// Add a batch record's aligned blocks. Records on other contigs are ignored.
+    public func add(_ record: BAMRecordView) {
+        add(record.pointer)
+    }
+
+    internal func add(_ record: UnsafePointer<bam1_t>) {
+        let core = record.pointee.core
+        guard core.tid == contigID, core.n_cigar > 0, let cigar = hts_shim_bam_get_cigar(record) else { return }
+        var pos = core.pos
+        var runStart: Int64 = -1
+        for i in 0..<Int(core.n_cigar) {
+            let raw = cigar[i]
+            let op = UInt8(raw & 0xF)
+            guard cigarConsumes(op) & 2 != 0 else { continue }
+            let counted = cigarConsumes(op) == 3
+                || (op == CIGAROperation.Op.deletion.rawValue && countDeletions)
+                || (op == CIGAROperation.Op.refSkip.rawValue && countRefSkips)
+            if counted {
+                if runStart < 0 { runStart = pos }
+            } else if runStart >= 0 {
+                addInterval(runStart, pos)
+                runStart = -1
+            }
+            pos += Int64(raw >> 4)
+        }
+        if runStart >= 0 { addInterval(runStart, pos) }
+    }
+
+    @inline(__always)
+    private func addInterval(_ start: Int64, _ end: Int64) {
+        let s = Int(max(start, 0))
+        let e = Int(min(end, Int64(length)))
+        guard s < e else { return }
+        storage[s] &+= 1
+        storage[e] &-= 1
+    }
+
+    /// Convert the accumulated differences into per-base depth.
+    ///
+    /// Call once per contig, after the last record has been added.
+    ///
+    /// - Returns: Depth at each 0-based position of the contig, valid until the next ``reset(contigID:length:)``.
+    public func finish() -> UnsafeBufferPointer<Int32> {
+        var running: Int32 = 0
+        for i in 0..<length {
+            running &+= storage[i]
+            storage[i] = running
+        }
+        storage[length] = 0
+        return UnsafeBufferPointer(start: storage, count: length)
+    }
+}
+
+// MARK: - Results
+
+/// A contig interval with its mean depth.
+public struct CoverageInterval: Sendable, Hashable {
+    /// Reference sequence ID.
+    public let contigID: Int32
+    /// 0-based inclusive start.
+    public let start: Int64
+    /// 0-based exclusive end.
+    public let end: Int64
+    /// Mean depth over `[start, end)`.
+    public let meanDepth: Double
+}
+
+/// Depth summary of one target region.
+public struct TargetCoverage: Sendable, Hashable {
+    /// The target.
+    public let region: BEDRegion
+    /// Reference sequence ID of the target's contig.
+    public let contigID: Int32
+    /// Mean depth over the target.
+    public let meanDepth: Double
+    /// Lowest depth in the target.
+    public let minimumDepth: Int32
+    /// Highest depth in the target.
+    public let maximumDepth: Int32
+    /// For each requested threshold, the number of bases with depth at or above it.
+    public let basesAtOrAbove: [Int64]
+}
+
+// MARK: - ContigCoverage
+
+/// Per-base depth for one contig, as handed to ``CoverageEngine/map(contigs:_:)``.
+///
+/// `depth` points into the engine's working buffer and is valid only inside the
+/// transform closure; copy it (e.g. `Array(coverage.depth)`) to keep it.
+public struct ContigCoverage {
+    /// Reference sequence ID.
+    public let contigID: Int32
+    /// Contig name.
+    public let name: String
+    /// Depth at each 0-based position.
+    public let depth: UnsafeBufferPointer<Int32>
+
+    /// Contig length in bases.
+    public var length: Int { depth.count }
+
+    /// Mean depth over `range` (the whole contig by default).
+    public func meanDepth(in range: Range<Int>? = nil) -> Double {
+        let range = (range ?? 0..<length).clamped(to: 0..<length)
+        guard !range.isEmpty else { return 0 }
+        var sum: Int64 = 0
+        for i in range { sum += Int64(depth[i]) }
+        return Double(sum) / Double(range.count)
+    }
+
+    /// Mean depth in consecutive fixed-size windows; the last window may be shorter.
+    public func windowMeans(size: Int) -> [CoverageInterval] {
+        precondition(size > 0, "Window size must be positive")
+        var windows: [CoverageInterval] = []
+        windows.reserveCapacity((length + size - 1) / size)
+        var start = 0
+        while start < length {
+            let end = min(start + size, length)
+            windows.append(CoverageInterval(contigID: contigID, start: Int64(start), end: Int64(end),
+                                            meanDepth: meanDepth(in: start..<end)))
+            start = end
+        }
+        return windows
+    }
+
+    /// Maximal runs of bases whose depth lies in `minimum...maximum`, as BED-style intervals.
+    public func intervals(minimumDepth minimum: Int32, maximumDepth maximum: Int32 = .max) -> [CoverageInterval] {
+        var result: [CoverageInterval] = []
+        var runStart = -1
+        var sum: Int64 = 0
+        for i in 0...length {
+            let inRange = i < length && depth[i] >= minimum && depth[i] <= maximum
+            if inRange {
+                if runStart < 0 { runStart = i; sum = 0 }
+                sum += Int64(depth[i])
+            } else if runStart >= 0 {
+                result.append(CoverageInterval(contigID: contigID, start: Int64(runStart), end: Int64(i),
+                                               meanDepth: Double(sum) / Double(i - runStart)))
+                runStart = -1
+            }
+        }
+        return result
+    }
+
+    /// Summarize a target on this contig.
+    ///
+    /// - Parameters:
+    ///   - region: The target; coordinates are clamped to the contig.
+    ///   - thresholds: Depths for which to count bases at or above.
+    public func summary(of region: BEDRegion, thresholds: [Int32] = []) -> TargetCoverage {
+        let start = Int(max(region.start, 0))
+        let end = Int(min(region.end, Int64(length)))
+        var sum: Int64 = 0
+        var low = Int32.max
+        var high: Int32 = 0
+        var above = [Int64](repeating: 0, count: thresholds.count)
+        if start < end {
+            for i in start..<end {
+                let d = depth[i]
+                sum += Int64(d)
+                low = min(low, d)
+                high = max(high, d)
+                for t in thresholds.indices where d >= thresholds[t] {
+                    above[t] += 1
+                }
+            }
+        }
+        return TargetCoverage(region: region, contigID: contigID,
+                              meanDepth: start < end ? Double(sum) / Double(end - start) : 0,
+                              minimumDepth: start < end ? low : 0, maximumDepth: high,
+                              basesAtOrAbove: above)
+    }
+}
+
+// MARK: - CoverageEngine
+
+/// Computes per-base depth for an indexed BAM/CRAM file, in parallel across contigs.
+///
+/// Each worker task opens its own handle, queries whole contigs through the index, drops
+/// records rejected by ``Options/filter`` inside the read loop, and feeds the rest to a
+/// ``DepthAccumulator``. Only depth is computed, so this is far cheaper than a
+/// ``PileupIterator``: there is no per-read, per-base work. Memory is one `Int32` per
+/// base of the largest contig handled by each worker.
+///
+/// ```swift
+/// let engine = CoverageEngine(path: "sample.bam")
+/// let windows = try await engine.windowMeans(windowSize: 1000)
+/// let targets = try await engine.summarize(targets: try BEDRegion.read(path: "exome.bed"),
+///                                          thresholds: [10, 20, 30])
+/// ```
+public struct CoverageEngine: Sendable {
+    /// Record selection and counting options.
+    public struct Options: Sendable {
+        /// Records must pass this filter to count.
+        public var filter: RecordFilter
+        /// Count deletions (`D`) as covered.
+        public var countDeletions: Bool
+        /// Count reference skips (`N`) as covered.
+        public var countRefSkips: Bool
+        /// Number of contig worker tasks.
+        public var workers: Int
+        /// Extra BGZF decompression threads per worker handle (0 = none).
+        public var threadsPerWorker: Int32
+
+        /// Flags excluded by default: unmapped, secondary, QC-fail, and duplicate.
+        public static let defaultExcludedFlags: AlignmentFlag = [.unmapped, .secondary, .failedQC, .duplicate]
+
+        public init(filter: RecordFilter = RecordFilter().excludingFlags(Options.defaultExcludedFlags),
+                    countDeletions: Bool = false, countRefSkips: Bool = false,
+                    workers: Int = 4, threadsPerWorker: Int32 = 0) {
+            precondition(workers > 0, "workers must be positive")
+            self.filter = filter
+            self.countDeletions = countDeletions
+            self.countRefSkips = countRefSkips
+            self.workers = workers
+            self.threadsPerWorker = threadsPerWorker
+        }
+
+        /// The default options with a minimum mapping quality.
+        public static func minimumMappingQuality(_ mapq: UInt8) -> Options {
+            Options(filter: RecordFilter().excludingFlags(defaultExcludedFlags).mappingQuality(atLeast: mapq))
+        }
+    }
+
+    /// Path to the indexed alignment file.
+    public let path: String
+    /// The options in effect.
+    public let options: Options
+
+    /// Create an engine for an indexed BAM or CRAM file.
+    public init(path: String, options: Options = Options()) {
+        self.path = path
+        self.options = options
+    }
+
+    // MARK: - Core
+
+    /// Compute depth for each contig and transform it into a result.
+    ///
+    /// `transform` runs on worker tasks, possibly concurrently for different contigs.
+    ///
+    /// - Parameters:
+    ///   - contigs: Reference IDs to process, or `nil` for every contig in the header.
+    ///   - transform: Reduces one contig's ``ContigCoverage`` to a result.
+    /// - Returns: One result per contig, in the order of `contigs`.
+    /// - Throws: Any error from opening the file or index, reading records, or `transform`.
+    public func map<Result: Sendable>(
+        contigs: [Int32]? = nil,
+        _ transform: @escaping @Sendable (ContigCoverage) throws -> Result
+    ) async throws -> [Result] {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let tids = contigs ?? Array(0..<header.nTargets)
+        let lengths = tids.map { header.targetLength(at: $0) }
+
+        // Longest-first assignment to the least-loaded worker.
+        let workerCount = min(options.workers, max(tids.count, 1))
+        var assignments = [[Int]](repeating: [], count: workerCount)
+        var load = [Int64](repeating: 0, count: workerCount)
+        for i in tids.indices.sorted(by: { lengths[$0] > lengths[$1] }) {
+            let w = load.indices.min { load[$0] < load[$1] }!
+            assignments[w].append(i)
+            load[w] += max(lengths[i], 1)
+        }
+
+        let path = self.path
+        let options = self.options
+        return try await withThrowingTaskGroup(of: [(Int, Result)].self) { group in
+            for slots in assignments where !slots.isEmpty {
+                let work = slots.map { (slot: $0, tid: tids[$0]) }
+                group.addTask {
+                    try Self.runWorker(work, path: path, options: options, transform: transform)
+                }
+            }
+            var results = [Result?](repeating: nil, count: tids.count)
+            for try await part in group {
+                for (slot, result) in part { results[slot] = result }
+            }
+            return results.map { $0! }
+        }
+    }
+
+    private static func runWorker<Result>(
+        _ work: [(slot: Int, tid: Int32)], path: String, options: Options,
+        transform: (ContigCoverage) throws -> Result
+    ) throws -> [(Int, Result)] {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: path)
+        if options.threadsPerWorker > 0 { file.setThreads(options.threadsPerWorker) }
+        let accumulator = DepthAccumulator(countDeletions: options.countDeletions,
+                                           countRefSkips: options.countRefSkips)
+        let filter = options.filter.compile()
+        var record = try BAMRecord()
+
+        var results: [(Int, Result)] = []
+        for (slot, tid) in work {
+            try Task.checkCancellation()
+            accumulator.reset(contigID: tid, length: Int(header.targetLength(at: tid)))
+            guard let itr = sam_itr_queryi(index.pointer, tid, 0, htsPosMax) else {
+                throw HTSError.seekFailed
+            }
+            let query = SAMQueryIterator(file: file.pointer, iterator: itr)
+            query.filter = filter
+            while try query.read(into: &record) {
+                accumulator.add(UnsafePointer(record.pointer))
+            }
+            let coverage = ContigCoverage(contigID: tid, name: header.targetName(at: tid) ?? "",
+                                          depth: accumulator.finish())
+            results.append((slot, try transform(coverage)))
+        }
+        return results
+    }
+
+    // MARK: - Reports
+
+    /// Per-base depth of a single contig.
+    public func depth(contigID: Int32) async throws -> [Int32] {
+        try await map(contigs: [contigID]) { Array($0.depth) }[0]
+    }
+
+    /// Mean depth in fixed-size windows across every contig.
+    public func windowMeans(windowSize: Int) async throws -> [CoverageInterval] {
+        try await map { $0.windowMeans(size: windowSize) }.flatMap { $0 }
+    }
+
+    /// BED-style runs of bases whose depth lies in `minimum...maximum`, across every contig.
+    public func intervals(minimumDepth minimum: Int32, maximumDepth maximum: Int32 = .max) async throws -> [CoverageInterval] {
+        try await map { $0.intervals(minimumDepth: minimum, maximumDepth: maximum) }.flatMap { $0 }
+    }
+
+    /// Summarize target regions (e.g. exome capture targets).
+    ///
+    /// Only contigs containing targets are read.
+    ///
+    /// - Parameters:
+    ///   - targets: The targets, typically from ``BEDRegion/read(path:)``.
+    ///   - thresholds: Depths for which to count bases at or above, per target.
+    /// - Returns: One summary per target, in input order.
+    /// - Throws: ``HTSError/invalidArgument(message:)`` if a target names an unknown contig.
+    public func summarize(targets: [BEDRegion], thresholds: [Int32] = []) async throws -> [TargetCoverage] {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        var byContig: [Int32: [Int]] = [:]
+        for (i, target) in targets.enumerated() {
+            let tid = header.targetID(forName: target.contig)
+            guard tid >= 0 else {
+                throw HTSError.invalidArgument(message: "Unknown contig in target: \(target.contig)")
+            }
+            byContig[tid, default: []].append(i)
+        }
+        let contigs = byContig.keys.sorted()
+        let groups = contigs.map { tid in byContig[tid]!.map { ($0, targets[$0]) } }
+        let perContig = try await map(contigs: contigs) { coverage in
+            let index = contigs.firstIndex(of: coverage.contigID)!
+            return groups[index].map { ($0.0, coverage.summary(of: $0.1, thresholds: thresholds)) }
+        }
+        var results = [TargetCoverage?](repeating: nil, count: targets.count)
+        for group in perContig {
+            for (i, summary) in group { results[i] = summary }
+        }
+        return results.map { $0! }
+    }
+}
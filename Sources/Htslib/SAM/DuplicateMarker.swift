@@ -0,0 +1,575 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - DuplicateMarker
+
+/// A streaming mark-duplicates stage for coordinate-sorted alignments.
+///
+/// Reads are grouped the way Picard MarkDuplicates groups them: pairs by library, both
+/// ends' unclipped 5' positions and orientations; unpaired reads (or reads whose mate is
+/// unmapped) by library, unclipped 5' position and orientation. In each group the read or
+/// pair with the highest base-quality score is kept and the rest get
+/// ``AlignmentFlag/duplicate``; an unpaired read that starts where a pair's end does is
+/// always a duplicate. Secondary, supplementary and unmapped records pass through.
+///
+/// Records are held in a positional window until no later record can join their group,
+/// then emitted in input order, so marking sits between a reader and a writer in one pass:
+///
+/// ```swift
+/// let marker = try DuplicateMarker(header: header)
+/// let writer = try AlignmentWriter(path: "marked.bam", header: header, pool: pool)
+/// let stats = try marker.run(input.samIterator(header: header), into: writer)
+/// try writer.close()
+/// print(stats.duplicates, stats.opticalDuplicates)
+/// ```
+///
+/// The mate's unclipped position comes from the `MC` tag and the mate's score from `ms`,
+/// as added by `samtools fixmate -m`; without them the mate's leftmost position and the
+/// read's own score are used. The second read of each pair takes the decision made for the
+/// first, which is looked up by a hash of the read name. That pending-mate table is capped
+/// at ``Options/mateTableCapacity`` entries and spills to sorted temporary files beyond it,
+/// which are read back as the stream reaches each mate's position.
+public final class DuplicateMarker {
+    /// Grouping, optical-duplicate and memory settings.
+    public struct Options: Sendable {
+        /// Bases a record is held for after its start. Must exceed the longest read plus
+        /// its clipping so every member of a group is seen before the first is emitted.
+        public var window: Int64
+        /// Maximum flowcell x/y distance between optical duplicates on the same tile, or
+        /// `nil` to skip optical detection. Tile, x and y are the last three `:` fields of
+        /// the read name.
+        public var opticalDistance: Int32?
+        /// Add `DT:Z:SQ` (optical) or `DT:Z:LB` (library) to duplicates.
+        public var tagDuplicateType: Bool
+        /// Drop duplicates instead of emitting them.
+        public var removeDuplicates: Bool
+        /// Pending mates held in memory before the table spills to disk.
+        public var mateTableCapacity: Int
+        /// Directory for spilled mate tables.
+        public var temporaryDirectory: String
+
+        public init(window: Int64 = 1000,
+                    opticalDistance: Int32? = 100,
+                    tagDuplicateType: Bool = false,
+                    removeDuplicates: Bool = false,
+                    mateTableCapacity: Int = 1 << 20,
+                    temporaryDirectory: String = "/tmp") {
+            self.window = window
+            self.opticalDistance = opticalDistance
+            self.tagDuplicateType = tagDuplicateType
+            self.removeDuplicates = removeDuplicates
+            self.mateTableCapacity = mateTableCapacity
+            self.temporaryDirectory = temporaryDirectory
+        }
+    }
+
+    /// Counters for one pass.
+    public struct Statistics: Sendable {
+        /// Records seen.
+        public internal(set) var records = 0
+        /// Primary mapped records that were grouped.
+        public internal(set) var examined = 0
+        /// Pairs whose first read was marked.
+        public internal(set) var pairDuplicates = 0
+        /// Second reads marked because their first read was.
+        public internal(set) var mateDuplicates = 0
+        /// Unpaired reads marked.
+        public internal(set) var fragmentDuplicates = 0
+        /// Duplicates also flagged as optical (counted once per read).
+        public internal(set) var opticalDuplicates = 0
+        /// Records dropped by ``Options/removeDuplicates``.
+        public internal(set) var removed = 0
+        /// Second reads whose first read was never seen.
+        public internal(set) var unmatchedMates = 0
+        /// Times the pending-mate table spilled to disk.
+        public internal(set) var spilledMateRuns = 0
+        /// Pending mates written to disk across all spills.
+        public internal(set) var spilledMates = 0
+        /// Largest number of records held in the window.
+        public internal(set) var peakWindow = 0
+        /// Largest number of pending mates held in memory.
+        public internal(set) var peakPendingMates = 0
+
+        /// All reads marked as duplicates.
+        public var duplicates: Int { pairDuplicates + mateDuplicates + fragmentDuplicates }
+    }
+
+    /// The options the marker was created with.
+    public let options: Options
+    /// Counters so far; complete after ``finish(emit:)``.
+    public private(set) var statistics = Statistics()
+
+    private let libraryByReadGroup: [UInt64: Int32]
+    private var window: [Slot] = []
+    private var head = 0
+    private var nextSeq = 0
+    private var freeRecords: [UnsafeMutablePointer<bam1_t>] = []
+    private var emission: BAMRecord
+    private var info = hts_shim_dup_info_t()
+
+    private var pairGroups: [PairKey: Group] = [:]
+    private var fragmentGroups: [FragmentKey: Group] = [:]
+    private var pairedEnds: [FragmentKey: Int] = [:]
+    private var samePositionLeaders: Set<UInt64> = []
+    private var pendingMates: [UInt64: PendingMate] = [:]
+    private var mateRuns: [MateRun] = []
+    private var last: (tid: UInt32, pos: Int64) = (0, -1)
+    private var finished = false
+
+    /// Create a marker for records described by `header`.
+    ///
+    /// - Parameters:
+    ///   - header: The input header; `@RG` `LB` values define libraries, and read groups
+    ///     without one share a library.
+    ///   - options: Grouping, optical and memory settings.
+    /// - Throws: ``HTSError/outOfMemory`` if the emission record cannot be allocated.
+    public init(header: SAMHeader, options: Options = Options()) throws {
+        self.options = options
+        var libraries: [String: Int32] = ["": 0]
+        var byReadGroup: [UInt64: Int32] = [:]
+        let count = header.countLines(type: "RG")
+        for i in 0..<max(count, 0) {
+            guard let id = sam_hdr_line_name(header.pointer, "RG", i) else { continue }
+            let name = String(cString: id)
+            let library = header.findTag(type: "RG", idKey: "ID", idValue: name, key: "LB") ?? ""
+            let index = libraries[library] ?? Int32(libraries.count)
+            libraries[library] = index
+            let hash = name.withCString { hts_shim_hash_bytes($0, name.utf8.count) }
+            byReadGroup[hash] = index
+        }
+        libraryByReadGroup = byReadGroup
+        guard let b = bam_init1() else { throw HTSError.outOfMemory }
+        emission = BAMRecord(pointer: b)
+    }
+
+    deinit {
+        for slot in window[head...] { bam_destroy1(slot.record) }
+        for b in freeRecords { bam_destroy1(b) }
+        for run in mateRuns { run.remove() }
+    }
+
+    // MARK: - Streaming
+
+    /// Add the next record; records whose decision is final are passed to `emit` in input order.
+    ///
+    /// - Parameters:
+    ///   - record: The next record in coordinate order. It is copied.
+    ///   - emit: Receives each released record, with its duplicate flag set.
+    /// - Throws: ``HTSError/invalidArgument(message:)`` if the input is not coordinate-sorted,
+    ///   errors from spilling the mate table, or any error thrown by `emit`.
+    public func add(_ record: borrowing BAMRecord, emit: (borrowing BAMRecord) throws -> Void) throws {
+        precondition(!finished, "DuplicateMarker already finished")
+        let b = record.pointer
+        let tid = UInt32(bitPattern: b.pointee.core.tid)
+        let pos = b.pointee.core.pos
+        if tid < last.tid || (tid == last.tid && pos < last.pos) {
+            throw HTSError.invalidArgument(message: "DuplicateMarker input is not coordinate-sorted")
+        }
+        last = (tid, pos)
+        statistics.records += 1
+
+        // Release everything that no record from here on can group with.
+        while head < window.count,
+              window[head].tid != b.pointee.core.tid || pos - window[head].position > options.window {
+            try release(emit)
+        }
+
+        guard let copy = freeRecords.popLast() ?? bam_init1(), bam_copy1(copy, b) != nil else {
+            throw HTSError.outOfMemory
+        }
+        var slot = Slot(record: copy, seq: nextSeq, tid: b.pointee.core.tid, position: pos)
+        nextSeq += 1
+        classify(&slot)
+
+        if slot.role == .passThrough && head == window.count {
+            // Nothing is waiting in front of it, so it can go straight out.
+            try deliver(slot, to: emit)
+            freeRecords.append(slot.record)
+            return
+        }
+        window.append(slot)
+        statistics.peakWindow = max(statistics.peakWindow, window.count - head)
+        if head > 4096 && head * 2 > window.count {
+            window.removeFirst(head)
+            head = 0
+        }
+    }
+
+    /// Release every record still held.
+    ///
+    /// - Parameter emit: Receives each released record, with its duplicate flag set.
+    /// - Returns: The final ``Statistics``.
+    /// - Throws: Errors from reading spilled mates, or any error thrown by `emit`.
+    @discardableResult
+    public func finish(emit: (borrowing BAMRecord) throws -> Void) throws -> Statistics {
+        precondition(!finished, "DuplicateMarker already finished")
+        while head < window.count { try release(emit) }
+        finished = true
+        window.removeAll()
+        head = 0
+        statistics.unmatchedMates += pendingMates.count
+        for run in mateRuns {
+            statistics.unmatchedMates += run.remaining
+            run.remove()
+        }
+        mateRuns.removeAll()
+        pendingMates.removeAll()
+        return statistics
+    }
+
+    /// Mark every remaining record from `iterator` and write it to `writer`.
+    ///
+    /// - Parameters:
+    ///   - iterator: A coordinate-sorted source; its filter, if any, applies.
+    ///   - writer: The destination, which the caller closes.
+    /// - Returns: The final ``Statistics``.
+    /// - Throws: Any error from reading, marking or writing.
+    @discardableResult
+    public func run(_ iterator: SAMRecordIterator, into writer: AlignmentWriter) throws -> Statistics {
+        var record = try BAMRecord()
+        while try iterator.read(into: &record) {
+            try add(record) { try writer.write($0) }
+        }
+        return try finish { try writer.write($0) }
+    }
+
+    // MARK: - Grouping
+
+    private func classify(_ slot: inout Slot) {
+        let b = slot.record
+        let flag = UInt32(b.pointee.core.flag)
+        if flag & UInt32(BAM_FSECONDARY | BAM_FSUPPLEMENTARY | BAM_FUNMAP) != 0 { return }
+        guard hts_shim_dup_info(b, &info) == 0 else { return }
+        b.pointee.core.flag &= ~UInt16(BAM_FDUP)
+        statistics.examined += 1
+
+        let library = info.rg_hash == 0 ? 0 : libraryByReadGroup[info.rg_hash] ?? 0
+        let end = FragmentKey(library: library, tid: info.tid, position: info.pos, reverse: info.reverse != 0)
+        let location = Location(seq: slot.seq, tile: info.tile, x: info.x, y: info.y)
+        slot.fragmentKey = end
+        slot.nameHash = info.qname_hash ^ (info.rg_hash &* 0x9e37_79b9_7f4a_7c15)
+        slot.mateTid = b.pointee.core.mtid
+        slot.matePosition = b.pointee.core.mpos
+
+        let paired = flag & UInt32(BAM_FPAIRED) != 0 && flag & UInt32(BAM_FMUNMAP) == 0 && slot.mateTid >= 0
+        guard paired else {
+            slot.role = .fragment
+            if pairedEnds[end] != nil {
+                slot.duplicate = true
+            } else {
+                compete(&fragmentGroups, key: end, slot: &slot, score: info.score, location: location)
+            }
+            return
+        }
+
+        pairedEnds[end, default: 0] += 1
+        if let group = fragmentGroups[end] {
+            // A pair now covers this end, so the unpaired read there is a duplicate.
+            markEarlier(seq: group.bestSeq, location: nil, group: nil)
+        }
+
+        let own = (UInt32(bitPattern: slot.tid), slot.position)
+        let mate = (UInt32(bitPattern: slot.mateTid), slot.matePosition)
+        let leader: Bool
+        if own != mate {
+            leader = own < mate
+        } else if samePositionLeaders.remove(slot.nameHash) != nil {
+            leader = false
+        } else {
+            samePositionLeaders.insert(slot.nameHash)
+            leader = true
+        }
+        guard leader else {
+            slot.role = .mate
+            return
+        }
+        slot.role = .pairLeader
+        let key = PairKey(end: end, mateTid: info.mate_tid, matePosition: info.mate_pos,
+                          mateReverse: info.mate_reverse != 0)
+        slot.pairKey = key
+        compete(&pairGroups, key: key, slot: &slot, score: info.score, location: location)
+    }
+
+    /// Enter `slot` in its group, marking whichever of it and the current best scores lower.
+    private func compete<Key: Hashable>(_ groups: inout [Key: Group], key: Key, slot: inout Slot,
+                                        score: Int32, location: Location) {
+        guard var group = groups[key] else {
+            groups[key] = Group(bestSeq: slot.seq, bestScore: score, members: [location])
+            return
+        }
+        if score > group.bestScore {
+            markEarlier(seq: group.bestSeq, location: group.members.first { $0.seq == group.bestSeq }, group: group)
+            group.bestSeq = slot.seq
+            group.bestScore = score
+        } else {
+            slot.duplicate = true
+            slot.optical = isOptical(location, among: group.members)
+        }
+        if group.members.count < Group.maxMembers { group.members.append(location) }
+        groups[key] = group
+    }
+
+    /// Mark a record still in the window as a duplicate.
+    private func markEarlier(seq: Int, location: Location?, group: Group?) {
+        guard head < window.count else { return }
+        let index = head + (seq - window[head].seq)
+        guard index >= head && index < window.count else { return }
+        window[index].duplicate = true
+        if let location, let group {
+            window[index].optical = isOptical(location, among: group.members)
+        }
+    }
+
+    private func isOptical(_ location: Location, among members: [Location]) -> Bool {
+        guard let distance = options.opticalDistance, location.tile >= 0 else { return false }
+        return members.contains {
+            $0.seq != location.seq && $0.tile == location.tile
+                && abs($0.x - location.x) <= distance && abs($0.y - location.y) <= distance
+        }
+    }
+
+    // MARK: - Releasing
+
+    private func release(_ emit: (borrowing BAMRecord) throws -> Void) throws {
+        var slot = window[head]
+        head += 1
+
+        switch slot.role {
+        case .passThrough:
+            break
+        case .fragment:
+            if let key = slot.fragmentKey, fragmentGroups[key]?.bestSeq == slot.seq {
+                fragmentGroups[key] = nil
+            }
+            if slot.duplicate { statistics.fragmentDuplicates += 1 }
+        case .pairLeader:
+            if let key = slot.pairKey, pairGroups[key]?.bestSeq == slot.seq {
+                pairGroups[key] = nil
+            }
+            if slot.duplicate { statistics.pairDuplicates += 1 }
+            try remember(slot)
+        case .mate:
+            try reloadMates(upTo: (UInt32(bitPattern: slot.tid), slot.position))
+            if let pending = pendingMates.removeValue(forKey: slot.nameHash) {
+                slot.duplicate = pending.duplicate
+                slot.optical = pending.optical
+                if slot.duplicate { statistics.mateDuplicates += 1 }
+            } else {
+                statistics.unmatchedMates += 1
+            }
+        }
+        if slot.role == .pairLeader || slot.role == .mate, let end = slot.fragmentKey {
+            if let n = pairedEnds[end], n > 1 { pairedEnds[end] = n - 1 } else { pairedEnds[end] = nil }
+        }
+
+        if slot.duplicate {
+            slot.record.pointee.core.flag |= UInt16(BAM_FDUP)
+            if slot.optical { statistics.opticalDuplicates += 1 }
+            if options.tagDuplicateType {
+                let type = slot.optical ? "SQ" : "LB"
+                _ = type.withCString { bam_aux_update_str(slot.record, "DT", 3, $0) }
+            }
+        }
+        if slot.duplicate && options.removeDuplicates {
+            statistics.removed += 1
+        } else {
+            try deliver(slot, to: emit)
+        }
+        freeRecords.append(slot.record)
+    }
+
+    /// Hand a slot's record to `body` by swapping it into the reusable emission record.
+    private func deliver(_ slot: Slot, to body: (borrowing BAMRecord) throws -> Void) throws {
+        let held = emission.pointer.pointee
+        emission.pointer.pointee = slot.record.pointee
+        slot.record.pointee = held
+        defer {
+            slot.record.pointee = emission.pointer.pointee
+            emission.pointer.pointee = held
+        }
+        try body(emission)
+    }
+
+    // MARK: - Pending mates
+
+    /// Store a released first read's decision for its mate, spilling the table when full.
+    private func remember(_ slot: Slot) throws {
+        pendingMates[slot.nameHash] = PendingMate(tid: slot.mateTid, position: slot.matePosition,
+                                                  duplicate: slot.duplicate, optical: slot.optical)
+        statistics.peakPendingMates = max(statistics.peakPendingMates, pendingMates.count)
+        if pendingMates.count >= max(options.mateTableCapacity, 1) {
+            try spillMates()
+        }
+    }
+
+    private func spillMates() throws {
+        var entries = pendingMates.map { MateRun.Entry(hash: $0.key, mate: $0.value) }
+        entries.sort { ($0.tid, $0.position) < ($1.tid, $1.position) }
+        mateRuns.append(try MateRun(directory: options.temporaryDirectory, entries: entries))
+        statistics.spilledMateRuns += 1
+        statistics.spilledMates += entries.count
+        pendingMates.removeAll(keepingCapacity: true)
+    }
+
+    /// Move spilled entries whose mate lies at or before `position` back into memory.
+    private func reloadMates(upTo position: (UInt32, Int64)) throws {
+        guard !mateRuns.isEmpty else { return }
+        for run in mateRuns {
+            while let entry = run.head, (entry.tid, entry.position) <= position {
+                pendingMates[entry.hash] = entry.pending
+                try run.advance()
+            }
+        }
+        mateRuns.removeAll { run in
+            if run.head != nil { return false }
+            run.remove()
+            return true
+        }
+    }
+}
+
+// MARK: - Keys and window state
+
+extension DuplicateMarker {
+    fileprivate struct FragmentKey: Hashable {
+        var library: Int32
+        var tid: Int32
+        var position: Int64
+        var reverse: Bool
+    }
+
+    fileprivate struct PairKey: Hashable {
+        var end: FragmentKey
+        var mateTid: Int32
+        var matePosition: Int64
+        var mateReverse: Bool
+    }
+
+    fileprivate struct Location {
+        var seq: Int
+        var tile: Int32
+        var x: Int32
+        var y: Int32
+    }
+
+    fileprivate struct Group {
+        /// Members remembered for optical checks; larger groups compare against the first ones.
+        static let maxMembers = 64
+        var bestSeq: Int
+        var bestScore: Int32
+        var members: [Location]
+    }
+
+    fileprivate enum Role {
+        case passThrough
+        case fragment
+        case pairLeader
+        case mate
+    }
+
+    fileprivate struct Slot {
+        var record: UnsafeMutablePointer<bam1_t>
+        var seq: Int
+        var tid: Int32
+        var position: Int64
+        var role = Role.passThrough
+        var duplicate = false
+        var optical = false
+        var fragmentKey: FragmentKey?
+        var pairKey: PairKey?
+        var nameHash: UInt64 = 0
+        var mateTid: Int32 = -1
+        var matePosition: Int64 = -1
+    }
+
+    fileprivate struct PendingMate {
+        var tid: Int32
+        var position: Int64
+        var duplicate: Bool
+        var optical: Bool
+    }
+}
+
+// MARK: - MateRun
+
+/// A spilled, mate-position-sorted slice of the pending-mate table, read back in order.
+private final class MateRun {
+    struct Entry {
+        var hash: UInt64
+        var tid: UInt32
+        var position: Int64
+        var flags: UInt8
+
+        init(hash: UInt64, mate: DuplicateMarker.PendingMate) {
+            self.hash = hash
+            tid = UInt32(bitPattern: mate.tid)
+            position = mate.position
+            flags = (mate.duplicate ? 1 : 0) | (mate.optical ? 2 : 0)
+        }
+
+        var pending: DuplicateMarker.PendingMate {
+            .init(tid: Int32(bitPattern: tid), position: position, duplicate: flags & 1 != 0, optical: flags & 2 != 0)
+        }
+    }
+
+    private let path: String
+    private var file: UnsafeMutablePointer<BGZF>?
+    private(set) var head: Entry?
+    private(set) var remaining: Int
+    private let scratch = UnsafeMutableRawPointer.allocate(byteCount: MemoryLayout<Entry>.stride,
+                                                           alignment: MemoryLayout<Entry>.alignment)
+
+    init(directory: String, entries: [Entry]) throws {
+        var buffer = [CChar](repeating: 0, count: 4096)
+        guard hts_shim_make_temp_path(directory, "htslib-markdup-", ".bin", &buffer, buffer.count) == 0 else {
+            throw HTSError.openFailed(path: directory, mode: "w")
+        }
+        let path = buffer.withUnsafeBufferPointer { String(cString: $0.baseAddress!) }
+        self.path = path
+        func fail(_ error: HTSError) -> HTSError {
+            _ = hts_shim_remove_file(path)
+            return error
+        }
+        guard let out = bgzf_open(path, "w1") else { throw fail(.openFailed(path: path, mode: "w1")) }
+        let written = entries.withUnsafeBytes { bgzf_write(out, $0.baseAddress, $0.count) }
+        let closed = bgzf_close(out)
+        if written != entries.count * MemoryLayout<Entry>.stride {
+            throw fail(.writeFailed(code: Int32(truncatingIfNeeded: written)))
+        }
+        if closed < 0 { throw fail(.closeFailed(code: closed)) }
+        guard let input = bgzf_open(path, "r") else { throw fail(.openFailed(path: path, mode: "r")) }
+        file = input
+        remaining = entries.count
+        try advance()
+    }
+
+    /// Load the next entry into ``head``, or `nil` at the end of the run.
+    func advance() throws {
+        guard remaining > 0, let file else {
+            head = nil
+            return
+        }
+        // Entries were written as array elements, so each occupies a full stride.
+        let n = bgzf_read(file, scratch, MemoryLayout<Entry>.stride)
+        guard n == MemoryLayout<Entry>.stride else { throw HTSError.readFailed(code: Int32(truncatingIfNeeded: n)) }
+        remaining -= 1
+        head = scratch.load(as: Entry.self)
+    }
+
+    deinit {
+        remove()
+        scratch.deallocate()
+    }
+
+    /// Close and delete the run file.
+    func remove() {
+        guard let file else { return }
+        bgzf_close(file)
+        self.file = nil
+        head = nil
+        _ = hts_shim_remove_file(path)
+    }
+}
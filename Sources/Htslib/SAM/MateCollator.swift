@@ -0,0 +1,439 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - MateCollator
+
+/// Brings the two primary reads of each pair together from records in any order.
+///
+/// Each primary paired read is held until its mate arrives, then both are handed to the
+/// `pair` closure, first read first. Reads are matched by a hash of the query name,
+/// confirmed by comparing the name bytes and the READ1/READ2 flags, so no `String` is
+/// built per read. Unpaired reads, secondary and supplementary records, and (at the end)
+/// reads whose mate never arrived go to the `single` closure.
+///
+/// ```swift
+/// let collator = try MateCollator(header: header, options: .init(memoryBudget: 512 << 20))
+/// let stats = try collator.run(input.samIterator(header: header)) { first, second in
+///     print(first.queryName, first.position, second.position)
+/// } single: { record in
+///     // Unpaired, secondary, supplementary or orphaned.
+/// }
+/// print(stats.pairs, stats.peakBufferedRecords)
+/// ```
+///
+/// Held reads are bounded by ``Options/memoryBudget``. When the buffer fills, every held
+/// read is spilled to one of ``Options/spillBuckets`` temporary BAM files chosen by name
+/// hash; mates that arrive later join their partner's bucket on the next spill, and each
+/// bucket is paired in memory by ``finish(pair:single:)``. Coordinate-sorted input holds
+/// roughly one insert's worth of reads at a time; name-grouped input holds almost none.
+public final class MateCollator {
+    /// Memory, spilling and record-handling settings.
+    public struct Options: Sendable {
+        /// Bytes of held reads (record data plus bookkeeping) before the buffer spills.
+        public var memoryBudget: Int
+        /// Number of bucket files reads are spilled into.
+        public var spillBuckets: Int
+        /// Directory for bucket files.
+        public var temporaryDirectory: String
+        /// BGZF level for bucket files.
+        public var spillCompressionLevel: Int
+        /// Pass secondary and supplementary records to `single` (`true`) or drop them.
+        public var keepNonPrimary: Bool
+
+        public init(memoryBudget: Int = 256 << 20,
+                    spillBuckets: Int = 64,
+                    temporaryDirectory: String = "/tmp",
+                    spillCompressionLevel: Int = 1,
+                    keepNonPrimary: Bool = true) {
+            self.memoryBudget = memoryBudget
+            self.spillBuckets = spillBuckets
+            self.temporaryDirectory = temporaryDirectory
+            self.spillCompressionLevel = spillCompressionLevel
+            self.keepNonPrimary = keepNonPrimary
+        }
+    }
+
+    /// Counters and high-water marks for one pass.
+    public struct Statistics: Sendable {
+        /// Records added.
+        public internal(set) var records = 0
+        /// Pairs delivered.
+        public internal(set) var pairs = 0
+        /// Unpaired, secondary and supplementary records delivered singly.
+        public internal(set) var singles = 0
+        /// Paired reads whose mate never arrived, delivered singly at the end.
+        public internal(set) var orphans = 0
+        /// Secondary and supplementary records dropped.
+        public internal(set) var skipped = 0
+        /// Name-hash matches rejected because the names or flags differed.
+        public internal(set) var hashCollisions = 0
+        /// Times the buffer spilled to disk.
+        public internal(set) var spills = 0
+        /// Reads written to bucket files.
+        public internal(set) var spilledRecords = 0
+        /// Largest number of reads held at once.
+        public internal(set) var peakBufferedRecords = 0
+        /// Largest number of bytes held at once.
+        public internal(set) var peakBufferedBytes = 0
+    }
+
+    /// The header for records added to the collator; bucket files are written with it.
+    public let header: SAMHeader
+    /// The options the collator was created with.
+    public let options: Options
+    /// Counters so far; complete after ``finish(pair:single:)``.
+    public private(set) var statistics = Statistics()
+
+    /// Reads currently held waiting for their mate.
+    public var bufferedRecords: Int { table.count }
+    /// Bytes currently held.
+    public var bufferedBytes: Int { table.bytes }
+
+    private var table = PendingTable()
+    private var emission: BAMRecord
+    private var buckets: [UnsafeMutablePointer<htsFile>] = []
+    private var bucketPaths: [String] = []
+    private var finished = false
+
+    /// Create a collator for records described by `header`.
+    ///
+    /// - Parameters:
+    ///   - header: The header of the input records.
+    ///   - options: Memory, spilling and record-handling settings.
+    /// - Throws: ``HTSError/outOfMemory`` if the emission record cannot be allocated.
+    public init(header: SAMHeader, options: Options = Options()) throws {
+        self.header = header
+        self.options = options
+        guard let b = bam_init1() else { throw HTSError.outOfMemory }
+        emission = BAMRecord(pointer: b)
+    }
+
+    deinit {
+        table.destroy()
+        closeBuckets()
+        removeBuckets()
+    }
+
+    // MARK: - Streaming
+
+    /// Add a record, delivering its pair if this completes one.
+    ///
+    /// - Parameters:
+    ///   - record: The next record, in any order. It is copied if it must be held.
+    ///   - pair: Receives the first and second read of a completed pair.
+    ///   - single: Receives unpaired, secondary and supplementary records.
+    /// - Throws: ``HTSError/outOfMemory``, errors from spilling, or any error thrown by a closure.
+    public func add(_ record: borrowing BAMRecord,
+                    pair: (borrowing BAMRecord, borrowing BAMRecord) throws -> Void,
+                    single: (borrowing BAMRecord) throws -> Void) throws {
+        precondition(!finished, "MateCollator already finished")
+        statistics.records += 1
+        if try collate(record, spilling: true, pair: pair) {
+            try single(record)
+        }
+    }
+
+    /// Pair the reads in each spilled bucket and deliver every read still held.
+    ///
+    /// - Parameters:
+    ///   - pair: Receives the first and second read of each completed pair.
+    ///   - single: Receives reads whose mate never arrived.
+    /// - Returns: The final ``Statistics``.
+    /// - Throws: Errors from reading buckets, or any error thrown by a closure.
+    @discardableResult
+    public func finish(pair: (borrowing BAMRecord, borrowing BAMRecord) throws -> Void,
+                       single: (borrowing BAMRecord) throws -> Void) throws -> Statistics {
+        precondition(!finished, "MateCollator already finished")
+        finished = true
+        defer { removeBuckets() }
+
+        if buckets.isEmpty {
+            try drainOrphans(single)
+            return statistics
+        }
+        // Held reads may have mates in a bucket, so they join the buckets too.
+        try spill()
+        closeBuckets()
+        for path in bucketPaths {
+            guard let fp = hts_open(path, "r") else { throw HTSError.openFailed(path: path, mode: "r") }
+            defer { hts_close(fp) }
+            guard let hdr = sam_hdr_read(fp) else { throw HTSError.headerReadFailed }
+            defer { sam_hdr_destroy(hdr) }
+            var record = try BAMRecord()
+            while true {
+                let ret = sam_read1(fp, hdr, record.pointer)
+                if ret < -1 { throw HTSError.readFailed(code: ret) }
+                if ret == -1 { break }
+                if try collate(record, spilling: false, pair: pair) { try single(record) }
+            }
+            try drainOrphans(single)
+        }
+        return statistics
+    }
+
+    /// Collate every remaining record from `iterator`.
+    ///
+    /// - Parameters:
+    ///   - iterator: The source, in any order; its filter, if any, applies.
+    ///   - pair: Receives the first and second read of each completed pair.
+    ///   - single: Receives unpaired, secondary, supplementary and orphaned records.
+    /// - Returns: The final ``Statistics``.
+    /// - Throws: Any error from reading, spilling or a closure.
+    @discardableResult
+    public func run(_ iterator: SAMRecordIterator,
+                    pair: (borrowing BAMRecord, borrowing BAMRecord) throws -> Void,
+                    single: (borrowing BAMRecord) throws -> Void) throws -> Statistics {
+        var record = try BAMRecord()
+        while try iterator.read(into: &record) {
+            try add(record, pair: pair, single: single)
+        }
+        return try finish(pair: pair, single: single)
+    }
+
+    // MARK: - Pairing
+
+    /// Match `record` against held reads, holding a copy if its mate has not arrived.
+    ///
+    /// - Returns: `true` if the caller should deliver `record` itself as a single.
+    private func collate(_ record: borrowing BAMRecord, spilling: Bool,
+                         pair: (borrowing BAMRecord, borrowing BAMRecord) throws -> Void) throws -> Bool {
+        let b = record.pointer
+        let flag = UInt32(b.pointee.core.flag)
+        if flag & UInt32(BAM_FSECONDARY | BAM_FSUPPLEMENTARY) != 0 {
+            if options.keepNonPrimary {
+                statistics.singles += 1
+                return true
+            }
+            statistics.skipped += 1
+            return false
+        }
+        if flag & UInt32(BAM_FPAIRED) == 0 {
+            statistics.singles += 1
+            return true
+        }
+
+        let hash = hts_shim_hash_bytes(b.pointee.data, Self.nameLength(b))
+        var rejected = 0
+        let mate = table.takeMate(of: b, hash: hash, rejected: &rejected)
+        statistics.hashCollisions += rejected
+        if let slot = mate {
+            statistics.pairs += 1
+            // Swap the held read into the emission record so it can be borrowed.
+            let held = emission.pointer.pointee
+            emission.pointer.pointee = slot.pointee
+            slot.pointee = held
+            defer {
+                slot.pointee = emission.pointer.pointee
+                emission.pointer.pointee = held
+                table.recycle(slot)
+            }
+            if Self.isFirst(emission.pointer, before: b) {
+                try pair(emission, record)
+            } else {
+                try pair(record, emission)
+            }
+            return false
+        }
+
+        try table.hold(b, hash: hash)
+        statistics.peakBufferedRecords = max(statistics.peakBufferedRecords, table.count)
+        statistics.peakBufferedBytes = max(statistics.peakBufferedBytes, table.bytes)
+        if spilling && table.bytes > options.memoryBudget {
+            try spill()
+        }
+        return false
+    }
+
+    /// Whether `a` is delivered before `b`: READ1 first, then the earlier-held read.
+    private static func isFirst(_ a: UnsafePointer<bam1_t>, before b: UnsafePointer<bam1_t>) -> Bool {
+        let read1 = UInt16(BAM_FREAD1)
+        let aFirst = a.pointee.core.flag & read1 != 0
+        let bFirst = b.pointee.core.flag & read1 != 0
+        return aFirst || !bFirst
+    }
+
+    static func nameLength(_ b: UnsafePointer<bam1_t>) -> Int {
+        max(Int(b.pointee.core.l_qname) - Int(b.pointee.core.l_extranul) - 1, 0)
+    }
+
+    private func drainOrphans(_ single: (borrowing BAMRecord) throws -> Void) throws {
+        try table.drain { slot in
+            statistics.orphans += 1
+            let held = emission.pointer.pointee
+            emission.pointer.pointee = slot.pointee
+            slot.pointee = held
+            defer {
+                slot.pointee = emission.pointer.pointee
+                emission.pointer.pointee = held
+            }
+            try single(emission)
+        }
+    }
+
+    // MARK: - Spilling
+
+    /// Write every held read to its bucket file and empty the buffer.
+    private func spill() throws {
+        if buckets.isEmpty { try openBuckets() }
+        let header = self.header.pointer
+        let n = UInt64(buckets.count)
+        var failure: Int32 = 0
+        table.drain { slot, hash in
+            guard failure >= 0 else { return }
+            let ret = sam_write1(buckets[Int(hash % n)], header, slot)
+            if ret < 0 { failure = ret } else { statistics.spilledRecords += 1 }
+        }
+        if failure < 0 { throw HTSError.writeFailed(code: failure) }
+        statistics.spills += 1
+    }
+
+    private func openBuckets() throws {
+        let count = max(options.spillBuckets, 1)
+        let level = min(max(options.spillCompressionLevel, 0), 9)
+        for _ in 0..<count {
+            var buffer = [CChar](repeating: 0, count: 4096)
+            guard hts_shim_make_temp_path(options.temporaryDirectory, "htslib-collate-", ".bam", &buffer, buffer.count) == 0 else {
+                throw HTSError.openFailed(path: options.temporaryDirectory, mode: "w")
+            }
+            let path = buffer.withUnsafeBufferPointer { String(cString: $0.baseAddress!) }
+            bucketPaths.append(path)
+            guard let fp = hts_open(path, "wb\(level)") else { throw HTSError.openFailed(path: path, mode: "wb\(level)") }
+            buckets.append(fp)
+            if sam_hdr_write(fp, header.pointer) < 0 { throw HTSError.headerWriteFailed }
+        }
+    }
+
+    private func closeBuckets() {
+        for fp in buckets { hts_close(fp) }
+        buckets.removeAll()
+    }
+
+    private func removeBuckets() {
+        for path in bucketPaths { _ = hts_shim_remove_file(path) }
+        bucketPaths.removeAll()
+    }
+}
+
+// MARK: - PendingTable
+
+/// Held reads keyed by name hash, with collision chains, reusing `bam1_t` buffers.
+private struct PendingTable {
+    private var heads: [UInt64: Int32] = [:]
+    private var records: [UnsafeMutablePointer<bam1_t>] = []
+    private var hashes: [UInt64] = []
+    private var next: [Int32] = []
+    private var freeSlots: [Int32] = []
+    private var spare: [UnsafeMutablePointer<bam1_t>] = []
+    private(set) var count = 0
+    private(set) var bytes = 0
+
+    /// Per-read bookkeeping on top of the record data: the `bam1_t`, chain arrays and table entry.
+    private static let overhead = MemoryLayout<bam1_t>.stride + 32
+
+    /// Remove and return the held mate of `b`, if any.
+    mutating func takeMate(of b: UnsafePointer<bam1_t>, hash: UInt64, rejected: inout Int) -> UnsafeMutablePointer<bam1_t>? {
+        guard let first = heads[hash] else { return nil }
+        var previous: Int32 = -1
+        var index = first
+        while index >= 0 {
+            let candidate = records[Int(index)]
+            if Self.areMates(candidate, b) {
+                let following = next[Int(index)]
+                if previous < 0 {
+                    heads[hash] = following >= 0 ? following : nil
+                } else {
+                    next[Int(previous)] = following
+                }
+                freeSlots.append(index)
+                count -= 1
+                bytes -= Int(candidate.pointee.l_data) + Self.overhead
+                return candidate
+            }
+            rejected += 1
+            previous = index
+            index = next[Int(index)]
+        }
+        return nil
+    }
+
+    /// Same name, and one is READ1 and the other READ2 (or neither says).
+    private static func areMates(_ a: UnsafePointer<bam1_t>, _ b: UnsafePointer<bam1_t>) -> Bool {
+        let length = MateCollator.nameLength(a)
+        guard length == MateCollator.nameLength(b),
+              memcmp(a.pointee.data, b.pointee.data, length) == 0 else { return false }
+        let mask = UInt16(BAM_FREAD1 | BAM_FREAD2)
+        let fa = a.pointee.core.flag & mask
+        let fb = b.pointee.core.flag & mask
+        return fa == 0 || fb == 0 || fa != fb
+    }
+
+    /// Copy `b` into a free buffer and hold it.
+    mutating func hold(_ b: UnsafePointer<bam1_t>, hash: UInt64) throws {
+        guard let copy = spare.popLast() ?? bam_init1(), bam_copy1(copy, b) != nil else {
+            throw HTSError.outOfMemory
+        }
+        let index: Int32
+        if let free = freeSlots.popLast() {
+            index = free
+            records[Int(index)] = copy
+            hashes[Int(index)] = hash
+            next[Int(index)] = heads[hash] ?? -1
+        } else {
+            index = Int32(records.count)
+            records.append(copy)
+            hashes.append(hash)
+            next.append(heads[hash] ?? -1)
+        }
+        heads[hash] = index
+        count += 1
+        bytes += Int(b.pointee.l_data) + Self.overhead
+    }
+
+    /// Return a buffer handed out by ``takeMate(of:hash:rejected:)`` for reuse.
+    mutating func recycle(_ record: UnsafeMutablePointer<bam1_t>) {
+        spare.append(record)
+    }
+
+    /// Hand every held read to `body`, then empty the table keeping its buffers.
+    mutating func drain(_ body: (UnsafeMutablePointer<bam1_t>, UInt64) throws -> Void) rethrows {
+        defer { reset() }
+        for index in heads.values {
+            var i = index
+            while i >= 0 {
+                try body(records[Int(i)], hashes[Int(i)])
+                i = next[Int(i)]
+            }
+        }
+    }
+
+    mutating func drain(_ body: (UnsafeMutablePointer<bam1_t>) throws -> Void) rethrows {
+        try drain { record, _ in try body(record) }
+    }
+
+    private mutating func reset() {
+        for index in heads.values {
+            var i = index
+            while i >= 0 {
+                spare.append(records[Int(i)])
+                i = next[Int(i)]
+            }
+        }
+        heads.removeAll(keepingCapacity: true)
+        records.removeAll(keepingCapacity: true)
+        hashes.removeAll(keepingCapacity: true)
+        next.removeAll(keepingCapacity: true)
+        freeSlots.removeAll(keepingCapacity: true)
+        count = 0
+        bytes = 0
+    }
+
+    /// Free every buffer.
+    mutating func destroy() {
+        reset()
+        for b in spare { bam_destroy1(b) }
+        spare.removeAll()
+    }
+}
@@ -51,6 +51,11 @@ public final class MultiPileupIterator {
     private let nSamples: Int
     private var contextBuffer: UnsafeMutablePointer<PileupCallbackData>
     private var dataPointers: UnsafeMutablePointer<UnsafeMutableRawPointer?>
+    private let depths: UnsafeMutablePointer<Int32>
+    private let entryPointers: UnsafeMutablePointer<UnsafePointer<bam_pileup1_t>?>
+
+    /// Number of samples.
+    public var sampleCount: Int { nSamples }
 
     /// Create a multi-sample pileup iterator.
     /// - Parameter files: Array of (file, header) pointer pairs, one per sample.
@@ -69,6 +74,11 @@ public final class MultiPileupIterator {
             dataPointers.advanced(by: i).initialize(to: UnsafeMutableRawPointer(contextBuffer.advanced(by: i)))
         }
 
+        depths = .allocate(capacity: max(nSamples, 1))
+        depths.initialize(repeating: 0, count: max(nSamples, 1))
+        entryPointers = .allocate(capacity: max(nSamples, 1))
+        entryPointers.initialize(repeating: nil, count: max(nSamples, 1))
+
         mplp = bam_mplp_init(Int32(nSamples), pileupReadCallback, dataPointers)
     }
 
@@ -79,6 +89,20 @@ public final class MultiPileupIterator {
         return bam_mplp_init_overlaps(mplp)
     }
 
+    /// Compile `filter` and apply it to every read fed to the pileup for one sample.
+    ///
+    /// - Parameters:
+    ///   - filter: The ``RecordFilter`` to apply, or `nil` to remove the sample's filter.
+    ///   - index: 0-based sample index.
+    /// - Returns: The compiled filter, whose ``CompiledRecordFilter/statistics`` report hit counts.
+    @discardableResult
+    public func setFilter(_ filter: RecordFilter?, forSample index: Int) -> CompiledRecordFilter? {
+        precondition(index >= 0 && index < nSamples, "Sample index out of range")
+        let compiled = filter?.compile()
+        contextBuffer[index].filter = compiled
+        return compiled
+    }
+
     /// Set the maximum number of reads to pile up at any position.
     public func setMaxDepth(_ maxcnt: Int32) {
         guard let mplp = mplp else { return }
@@ -96,23 +120,16 @@ public final class MultiPileupIterator {
         guard let mplp = mplp else { return nil }
         var tid: Int32 = 0
         var pos: Int64 = 0
-        var nPlp = [Int32](repeating: 0, count: nSamples)
-        var plpPtrs = [UnsafePointer<bam_pileup1_t>?](repeating: nil, count: nSamples)
-
-        let ret = nPlp.withUnsafeMutableBufferPointer { nBuf in
-            plpPtrs.withUnsafeMutableBufferPointer { pBuf in
-                bam_mplp64_auto(mplp, &tid, &pos, nBuf.baseAddress!, pBuf.baseAddress!)
-            }
-        }
-        if ret <= 0 { return nil }
+        if bam_mplp64_auto(mplp, &tid, &pos, depths, entryPointers) <= 0 { return nil }
 
         var samples: [[PileupEntry]] = []
         samples.reserveCapacity(nSamples)
         for s in 0..<nSamples {
             var entries: [PileupEntry] = []
-            if let plp = plpPtrs[s], nPlp[s] > 0 {
-                entries.reserveCapacity(Int(nPlp[s]))
-                for i in 0..<Int(nPlp[s]) {
+            let n = Int(depths[s])
+            if let plp = entryPointers[s], n > 0 {
+                entries.reserveCapacity(n)
+                for i in 0..<n {
                     entries.append(makePileupEntry(from: plp[i]))
                 }
             }
@@ -121,11 +138,29 @@ public final class MultiPileupIterator {
         return MultiPileupColumn(contigID: tid, position: pos, sampleEntries: samples)
     }
 
+    /// Advance to the next column, decoding each sample into a reusable columnar buffer.
+    ///
+    /// - Parameter columns: One ``PileupColumnBuffer`` per sample, overwritten in place.
+    /// - Returns: `true` if a column was read, `false` at the end of the input.
+    public func next(into columns: [PileupColumnBuffer]) -> Bool {
+        precondition(columns.count == nSamples, "Need one column buffer per sample")
+        guard let mplp = mplp else { return false }
+        var tid: Int32 = 0
+        var pos: Int64 = 0
+        if bam_mplp64_auto(mplp, &tid, &pos, depths, entryPointers) <= 0 { return false }
+        for s in 0..<nSamples {
+            columns[s].fill(contigID: tid, position: pos, entries: entryPointers[s], count: Int(depths[s]))
+        }
+        return true
+    }
+
     deinit {
         if let mplp = mplp { bam_mplp_destroy(mplp) }
         dataPointers.deinitialize(count: nSamples)
         dataPointers.deallocate()
         contextBuffer.deinitialize(count: nSamples)
         contextBuffer.deallocate()
+        depths.deallocate()
+        entryPointers.deallocate()
     }
 }
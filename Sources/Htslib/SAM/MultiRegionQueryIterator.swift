@@ -0,0 +1,310 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - QueryInterval
+
+/// A resolved query region: a contig ID and a 0-based half-open `[start, end)` range.
+public struct QueryInterval: Sendable, Hashable {
+    /// Reference sequence ID.
+    public let contigID: Int32
+    /// 0-based inclusive start.
+    public let start: Int64
+    /// 0-based exclusive end.
+    public let end: Int64
+
+    public init(contigID: Int32, start: Int64, end: Int64) {
+        self.contigID = contigID
+        self.start = start
+        self.end = end
+    }
+
+    /// Resolve samtools-style region strings against `header`.
+    ///
+    /// - Throws: ``HTSError/regionParseFailed(region:)`` for an unparseable region.
+    static func resolve(_ regions: [String], header: SAMHeader) throws -> [QueryInterval] {
+        try regions.map { region in
+            let parsed = try RegionParser.parse(region: region, header: header)
+            guard parsed.tid >= 0 else { throw HTSError.regionParseFailed(region: region) }
+            return QueryInterval(contigID: parsed.tid, start: parsed.start, end: parsed.end)
+        }
+    }
+
+    /// Resolve BED intervals against `header`.
+    ///
+    /// - Throws: ``HTSError/regionParseFailed(region:)`` for a contig missing from the header.
+    static func resolve(_ regions: [BEDRegion], header: SAMHeader) throws -> [QueryInterval] {
+        try regions.map { region in
+            let tid = header.targetID(forName: region.contig)
+            guard tid >= 0 else {
+                throw HTSError.regionParseFailed(region: "\(region.contig):\(region.start + 1)-\(region.end)")
+            }
+            return QueryInterval(contigID: tid, start: region.start, end: region.end)
+        }
+    }
+}
+
+/// Build one hts_itr_multi iterator over `intervals`, merging them into a single chunk list.
+///
+/// - Throws: ``HTSError/invalidArgument(message:)`` for an empty list,
+///   ``HTSError/seekFailed`` if htslib cannot build the iterator.
+func makeMultiRegionIterator(index: OpaquePointer, header: SAMHeader,
+                             intervals: [QueryInterval]) throws -> UnsafeMutablePointer<hts_itr_t> {
+    guard !intervals.isEmpty else {
+        throw HTSError.invalidArgument(message: "Multi-region query needs at least one region")
+    }
+    let sorted = intervals.sorted { ($0.contigID, $0.start) < ($1.contigID, $1.start) }
+    let tids = sorted.map { $0.contigID }
+    let begs = sorted.map { $0.start }
+    let ends = sorted.map { $0.end }
+    guard let itr = hts_shim_sam_itr_intervals(index, header.pointer, tids, begs, ends, Int32(sorted.count)) else {
+        throw HTSError.seekFailed
+    }
+    return itr
+}
+
+// MARK: - RegionOverlapIndex
+
+/// Finds which query intervals a record overlaps.
+///
+/// Intervals are sorted by `(contigID, start)` with a running maximum of `end`, so a
+/// lookup is a binary search for the last interval starting before the record's end,
+/// followed by a backwards scan that stops once no earlier interval can reach the record.
+struct RegionOverlapIndex {
+    private var starts: [Int64] = []
+    private var ends: [Int64] = []
+    private var maxEnds: [Int64] = []
+    private var ids: [Int] = []
+    private var contigRanges: [Range<Int>]
+
+    init(intervals: [QueryInterval], nTargets: Int) {
+        contigRanges = Array(repeating: 0..<0, count: max(nTargets, 0))
+        let order = intervals.indices.sorted {
+            (intervals[$0].contigID, intervals[$0].start) < (intervals[$1].contigID, intervals[$1].start)
+        }
+        var i = 0
+        while i < order.count {
+            let tid = intervals[order[i]].contigID
+            let first = i
+            var runningMax = Int64.min
+            while i < order.count, intervals[order[i]].contigID == tid {
+                let interval = intervals[order[i]]
+                runningMax = max(runningMax, interval.end)
+                starts.append(interval.start)
+                ends.append(interval.end)
+                maxEnds.append(runningMax)
+                ids.append(order[i])
+                i += 1
+            }
+            if tid >= 0 && Int(tid) < contigRanges.count {
+                contigRanges[Int(tid)] = first..<i
+            }
+        }
+    }
+
+    /// Replace `result` with the IDs of intervals overlapping `[start, end)` on `contigID`, ascending.
+    func overlaps(contigID: Int32, start: Int64, end: Int64, into result: inout [Int]) {
+        result.removeAll(keepingCapacity: true)
+        guard contigID >= 0, Int(contigID) < contigRanges.count else { return }
+        let range = contigRanges[Int(contigID)]
+        // First interval starting at or after `end`.
+        var lo = range.lowerBound
+        var hi = range.upperBound
+        while lo < hi {
+            let mid = (lo + hi) >> 1
+            if starts[mid] < end { lo = mid + 1 } else { hi = mid }
+        }
+        var i = lo - 1
+        while i >= range.lowerBound, maxEnds[i] > start {
+            if ends[i] > start { result.append(ids[i]) }
+            i -= 1
+        }
+        if result.count > 1 { result.sort() }
+    }
+}
+
+// MARK: - MultiRegionQueryIterator
+
+/// Iterates records overlapping any of many regions through one merged index query.
+///
+/// All regions are turned into a single htslib multi-region iterator (`hts_itr_multi`),
+/// whose chunk list is sorted and merged across regions. Neighbouring targets share
+/// BGZF block reads, and a record overlapping several regions is returned once. After
+/// each read, ``overlappingRegions`` lists the indices of the input regions the record
+/// overlaps.
+///
+/// ```swift
+/// let targets = try BEDRegion.read(path: "exome.bed")
+/// let iter = try file.samQueryIterator(header: header, index: index, regions: targets)
+/// try iter.forEach { record, regions in
+///     for r in regions { readsPerTarget[r] += 1 }
+/// }
+/// ```
+public final class MultiRegionQueryIterator {
+    private let file: UnsafeMutablePointer<htsFile>
+    private let iterator: UnsafeMutablePointer<hts_itr_t>
+    private var record: UnsafeMutablePointer<bam1_t>?
+    private var exhausted = false
+    private let overlapIndex: RegionOverlapIndex
+
+    /// The query regions, in input order. ``overlappingRegions`` indexes into this array.
+    public let intervals: [QueryInterval]
+
+    /// Indices into ``intervals`` of the regions overlapped by the last record read, ascending.
+    public private(set) var overlappingRegions: [Int] = []
+
+    internal init(file: UnsafeMutablePointer<htsFile>,
+                  iterator: UnsafeMutablePointer<hts_itr_t>,
+                  intervals: [QueryInterval],
+                  nTargets: Int) {
+        self.file = file
+        self.iterator = iterator
+        self.intervals = intervals
+        self.overlapIndex = RegionOverlapIndex(intervals: intervals, nTargets: nTargets)
+        self.record = bam_init1()
+    }
+
+    /// The filter applied to records before they are returned, or `nil` for none.
+    public var filter: CompiledRecordFilter?
+
+    /// Compile `filter` and apply it to every subsequent read.
+    ///
+    /// - Parameter filter: The ``RecordFilter`` to apply.
+    /// - Returns: The compiled filter, whose ``CompiledRecordFilter/statistics`` report hit counts.
+    @discardableResult
+    public func setFilter(_ filter: RecordFilter) -> CompiledRecordFilter {
+        let compiled = filter.compile()
+        self.filter = compiled
+        return compiled
+    }
+
+    private func tagOverlaps(_ b: UnsafePointer<bam1_t>) {
+        overlapIndex.overlaps(contigID: b.pointee.core.tid, start: b.pointee.core.pos,
+                              end: bam_endpos(b), into: &overlappingRegions)
+    }
+
+    /// Read the next record overlapping any region.
+    ///
+    /// - Returns: The next ``BAMRecord``, or `nil` when all regions are exhausted.
+    public func next() -> BAMRecord? {
+        guard !exhausted, let rec = record else { return nil }
+        var ret = hts_shim_sam_itr_next(file, iterator, rec)
+        while ret >= 0, let filter, !filter.accepts(rec) {
+            ret = hts_shim_sam_itr_next(file, iterator, rec)
+        }
+        if ret >= 0 {
+            tagOverlaps(rec)
+            let result = rec
+            self.record = bam_init1()
+            return BAMRecord(pointer: result)
+        } else {
+            exhausted = true
+            overlappingRegions.removeAll(keepingCapacity: true)
+            return nil
+        }
+    }
+
+    /// Read the next overlapping record into an existing record, reusing its storage.
+    ///
+    /// - Parameter record: The ``BAMRecord`` to overwrite.
+    /// - Returns: `true` if a record was read, `false` when all regions are exhausted.
+    /// - Throws: ``HTSError/readFailed(code:)`` on a decoding or I/O error.
+    public func read(into record: inout BAMRecord) throws -> Bool {
+        guard !exhausted else { return false }
+        var ret = hts_shim_sam_itr_next(file, iterator, record.pointer)
+        while ret >= 0, let filter, !filter.accepts(record.pointer) {
+            ret = hts_shim_sam_itr_next(file, iterator, record.pointer)
+        }
+        if ret >= 0 {
+            tagOverlaps(record.pointer)
+            return true
+        }
+        exhausted = true
+        overlappingRegions.removeAll(keepingCapacity: true)
+        if ret == -1 { return false }
+        throw HTSError.readFailed(code: ret)
+    }
+
+    /// Visit every remaining record with the indices of the regions it overlaps.
+    ///
+    /// The record and region list passed to `body` are only valid for the duration of the call.
+    ///
+    /// - Parameter body: A closure invoked with each record and its ``overlappingRegions``.
+    /// - Throws: ``HTSError/readFailed(code:)`` on a decoding error, or any error thrown by `body`.
+    public func forEach(_ body: (borrowing BAMRecord, [Int]) throws -> Void) throws {
+        var record = try BAMRecord()
+        while try read(into: &record) {
+            try body(record, overlappingRegions)
+        }
+    }
+
+    deinit {
+        hts_itr_destroy(iterator)
+        if let rec = record {
+            bam_destroy1(rec)
+        }
+    }
+}
+
+// MARK: - Factories
+
+extension HTSFile {
+    /// Create one iterator over records overlapping any of `regions`.
+    ///
+    /// - Parameters:
+    ///   - header: The ``SAMHeader`` obtained from ``samHeader()``.
+    ///   - index: The ``HTSIndex`` for this file.
+    ///   - regions: Region strings (e.g. `"chr1:1000-2000"`).
+    /// - Returns: A ``MultiRegionQueryIterator`` yielding each overlapping record once.
+    /// - Throws: ``HTSError/regionParseFailed(region:)`` for an unparseable region,
+    ///   ``HTSError/invalidArgument(message:)`` for an empty list, or
+    ///   ``HTSError/seekFailed`` if the query cannot be created.
+    public func samQueryIterator(header: SAMHeader, index: borrowing HTSIndex,
+                                 regions: [String]) throws -> MultiRegionQueryIterator {
+        try samQueryIterator(header: header, index: index,
+                             intervals: QueryInterval.resolve(regions, header: header))
+    }
+
+    /// Create one iterator over records overlapping any of the BED `regions`.
+    ///
+    /// - Parameters:
+    ///   - header: The ``SAMHeader`` obtained from ``samHeader()``.
+    ///   - index: The ``HTSIndex`` for this file.
+    ///   - regions: BED intervals, for example from ``BEDRegion/read(path:)``.
+    /// - Returns: A ``MultiRegionQueryIterator`` yielding each overlapping record once.
+    /// - Throws: ``HTSError/regionParseFailed(region:)`` for a contig missing from the header,
+    ///   ``HTSError/invalidArgument(message:)`` for an empty list, or
+    ///   ``HTSError/seekFailed`` if the query cannot be created.
+    public func samQueryIterator(header: SAMHeader, index: borrowing HTSIndex,
+                                 regions: [BEDRegion]) throws -> MultiRegionQueryIterator {
+        try samQueryIterator(header: header, index: index,
+                             intervals: QueryInterval.resolve(regions, header: header))
+    }
+
+    /// Create one iterator over records overlapping any of the intervals in a BED file.
+    ///
+    /// - Parameters:
+    ///   - header: The ``SAMHeader`` obtained from ``samHeader()``.
+    ///   - index: The ``HTSIndex`` for this file.
+    ///   - bedPath: Path to a plain or BGZF-compressed BED file.
+    /// - Returns: A ``MultiRegionQueryIterator`` whose ``MultiRegionQueryIterator/intervals``
+    ///   follow the BED file's line order.
+    /// - Throws: Any error from ``BEDRegion/read(path:)`` or the region-list overload.
+    public func samQueryIterator(header: SAMHeader, index: borrowing HTSIndex,
+                                 bedPath: String) throws -> MultiRegionQueryIterator {
+        try samQueryIterator(header: header, index: index, regions: BEDRegion.read(path: bedPath))
+    }
+
+    /// Create one iterator over records overlapping any of the resolved `intervals`.
+    ///
+    /// - Throws: ``HTSError/invalidArgument(message:)`` for an empty list, or
+    ///   ``HTSError/seekFailed`` if the query cannot be created.
+    public func samQueryIterator(header: SAMHeader, index: borrowing HTSIndex,
+                                 intervals: [QueryInterval]) throws -> MultiRegionQueryIterator {
+        let itr = try makeMultiRegionIterator(index: index.pointer, header: header, intervals: intervals)
+        return MultiRegionQueryIterator(file: pointer, iterator: itr, intervals: intervals,
+                                        nTargets: Int(header.nTargets))
+    }
+}
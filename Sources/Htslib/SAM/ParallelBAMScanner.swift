@@ -0,0 +1,255 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - BAMShard
+
+/// A slice of an indexed alignment file processed by one ``ParallelBAMScanner`` task.
+///
+/// A shard is a list of contiguous reference spans. Every record belongs to exactly one
+/// span: the one whose `[start, end)` range contains the record's leftmost position.
+/// Records that overlap a span but start before it are skipped, so reads crossing a shard
+/// boundary are processed once, by the shard in which they start.
+public struct BAMShard: Sendable, Hashable {
+    /// A half-open reference interval on one contig.
+    public struct Span: Sendable, Hashable {
+        /// Reference sequence ID, or -1 for unplaced unmapped reads.
+        public let contigID: Int32
+        /// 0-based inclusive start.
+        public let start: Int64
+        /// 0-based exclusive end.
+        public let end: Int64
+
+        /// Whether a record at `contigID`/`position` is owned by this span.
+        @inlinable
+        public func owns(contigID tid: Int32, position: Int64) -> Bool {
+            if contigID < 0 { return tid < 0 }
+            return tid == contigID && position >= start && position < end
+        }
+    }
+
+    /// The spans covered by this shard, in file order.
+    public let spans: [Span]
+    /// Estimated compressed bytes covered by the shard.
+    public let estimatedBytes: Int64
+}
+
+// MARK: - ParallelBAMScanner
+
+/// Scans an indexed BAM/CRAM file in parallel, one file handle per shard.
+///
+/// The scanner uses the file's BAI/CSI/CRAI index to split the genome into windows,
+/// estimates the compressed bytes in each window from the index's chunk offsets, and
+/// groups consecutive windows into shards of roughly equal size. Each shard runs in its
+/// own child task of a `TaskGroup`, decoding records through its own `htsFile`, and
+/// per-shard partial results are merged in shard order at the end.
+///
+/// ```swift
+/// struct FlagCounts: Sendable { var total = 0, duplicates = 0 }
+/// let scanner = ParallelBAMScanner(path: "sample.bam", shardCount: 16)
+/// let counts = try await scanner.scan(
+///     initial: { FlagCounts() },
+///     process: { counts, record in
+///         counts.total += 1
+///         if record.isDuplicate { counts.duplicates += 1 }
+///     },
+///     merge: { total, part in
+///         total.total += part.total
+///         total.duplicates += part.duplicates
+///     })
+/// ```
+public struct ParallelBAMScanner: Sendable {
+    /// Path to the indexed alignment file.
+    public let path: String
+    /// The number of shards to plan.
+    public let shardCount: Int
+    /// Genomic window size used when estimating bytes per region.
+    public let windowSize: Int64
+    /// Extra BGZF decompression threads per shard handle (0 = none).
+    public let threadsPerShard: Int32
+
+    /// Create a scanner for an indexed BAM or CRAM file.
+    ///
+    /// - Parameters:
+    ///   - path: Path to the data file (its index is located automatically).
+    ///   - shardCount: Number of shards to split the file into; usually the core count.
+    ///   - windowSize: Planning granularity in bases.
+    ///   - threadsPerShard: Extra decompression threads given to each shard's handle.
+    public init(path: String, shardCount: Int, windowSize: Int64 = 1 << 20, threadsPerShard: Int32 = 0) {
+        precondition(shardCount > 0, "shardCount must be positive")
+        precondition(windowSize > 0, "windowSize must be positive")
+        self.path = path
+        self.shardCount = shardCount
+        self.windowSize = windowSize
+        self.threadsPerShard = threadsPerShard
+    }
+
+    // MARK: - Planning
+
+    /// Split the file into at most ``shardCount`` byte-balanced shards.
+    ///
+    /// - Returns: Shards covering every placed and unplaced record exactly once.
+    /// - Throws: ``HTSError/openFailed(path:mode:)``, ``HTSError/headerReadFailed``, or
+    ///   ``HTSError/indexLoadFailed(path:)``.
+    public func plan() throws -> [BAMShard] {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: path)
+
+        var windows: [(span: BAMShard.Span, offset: Int64?, bases: Int64)] = []
+        var mappedRecords: UInt64 = 0
+        for tid in 0..<header.nTargets {
+            var mapped: UInt64 = 0
+            var unmapped: UInt64 = 0
+            // BAI/CSI record per-contig counts; skip contigs known to be empty.
+            if hts_idx_get_stat(index.pointer, tid, &mapped, &unmapped) == 0 {
+                mappedRecords += mapped
+                if mapped + unmapped == 0 { continue }
+            }
+            let length = max(header.targetLength(at: tid), 1)
+            var start: Int64 = 0
+            while start < length {
+                let isLast = start + windowSize >= length
+                let end = isLast ? htsPosMax : start + windowSize
+                windows.append((BAMShard.Span(contigID: tid, start: start, end: end),
+                                firstOffset(index: index.pointer, tid: tid, start: start, end: end),
+                                min(windowSize, length - start)))
+                start += windowSize
+            }
+        }
+        let noCoordinateOffset = firstOffset(index: index.pointer, tid: HTS_IDX_NOCOOR, start: 0, end: 0)
+
+        // Bytes in a window = distance to the next window's first chunk.
+        var weights = [Int64](repeating: 0, count: windows.count)
+        var nextOffset = noCoordinateOffset
+        for i in windows.indices.reversed() {
+            if let offset = windows[i].offset {
+                if let next = nextOffset { weights[i] = max(next - offset, 0) }
+                nextOffset = offset
+            }
+        }
+        var totalBytes = weights.reduce(0, +)
+        if totalBytes == 0 {
+            // No usable chunk offsets (e.g. CRAM): balance by genomic span instead.
+            weights = windows.map(\.bases)
+            totalBytes = weights.reduce(0, +)
+        }
+
+        var shards: [BAMShard] = []
+        let target = max(totalBytes / Int64(shardCount), 1)
+        var spans: [BAMShard.Span] = []
+        var bytes: Int64 = 0
+        for (i, window) in windows.enumerated() {
+            if let last = spans.last, last.contigID == window.span.contigID, last.end == window.span.start {
+                spans[spans.count - 1] = BAMShard.Span(contigID: last.contigID, start: last.start, end: window.span.end)
+            } else {
+                spans.append(window.span)
+            }
+            bytes += weights[i]
+            if bytes >= target && shards.count < shardCount - 1 {
+                shards.append(BAMShard(spans: spans, estimatedBytes: bytes))
+                spans = []
+                bytes = 0
+            }
+        }
+
+        let unplaced = hts_idx_get_n_no_coor(index.pointer)
+        if unplaced > 0 {
+            // Estimate unplaced bytes from the average placed record size.
+            let perRecord = mappedRecords > 0 ? totalBytes / Int64(mappedRecords) : 0
+            spans.append(BAMShard.Span(contigID: -1, start: 0, end: 0))
+            bytes += perRecord * Int64(unplaced)
+        }
+        if !spans.isEmpty {
+            shards.append(BAMShard(spans: spans, estimatedBytes: bytes))
+        }
+        return shards
+    }
+
+    /// The compressed file offset of the first chunk overlapping a region, if any.
+    private func firstOffset(index: OpaquePointer, tid: Int32, start: Int64, end: Int64) -> Int64? {
+        guard let itr = sam_itr_queryi(index, tid, start, end) else { return nil }
+        defer { hts_itr_destroy(itr) }
+        guard itr.pointee.n_off > 0, let off = itr.pointee.off else { return nil }
+        var first = off[0].u
+        for i in 1..<Int(itr.pointee.n_off) where off[i].u < first {
+            first = off[i].u
+        }
+        return Int64(first >> 16)
+    }
+
+    // MARK: - Scanning
+
+    /// Process every record in the file, one child task per shard.
+    ///
+    /// `process` runs concurrently on different shards, each with its own partial result
+    /// created by `initial`. The record it receives is reused between calls; copy it to
+    /// keep it. Partial results are merged in shard order once all shards finish.
+    ///
+    /// - Parameters:
+    ///   - shards: A precomputed plan, or `nil` to call ``plan()``.
+    ///   - initial: Creates an empty partial result for one shard.
+    ///   - process: Folds one record into a shard's partial result.
+    ///   - merge: Combines a shard's partial result into the running total.
+    /// - Returns: The merged result.
+    /// - Throws: Any error from opening the file, reading records, or `process`.
+    public func scan<Partial: Sendable>(
+        shards: [BAMShard]? = nil,
+        initial: @escaping @Sendable () -> Partial,
+        process: @escaping @Sendable (inout Partial, borrowing BAMRecord) throws -> Void,
+        merge: (inout Partial, Partial) -> Void
+    ) async throws -> Partial {
+        let plan = try shards ?? self.plan()
+        let path = self.path
+        let threads = self.threadsPerShard
+        return try await withThrowingTaskGroup(of: (Int, Partial).self) { group in
+            for (i, shard) in plan.enumerated() {
+                group.addTask {
+                    let partial = try Self.scanShard(shard, path: path, threads: threads,
+                                                     initial: initial, process: process)
+                    return (i, partial)
+                }
+            }
+            var partials = [Partial?](repeating: nil, count: plan.count)
+            for try await (i, partial) in group {
+                partials[i] = partial
+            }
+            var result = initial()
+            for case let partial? in partials {
+                merge(&result, partial)
+            }
+            return result
+        }
+    }
+
+    private static func scanShard<Partial>(
+        _ shard: BAMShard, path: String, threads: Int32,
+        initial: () -> Partial,
+        process: (inout Partial, borrowing BAMRecord) throws -> Void
+    ) throws -> Partial {
+        let file = try HTSFile(path: path, mode: "r")
+        // CRAM decoding needs the header to have been read from this handle.
+        _ = try file.samHeader()
+        let index = try HTSIndex(path: path)
+        if threads > 0 { file.setThreads(threads) }
+
+        var partial = initial()
+        var record = try BAMRecord()
+        for span in shard.spans {
+            try Task.checkCancellation()
+            let tid = span.contigID < 0 ? HTS_IDX_NOCOOR : span.contigID
+            guard let itr = sam_itr_queryi(index.pointer, tid, span.start, span.end) else {
+                throw HTSError.seekFailed
+            }
+            let query = SAMQueryIterator(file: file.pointer, iterator: itr)
+            while try query.read(into: &record) {
+                if span.owns(contigID: record.contigID, position: record.position) {
+                    try process(&partial, record)
+                }
+            }
+        }
+        return partial
+    }
+}
@@ -57,14 +57,18 @@ private let seq_nt16_str: [Character] = [
 struct PileupCallbackData {
     var file: UnsafeMutablePointer<htsFile>
     var header: UnsafeMutablePointer<sam_hdr_t>
+    var filter: CompiledRecordFilter?
 }
 
-/// C-compatible callback that reads the next alignment record.
+/// C-compatible callback that reads the next alignment record passing the context's filter.
 /// Returns 0 on success, -1 on EOF, < -1 on error.
 let pileupReadCallback: @convention(c) (UnsafeMutableRawPointer?, UnsafeMutablePointer<bam1_t>?) -> Int32 = { data, b in
     guard let data = data, let b = b else { return -1 }
     let ctx = data.assumingMemoryBound(to: PileupCallbackData.self)
-    let ret = sam_read1(ctx.pointee.file, ctx.pointee.header, b)
+    var ret = sam_read1(ctx.pointee.file, ctx.pointee.header, b)
+    while ret >= 0, let filter = ctx.pointee.filter, !filter.accepts(b) {
+        ret = sam_read1(ctx.pointee.file, ctx.pointee.header, b)
+    }
     return ret >= 0 ? 0 : ret
 }
 
@@ -121,6 +125,23 @@ public final class PileupIterator {
         plp = bam_plp_init(pileupReadCallback, context)
     }
 
+    /// The filter applied to reads before they enter the pileup, or `nil` for none.
+    public var filter: CompiledRecordFilter? {
+        get { context.pointee.filter }
+        set { context.pointee.filter = newValue }
+    }
+
+    /// Compile `filter` and apply it to every read fed to the pileup.
+    ///
+    /// - Parameter filter: The ``RecordFilter`` to apply.
+    /// - Returns: The compiled filter, whose ``CompiledRecordFilter/statistics`` report hit counts.
+    @discardableResult
+    public func setFilter(_ filter: RecordFilter) -> CompiledRecordFilter {
+        let compiled = filter.compile()
+        self.filter = compiled
+        return compiled
+    }
+
     /// Set the maximum number of reads to pile up at any position.
     public func setMaxDepth(_ maxcnt: Int32) {
         guard let plp = plp else { return }
@@ -150,6 +171,23 @@ public final class PileupIterator {
         return PileupColumn(contigID: tid, position: pos, entries: result)
     }
 
+    /// Advance to the next column, decoding it into a reusable columnar buffer.
+    ///
+    /// Unlike ``next()``, this builds no per-read values: one kernel call writes every
+    /// read's fields into `column`'s buffers.
+    ///
+    /// - Parameter column: The ``PileupColumnBuffer`` to overwrite.
+    /// - Returns: `true` if a column was read, `false` at the end of the input.
+    public func next(into column: PileupColumnBuffer) -> Bool {
+        guard let plp = plp else { return false }
+        var tid: Int32 = 0
+        var pos: Int64 = 0
+        var nPlp: Int32 = 0
+        guard let entries = bam_plp64_auto(plp, &tid, &pos, &nPlp), nPlp > 0 else { return false }
+        column.fill(contigID: tid, position: pos, entries: entries, count: Int(nPlp))
+        return true
+    }
+
     deinit {
         if let plp = plp { bam_plp_destroy(plp) }
         context.deinitialize(count: 1)
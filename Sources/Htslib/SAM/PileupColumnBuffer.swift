@@ -0,0 +1,238 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - PileupEntryState
+
+/// Per-read state bits of a pileup entry.
+public struct PileupEntryState: OptionSet, Sendable, Hashable {
+    public let rawValue: UInt8
+    public init(rawValue: UInt8) { self.rawValue = rawValue }
+
+    /// The read has a deletion at this position.
+    public static let deletion = PileupEntryState(rawValue: 1)   // HTS_SHIM_PLP_DEL
+    /// The read has a reference skip (N) at this position.
+    public static let refSkip  = PileupEntryState(rawValue: 2)   // HTS_SHIM_PLP_REFSKIP
+    /// This is the first base of the read.
+    public static let head     = PileupEntryState(rawValue: 4)   // HTS_SHIM_PLP_HEAD
+    /// This is the last base of the read.
+    public static let tail     = PileupEntryState(rawValue: 8)   // HTS_SHIM_PLP_TAIL
+}
+
+// MARK: - PileupBase
+
+/// The categories tallied by ``PileupColumnBuffer/count(of:)``.
+public enum PileupBase: Int, Sendable, CaseIterable {
+    case a, c, g, t
+    /// Any ambiguity code, including `N`.
+    case n
+    /// A deletion in the read.
+    case deletion
+}
+
+// MARK: - PileupColumnBuffer
+
+/// A reusable, columnar (struct-of-arrays) pileup column.
+///
+/// Filled in place by ``PileupIterator/next(into:)`` and
+/// ``MultiPileupIterator/next(into:)``: every per-read field lives in its own contiguous
+/// buffer, indexed `0..<depth`, and base/strand counts are tallied while filling. The
+/// buffers only grow, so once they reach the maximum depth, iterating allocates nothing.
+///
+/// ```swift
+/// try pileup.forEachColumn { column in
+///     let alt = column.count(of: .t)
+///     let quals = column.qualities   // UnsafeBufferPointer<UInt8>, depth elements
+/// }
+/// ```
+///
+/// Buffer contents are valid until the next fill.
+public final class PileupColumnBuffer {
+    /// Reference sequence ID of the current column.
+    public private(set) var contigID: Int32 = -1
+    /// 0-based reference position of the current column.
+    public private(set) var position: Int64 = -1
+    /// Number of reads in the current column (including reference skips).
+    public private(set) var depth: Int = 0
+
+    private var capacity: Int
+    private var baseStorage: UnsafeMutablePointer<UInt8>
+    private var qualityStorage: UnsafeMutablePointer<UInt8>
+    private var flagStorage: UnsafeMutablePointer<UInt16>
+    private var mapqStorage: UnsafeMutablePointer<UInt8>
+    private var strandStorage: UnsafeMutablePointer<UInt8>
+    private var qposStorage: UnsafeMutablePointer<Int32>
+    private var indelStorage: UnsafeMutablePointer<Int32>
+    private var stateStorage: UnsafeMutablePointer<UInt8>
+    private let counts: UnsafeMutablePointer<Int32>
+
+    /// Create a buffer with room for `capacity` reads before it needs to grow.
+    public init(capacity: Int = 256) {
+        self.capacity = max(capacity, 1)
+        baseStorage = .allocate(capacity: self.capacity)
+        qualityStorage = .allocate(capacity: self.capacity)
+        flagStorage = .allocate(capacity: self.capacity)
+        mapqStorage = .allocate(capacity: self.capacity)
+        strandStorage = .allocate(capacity: self.capacity)
+        qposStorage = .allocate(capacity: self.capacity)
+        indelStorage = .allocate(capacity: self.capacity)
+        stateStorage = .allocate(capacity: self.capacity)
+        counts = .allocate(capacity: Int(HTS_SHIM_PLP_NCOUNTS))
+        counts.initialize(repeating: 0, count: Int(HTS_SHIM_PLP_NCOUNTS))
+    }
+
+    deinit {
+        deallocateColumns()
+        counts.deallocate()
+    }
+
+    private func deallocateColumns() {
+        baseStorage.deallocate()
+        qualityStorage.deallocate()
+        flagStorage.deallocate()
+        mapqStorage.deallocate()
+        strandStorage.deallocate()
+        qposStorage.deallocate()
+        indelStorage.deallocate()
+        stateStorage.deallocate()
+    }
+
+    private func reserve(_ needed: Int) {
+        guard needed > capacity else { return }
+        deallocateColumns()
+        capacity = max(needed, capacity * 2)
+        baseStorage = .allocate(capacity: capacity)
+        qualityStorage = .allocate(capacity: capacity)
+        flagStorage = .allocate(capacity: capacity)
+        mapqStorage = .allocate(capacity: capacity)
+        strandStorage = .allocate(capacity: capacity)
+        qposStorage = .allocate(capacity: capacity)
+        indelStorage = .allocate(capacity: capacity)
+        stateStorage = .allocate(capacity: capacity)
+    }
+
+    /// Decode `n` raw pileup entries into the columns.
+    internal func fill(contigID: Int32, position: Int64, entries: UnsafePointer<bam_pileup1_t>?, count n: Int) {
+        self.contigID = contigID
+        self.position = position
+        guard n > 0, let entries else {
+            depth = 0
+            counts.update(repeating: 0, count: Int(HTS_SHIM_PLP_NCOUNTS))
+            return
+        }
+        reserve(n)
+        depth = n
+        var out = hts_shim_pileup_columns_t(
+            bases: baseStorage, quals: qualityStorage, flags: flagStorage, mapq: mapqStorage,
+            strand: strandStorage, qpos: qposStorage, indel: indelStorage, state: stateStorage,
+            counts: counts)
+        hts_shim_pileup_fill(entries, Int32(n), &out)
+    }
+
+    // MARK: - Columns
+
+    /// 4-bit nt16 base codes (`1`=A, `2`=C, `4`=G, `8`=T, `15`=N; 0 for deletions and ref skips).
+    public var baseCodes: UnsafeBufferPointer<UInt8> { UnsafeBufferPointer(start: baseStorage, count: depth) }
+    /// Base qualities (0 for deletions and ref skips).
+    public var qualities: UnsafeBufferPointer<UInt8> { UnsafeBufferPointer(start: qualityStorage, count: depth) }
+    /// Alignment FLAG of each read.
+    public var flags: UnsafeBufferPointer<UInt16> { UnsafeBufferPointer(start: flagStorage, count: depth) }
+    /// Mapping quality of each read.
+    public var mappingQualities: UnsafeBufferPointer<UInt8> { UnsafeBufferPointer(start: mapqStorage, count: depth) }
+    /// Strand of each read: 1 for reverse, 0 for forward.
+    public var strands: UnsafeBufferPointer<UInt8> { UnsafeBufferPointer(start: strandStorage, count: depth) }
+    /// 0-based position of this column within each read.
+    public var queryPositions: UnsafeBufferPointer<Int32> { UnsafeBufferPointer(start: qposStorage, count: depth) }
+    /// Indel length following this position (positive insertion, negative deletion, 0 none).
+    public var indels: UnsafeBufferPointer<Int32> { UnsafeBufferPointer(start: indelStorage, count: depth) }
+    /// Raw ``PileupEntryState`` bits of each read.
+    public var stateBits: UnsafeBufferPointer<UInt8> { UnsafeBufferPointer(start: stateStorage, count: depth) }
+
+    /// The state of read `index`.
+    public func state(at index: Int) -> PileupEntryState {
+        PileupEntryState(rawValue: stateStorage[index])
+    }
+
+    /// The base of read `index` as an ASCII byte (`*` for deletions, `>` for ref skips).
+    public func base(at index: Int) -> UInt8 {
+        let state = stateStorage[index]
+        if state & PileupEntryState.deletion.rawValue != 0 { return UInt8(ascii: "*") }
+        if state & PileupEntryState.refSkip.rawValue != 0 { return UInt8(ascii: ">") }
+        return Self.nt16ASCII[Int(baseStorage[index])]
+    }
+
+    private static let nt16ASCII: [UInt8] = Array("=ACMGRSVTWYHKDBN".utf8)
+
+    // MARK: - Counts
+
+    /// Number of reads showing `base` on one strand.
+    public func count(of base: PileupBase, reverse: Bool) -> Int {
+        Int(counts[base.rawValue * 2 + (reverse ? 1 : 0)])
+    }
+
+    /// Number of reads showing `base` on either strand.
+    public func count(of base: PileupBase) -> Int {
+        Int(counts[base.rawValue * 2]) + Int(counts[base.rawValue * 2 + 1])
+    }
+
+    /// Number of reverse-strand reads in the column.
+    public var reverseCount: Int {
+        var total = 0
+        for i in 0..<depth { total += Int(strandStorage[i]) }
+        return total
+    }
+
+    // MARK: - Conversion
+
+    /// Copy the column into an owned ``PileupColumn``.
+    public func makeColumn() -> PileupColumn {
+        var entries: [PileupEntry] = []
+        entries.reserveCapacity(depth)
+        for i in 0..<depth {
+            let state = self.state(at: i)
+            entries.append(PileupEntry(
+                queryPosition: qposStorage[i],
+                indel: indelStorage[i],
+                level: 0,
+                isDeletion: state.contains(.deletion),
+                isHead: state.contains(.head),
+                isTail: state.contains(.tail),
+                isRefSkip: state.contains(.refSkip),
+                base: Character(UnicodeScalar(base(at: i))),
+                baseQuality: qualityStorage[i],
+                mappingQuality: mapqStorage[i],
+                isReverse: strandStorage[i] != 0))
+        }
+        return PileupColumn(contigID: contigID, position: position, entries: entries)
+    }
+}
+
+// MARK: - Columnar iteration
+
+extension PileupIterator {
+    /// Visit every remaining column through one reused ``PileupColumnBuffer``.
+    ///
+    /// The column passed to `body` is only valid for the duration of the call.
+    ///
+    /// - Parameter body: A closure invoked with each column in order.
+    public func forEachColumn(_ body: (borrowing PileupColumnBuffer) throws -> Void) rethrows {
+        let column = PileupColumnBuffer()
+        while next(into: column) {
+            try body(column)
+        }
+    }
+}
+
+extension MultiPileupIterator {
+    /// Visit every remaining column through one reused ``PileupColumnBuffer`` per sample.
+    ///
+    /// - Parameter body: A closure invoked with the per-sample columns at each position.
+    public func forEachColumn(_ body: (borrowing [PileupColumnBuffer]) throws -> Void) rethrows {
+        let columns = (0..<sampleCount).map { _ in PileupColumnBuffer() }
+        while next(into: columns) {
+            try body(columns)
+        }
+    }
+}
@@ -0,0 +1,193 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+/// Context passed through the void* data parameter of the prefetching pileup callback.
+struct PrefetchCallbackData {
+    var prefetcher: OpaquePointer   // hts_shim_prefetch_t*
+    var filter: CompiledRecordFilter?
+}
+
+/// C-compatible callback that takes the next prefetched record passing the context's filter.
+/// Returns 0 on success, -1 on EOF, < -1 on error.
+let prefetchReadCallback: @convention(c) (UnsafeMutableRawPointer?, UnsafeMutablePointer<bam1_t>?) -> Int32 = { data, b in
+    guard let data = data, let b = b else { return -1 }
+    let ctx = data.assumingMemoryBound(to: PrefetchCallbackData.self)
+    var ret = hts_shim_prefetch_read(ctx.pointee.prefetcher, b)
+    while ret == 0, let filter = ctx.pointee.filter, !filter.accepts(b) {
+        ret = hts_shim_prefetch_read(ctx.pointee.prefetcher, b)
+    }
+    return ret
+}
+
+// MARK: - PrefetchingMultiPileup
+
+/// A multi-sample pileup whose per-sample records are decoded ahead on a shared ``ThreadPool``.
+///
+/// ``MultiPileupIterator`` decodes every sample's records on the calling thread, one at a
+/// time, as the pileup engine asks for them. With many samples that serial decoding
+/// dominates. Here each sample owns a bounded ring of record batches that a decoding job
+/// on the pool keeps topped up, so the pileup engine mostly takes records that are already
+/// decoded. Records move out of the ring by swapping buffers, and each sample is read by at
+/// most one job at a time.
+///
+/// ```swift
+/// let pool = try ThreadPool(threads: 8)
+/// let pileup = try PrefetchingMultiPileup(paths: samplePaths, pool: pool)
+/// pileup.forEachColumn { columns in
+///     let total = columns.reduce(0) { $0 + $1.depth }
+/// }
+/// ```
+///
+/// Memory per sample is bounded by `batchSize * queueDepth` records. The pool must outlive
+/// the pileup, and should not also be attached to these files for BGZF decompression:
+/// decoding jobs would then wait on decompression jobs queued behind them.
+public final class PrefetchingMultiPileup {
+    private var mplp: OpaquePointer?
+    private let nSamples: Int
+    private var files: [UnsafeMutablePointer<htsFile>] = []
+    private var prefetchers: [OpaquePointer] = []
+    private let contextBuffer: UnsafeMutablePointer<PrefetchCallbackData>
+    private let dataPointers: UnsafeMutablePointer<UnsafeMutableRawPointer?>
+    private let depths: UnsafeMutablePointer<Int32>
+    private let entryPointers: UnsafeMutablePointer<UnsafePointer<bam_pileup1_t>?>
+
+    /// The header of each sample's file, in input order.
+    public let headers: [SAMHeader]
+
+    /// Number of samples.
+    public var sampleCount: Int { nSamples }
+
+    /// Open one SAM/BAM/CRAM file per sample and start decoding ahead.
+    ///
+    /// - Parameters:
+    ///   - paths: One file path per sample.
+    ///   - pool: The pool that runs decoding jobs. It must outlive the pileup.
+    ///   - batchSize: Records decoded per job step.
+    ///   - queueDepth: Batches buffered per sample (at least 2).
+    /// - Throws: ``HTSError/openFailed(path:mode:)``, ``HTSError/headerReadFailed`` or
+    ///   ``HTSError/outOfMemory``.
+    public init(paths: [String], pool: borrowing ThreadPool, batchSize: Int = 256, queueDepth: Int = 4) throws {
+        nSamples = paths.count
+        var headers: [SAMHeader] = []
+        headers.reserveCapacity(nSamples)
+        var files: [UnsafeMutablePointer<htsFile>] = []
+        var prefetchers: [OpaquePointer] = []
+        func cleanup() {
+            for pf in prefetchers { hts_shim_prefetch_destroy(pf) }
+            for fp in files { hts_close(fp) }
+        }
+
+        for path in paths {
+            guard let fp = hts_open(path, "r") else {
+                cleanup()
+                throw HTSError.openFailed(path: path, mode: "r")
+            }
+            files.append(fp)
+            guard let hdr = sam_hdr_read(fp) else {
+                cleanup()
+                throw HTSError.headerReadFailed
+            }
+            headers.append(SAMHeader(pointer: hdr))
+            guard let pf = hts_shim_prefetch_init(fp, hdr, pool.pointer, Int32(batchSize), Int32(queueDepth)) else {
+                cleanup()
+                throw HTSError.outOfMemory
+            }
+            prefetchers.append(pf)
+        }
+        self.headers = headers
+        self.files = files
+        self.prefetchers = prefetchers
+
+        contextBuffer = .allocate(capacity: max(nSamples, 1))
+        for (i, pf) in prefetchers.enumerated() {
+            contextBuffer.advanced(by: i).initialize(to: PrefetchCallbackData(prefetcher: pf))
+        }
+        dataPointers = .allocate(capacity: max(nSamples, 1))
+        for i in 0..<nSamples {
+            dataPointers.advanced(by: i).initialize(to: UnsafeMutableRawPointer(contextBuffer.advanced(by: i)))
+        }
+        depths = .allocate(capacity: max(nSamples, 1))
+        depths.initialize(repeating: 0, count: max(nSamples, 1))
+        entryPointers = .allocate(capacity: max(nSamples, 1))
+        entryPointers.initialize(repeating: nil, count: max(nSamples, 1))
+
+        mplp = bam_mplp_init(Int32(nSamples), prefetchReadCallback, dataPointers)
+    }
+
+    /// Compile `filter` and apply it to every read fed to the pileup for one sample.
+    ///
+    /// Filtering runs on the consuming thread, after prefetching.
+    ///
+    /// - Parameters:
+    ///   - filter: The ``RecordFilter`` to apply, or `nil` to remove the sample's filter.
+    ///   - index: 0-based sample index.
+    /// - Returns: The compiled filter, whose ``CompiledRecordFilter/statistics`` report hit counts.
+    @discardableResult
+    public func setFilter(_ filter: RecordFilter?, forSample index: Int) -> CompiledRecordFilter? {
+        precondition(index >= 0 && index < nSamples, "Sample index out of range")
+        let compiled = filter?.compile()
+        contextBuffer[index].filter = compiled
+        return compiled
+    }
+
+    /// Set the maximum number of reads to pile up at any position.
+    public func setMaxDepth(_ maxcnt: Int32) {
+        guard let mplp = mplp else { return }
+        bam_mplp_set_maxcnt(mplp, maxcnt)
+    }
+
+    /// Enable overlap detection for paired-end reads.
+    @discardableResult
+    public func initOverlaps() -> Int32 {
+        guard let mplp = mplp else { return -1 }
+        return bam_mplp_init_overlaps(mplp)
+    }
+
+    /// Number of decoded records currently buffered ahead for one sample.
+    ///
+    /// - Parameter index: 0-based sample index.
+    public func bufferedRecords(forSample index: Int) -> Int {
+        Int(hts_shim_prefetch_buffered(prefetchers[index]))
+    }
+
+    /// Advance to the next column, decoding each sample into a reusable columnar buffer.
+    ///
+    /// - Parameter columns: One ``PileupColumnBuffer`` per sample, overwritten in place.
+    /// - Returns: `true` if a column was read, `false` at the end of the input.
+    public func next(into columns: [PileupColumnBuffer]) -> Bool {
+        precondition(columns.count == nSamples, "Need one column buffer per sample")
+        guard let mplp = mplp else { return false }
+        var tid: Int32 = 0
+        var pos: Int64 = 0
+        if bam_mplp64_auto(mplp, &tid, &pos, depths, entryPointers) <= 0 { return false }
+        for s in 0..<nSamples {
+            columns[s].fill(contigID: tid, position: pos, entries: entryPointers[s], count: Int(depths[s]))
+        }
+        return true
+    }
+
+    /// Visit every remaining column through one reused ``PileupColumnBuffer`` per sample.
+    ///
+    /// - Parameter body: A closure invoked with the per-sample columns at each position.
+    public func forEachColumn(_ body: (borrowing [PileupColumnBuffer]) throws -> Void) rethrows {
+        let columns = (0..<nSamples).map { _ in PileupColumnBuffer() }
+        while next(into: columns) {
+            try body(columns)
+        }
+    }
+
+    deinit {
+        if let mplp = mplp { bam_mplp_destroy(mplp) }
+        for pf in prefetchers { hts_shim_prefetch_destroy(pf) }
+        for fp in files { hts_close(fp) }
+        dataPointers.deinitialize(count: nSamples)
+        dataPointers.deallocate()
+        contextBuffer.deinitialize(count: nSamples)
+        contextBuffer.deallocate()
+        depths.deallocate()
+        entryPointers.deallocate()
+    }
+}
@@ -0,0 +1,136 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - QualityStatistics
+
+/// A single-pass summary of a read's base qualities.
+public struct QualityStatistics: Sendable, Equatable {
+    /// Number of quality values summarized.
+    public let count: Int
+    /// Sum of all quality values.
+    public let sum: UInt64
+    /// Lowest quality value.
+    public let minimum: UInt8
+    /// Highest quality value.
+    public let maximum: UInt8
+    /// Number of values strictly below ``threshold``.
+    public let belowThreshold: Int
+    /// The threshold used for ``belowThreshold``.
+    public let threshold: UInt8
+
+    /// Mean quality (0 for an empty read).
+    public var mean: Double {
+        count > 0 ? Double(sum) / Double(count) : 0
+    }
+}
+
+// MARK: - QualityBinning
+
+/// A lookup table mapping every Phred quality to a binned value.
+///
+/// Apply with ``BAMRecord/binQualities(_:)`` before writing records to reduce the
+/// entropy of the quality stream.
+public struct QualityBinning: Sendable {
+    /// The 256-entry mapping from raw to binned quality.
+    public let table: [UInt8]
+
+    /// Create a binning from an explicit 256-entry table.
+    ///
+    /// - Parameter table: `table[q]` is the binned value for quality `q`.
+    public init(table: [UInt8]) {
+        precondition(table.count == 256, "Binning table must have 256 entries")
+        self.table = table
+    }
+
+    /// Create a binning from quality ranges. Qualities outside every range are unchanged.
+    ///
+    /// - Parameter bins: Pairs of an inclusive quality range and the value it maps to.
+    public init(bins: [(range: ClosedRange<UInt8>, value: UInt8)]) {
+        var table = (0...255).map { UInt8($0) }
+        for bin in bins {
+            for q in bin.range { table[Int(q)] = bin.value }
+        }
+        self.table = table
+    }
+
+    /// Illumina's 8-level binning scheme (Q2–9 → 6, 10–19 → 15, 20–24 → 22,
+    /// 25–29 → 27, 30–34 → 33, 35–39 → 37, ≥40 → 40). Q0–1 and `0xFF` are kept.
+    public static let illumina8 = QualityBinning(bins: [
+        (2...9, 6), (10...19, 15), (20...24, 22), (25...29, 27),
+        (30...34, 33), (35...39, 37), (40...254, 40),
+    ])
+}
+
+// MARK: - In-place binning
+
+extension BAMRecord {
+    /// Replace this record's base qualities with their binned values, in place.
+    ///
+    /// Records without qualities (first byte `0xFF`) are left untouched.
+    ///
+    /// - Parameter binning: The ``QualityBinning`` to apply.
+    public mutating func binQualities(_ binning: QualityBinning) {
+        guard qualities.isAvailable else { return }
+        binning.table.withUnsafeBufferPointer { table in
+            hts_shim_qual_bin(hts_shim_bam_get_qual(pointer), Int64(sequenceLength), table.baseAddress)
+        }
+    }
+}
+
+// MARK: - Batch kernels
+
+extension BAMRecordBatch {
+    /// Summarize the qualities of every record in the batch.
+    ///
+    /// - Parameters:
+    ///   - threshold: Qualities strictly below this value are counted.
+    ///   - results: Reused output array, resized to ``count``; `nil` marks records
+    ///     without qualities.
+    public func qualityStatistics(threshold: UInt8 = 20, into results: inout [QualityStatistics?]) {
+        results.removeAll(keepingCapacity: true)
+        results.reserveCapacity(count)
+        for i in 0..<count {
+            results.append(self[i].qualities.statistics(threshold: threshold))
+        }
+    }
+
+    /// Write each record's mean quality into a caller-provided buffer.
+    ///
+    /// - Parameter means: Destination with at least ``count`` elements; records without
+    ///   qualities receive `nan`.
+    public func meanQualities(into means: UnsafeMutableBufferPointer<Float>) {
+        precondition(means.count >= count, "Buffer too small for batch")
+        var stats = hts_shim_qual_stats_t()
+        for i in 0..<count {
+            let quals = self[i].qualities
+            guard quals.isAvailable, let base = quals.buffer.baseAddress else {
+                means[i] = .nan
+                continue
+            }
+            hts_shim_qual_stats(base, Int64(quals.count), 0, &stats)
+            means[i] = Float(Double(stats.sum) / Double(quals.count))
+        }
+    }
+
+    /// Count, for every record, the bases with quality strictly below `threshold`.
+    ///
+    /// - Parameters:
+    ///   - threshold: The quality threshold.
+    ///   - counts: Destination with at least ``count`` elements (0 for records without qualities).
+    public func countQualities(below threshold: UInt8, into counts: UnsafeMutableBufferPointer<Int32>) {
+        precondition(counts.count >= count, "Buffer too small for batch")
+        var stats = hts_shim_qual_stats_t()
+        for i in 0..<count {
+            let quals = self[i].qualities
+            guard quals.isAvailable, let base = quals.buffer.baseAddress else {
+                counts[i] = 0
+                continue
+            }
+            hts_shim_qual_stats(base, Int64(quals.count), threshold, &stats)
+            counts[i] = Int32(stats.below)
+        }
+    }
+}
@@ -0,0 +1,330 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - RecordFilter
+
+/// A typed, composable alignment filter.
+///
+/// A `RecordFilter` is a list of clauses that must all pass. Build one with the chaining
+/// methods, then attach it to a ``SAMRecordIterator``, ``SAMQueryIterator``,
+/// ``PileupIterator`` or ``MultiPileupIterator``. The filter runs on the reused `bam1_t`
+/// inside the read loop, so rejected records never reach user code and are never
+/// materialized as a ``BAMRecord``.
+///
+/// ```swift
+/// let filter = RecordFilter()
+///     .excludingFlags([.unmapped, .secondary, .duplicate, .failedQC])
+///     .mappingQuality(atLeast: 20)
+///     .readGroups(["lane1", "lane2"])
+/// let iterator = file.samIterator(header: header)
+/// let compiled = iterator.setFilter(filter)
+/// try iterator.forEach { record in ... }
+/// print(compiled.statistics)
+/// ```
+///
+/// Unlike ``HTSFile/setFilterExpression(_:)``, clauses are checked in Swift against
+/// precompiled constants rather than parsed and evaluated per record.
+public struct RecordFilter: Sendable {
+    /// A single filter condition.
+    public enum Clause: Sendable, CustomStringConvertible {
+        /// All of these flags must be set.
+        case requireFlags(AlignmentFlag)
+        /// None of these flags may be set.
+        case excludeFlags(AlignmentFlag)
+        /// Mapping quality must lie in the range.
+        case mappingQuality(ClosedRange<UInt8>)
+        /// The record must be placed on this contig.
+        case contig(Int32)
+        /// The record must overlap `[range.lowerBound, range.upperBound)` on a contig.
+        case overlaps(contigID: Int32, range: Range<Int64>)
+        /// Query sequence length must lie in the range.
+        case sequenceLength(ClosedRange<Int32>)
+        /// The `RG` tag must be one of these read groups.
+        case readGroups(Set<String>)
+        /// The tag must be present.
+        case hasTag(AuxTag)
+        /// The tag must be absent.
+        case lacksTag(AuxTag)
+        /// The integer tag must be present with a value in the range.
+        case integerTag(AuxTag, ClosedRange<Int64>)
+        /// The string (`Z`) tag must be present with exactly this value.
+        case stringTag(AuxTag, String)
+        /// An arbitrary predicate over the record.
+        case custom(name: String, predicate: @Sendable (BAMRecordView) -> Bool)
+
+        public var description: String {
+            switch self {
+            case .requireFlags(let f): return "flags & 0x\(String(f.rawValue, radix: 16)) == all"
+            case .excludeFlags(let f): return "flags & 0x\(String(f.rawValue, radix: 16)) == 0"
+            case .mappingQuality(let r): return "mapq in \(r.lowerBound)...\(r.upperBound)"
+            case .contig(let tid): return "tid == \(tid)"
+            case .overlaps(let tid, let r): return "overlaps \(tid):\(r.lowerBound)-\(r.upperBound)"
+            case .sequenceLength(let r): return "length in \(r.lowerBound)...\(r.upperBound)"
+            case .readGroups(let groups): return "RG in [\(groups.sorted().joined(separator: ","))]"
+            case .hasTag(let tag): return "has \(tag)"
+            case .lacksTag(let tag): return "lacks \(tag)"
+            case .integerTag(let tag, let r): return "\(tag) in \(r.lowerBound)...\(r.upperBound)"
+            case .stringTag(let tag, let value): return "\(tag) == \(value)"
+            case .custom(let name, _): return name
+            }
+        }
+    }
+
+    /// The clauses, all of which must pass.
+    public private(set) var clauses: [Clause]
+
+    /// Create a filter from explicit clauses (an empty filter accepts everything).
+    public init(_ clauses: [Clause] = []) {
+        self.clauses = clauses
+    }
+
+    /// Return a copy with `clause` appended.
+    public func adding(_ clause: Clause) -> RecordFilter {
+        var copy = self
+        copy.clauses.append(clause)
+        return copy
+    }
+
+    /// Require all of `flags` to be set.
+    public func requiringFlags(_ flags: AlignmentFlag) -> RecordFilter { adding(.requireFlags(flags)) }
+
+    /// Reject records with any of `flags` set.
+    public func excludingFlags(_ flags: AlignmentFlag) -> RecordFilter { adding(.excludeFlags(flags)) }
+
+    /// Require a mapping quality of at least `minimum`.
+    public func mappingQuality(atLeast minimum: UInt8) -> RecordFilter { adding(.mappingQuality(minimum...255)) }
+
+    /// Require placement on contig `tid`.
+    public func contig(_ tid: Int32) -> RecordFilter { adding(.contig(tid)) }
+
+    /// Require overlap with a 0-based half-open region.
+    public func overlapping(contigID: Int32, _ range: Range<Int64>) -> RecordFilter {
+        adding(.overlaps(contigID: contigID, range: range))
+    }
+
+    /// Require a query sequence length within `range`.
+    public func sequenceLength(_ range: ClosedRange<Int32>) -> RecordFilter { adding(.sequenceLength(range)) }
+
+    /// Require the `RG` tag to be one of `groups`.
+    public func readGroups(_ groups: Set<String>) -> RecordFilter { adding(.readGroups(groups)) }
+
+    /// Require `tag` to be present.
+    public func hasTag(_ tag: AuxTag) -> RecordFilter { adding(.hasTag(tag)) }
+
+    /// Require `tag` to be absent.
+    public func lacksTag(_ tag: AuxTag) -> RecordFilter { adding(.lacksTag(tag)) }
+
+    /// Require integer `tag` to be within `range`.
+    public func tag(_ tag: AuxTag, in range: ClosedRange<Int64>) -> RecordFilter { adding(.integerTag(tag, range)) }
+
+    /// Require string `tag` to equal `value`.
+    public func tag(_ tag: AuxTag, equals value: String) -> RecordFilter { adding(.stringTag(tag, value)) }
+
+    /// Add an arbitrary predicate, reported under `name` in the statistics.
+    public func matching(_ name: String, _ predicate: @escaping @Sendable (BAMRecordView) -> Bool) -> RecordFilter {
+        adding(.custom(name: name, predicate: predicate))
+    }
+
+    /// Compile the filter into an evaluator with its own hit counters.
+    public func compile() -> CompiledRecordFilter {
+        CompiledRecordFilter(self)
+    }
+}
+
+// MARK: - FilterStatistics
+
+/// Hit counters reported by a ``CompiledRecordFilter``.
+public struct FilterStatistics: Sendable, Equatable, CustomStringConvertible {
+    /// A compiled step and the number of records it rejected.
+    public struct Step: Sendable, Equatable {
+        /// Human-readable description of the step.
+        public let name: String
+        /// Records rejected by this step (each record is charged to the first failing step).
+        public let rejected: Int
+    }
+
+    /// Records examined.
+    public let examined: Int
+    /// Records that passed every step.
+    public let passed: Int
+    /// Per-step rejection counts, in evaluation order.
+    public let steps: [Step]
+
+    /// Records rejected by any step.
+    public var rejected: Int { examined - passed }
+
+    public var description: String {
+        var lines = ["examined \(examined), passed \(passed)"]
+        for step in steps {
+            lines.append("  \(step.name): \(step.rejected)")
+        }
+        return lines.joined(separator: "\n")
+    }
+}
+
+// MARK: - CompiledRecordFilter
+
+/// A ``RecordFilter`` compiled for evaluation on raw records.
+///
+/// Compilation fuses all flag clauses into one required/excluded mask pair, intersects
+/// mapping-quality and length ranges, pre-encodes string comparands as bytes, and orders
+/// the steps so cheap core-field checks run before auxiliary-tag lookups.
+///
+/// A compiled filter keeps mutable counters and is not thread-safe; compile one per
+/// iterator.
+public final class CompiledRecordFilter {
+    private enum Step {
+        case flags(required: UInt16, excluded: UInt16)
+        case mappingQuality(UInt8, UInt8)
+        case contig(Int32)
+        case overlaps(Int32, Int64, Int64)
+        case length(Int32, Int32)
+        case hasTag(AuxTag)
+        case lacksTag(AuxTag)
+        case integerTag(AuxTag, Int64, Int64)
+        case stringTag(AuxTag, [[UInt8]])
+        case custom(@Sendable (BAMRecordView) -> Bool)
+    }
+
+    /// The source filter.
+    public let filter: RecordFilter
+    private let steps: ContiguousArray<Step>
+    private let names: [String]
+    private var rejections: [Int]
+    private var examined = 0
+    private var passed = 0
+
+    init(_ filter: RecordFilter) {
+        self.filter = filter
+        var required: UInt16 = 0
+        var excluded: UInt16 = 0
+        // Ranges are intersected; an empty intersection (lo > hi) rejects everything.
+        var mapq: (lo: UInt8, hi: UInt8)?
+        var length: (lo: Int32, hi: Int32)?
+        var core: [(Step, String)] = []
+        var aux: [(Step, String)] = []
+        var custom: [(Step, String)] = []
+
+        for clause in filter.clauses {
+            switch clause {
+            case .requireFlags(let f): required |= f.rawValue
+            case .excludeFlags(let f): excluded |= f.rawValue
+            case .mappingQuality(let r):
+                mapq = (max(mapq?.lo ?? r.lowerBound, r.lowerBound), min(mapq?.hi ?? r.upperBound, r.upperBound))
+            case .sequenceLength(let r):
+                length = (max(length?.lo ?? r.lowerBound, r.lowerBound), min(length?.hi ?? r.upperBound, r.upperBound))
+            case .contig(let tid): core.append((.contig(tid), clause.description))
+            case .overlaps(let tid, let r):
+                core.append((.overlaps(tid, r.lowerBound, r.upperBound), clause.description))
+            case .readGroups(let groups):
+                aux.append((.stringTag(.RG, groups.sorted().map { Array($0.utf8) }), clause.description))
+            case .hasTag(let tag): aux.append((.hasTag(tag), clause.description))
+            case .lacksTag(let tag): aux.append((.lacksTag(tag), clause.description))
+            case .integerTag(let tag, let r):
+                aux.append((.integerTag(tag, r.lowerBound, r.upperBound), clause.description))
+            case .stringTag(let tag, let value):
+                aux.append((.stringTag(tag, [Array(value.utf8)]), clause.description))
+            case .custom(_, let predicate): custom.append((.custom(predicate), clause.description))
+            }
+        }
+
+        var ordered: [(Step, String)] = []
+        if required != 0 || excluded != 0 {
+            ordered.append((.flags(required: required, excluded: excluded),
+                            "flags +0x\(String(required, radix: 16)) -0x\(String(excluded, radix: 16))"))
+        }
+        if let mapq {
+            ordered.append((.mappingQuality(mapq.lo, mapq.hi), "mapq in \(mapq.lo)...\(mapq.hi)"))
+        }
+        if let length {
+            ordered.append((.length(length.lo, length.hi), "length in \(length.lo)...\(length.hi)"))
+        }
+        ordered += core + aux + custom
+
+        self.steps = ContiguousArray(ordered.map(\.0))
+        self.names = ordered.map(\.1)
+        self.rejections = [Int](repeating: 0, count: ordered.count)
+    }
+
+    /// Evaluate the filter on a raw record, updating the counters.
+    ///
+    /// - Returns: `true` if the record passes every step.
+    public func accepts(_ record: UnsafePointer<bam1_t>) -> Bool {
+        examined += 1
+        let core = record.pointee.core
+        for i in steps.indices {
+            let ok: Bool
+            switch steps[i] {
+            case .flags(let required, let excluded):
+                ok = core.flag & required == required && core.flag & excluded == 0
+            case .mappingQuality(let lo, let hi):
+                ok = core.qual >= lo && core.qual <= hi
+            case .contig(let tid):
+                ok = core.tid == tid
+            case .overlaps(let tid, let start, let end):
+                ok = core.tid == tid && core.pos < end && bam_endpos(record) > start
+            case .length(let lo, let hi):
+                ok = core.l_qseq >= lo && core.l_qseq <= hi
+            case .hasTag(let tag):
+                ok = Self.field(record, tag) != nil
+            case .lacksTag(let tag):
+                ok = Self.field(record, tag) == nil
+            case .integerTag(let tag, let lo, let hi):
+                if let data = Self.field(record, tag), let value = AuxDecoder.integer(data) {
+                    ok = value >= lo && value <= hi
+                } else {
+                    ok = false
+                }
+            case .stringTag(let tag, let values):
+                if let data = Self.field(record, tag), data[0] == UInt8(ascii: "Z") {
+                    ok = values.contains { Self.matchesCString(data + 1, $0) }
+                } else {
+                    ok = false
+                }
+            case .custom(let predicate):
+                ok = predicate(BAMRecordView(pointer: record))
+            }
+            if !ok {
+                rejections[i] += 1
+                return false
+            }
+        }
+        passed += 1
+        return true
+    }
+
+    /// Evaluate the filter on a record, updating the counters.
+    public func accepts(_ record: borrowing BAMRecord) -> Bool {
+        accepts(UnsafePointer(record.pointer))
+    }
+
+    /// A snapshot of the hit counters.
+    public var statistics: FilterStatistics {
+        FilterStatistics(examined: examined, passed: passed,
+                         steps: zip(names, rejections).map { FilterStatistics.Step(name: $0, rejected: $1) })
+    }
+
+    /// Zero the hit counters.
+    public func resetCounters() {
+        examined = 0
+        passed = 0
+        for i in rejections.indices { rejections[i] = 0 }
+    }
+
+    @inline(__always)
+    private static func field(_ record: UnsafePointer<bam1_t>, _ tag: AuxTag) -> UnsafePointer<UInt8>? {
+        tag.withCTag { bam_aux_get(record, $0).map { UnsafePointer($0) } }
+    }
+
+    /// Compare a NUL-terminated string with `bytes` without building a `String`.
+    @inline(__always)
+    private static func matchesCString(_ s: UnsafePointer<UInt8>, _ bytes: [UInt8]) -> Bool {
+        for i in bytes.indices where s[i] != bytes[i] {
+            return false
+        }
+        return s[bytes.count] == 0
+    }
+}
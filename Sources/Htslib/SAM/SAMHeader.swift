@@ -18,6 +18,11 @@ public final class SAMHeader: @unchecked Sendable {
         self.owned = owned
     }
 
+    /// The underlying `sam_hdr_t` pointer, for APIs such as ``PileupIterator`` that take raw handles.
+    ///
+    /// The pointer is owned by this header and is only valid while it is alive.
+    public var rawPointer: UnsafeMutablePointer<sam_hdr_t> { pointer }
+
     /// Create an empty SAM header.
     ///
     /// - Throws: ``HTSError/outOfMemory`` if allocation fails.
@@ -202,6 +207,46 @@ public final class SAMHeader: @unchecked Sendable {
         if ret < 0 { throw HTSError.headerWriteFailed }
     }
 
+    /// Remove every line of a type except the one with a given identifying tag value.
+    ///
+    /// - Parameters:
+    ///   - type: The two-character record type (e.g. `"RG"`).
+    ///   - idKey: The identifying tag key (e.g. `"ID"`).
+    ///   - idValue: The value of the line to keep (e.g. `"rg1"`).
+    /// - Throws: ``HTSError/headerWriteFailed`` on failure.
+    public func removeLines(type: String, keeping idKey: String, _ idValue: String) throws {
+        let ret = type.withCString { t in
+            idKey.withCString { k in
+                idValue.withCString { v in
+                    sam_hdr_remove_except(pointer, t, k, v)
+                }
+            }
+        }
+        if ret < 0 { throw HTSError.headerWriteFailed }
+    }
+
+    /// The `SO` (sort order) field of the `@HD` line, or `nil` if absent.
+    public var sortOrder: String? {
+        findTag(type: "HD", key: "SO")
+    }
+
+    /// Set the `@HD` sort order, adding an `@HD` line if there is none.
+    ///
+    /// - Parameters:
+    ///   - sortOrder: The `SO` value: `"unknown"`, `"unsorted"`, `"queryname"` or `"coordinate"`.
+    ///   - subSort: An optional `SS` value (e.g. `"coordinate:MI"`); any existing `SS` is
+    ///     removed when `nil`.
+    /// - Throws: ``HTSError/headerWriteFailed`` on failure.
+    public func setSortOrder(_ sortOrder: String, subSort: String? = nil) throws {
+        let ret = sortOrder.withCString { so in
+            if let subSort {
+                return subSort.withCString { ss in hts_shim_sam_hdr_set_sort_order(pointer, so, ss) }
+            }
+            return hts_shim_sam_hdr_set_sort_order(pointer, so, nil)
+        }
+        if ret < 0 { throw HTSError.headerWriteFailed }
+    }
+
     /// Count the number of lines of a given type.
     ///
     /// - Parameter type: The two-character record type (e.g. `"SQ"`, `"RG"`).
@@ -13,6 +13,9 @@ import CHTSlibShims
 ///     print(record.queryName)
 /// }
 /// ```
+///
+/// For high-throughput scans, ``forEach(_:)`` and ``read(into:)`` decode every record
+/// into a single reused ``BAMRecord`` instead of allocating one per record.
 public final class SAMRecordIterator {
     private let file: UnsafeMutablePointer<htsFile>
     private let header: UnsafeMutablePointer<sam_hdr_t>
@@ -25,12 +28,31 @@ public final class SAMRecordIterator {
         self.record = bam_init1()
     }
 
+    /// The filter applied to records before they are returned, or `nil` for none.
+    ///
+    /// Rejected records are skipped inside the read loop and never reach the caller.
+    public var filter: CompiledRecordFilter?
+
+    /// Compile `filter` and apply it to every subsequent read.
+    ///
+    /// - Parameter filter: The ``RecordFilter`` to apply.
+    /// - Returns: The compiled filter, whose ``CompiledRecordFilter/statistics`` report hit counts.
+    @discardableResult
+    public func setFilter(_ filter: RecordFilter) -> CompiledRecordFilter {
+        let compiled = filter.compile()
+        self.filter = compiled
+        return compiled
+    }
+
     /// Read the next alignment record.
     ///
     /// - Returns: The next ``BAMRecord``, or `nil` at end-of-file.
     public func next() -> BAMRecord? {
         guard !exhausted, let rec = record else { return nil }
-        let ret = sam_read1(file, header, rec)
+        var ret = sam_read1(file, header, rec)
+        while ret >= 0, let filter, !filter.accepts(rec) {
+            ret = sam_read1(file, header, rec)
+        }
         if ret >= 0 {
             let result = rec
             self.record = bam_init1()
@@ -41,6 +63,45 @@ public final class SAMRecordIterator {
         }
     }
 
+    /// Read the next alignment record into an existing record, reusing its storage.
+    ///
+    /// The record's `bam1_t` buffer is grown only when a longer record is encountered,
+    /// so a scan that reads into one record performs no per-record allocation.
+    ///
+    /// - Parameter record: The ``BAMRecord`` to overwrite with the next record.
+    /// - Returns: `true` if a record was read, `false` at end-of-file.
+    /// - Throws: ``HTSError/readFailed(code:)`` on a decoding or I/O error.
+    public func read(into record: inout BAMRecord) throws -> Bool {
+        guard !exhausted else { return false }
+        var ret = sam_read1(file, header, record.pointer)
+        while ret >= 0, let filter, !filter.accepts(record.pointer) {
+            ret = sam_read1(file, header, record.pointer)
+        }
+        if ret >= 0 { return true }
+        exhausted = true
+        if ret == -1 { return false }
+        throw HTSError.readFailed(code: ret)
+    }
+
+    /// Visit every remaining record through a single reused ``BAMRecord``.
+    ///
+    /// The record passed to `body` is only valid for the duration of the call; use
+    /// ``BAMRecord/copy()`` to keep an owned record beyond that.
+    /// ```swift
+    /// try iterator.forEach { record in
+    ///     if record.mappingQuality >= 30 { mapped += 1 }
+    /// }
+    /// ```
+    ///
+    /// - Parameter body: A closure invoked with each record in file order.
+    /// - Throws: ``HTSError/readFailed(code:)`` on a decoding error, or any error thrown by `body`.
+    public func forEach(_ body: (borrowing BAMRecord) throws -> Void) throws {
+        var record = try BAMRecord()
+        while try read(into: &record) {
+            try body(record)
+        }
+    }
+
     deinit {
         if let rec = record {
             bam_destroy1(rec)
@@ -70,12 +131,31 @@ public final class SAMQueryIterator {
         self.record = bam_init1()
     }
 
+    /// The filter applied to records before they are returned, or `nil` for none.
+    ///
+    /// Rejected records are skipped inside the read loop and never reach the caller.
+    public var filter: CompiledRecordFilter?
+
+    /// Compile `filter` and apply it to every subsequent read.
+    ///
+    /// - Parameter filter: The ``RecordFilter`` to apply.
+    /// - Returns: The compiled filter, whose ``CompiledRecordFilter/statistics`` report hit counts.
+    @discardableResult
+    public func setFilter(_ filter: RecordFilter) -> CompiledRecordFilter {
+        let compiled = filter.compile()
+        self.filter = compiled
+        return compiled
+    }
+
     /// Read the next alignment record in the queried region.
     ///
     /// - Returns: The next ``BAMRecord`` overlapping the region, or `nil` when exhausted.
     public func next() -> BAMRecord? {
         guard !exhausted, let rec = record else { return nil }
-        let ret = hts_shim_sam_itr_next(file, iterator, rec)
+        var ret = hts_shim_sam_itr_next(file, iterator, rec)
+        while ret >= 0, let filter, !filter.accepts(rec) {
+            ret = hts_shim_sam_itr_next(file, iterator, rec)
+        }
         if ret >= 0 {
             let result = rec
             self.record = bam_init1()
@@ -86,6 +166,37 @@ public final class SAMQueryIterator {
         }
     }
 
+    /// Read the next record in the queried region into an existing record, reusing its storage.
+    ///
+    /// - Parameter record: The ``BAMRecord`` to overwrite with the next overlapping record.
+    /// - Returns: `true` if a record was read, `false` when the region is exhausted.
+    /// - Throws: ``HTSError/readFailed(code:)`` on a decoding or I/O error.
+    public func read(into record: inout BAMRecord) throws -> Bool {
+        guard !exhausted else { return false }
+        var ret = hts_shim_sam_itr_next(file, iterator, record.pointer)
+        while ret >= 0, let filter, !filter.accepts(record.pointer) {
+            ret = hts_shim_sam_itr_next(file, iterator, record.pointer)
+        }
+        if ret >= 0 { return true }
+        exhausted = true
+        if ret == -1 { return false }
+        throw HTSError.readFailed(code: ret)
+    }
+
+    /// Visit every remaining record in the queried region through a single reused ``BAMRecord``.
+    ///
+    /// The record passed to `body` is only valid for the duration of the call; use
+    /// ``BAMRecord/copy()`` to keep an owned record beyond that.
+    ///
+    /// - Parameter body: A closure invoked with each overlapping record.
+    /// - Throws: ``HTSError/readFailed(code:)`` on a decoding error, or any error thrown by `body`.
+    public func forEach(_ body: (borrowing BAMRecord) throws -> Void) throws {
+        var record = try BAMRecord()
+        while try read(into: &record) {
+            try body(record)
+        }
+    }
+
     deinit {
         hts_itr_destroy(iterator)
         if let rec = record {
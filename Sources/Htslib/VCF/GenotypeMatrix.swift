@@ -0,0 +1,284 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - GenotypeMatrix
+
+/// Packed GT calls for every sample of one record, decoded into reusable buffers.
+///
+/// ``VCFRecord/genotypes(header:)`` builds a ``Genotype`` with two arrays per sample;
+/// on large cohorts that is millions of allocations per site. A matrix instead decodes
+/// GT straight from the record's typed bytes into buffers kept across records:
+///
+/// - Sites with at most two alleles use 2 bits per allele slot (REF, ALT, missing, absent).
+/// - Multiallelic sites use a byte per slot, or 16 bits beyond 254 alleles.
+/// - A phase bitmask and a missing bitmask hold one bit per sample.
+///
+/// Site summaries (allele counts and frequencies, het/hom-alt/missing counts and call
+/// rate) run over the packed slots; diploid biallelic sites are classified 16 samples per
+/// 64-bit word with bitwise lane tests and popcounts.
+///
+/// ```swift
+/// let matrix = GenotypeMatrix()
+/// while let record = iter.next() {
+///     guard matrix.decode(record, header: header) else { continue }
+///     let summary = matrix.summary()
+///     print(summary.alleleFrequencies, summary.callRate)
+/// }
+/// ```
+public final class GenotypeMatrix {
+    /// How allele slots are stored.
+    public enum Encoding: Sendable {
+        /// 2 bits per slot: 0 = REF, 1 = ALT, 2 = missing, 3 = absent.
+        case twoBit
+        /// 8 bits per slot: the allele index, 0xFE = missing, 0xFF = absent.
+        case byte
+        /// 16 bits per slot: the allele index, 0xFFFE = missing, 0xFFFF = absent.
+        case wide
+    }
+
+    /// Counts over all samples at one site.
+    public struct Summary: Sendable, Hashable {
+        /// Samples in the record.
+        public let samples: Int
+        /// Called (non-missing) alleles, as in INFO/AN.
+        public let alleleNumber: Int
+        /// Called alleles per allele index; index 0 is REF, as in INFO/AC for the rest.
+        public let alleleCounts: [Int]
+        /// Samples with at least two called alleles, all REF.
+        public let homRef: Int
+        /// Samples with at least two called alleles that differ.
+        public let het: Int
+        /// Samples with at least two called alleles, all the same ALT.
+        public let homAlt: Int
+        /// Samples whose alleles are all missing.
+        public let missing: Int
+
+        /// ALT allele frequencies (`alleleCounts[i] / alleleNumber` for i ≥ 1), as in INFO/AF.
+        public var alleleFrequencies: [Double] {
+            alleleCounts.dropFirst().map { alleleNumber > 0 ? Double($0) / Double(alleleNumber) : 0 }
+        }
+
+        /// The fraction of samples with at least one called allele.
+        public var callRate: Double {
+            samples > 0 ? Double(samples - missing) / Double(samples) : 0
+        }
+    }
+
+    /// Samples decoded by the last ``decode(_:header:)``.
+    public private(set) var sampleCount = 0
+    /// Allele slots per sample (the record's maximum ploidy).
+    public private(set) var ploidy = 0
+    /// Alleles at the site, including REF.
+    public private(set) var alleleCount = 0
+    /// The storage used for the current site.
+    public private(set) var encoding: Encoding = .twoBit
+
+    private var words: [UInt64] = []
+    private var bytes: [UInt8] = []
+    private var wide: [UInt16] = []
+    private var phasedMask: [UInt64] = []
+    private var missingMask: [UInt64] = []
+    private var counts: [Int64] = []
+
+    // The GT header ID, resolved once per header.
+    private var gtID: Int32 = -1
+    private var gtHeader: UnsafeMutablePointer<bcf_hdr_t>?
+
+    /// Create an empty matrix. Buffers grow to the largest site decoded and are then reused.
+    public init() {}
+
+    // MARK: - Decoding
+
+    /// Decode the GT calls of `record`, replacing the current site.
+    ///
+    /// - Parameters:
+    ///   - record: The record; its FORMAT fields are unpacked if needed.
+    ///   - header: The ``VCFHeader`` for the record's file.
+    /// - Returns: `false` if the record has no GT field or no samples.
+    @discardableResult
+    public func decode(_ record: borrowing VCFRecord, header: VCFHeader) -> Bool {
+        if gtHeader != header.pointer {
+            gtID = bcf_hdr_id2int(header.pointer, Int32(BCF_DT_ID), "GT")
+            gtHeader = header.pointer
+        }
+        sampleCount = 0
+        ploidy = 0
+        let n = record.nSamples
+        guard n > 0, let fmt = hts_shim_gt_field(record.pointer, gtID) else { return false }
+
+        let nSamples = Int32(n)
+        let slots = n * Int(fmt.pointee.n)
+        let maskWords = (n + 63) / 64
+        Self.grow(&phasedMask, to: maskWords)
+        Self.grow(&missingMask, to: maskWords)
+        alleleCount = record.nAlleles
+
+        var packed = false
+        if alleleCount <= 2 {
+            Self.grow(&words, to: (slots + 31) / 32)
+            packed = words.withUnsafeMutableBufferPointer { w in
+                phasedMask.withUnsafeMutableBufferPointer { p in
+                    missingMask.withUnsafeMutableBufferPointer { m in
+                        hts_shim_gt_pack2(fmt, nSamples, w.baseAddress, p.baseAddress, m.baseAddress) == 0
+                    }
+                }
+            }
+            encoding = .twoBit
+        }
+        if !packed && alleleCount <= 254 {
+            Self.grow(&bytes, to: slots)
+            packed = bytes.withUnsafeMutableBufferPointer { b in
+                phasedMask.withUnsafeMutableBufferPointer { p in
+                    missingMask.withUnsafeMutableBufferPointer { m in
+                        hts_shim_gt_pack8(fmt, nSamples, b.baseAddress, p.baseAddress, m.baseAddress) == 0
+                    }
+                }
+            }
+            encoding = .byte
+        }
+        if !packed {
+            Self.grow(&wide, to: slots)
+            wide.withUnsafeMutableBufferPointer { c in
+                phasedMask.withUnsafeMutableBufferPointer { p in
+                    missingMask.withUnsafeMutableBufferPointer { m in
+                        hts_shim_gt_pack16(fmt, nSamples, c.baseAddress, p.baseAddress, m.baseAddress)
+                    }
+                }
+            }
+            encoding = .wide
+        }
+        sampleCount = n
+        ploidy = Int(fmt.pointee.n)
+        return true
+    }
+
+    private static func grow<T: FixedWidthInteger>(_ buffer: inout [T], to count: Int) {
+        if buffer.count < count {
+            buffer = [T](repeating: 0, count: count)
+        }
+    }
+
+    // MARK: - Access
+
+    /// The allele index in one slot of a sample's call.
+    ///
+    /// - Parameters:
+    ///   - sample: Sample index.
+    ///   - slot: Allele position, below ``ploidy``.
+    /// - Returns: The allele index (0 = REF), or `nil` if missing or absent.
+    public func allele(sample: Int, slot: Int) -> Int? {
+        precondition(sample < sampleCount && slot < ploidy, "Genotype slot out of range")
+        let i = sample * ploidy + slot
+        switch encoding {
+        case .twoBit:
+            let code = Int((words[i >> 5] >> UInt64((i & 31) * 2)) & 3)
+            return code < 2 ? code : nil
+        case .byte:
+            return bytes[i] < 0xFE ? Int(bytes[i]) : nil
+        case .wide:
+            return wide[i] < 0xFFFE ? Int(wide[i]) : nil
+        }
+    }
+
+    /// Whether a sample has at least two alleles and every separator is phased (`|`).
+    public func isPhased(sample: Int) -> Bool {
+        precondition(sample < sampleCount, "Sample index out of range")
+        return phasedMask[sample >> 6] & (1 << UInt64(sample & 63)) != 0
+    }
+
+    /// Whether all of a sample's alleles are missing.
+    public func isMissing(sample: Int) -> Bool {
+        precondition(sample < sampleCount, "Sample index out of range")
+        return missingMask[sample >> 6] & (1 << UInt64(sample & 63)) != 0
+    }
+
+    /// A sample's call as a ``Genotype``, for code that needs the per-sample form.
+    ///
+    /// The matrix keeps one phase bit per sample, so every separator gets the same phasing.
+    public func genotype(sample: Int) -> Genotype {
+        var alleles: [Int?] = []
+        var phased: [Bool] = []
+        let isPhased = isPhased(sample: sample)
+        for slot in 0..<ploidy {
+            let i = sample * ploidy + slot
+            let absent: Bool
+            switch encoding {
+            case .twoBit: absent = (words[i >> 5] >> UInt64((i & 31) * 2)) & 3 == 3
+            case .byte: absent = bytes[i] == 0xFF
+            case .wide: absent = wide[i] == 0xFFFF
+            }
+            if absent { break }
+            alleles.append(allele(sample: sample, slot: slot))
+            phased.append(slot > 0 && isPhased)
+        }
+        return Genotype(alleles: alleles, phased: phased)
+    }
+
+    /// Call `body` with the packed slots of the current site, laid out per ``encoding``.
+    public func withUnsafePackedSlots<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+        let slots = sampleCount * ploidy
+        switch encoding {
+        case .twoBit:
+            return try words.withUnsafeBytes { try body(UnsafeRawBufferPointer(rebasing: $0[..<((slots + 31) / 32 * 8)])) }
+        case .byte:
+            return try bytes.withUnsafeBytes { try body(UnsafeRawBufferPointer(rebasing: $0[..<slots])) }
+        case .wide:
+            return try wide.withUnsafeBytes { try body(UnsafeRawBufferPointer(rebasing: $0[..<(slots * 2)])) }
+        }
+    }
+
+    /// Call `body` with the phase and missing bitmasks; bit `s % 64` of word `s / 64` is sample `s`.
+    public func withUnsafeMasks<R>(
+        _ body: (_ phased: UnsafeBufferPointer<UInt64>, _ missing: UnsafeBufferPointer<UInt64>) throws -> R
+    ) rethrows -> R {
+        let n = (sampleCount + 63) / 64
+        return try phasedMask.withUnsafeBufferPointer { p in
+            try missingMask.withUnsafeBufferPointer { m in
+                try body(UnsafeBufferPointer(rebasing: p[..<n]), UnsafeBufferPointer(rebasing: m[..<n]))
+            }
+        }
+    }
+
+    // MARK: - Summary
+
+    /// Allele counts and genotype classes over all samples at the current site.
+    public func summary() -> Summary {
+        var out = hts_shim_gt_summary_t()
+        let nSamples = Int32(sampleCount)
+        let nPloidy = Int32(ploidy)
+        // The 2-bit kernel always writes REF and ALT counts, even at REF-only sites.
+        let countSlots = max(alleleCount, 2)
+        if counts.count < countSlots {
+            counts = [Int64](repeating: 0, count: countSlots)
+        } else {
+            for i in 0..<countSlots { counts[i] = 0 }
+        }
+        counts.withUnsafeMutableBufferPointer { c in
+            missingMask.withUnsafeBufferPointer { m in
+                switch encoding {
+                case .twoBit:
+                    words.withUnsafeBufferPointer {
+                        hts_shim_gt_summary2($0.baseAddress, nSamples, nPloidy, m.baseAddress, &out, c.baseAddress)
+                    }
+                case .byte:
+                    bytes.withUnsafeBufferPointer {
+                        hts_shim_gt_summary8($0.baseAddress, nSamples, nPloidy, Int32(alleleCount),
+                                             m.baseAddress, &out, c.baseAddress)
+                    }
+                case .wide:
+                    wide.withUnsafeBufferPointer {
+                        hts_shim_gt_summary16($0.baseAddress, nSamples, nPloidy, Int32(alleleCount),
+                                              m.baseAddress, &out, c.baseAddress)
+                    }
+                }
+            }
+        }
+        return Summary(samples: sampleCount, alleleNumber: Int(out.allele_number),
+                       alleleCounts: counts[..<alleleCount].map { Int($0) },
+                       homRef: Int(out.hom_ref), het: Int(out.het), homAlt: Int(out.hom_alt),
+                       missing: Int(out.missing))
+    }
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - ParallelVCFReader
+
+/// A VCF text reader whose lines are parsed into records on a shared ``ThreadPool``.
+///
+/// For BCF, reading is dominated by BGZF decompression, which htslib already spreads
+/// over a pool. For VCF text, `vcf_parse` — tokenizing every column and converting every
+/// per-sample value — dominates, and ``HTSFile/vcfIterator(header:)`` runs it on the
+/// calling thread. Here a reading job splits the decompressed text into chunks of whole
+/// lines and each chunk is parsed by its own job on the pool. Records still come back in
+/// file order: chunks sit in a bounded ring that is drained in order, so at most
+/// `chunksInFlight` chunks are parsed ahead of the consumer.
+///
+/// ```swift
+/// let pool = try ThreadPool(threads: 8)
+/// let reader = try ParallelVCFReader(path: "cohort.vcf.gz", pool: pool, decompressionThreads: 2)
+/// while let record = try reader.next() {
+///     print(record.position)
+/// }
+/// ```
+///
+/// Lines naming a contig, FILTER or INFO/FORMAT tag that the header does not declare make
+/// htslib add a header record as it parses them. Such lines are parsed on the consuming
+/// thread, in order, so ``header`` is only changed there.
+///
+/// The reader keeps the pool alive until it is released. The pool should not also be
+/// used for the file's BGZF decompression: parse jobs would then wait on decompression
+/// jobs queued behind them. Use `decompressionThreads` instead, which gives the file a
+/// pool of its own.
+public final class ParallelVCFReader {
+    private let filePointer: UnsafeMutablePointer<htsFile>
+    private let parser: OpaquePointer  // hts_shim_vcf_parser_t*
+    private let pool: ThreadPool.Storage
+
+    /// The VCF header. Parsing may add records for undeclared names; see the type discussion.
+    public let header: VCFHeader
+
+    /// The file path.
+    public let path: String
+
+    /// Open a VCF file and start parsing ahead.
+    ///
+    /// - Parameters:
+    ///   - path: Path to a VCF file, plain or BGZF-compressed.
+    ///   - pool: The pool that runs parsing jobs; the reader keeps it alive.
+    ///   - linesPerChunk: Lines parsed per job.
+    ///   - chunksInFlight: Chunks buffered ahead of the consumer; defaults to twice the pool size.
+    ///   - decompressionThreads: Threads for a separate BGZF decompression pool; 0 decompresses
+    ///     in the reading job.
+    ///   - fields: If set, decode only these fields; records are returned unpacked to the
+    ///     levels they need and ``header``'s samples are subset. See ``VCFFieldSelection``.
+    /// - Throws: ``HTSError/openFailed(path:mode:)``, ``HTSError/headerReadFailed``,
+    ///   ``HTSError/invalidArgument(message:)`` if the file is not VCF text,
+    ///   ``HTSError/tagNotFound(tag:)`` if a selected key is not in the header,
+    ///   or ``HTSError/outOfMemory``, also if the decompression threads cannot be started.
+    public init(
+        path: String, pool: borrowing ThreadPool, linesPerChunk: Int = 1024, chunksInFlight: Int? = nil,
+        decompressionThreads: Int32 = 0, fields: VCFFieldSelection? = nil
+    ) throws {
+        guard let fp = hts_open(path, "r") else {
+            throw HTSError.openFailed(path: path, mode: "r")
+        }
+        guard HTSFileFormat(from: fp.pointee.format.format) == .vcf else {
+            hts_close(fp)
+            throw HTSError.invalidArgument(message: "Not a VCF text file: \(path)")
+        }
+        guard let hdr = bcf_hdr_read(fp) else {
+            hts_close(fp)
+            throw HTSError.headerReadFailed
+        }
+        self.header = VCFHeader(pointer: hdr)
+        do {
+            try fields?.apply(to: hdr, strict: true)
+        } catch {
+            hts_close(fp)
+            throw error
+        }
+        if decompressionThreads > 0, hts_set_threads(fp, decompressionThreads) < 0 {
+            hts_close(fp)
+            throw HTSError.outOfMemory
+        }
+
+        let chunks = chunksInFlight ?? Int(hts_tpool_size(pool.pointer)) * 2
+        guard let parser = hts_shim_vcf_parser_init(fp, hdr, pool.pointer, Int32(clamping: linesPerChunk),
+                                                    Int32(clamping: chunks), fields?.unpackFlags ?? 0) else {
+            hts_close(fp)
+            throw HTSError.outOfMemory
+        }
+        self.filePointer = fp
+        self.parser = parser
+        self.pool = pool.storage
+        self.path = path
+    }
+
+    deinit {
+        // Stops the parse jobs before `pool` is released.
+        hts_shim_vcf_parser_destroy(parser)
+        hts_close(filePointer)
+    }
+
+    /// Take the next record, waiting for its chunk to be parsed if necessary.
+    ///
+    /// Each call hands a new, empty record to the parse jobs; use ``read(into:)`` in
+    /// loops to keep buffers circulating.
+    ///
+    /// - Returns: The next ``VCFRecord`` in file order, or `nil` at end-of-file.
+    /// - Throws: ``HTSError/readFailed(code:)`` if the file cannot be read, or
+    ///   ``HTSError/parseFailed(message:)`` if a line is not valid VCF. Errors are sticky.
+    public func next() throws -> VCFRecord? {
+        var record = try VCFRecord()
+        guard try read(into: &record) else { return nil }
+        return record
+    }
+
+    /// Take the next record into an existing record, reusing its storage.
+    ///
+    /// The record's buffers are swapped into the parsed record's slot, so a later line
+    /// is parsed into them; a loop that reads into one record performs no per-record
+    /// allocation once the buffers have grown.
+    ///
+    /// - Parameter record: The ``VCFRecord`` to overwrite with the next record.
+    /// - Returns: `true` if a record was read, `false` at end-of-file.
+    /// - Throws: ``HTSError/readFailed(code:)`` if the file cannot be read, or
+    ///   ``HTSError/parseFailed(message:)`` if a line is not valid VCF. Errors are sticky.
+    public func read(into record: inout VCFRecord) throws -> Bool {
+        let ret = hts_shim_vcf_parser_read(parser, record.pointer)
+        switch ret {
+        case 0:
+            return true
+        case -1:
+            return false
+        case -3:
+            throw HTSError.parseFailed(message: "Invalid VCF line in \(path)")
+        default:
+            throw HTSError.readFailed(code: ret)
+        }
+    }
+
+    /// Number of parsed records buffered ahead of the consumer.
+    public var buffered: Int {
+        Int(hts_shim_vcf_parser_buffered(parser))
+    }
+}
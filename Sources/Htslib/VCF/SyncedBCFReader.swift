@@ -22,6 +22,7 @@ import CHTSlibShims
 /// ```
 public final class SyncedBCFReader {
     private var pointer: UnsafeMutablePointer<bcf_srs_t>
+    private var fields: VCFFieldSelection?
 
     /// Create a new synced BCF reader.
     public init() throws {
@@ -68,6 +69,21 @@ public final class SyncedBCFReader {
         hts_shim_bcf_sr_set_opt_targets_overlap(pointer, overlap)
     }
 
+    /// Decode only the selected fields of every reader's records.
+    ///
+    /// Each header added afterwards has its samples subset per ``VCFFieldSelection/samples``;
+    /// keys and samples a file does not define are skipped. Records returned by
+    /// ``getRecord(at:)`` are unpacked to the levels the selection needs.
+    ///
+    /// - Parameter fields: The fields to decode.
+    /// - Throws: ``HTSError/invalidArgument(message:)`` if readers were already added.
+    public func selectFields(_ fields: VCFFieldSelection) throws {
+        guard nReaders == 0 else {
+            throw HTSError.invalidArgument(message: "Select fields before adding readers")
+        }
+        self.fields = fields
+    }
+
     // MARK: - Readers
 
     /// Add a VCF/BCF file to the synced reader.
@@ -79,6 +95,15 @@ public final class SyncedBCFReader {
         if ret != 1 {
             throw HTSError.openFailed(path: path, mode: "r")
         }
+        // Records are read on the first nextLine(), so the new header can still be subset.
+        if let fields, let header = hts_shim_bcf_sr_get_header(pointer, Int32(nReaders - 1)) {
+            do {
+                try fields.apply(to: header, strict: false)
+            } catch {
+                removeReader(at: nReaders - 1)
+                throw error
+            }
+        }
     }
 
     /// Remove a reader by its 0-based index.
@@ -102,9 +127,15 @@ public final class SyncedBCFReader {
 
     /// Get a copy of the VCF record from reader at `index`.
     /// Returns nil if the reader doesn't have a record at the current position.
+    /// After ``selectFields(_:)`` the copy is unpacked to the selected levels; a record
+    /// that fails to unpack is also returned as nil.
     public func getRecord(at index: Int) -> VCFRecord? {
         guard let line = hts_shim_bcf_sr_get_line(pointer, Int32(index)) else { return nil }
         guard let copy = bcf_dup(line) else { return nil }
+        if let flags = fields?.unpackFlags, flags != 0, bcf_unpack(copy, flags) < 0 {
+            bcf_destroy(copy)
+            return nil
+        }
         return VCFRecord(pointer: copy)
     }
 
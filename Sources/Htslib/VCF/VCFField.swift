@@ -0,0 +1,232 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - VCFFieldValue
+
+/// A value type that ``InfoField`` and ``FormatField`` can read.
+///
+/// `Int32` reads `Type=Integer` fields, `Float` reads `Type=Float` fields and `UInt8`
+/// reads `Type=String` and `Type=Character` fields as raw bytes.
+public protocol VCFFieldValue: BitwiseCopyable {
+    /// The header type this value reads (`BCF_HT_INT`, `BCF_HT_REAL` or `BCF_HT_STR`).
+    static var bcfHeaderType: Int32 { get }
+    /// Whether this is the BCF missing sentinel (`.` in VCF).
+    var isBCFMissing: Bool { get }
+    /// Whether this is the BCF vector-end sentinel padding a short FORMAT vector.
+    var isBCFVectorEnd: Bool { get }
+}
+
+extension Int32: VCFFieldValue {
+    public static var bcfHeaderType: Int32 { Int32(BCF_HT_INT) }
+    public var isBCFMissing: Bool { self == hts_shim_bcf_int32_missing() }
+    public var isBCFVectorEnd: Bool { self == hts_shim_bcf_int32_vector_end() }
+}
+
+extension Float: VCFFieldValue {
+    public static var bcfHeaderType: Int32 { Int32(BCF_HT_REAL) }
+    public var isBCFMissing: Bool { hts_shim_bcf_float_is_missing(self) != 0 }
+    public var isBCFVectorEnd: Bool { hts_shim_bcf_float_is_vector_end(self) != 0 }
+}
+
+extension UInt8: VCFFieldValue {
+    public static var bcfHeaderType: Int32 { Int32(BCF_HT_STR) }
+    public var isBCFMissing: Bool { false }
+    public var isBCFVectorEnd: Bool { self == 0 }
+}
+
+/// Resolve `key` as an INFO or FORMAT field of `header` and check its declared type.
+private func resolveField<Value: VCFFieldValue>(
+    _ key: String, header: VCFHeader, line: Int32, kind: String, as _: Value.Type
+) throws -> Int32 {
+    let id = bcf_hdr_id2int(header.pointer, Int32(BCF_DT_ID), key)
+    let type = hts_shim_bcf_hdr_field_type(header.pointer, line, id)
+    guard type >= 0 else { throw HTSError.tagNotFound(tag: key) }
+    guard type == Value.bcfHeaderType else {
+        throw HTSError.invalidArgument(message: "\(kind) field \(key) is not readable as \(Value.self)")
+    }
+    return id
+}
+
+// MARK: - InfoField
+
+/// A reusable reader for one INFO field, resolved once against a header.
+///
+/// ``VCFRecord/infoInt32(forKey:header:)`` and its siblings look the key up in the
+/// header dictionary and allocate a fresh array on every call. An `InfoField` resolves
+/// the tag ID and checks its type once, then decodes into a scratch buffer that only
+/// grows, so reading a field in a loop over millions of records does no allocation
+/// or string hashing:
+///
+/// ```swift
+/// let dp = try InfoField<Int32>("DP", header: header)
+/// while let record = iter.next() {
+///     if let depth = dp.first(in: record), depth >= 10 { ... }
+/// }
+/// ```
+///
+/// A field holds mutable scratch state; use one per thread.
+public final class InfoField<Value: VCFFieldValue> {
+    /// The INFO key.
+    public let key: String
+    /// The header the field was resolved against; records must come from files sharing it.
+    public let header: VCFHeader
+    /// The header dictionary ID of the key.
+    public let id: Int32
+
+    private var buffer: UnsafeMutableRawPointer?
+    private var capacity: Int32 = 0
+
+    /// Resolve an INFO field.
+    ///
+    /// - Parameters:
+    ///   - key: The INFO key (e.g. `"DP"`, `"AF"`).
+    ///   - header: The ``VCFHeader`` records will be read with.
+    /// - Throws: ``HTSError/tagNotFound(tag:)`` if the header defines no such INFO field,
+    ///   or ``HTSError/invalidArgument(message:)`` if its type does not match `Value`.
+    public init(_ key: String, header: VCFHeader) throws {
+        self.id = try resolveField(key, header: header, line: Int32(BCF_HL_INFO), kind: "INFO", as: Value.self)
+        self.key = key
+        self.header = header
+    }
+
+    deinit {
+        free(buffer)
+    }
+
+    /// Decode the field into the scratch buffer; returns the value count, or -1 if absent.
+    private func load(_ record: borrowing VCFRecord) -> Int {
+        let n = hts_shim_bcf_get_info_values_id(record.pointer, id, Value.bcfHeaderType, &buffer, &capacity)
+        return n >= 0 ? Int(n) : -1
+    }
+
+    /// Call `body` with the field's values in `record`.
+    ///
+    /// The buffer is reused by the next read and must not escape `body`. Strings are
+    /// passed as their bytes, without the terminating NUL.
+    ///
+    /// - Parameters:
+    ///   - record: The record to read.
+    ///   - body: A closure receiving the values.
+    /// - Returns: The result of `body`, or `nil` if the record has no such field.
+    public func withValues<R>(
+        in record: borrowing VCFRecord, _ body: (UnsafeBufferPointer<Value>) throws -> R
+    ) rethrows -> R? {
+        let n = load(record)
+        guard n >= 0, let buffer else { return nil }
+        return try body(UnsafeBufferPointer(start: buffer.bindMemory(to: Value.self, capacity: n), count: n))
+    }
+
+    /// The field's values in `record` as a new array, or `nil` if absent.
+    public func values(in record: borrowing VCFRecord) -> [Value]? {
+        withValues(in: record) { Array($0) }
+    }
+
+    /// The field's first value in `record`, or `nil` if absent or empty.
+    public func first(in record: borrowing VCFRecord) -> Value? {
+        withValues(in: record) { $0.first } ?? nil
+    }
+
+    /// Whether `record` has the field.
+    public func isPresent(in record: borrowing VCFRecord) -> Bool {
+        load(record) >= 0
+    }
+}
+
+extension InfoField where Value == UInt8 {
+    /// The field's value in `record` as a string, or `nil` if absent.
+    public func string(in record: borrowing VCFRecord) -> String? {
+        withValues(in: record) { String(decoding: $0, as: UTF8.self) }
+    }
+}
+
+// MARK: - FormatField
+
+/// A reusable reader for one FORMAT field, resolved once against a header.
+///
+/// The per-sample counterpart of ``InfoField``: values for every sample are decoded
+/// into one grow-only scratch buffer, sample-major, with the same number of values per
+/// sample. Short samples are padded with the vector-end sentinel
+/// (``VCFFieldValue/isBCFVectorEnd``).
+///
+/// ```swift
+/// let gq = try FormatField<Int32>("GQ", header: header)
+/// while let record = iter.next() {
+///     let passing = gq.withValues(in: record) { values, _ in
+///         values.filter { !$0.isBCFMissing && $0 >= 20 }.count
+///     } ?? 0
+/// }
+/// ```
+///
+/// Use ``GenotypeMatrix`` for GT, which is stored as encoded integers.
+/// A field holds mutable scratch state; use one per thread.
+public final class FormatField<Value: VCFFieldValue> {
+    /// The FORMAT key.
+    public let key: String
+    /// The header the field was resolved against; records must come from files sharing it.
+    public let header: VCFHeader
+    /// The header dictionary ID of the key.
+    public let id: Int32
+
+    private var buffer: UnsafeMutableRawPointer?
+    private var capacity: Int32 = 0
+
+    /// Resolve a FORMAT field.
+    ///
+    /// - Parameters:
+    ///   - key: The FORMAT key (e.g. `"DP"`, `"GL"`).
+    ///   - header: The ``VCFHeader`` records will be read with.
+    /// - Throws: ``HTSError/tagNotFound(tag:)`` if the header defines no such FORMAT field,
+    ///   or ``HTSError/invalidArgument(message:)`` if its type does not match `Value`.
+    public init(_ key: String, header: VCFHeader) throws {
+        self.id = try resolveField(key, header: header, line: Int32(BCF_HL_FMT), kind: "FORMAT", as: Value.self)
+        self.key = key
+        self.header = header
+    }
+
+    deinit {
+        free(buffer)
+    }
+
+    /// Call `body` with the field's values for every sample of `record`.
+    ///
+    /// The buffer is reused by the next read and must not escape `body`.
+    ///
+    /// - Parameters:
+    ///   - record: The record to read.
+    ///   - body: A closure receiving the flat values and the number of values per sample;
+    ///     sample `s` occupies `values[s * perSample ..< (s + 1) * perSample]`.
+    /// - Returns: The result of `body`, or `nil` if the record has no such field.
+    public func withValues<R>(
+        in record: borrowing VCFRecord,
+        _ body: (_ values: UnsafeBufferPointer<Value>, _ perSample: Int) throws -> R
+    ) rethrows -> R? {
+        let n = hts_shim_bcf_get_format_values_id(header.pointer, record.pointer, id,
+                                                  Value.bcfHeaderType, &buffer, &capacity)
+        guard n >= 0, let buffer else { return nil }
+        let samples = min(Int(hts_shim_bcf_hdr_nsamples(header.pointer)), record.nSamples)
+        let values = UnsafeBufferPointer(start: buffer.bindMemory(to: Value.self, capacity: Int(n)), count: Int(n))
+        return try body(values, samples > 0 ? Int(n) / samples : 0)
+    }
+
+    /// The field's values for every sample of `record` as a new flat array, or `nil` if absent.
+    public func values(in record: borrowing VCFRecord) -> [Value]? {
+        withValues(in: record) { values, _ in Array(values) }
+    }
+}
+
+extension FormatField where Value == UInt8 {
+    /// The field's value for each sample of `record` as a string, or `nil` if absent.
+    public func strings(in record: borrowing VCFRecord) -> [String]? {
+        withValues(in: record) { values, perSample in
+            guard perSample > 0 else { return [] }
+            return stride(from: 0, to: values.count, by: perSample).map { start in
+                let sample = values[start..<(start + perSample)]
+                let end = sample.firstIndex(of: 0) ?? sample.endIndex
+                return String(decoding: UnsafeBufferPointer(rebasing: sample[..<end]), as: UTF8.self)
+            }
+        }
+    }
+}
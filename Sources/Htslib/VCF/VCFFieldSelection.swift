@@ -0,0 +1,139 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - VCFFieldSelection
+
+/// The fields a VCF/BCF reader should decode, declared before the first record is read.
+///
+/// Readers configured with a selection return records already unpacked to exactly the
+/// levels the selection needs, so accessors never see undecoded fields and nothing else
+/// is decoded:
+///
+/// - CHROM, POS, QUAL and the reference length are always available.
+/// - ``id`` and ``alleles`` unpack the shared strings (`BCF_UN_STR`).
+/// - ``filters`` unpacks FILTER (`BCF_UN_FLT`).
+/// - Any ``info`` key unpacks INFO (`BCF_UN_INFO`).
+/// - Any ``format`` key unpacks the per-sample block (`BCF_UN_FMT`).
+///
+/// Without ``format`` keys the per-sample columns are dropped with
+/// `bcf_hdr_set_samples`, which skips FORMAT parsing in VCF text and discards the
+/// per-sample block of each BCF record as it is read. That is the largest saving on wide
+/// cohort files. Sample subsetting changes the reader's header: the header's sample
+/// list and every record's ``VCFRecord/nSamples`` reflect the kept samples.
+///
+/// ```swift
+/// // POS, ALT and INFO/AF only: no per-sample data is decoded.
+/// let fields = VCFFieldSelection(alleles: true, info: ["AF"])
+/// let iter = try file.vcfIterator(header: header, fields: fields)
+/// while let record = iter.next() {
+///     print(record.position, record.alleles, record.infoFloat(forKey: "AF", header: header) ?? [])
+/// }
+/// ```
+public struct VCFFieldSelection: Sendable, Hashable {
+    /// Which samples' FORMAT data to keep.
+    public enum Samples: Sendable, Hashable {
+        /// Keep every sample.
+        case all
+        /// Drop all per-sample data.
+        case none
+        /// Keep only the named samples, in header order.
+        case only([String])
+    }
+
+    /// Decode the ID column.
+    public var id: Bool
+    /// Decode REF and ALT.
+    public var alleles: Bool
+    /// Decode FILTER.
+    public var filters: Bool
+    /// INFO keys the caller will read.
+    public var info: [String]
+    /// FORMAT keys the caller will read (e.g. `"GT"`).
+    public var format: [String]
+    /// Samples whose FORMAT data is kept.
+    public var samples: Samples
+
+    private var everything = false
+
+    /// Declare the fields to decode.
+    ///
+    /// - Parameters:
+    ///   - id: Decode the ID column.
+    ///   - alleles: Decode REF and ALT.
+    ///   - filters: Decode FILTER.
+    ///   - info: INFO keys to be read.
+    ///   - format: FORMAT keys to be read.
+    ///   - samples: Samples to keep; defaults to `.none` without `format` keys and `.all` with them.
+    public init(
+        id: Bool = false, alleles: Bool = false, filters: Bool = false,
+        info: [String] = [], format: [String] = [], samples: Samples? = nil
+    ) {
+        self.id = id
+        self.alleles = alleles
+        self.filters = filters
+        self.info = info
+        self.format = format
+        self.samples = samples ?? (format.isEmpty ? Samples.none : .all)
+    }
+
+    /// Decode every field of every sample, as ``VCFRecord/unpack(_:)`` does by default.
+    public static let all: VCFFieldSelection = {
+        var selection = VCFFieldSelection(samples: .all)
+        selection.everything = true
+        return selection
+    }()
+
+    /// The `bcf_unpack` flags covering the selected fields; 0 if only core fields are needed.
+    internal var unpackFlags: Int32 {
+        typealias Level = VCFRecord.UnpackLevel
+        if everything { return Level.all.rawValue }
+        var flags: Int32 = 0
+        if id || alleles { flags |= Level.str.rawValue }
+        if filters { flags |= Level.flt.rawValue }
+        if !info.isEmpty { flags |= Level.info.rawValue }
+        if !format.isEmpty && samples != Samples.none { flags |= Level.fmt.rawValue }
+        return flags
+    }
+
+    /// Check the selected keys against `header` and subset its samples.
+    ///
+    /// Must run before any record is read with `header`.
+    ///
+    /// - Parameters:
+    ///   - header: The header records will be read with.
+    ///   - strict: Throw if a key or sample is not in the header; otherwise skip it.
+    /// - Throws: ``HTSError/tagNotFound(tag:)`` for an undefined key,
+    ///   ``HTSError/invalidArgument(message:)`` for an unknown sample.
+    internal func apply(to header: UnsafeMutablePointer<bcf_hdr_t>, strict: Bool) throws {
+        if strict {
+            for (keys, line) in [(info, BCF_HL_INFO), (format, BCF_HL_FMT)] {
+                for key in keys {
+                    let id = bcf_hdr_id2int(header, Int32(BCF_DT_ID), key)
+                    if hts_shim_bcf_hdr_field_type(header, Int32(line), id) < 0 {
+                        throw HTSError.tagNotFound(tag: key)
+                    }
+                }
+            }
+        }
+
+        let ret: Int32
+        switch samples {
+        case .all:
+            return
+        case .none, .only([]):
+            ret = bcf_hdr_set_samples(header, nil, 0)
+        case .only(let names):
+            ret = names.joined(separator: ",").withCString { bcf_hdr_set_samples(header, $0, 0) }
+        }
+        if ret < 0 {
+            throw HTSError.invalidArgument(message: "Cannot subset samples")
+        }
+        // A positive result is the 1-based position of the first name missing from the header.
+        if ret > 0, strict, case .only(let names) = samples {
+            throw HTSError.invalidArgument(message: "Sample not in header: \(names[Int(ret) - 1])")
+        }
+    }
+}
@@ -14,25 +14,35 @@ import CHTSlibShims
 ///     print(record.alleles)
 /// }
 /// ```
+///
+/// An iterator created with a ``VCFFieldSelection`` returns records already unpacked
+/// to the selected levels; see ``HTSFile/vcfIterator(header:fields:)``.
 public final class VCFRecordIterator {
     private let file: UnsafeMutablePointer<htsFile>
     private let header: UnsafeMutablePointer<bcf_hdr_t>
     private var record: UnsafeMutablePointer<bcf1_t>?
     private var exhausted = false
+    private let unpackFlags: Int32
 
-    internal init(file: UnsafeMutablePointer<htsFile>, header: UnsafeMutablePointer<bcf_hdr_t>) {
+    internal init(file: UnsafeMutablePointer<htsFile>, header: UnsafeMutablePointer<bcf_hdr_t>,
+                  unpackFlags: Int32 = 0) {
         self.file = file
         self.header = header
+        self.unpackFlags = unpackFlags
         self.record = bcf_init()
     }
 
     /// Read the next variant record.
     ///
-    /// - Returns: The next ``VCFRecord``, or `nil` at end-of-file.
+    /// A record that cannot be read, or cannot be unpacked to the selected levels, ends
+    /// iteration exactly like end-of-file: `next()` returns `nil` from then on. Use
+    /// ``AsyncVCFReader`` or ``ParallelVCFReader``, which throw, to tell the two apart.
+    ///
+    /// - Returns: The next ``VCFRecord``, or `nil` at end-of-file or on the first error.
     public func next() -> VCFRecord? {
         guard !exhausted, let rec = record else { return nil }
         let ret = bcf_read(file, header, rec)
-        if ret >= 0 {
+        if ret >= 0, unpackFlags == 0 || bcf_unpack(rec, unpackFlags) >= 0 {
             let result = rec
             self.record = bcf_init()
             return VCFRecord(pointer: result)
@@ -12,6 +12,7 @@ import CHTSlibShims
 public struct VCFRecord: ~Copyable, @unchecked Sendable {
     @usableFromInline
     nonisolated(unsafe) var pointer: UnsafeMutablePointer<bcf1_t>
+    private let owned: Bool
 
     /// Allocate an empty VCF record.
     ///
@@ -21,10 +22,12 @@ public struct VCFRecord: ~Copyable, @unchecked Sendable {
             throw HTSError.outOfMemory
         }
         self.pointer = v
+        self.owned = true
     }
 
-    internal init(pointer: UnsafeMutablePointer<bcf1_t>) {
+    internal init(pointer: UnsafeMutablePointer<bcf1_t>, owned: Bool = true) {
         self.pointer = pointer
+        self.owned = owned
     }
 
     /// Unpack (decode) record fields from the binary representation.
@@ -287,6 +290,8 @@ public struct VCFRecord: ~Copyable, @unchecked Sendable {
     }
 
     deinit {
-        bcf_destroy(pointer)
+        if owned {
+            bcf_destroy(pointer)
+        }
     }
 }
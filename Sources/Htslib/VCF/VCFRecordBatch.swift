@@ -0,0 +1,93 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - VCFRecordBatch
+
+/// A reusable batch of variant records.
+///
+/// The batch owns `capacity` `bcf1_t` buffers that are decoded into in place and kept
+/// across refills, so a scan that reuses one batch stops allocating once each buffer
+/// has grown to fit its largest record.
+///
+/// ```swift
+/// for try await batch in reader.batches() {
+///     for i in 0..<batch.count {
+///         let record = batch[i]
+///         print(record.position)
+///     }
+/// }
+/// ```
+public final class VCFRecordBatch: @unchecked Sendable {
+    /// The maximum number of records held by one batch.
+    public let capacity: Int
+    /// The number of records currently in the batch.
+    public private(set) var count: Int = 0
+
+    private let records: UnsafeMutablePointer<UnsafeMutablePointer<bcf1_t>>
+
+    /// Create an empty batch.
+    ///
+    /// - Parameter capacity: Maximum number of records per batch.
+    /// - Throws: ``HTSError/outOfMemory`` if a record buffer cannot be allocated.
+    public init(capacity: Int = 1024) throws {
+        precondition(capacity > 0, "Batch capacity must be positive")
+        let records = UnsafeMutablePointer<UnsafeMutablePointer<bcf1_t>>.allocate(capacity: capacity)
+        for i in 0..<capacity {
+            guard let record = bcf_init() else {
+                for j in 0..<i { bcf_destroy(records[j]) }
+                records.deallocate()
+                throw HTSError.outOfMemory
+            }
+            (records + i).initialize(to: record)
+        }
+        self.capacity = capacity
+        self.records = records
+    }
+
+    deinit {
+        for i in 0..<capacity { bcf_destroy(records[i]) }
+        records.deallocate()
+    }
+
+    // MARK: - Per-record access
+
+    /// A non-owning ``VCFRecord`` for the record at `index`, valid until the batch is refilled.
+    ///
+    /// The record may be unpacked in place; it is not freed when the returned value goes
+    /// out of scope.
+    public subscript(index: Int) -> VCFRecord {
+        precondition(index >= 0 && index < count, "Batch index out of range")
+        return VCFRecord(pointer: records[index], owned: false)
+    }
+
+    /// Copy the record at `index` into a new, independently owned ``VCFRecord``.
+    ///
+    /// - Throws: ``HTSError/outOfMemory`` if allocation fails.
+    public func copyRecord(at index: Int) throws -> VCFRecord {
+        precondition(index >= 0 && index < count, "Batch index out of range")
+        guard let dup = bcf_dup(records[index]) else { throw HTSError.outOfMemory }
+        return VCFRecord(pointer: dup)
+    }
+
+    // MARK: - Filling
+
+    /// Whether the batch has reached ``capacity``.
+    internal var isFull: Bool { count == capacity }
+
+    /// The buffer the next record should be decoded into.
+    internal var nextSlot: UnsafeMutablePointer<bcf1_t> { records[count] }
+
+    /// Keep the record just decoded into ``nextSlot``.
+    internal func commit() {
+        precondition(!isFull, "Batch is full")
+        count += 1
+    }
+
+    /// Discard all records, keeping their buffers for reuse.
+    public func reset() {
+        count = 0
+    }
+}
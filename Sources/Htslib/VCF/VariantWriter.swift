@@ -0,0 +1,110 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import CHtslib
+import CHTSlibShims
+
+// MARK: - VariantWriter
+
+/// A write-behind VCF/BCF writer that can index its output as it goes.
+///
+/// The variant counterpart of ``AlignmentWriter``: records are copied into queued batches
+/// and written in order by a writer thread, with BGZF compression on the attached
+/// ``ThreadPool``. With ``WriterOptions/buildIndex`` a CSI index (BCF) or TBI index
+/// (bgzipped VCF) is built while writing and saved by ``close()``.
+///
+/// ```swift
+/// let writer = try VariantWriter(path: "out.bcf", header: header, mode: "wb",
+///                                options: .init(buildIndex: true), pool: pool)
+/// let records = input.vcfIterator(header: header)
+/// while let record = records.next() { try writer.write(record) }
+/// try writer.close()   // out.bcf and out.bcf.csi are complete
+/// ```
+///
+/// A writer takes records from one thread at a time. The pool must outlive the writer.
+/// A writer that is not closed is closed on deinitialization, ignoring errors.
+public final class VariantWriter {
+    /// The header written to the output.
+    public let header: VCFHeader
+    private let core: RecordWriterCore
+
+    /// The output path.
+    public var path: String { core.path }
+
+    /// Records written to the file so far; queued records are not counted until written.
+    public var recordsWritten: Int { core.recordsWritten }
+
+    /// Open an output whose compression runs on the writer thread.
+    ///
+    /// - Parameters:
+    ///   - path: The output path.
+    ///   - header: The header to write; it must outlive the writer.
+    ///   - mode: The htslib open mode, e.g. `"wb"` for BCF or `"wz"` for bgzipped VCF.
+    ///   - options: Queueing and indexing settings.
+    /// - Throws: ``HTSError/openFailed(path:mode:)``, ``HTSError/headerWriteFailed`` or
+    ///   ``HTSError/indexBuildFailed(path:code:)``.
+    public init(path: String, header: VCFHeader, mode: String = "wb", options: WriterOptions = WriterOptions()) throws {
+        self.header = header
+        core = try RecordWriterCore(path: path, mode: mode, kind: .variant, options: options, pool: nil,
+                                    header: UnsafeMutableRawPointer(header.pointer)) { bcf_hdr_write($0, header.pointer) }
+    }
+
+    /// Open an output whose BGZF compression runs on a shared thread pool.
+    ///
+    /// - Parameters:
+    ///   - path: The output path.
+    ///   - header: The header to write; it must outlive the writer.
+    ///   - mode: The htslib open mode, e.g. `"wb"` for BCF or `"wz"` for bgzipped VCF.
+    ///   - options: Queueing and indexing settings.
+    ///   - pool: The pool for compression. It must outlive the writer.
+    /// - Throws: ``HTSError/openFailed(path:mode:)``, ``HTSError/headerWriteFailed`` or
+    ///   ``HTSError/indexBuildFailed(path:code:)``.
+    public init(path: String, header: VCFHeader, mode: String = "wb", options: WriterOptions = WriterOptions(),
+                pool: borrowing ThreadPool) throws {
+        self.header = header
+        core = try RecordWriterCore(path: path, mode: mode, kind: .variant, options: options, pool: pool.pointer,
+                                    header: UnsafeMutableRawPointer(header.pointer)) { bcf_hdr_write($0, header.pointer) }
+    }
+
+    /// Queue a copy of a record for writing.
+    ///
+    /// - Parameter record: The record to write; the caller may reuse it immediately.
+    /// - Throws: ``HTSError/writeFailed(code:)`` if this or an earlier queued write failed.
+    public func write(_ record: borrowing VCFRecord) throws {
+        try write(pointer: record.pointer)
+    }
+
+    /// Queue a copy of every record in a batch.
+    ///
+    /// - Parameter batch: The records to write; the caller may refill the batch immediately.
+    /// - Throws: ``HTSError/writeFailed(code:)`` if a write failed.
+    public func write(_ batch: VCFRecordBatch) throws {
+        for i in 0..<batch.count {
+            let record = batch[i]
+            try write(pointer: record.pointer)
+        }
+    }
+
+    private func write(pointer: UnsafeMutablePointer<bcf1_t>) throws {
+        let slot = try core.slot().assumingMemoryBound(to: bcf1_t.self)
+        guard bcf_copy(slot, pointer) != nil else { throw HTSError.outOfMemory }
+        try core.commit()
+    }
+
+    /// Wait until every queued record has been written.
+    ///
+    /// - Throws: ``HTSError/writeFailed(code:)`` if a write failed.
+    public func flush() throws {
+        try core.flush()
+    }
+
+    /// Write the remaining records, save the index if one is being built, and close the file.
+    ///
+    /// - Returns: The writer's ``WriterStatistics``.
+    /// - Throws: ``HTSError/writeFailed(code:)``, ``HTSError/indexBuildFailed(path:code:)``
+    ///   or ``HTSError/closeFailed(code:)``.
+    @discardableResult
+    public func close() throws -> WriterStatistics {
+        try core.close()
+    }
+}
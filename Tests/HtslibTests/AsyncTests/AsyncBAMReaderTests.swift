@@ -123,4 +123,43 @@ struct AsyncBAMReaderTests {
             try await reader.query(region: "chr1")
         }
     }
+
+    @Test func batchedSequence() async throws {
+        let reader = try AsyncBAMReader(path: testDataPath("range.bam"))
+        var records = 0
+        var batches = 0
+        for try await batch in reader.batches(size: 10, prefetch: 2) {
+            #expect(batch.count <= 10)
+            records += batch.count
+            batches += 1
+        }
+        #expect(records == 112)
+        #expect(batches == 12)
+    }
+
+    @Test func batchedRegionQuery() async throws {
+        let reader = try AsyncBAMReader(
+            path: testDataPath("range.bam"), loadIndex: true)
+        try await reader.query(region: "CHROMOSOME_II")
+        var records = 0
+        for try await batch in reader.batches(size: 8) {
+            for contig in batch.contigIDs { #expect(contig == 1) }
+            records += batch.count
+        }
+        #expect(records == 34)
+    }
+
+    @Test func batchedEarlyExit() async throws {
+        let reader = try AsyncBAMReader(path: testDataPath("range.bam"))
+        var first = 0
+        for try await batch in reader.batches(size: 5, prefetch: 2) {
+            first = batch.count
+            break
+        }
+        #expect(first == 5)
+        // The producer stops at the ring bound; the reader is still usable.
+        let batch = BAMRecordBatch(capacity: 1000)
+        let rest = try await reader.readBatch(into: batch)
+        #expect(rest > 0 && rest < 112)
+    }
 }
@@ -50,4 +50,27 @@ struct AsyncVCFReaderTests {
         }
         #expect(count == 15)
     }
+
+    @Test func batchedSequence() async throws {
+        let reader = try AsyncVCFReader(path: testDataPath("vcf_file.vcf"))
+        var positions: [Int64] = []
+        for try await batch in reader.batches(size: 4, prefetch: 2) {
+            for i in 0..<batch.count { positions.append(batch[i].position) }
+        }
+        #expect(positions.count == 15)
+
+        let reference = try AsyncVCFReader(path: testDataPath("vcf_file.vcf"))
+        var expected: [Int64] = []
+        while let record = try await reference.next() { expected.append(record.position) }
+        #expect(positions == expected)
+    }
+
+    @Test func batchRecordCopy() async throws {
+        let reader = try AsyncVCFReader(path: testDataPath("vcf_file.vcf"))
+        let batch = try VCFRecordBatch(capacity: 2)
+        #expect(try await reader.readBatch(into: batch) == 2)
+        let copy = try batch.copyRecord(at: 1)
+        let position = copy.position
+        #expect(position == batch[1].position)
+    }
 }
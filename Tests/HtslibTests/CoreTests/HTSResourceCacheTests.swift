@@ -0,0 +1,128 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Testing
+@testable import Htslib
+
+@Suite("HTSResourceCache")
+struct HTSResourceCacheTests {
+
+    @Test func secondIndexLoadIsAHit() throws {
+        let cache = try HTSResourceCache()
+        let first = try HTSIndex(path: testDataPath("range.bam"), cache: cache)
+        let second = try HTSIndex(path: testDataPath("range.bam"), cache: cache)
+        #expect(first.nSequences() == second.nSequences())
+        #expect(first.pointer == second.pointer)
+
+        let stats = cache.statistics
+        #expect(stats.misses == 1)
+        #expect(stats.hits == 1)
+        #expect(stats.entries == 1)
+        #expect(stats.entriesInUse == 1)
+        #expect(stats.bytes > 0)
+    }
+
+    @Test func headersAreShared() throws {
+        let cache = try HTSResourceCache()
+        let first = try cache.samHeader(for: testDataPath("range.bam"))
+        let second = try cache.samHeader(for: testDataPath("range.bam"))
+        #expect(first === second)
+        #expect(first.nTargets > 0)
+
+        let vcf = try cache.vcfHeader(for: testDataPath("vcf_file.vcf"))
+        #expect(try cache.vcfHeader(for: testDataPath("vcf_file.vcf")) === vcf)
+        #expect(cache.statistics.hits == 2)
+    }
+
+    @Test func evictsOnlyReleasedEntries() throws {
+        let cache = try HTSResourceCache()
+        let header = try cache.samHeader(for: testDataPath("range.bam"))
+        try withExtendedLifetime(header) {
+            do {
+                let index = try HTSIndex(path: testDataPath("range.bam"), cache: cache)
+                #expect(index.nSequences() > 0)
+                #expect(cache.statistics.entriesInUse == 2)
+            }
+            #expect(cache.statistics.entriesInUse == 1)
+
+            cache.byteBudget = 0
+            let stats = cache.statistics
+            #expect(stats.evictions == 1)
+            #expect(stats.entries == 1)
+        }
+    }
+
+    @Test func releasedEntriesAreEvictedLeastRecentlyUsedFirst() throws {
+        let cache = try HTSResourceCache()
+        _ = try cache.samHeader(for: testDataPath("range.bam"))
+        _ = try cache.vcfHeader(for: testDataPath("vcf_file.vcf"))
+        let bytes = cache.statistics.bytes
+        #expect(bytes > 0)
+
+        // Touch the SAM header so the VCF header is the least recently used.
+        _ = try cache.samHeader(for: testDataPath("range.bam"))
+        cache.byteBudget = bytes - 1
+        #expect(cache.statistics.evictions == 1)
+        #expect(cache.statistics.hits == 1)
+        _ = try cache.samHeader(for: testDataPath("range.bam"))
+        #expect(cache.statistics.hits == 2)
+
+        cache.byteBudget = 0
+        #expect(cache.statistics.entries == 0)
+        #expect(cache.statistics.bytes == 0)
+    }
+
+    @Test func rewrittenFileIsReloaded() throws {
+        let path = tempFilePath("cache-\(UInt32.random(in: 0...UInt32.max)).sam")
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        try "@SQ\tSN:chr1\tLN:1000\n".write(toFile: path, atomically: true, encoding: .utf8)
+
+        let cache = try HTSResourceCache()
+        let before = try cache.samHeader(for: path)
+        #expect(before.nTargets == 1)
+
+        try "@SQ\tSN:chr1\tLN:1000\n@SQ\tSN:chr2\tLN:2000\n"
+            .write(toFile: path, atomically: true, encoding: .utf8)
+        let after = try cache.samHeader(for: path)
+        #expect(after.nTargets == 2)
+        #expect(before !== after)
+        #expect(cache.statistics.invalidations == 1)
+        #expect(cache.statistics.misses == 2)
+    }
+
+    @Test func missingFileThrows() throws {
+        let cache = try HTSResourceCache()
+        #expect(throws: HTSError.self) {
+            _ = try cache.samHeader(for: "/nonexistent/file.bam")
+        }
+        #expect(cache.statistics.entries == 0)
+    }
+
+    @Test func asyncBAMReadersShareHeaderAndIndex() async throws {
+        let cache = try HTSResourceCache()
+        let path = testDataPath("range.bam")
+
+        let reader = try AsyncBAMReader(path: path, cache: cache, loadIndex: true)
+        var count = 0
+        while let _ = try await reader.next() { count += 1 }
+        #expect(count == 112)
+
+        let other = try AsyncBAMReader(path: path, cache: cache, loadIndex: true, threads: 2)
+        #expect(other.header === reader.header)
+        try await other.query(region: "CHROMOSOME_II")
+        var regionCount = 0
+        while let _ = try await other.next() { regionCount += 1 }
+        #expect(regionCount == 34)
+        #expect(cache.statistics.hits == 2)
+    }
+
+    @Test func asyncVCFReaderReadsTextWithCache() async throws {
+        let cache = try HTSResourceCache()
+        let reader = try AsyncVCFReader(path: testDataPath("vcf_file.vcf"), cache: cache)
+        var count = 0
+        while let _ = try await reader.next() { count += 1 }
+        #expect(count == 15)
+        #expect(cache.statistics.misses == 1)
+    }
+}
@@ -0,0 +1,171 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Testing
+@testable import Htslib
+
+@Suite("ShardPlanner")
+struct ShardPlannerTests {
+
+    /// Count the records each shard owns by querying its regions.
+    private func ownedRecords(_ plan: ShardPlan) throws -> Int {
+        let file = try HTSFile(path: plan.path, mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: plan.path)
+        var count = 0
+        for shard in plan.shards {
+            for (region, string) in zip(shard.regions, shard.regionStrings) {
+                try file.samQueryIterator(header: header, index: index, region: string).forEach { record in
+                    if region.contig == "*" || (record.position >= region.start && record.position < region.end) {
+                        count += 1
+                    }
+                }
+            }
+        }
+        return count
+    }
+
+    /// Write vcf_file.vcf as an indexed BCF or bgzipped VCF.
+    private func writeIndexedVCF(mode: String, suffix: String) throws -> String {
+        let output = tempFilePath("planner-\(UInt32.random(in: 0...UInt32.max))\(suffix)")
+        let input = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: input)
+        let iter = VCFRecordIterator(file: input.pointer, header: header.pointer)
+        let writer = try VariantWriter(path: output, header: header, mode: mode, options: .init(buildIndex: true))
+        while let record = iter.next() {
+            try writer.write(record)
+        }
+        _ = try writer.close()
+        return output
+    }
+
+    private func removeIndexed(_ path: String) {
+        for suffix in ["", ".csi", ".tbi", ".crai"] {
+            try? FileManager.default.removeItem(atPath: path + suffix)
+        }
+    }
+
+    @Test func bamShardsOwnEveryRecordOnce() throws {
+        let plan = try ShardPlanner(path: testDataPath("range.bam"), shardCount: 4, windowSize: 1000).plan()
+        #expect(plan.format == .bam)
+        #expect(plan.shards.count > 1)
+        #expect(plan.shards.count <= 4)
+        #expect(try ownedRecords(plan) == 112)
+
+        // Per-shard estimates are rounded, so the sum can drift by one per shard.
+        let records = plan.shards.compactMap(\.estimatedRecords).reduce(0, +)
+        #expect(abs(records - 112) <= Int64(plan.shards.count))
+        #expect(plan.totalBytes > 0)
+        for (shard, next) in zip(plan.shards, plan.shards.dropFirst()) {
+            #expect(shard.startOffset <= next.startOffset)
+            #expect(shard.endOffset == next.startOffset)
+        }
+    }
+
+    @Test func shardsAreBalancedByBytes() throws {
+        let plan = try ShardPlanner(path: testDataPath("range.bam"), shardCount: 3, windowSize: 500).plan()
+        // Window weights do not depend on the shard count, so a plan with more shards than
+        // windows puts each weighted window in a shard of its own.
+        let windows = try ShardPlanner(path: testDataPath("range.bam"), shardCount: 10_000, windowSize: 500).plan()
+        let largestWindow = windows.shards.map(\.estimatedBytes).max() ?? 0
+        #expect(windows.totalBytes == plan.totalBytes)
+        #expect(largestWindow > 0)
+
+        // A shard closes once it reaches the target, so it overshoots by at most one window;
+        // the last shard takes whatever remains.
+        let target = plan.totalBytes / 3
+        for shard in plan.shards.dropLast() {
+            #expect(shard.estimatedBytes >= target)
+            #expect(shard.estimatedBytes <= target + largestWindow)
+        }
+        #expect(plan.shards.allSatisfy { !$0.regions.isEmpty })
+    }
+
+    @Test func serializedPlanEscapesSeparators() throws {
+        let plan = ShardPlan(
+            path: "dir\twith\\odd\nname.bam", format: .bam,
+            shards: [ShardPlan.Shard(regions: [BEDRegion(contig: "chr\t1", start: 0, end: 10)],
+                                     startOffset: 0, endOffset: 100, estimatedBytes: 100, estimatedRecords: 1)])
+        let text = plan.serialized()
+        #expect(text.split(separator: "\n").count == 5)
+        #expect(try ShardPlan(serialized: text) == plan)
+        #expect(throws: HTSError.self) {
+            _ = try ShardPlan(serialized: "#shard-plan\t1\n#path\tbad\\q.bam\n#format\tbam\n")
+        }
+    }
+
+    @Test func planRoundTripsThroughFile() throws {
+        let plan = try ShardPlanner(path: testDataPath("range.bam"), shardCount: 4, windowSize: 1000).plan()
+        let path = tempFilePath("plan-\(UInt32.random(in: 0...UInt32.max)).tsv")
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        try plan.write(to: path)
+        let loaded = try ShardPlan.read(path: path)
+        #expect(loaded == plan)
+        #expect(try ShardPlan(serialized: plan.serialized()) == plan)
+    }
+
+    @Test func malformedPlanThrows() {
+        #expect(throws: HTSError.self) { _ = try ShardPlan(serialized: "not a plan\n") }
+        #expect(throws: HTSError.self) {
+            _ = try ShardPlan(serialized: "#shard-plan\t1\n#path\tx.bam\n#format\tbam\nregion\t0\tchr1\t0\t10\n")
+        }
+    }
+
+    @Test func regionStringsUseOneBasedCoordinates() {
+        let shard = ShardPlan.Shard(
+            regions: [BEDRegion(contig: "chr1", start: 0, end: 1000),
+                      BEDRegion(contig: "chr1", start: 1000, end: htsPosMax),
+                      BEDRegion(contig: "chr2", start: 0, end: htsPosMax),
+                      BEDRegion(contig: "*", start: 0, end: 0)],
+            startOffset: 0, endOffset: 0, estimatedBytes: 0, estimatedRecords: nil)
+        #expect(shard.regionStrings == ["chr1:1-1000", "chr1:1001", "chr2", "*"])
+    }
+
+    @Test func plansIndexedBCF() throws {
+        let path = try writeIndexedVCF(mode: "wb", suffix: ".bcf")
+        defer { removeIndexed(path) }
+        let plan = try ShardPlanner(path: path, shardCount: 2, windowSize: 1000).plan()
+        #expect(plan.format == .bcf)
+        let records = plan.shards.compactMap(\.estimatedRecords).reduce(0, +)
+        #expect(abs(records - 15) <= Int64(plan.shards.count))
+        #expect(Set(plan.shards.flatMap { $0.regions.map(\.contig) }).count == 4)
+    }
+
+    @Test func plansTabixIndexedVCF() throws {
+        let path = try writeIndexedVCF(mode: "wz", suffix: ".vcf.gz")
+        defer { removeIndexed(path) }
+        let plan = try ShardPlanner(path: path, shardCount: 2, windowSize: 1000).plan()
+        #expect(plan.format == .vcf)
+        #expect(plan.totalBytes > 0)
+        #expect(Set(plan.shards.flatMap { $0.regions.map(\.contig) }).count == 4)
+    }
+
+    @Test func plansCRAMFromCRAI() throws {
+        let path = tempFilePath("planner-\(UInt32.random(in: 0...UInt32.max)).cram")
+        defer { removeIndexed(path) }
+        do {
+            let input = try HTSFile(path: testDataPath("range.bam"), mode: "r")
+            let header = try input.samHeader()
+            let output = try HTSFile(path: path, mode: "wc")
+            try output.setFaiFilename(testDataPath("ce.fa"))
+            try header.write(to: output)
+            try input.samIterator(header: header).forEach { record in
+                try output.write(record: record, header: header)
+            }
+        }
+        try HTSIndex.build(path: path)
+
+        let plan = try ShardPlanner(path: path, shardCount: 2, windowSize: 1000).plan()
+        #expect(plan.format == .cram)
+        #expect(plan.totalBytes > 0)
+        #expect(plan.shards.allSatisfy { $0.estimatedRecords == nil })
+        #expect(plan.shards.flatMap(\.regions).contains { $0.contig == "CHROMOSOME_II" })
+    }
+
+    @Test func unindexedFileThrows() {
+        #expect(throws: HTSError.self) {
+            _ = try ShardPlanner(path: testDataPath("vcf_file.vcf"), shardCount: 2).plan()
+        }
+    }
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Testing
+@testable import Htslib
+
+@Suite("AlignmentSplitter")
+struct AlignmentSplitterTests {
+    // Read groups alternate so a one-writer limit forces evictions; r7 has no RG and r8
+    // is unmapped.
+    private static let sam = """
+        @HD\tVN:1.6\tSO:coordinate
+        @SQ\tSN:chr1\tLN:10000
+        @SQ\tSN:chr2\tLN:10000
+        @RG\tID:rgA\tSM:s1
+        @RG\tID:rgB\tSM:s2
+        r1\t0\tchr1\t100\t60\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII\tRG:Z:rgA
+        r2\t0\tchr1\t200\t60\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII\tRG:Z:rgB
+        r3\t0\tchr1\t300\t60\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII\tRG:Z:rgA
+        r4\t0\tchr2\t100\t60\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII\tRG:Z:rgB
+        r5\t0\tchr2\t200\t60\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII\tRG:Z:rgA
+        r6\t0\tchr2\t300\t60\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII\tRG:Z:rgB
+        r7\t0\tchr2\t400\t60\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII
+        r8\t4\t*\t0\t0\t*\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII\tRG:Z:rgA
+
+        """
+
+    private func split(_ key: AlignmentSplitter.Key, options: AlignmentSplitter.Options)
+        throws -> (outputs: [AlignmentSplitter.Output], stats: AlignmentSplitter.Statistics) {
+        let path = tempFilePath("split-\(UInt32.random(in: 0...UInt32.max)).sam")
+        try Self.sam.write(toFile: path, atomically: true, encoding: .utf8)
+        defer { try? FileManager.default.removeItem(atPath: path) }
+
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let pool = try ThreadPool(threads: 2)
+        let splitter = AlignmentSplitter(header: header, key: key, options: options, pool: pool)
+        let stats = try splitter.run(file.samIterator(header: header))
+        return (splitter.outputs, stats)
+    }
+
+    private func readNames(_ path: String) throws -> (names: [String], readGroups: Int32) {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        var names: [String] = []
+        try file.samIterator(header: header).forEach { names.append($0.queryName) }
+        return (names, header.countLines(type: "RG"))
+    }
+
+    private func makeDirectory() throws -> String {
+        let directory = tempFilePath("split-\(UInt32.random(in: 0...UInt32.max))")
+        try FileManager.default.createDirectory(atPath: directory, withIntermediateDirectories: true)
+        return directory
+    }
+
+    @Test func splitsByReadGroup() throws {
+        let directory = try makeDirectory()
+        defer { try? FileManager.default.removeItem(atPath: directory) }
+        let (outputs, stats) = try split(.readGroup, options: .init(directory: directory, prefix: "x-"))
+        #expect(stats.records == 8)
+        #expect(outputs.map(\.key) == ["rgA", "rgB", "unassigned"])
+        #expect(outputs[0].path == directory + "/x-rgA.bam")
+
+        let a = try readNames(outputs[0].path)
+        #expect(a.names == ["r1", "r3", "r5", "r8"])
+        #expect(a.readGroups == 1)
+        #expect(try readNames(outputs[1].path).names == ["r2", "r4", "r6"])
+        let unassigned = try readNames(outputs[2].path)
+        #expect(unassigned.names == ["r7"])
+        #expect(unassigned.readGroups == 0)
+    }
+
+    @Test func splitsByContigAndDropsUnmapped() throws {
+        let directory = try makeDirectory()
+        defer { try? FileManager.default.removeItem(atPath: directory) }
+        let (outputs, stats) = try split(.contig, options: .init(directory: directory, unassignedKey: nil))
+        #expect(outputs.map(\.key) == ["chr1", "chr2"])
+        #expect(outputs.map(\.records) == [3, 4])
+        #expect(stats.dropped == 1)
+        #expect(try readNames(outputs[0].path).readGroups == 2)
+    }
+
+    @Test func evictedOutputsAreMergedInOrder() throws {
+        let directory = try makeDirectory()
+        let segments = try makeDirectory()
+        defer {
+            try? FileManager.default.removeItem(atPath: directory)
+            try? FileManager.default.removeItem(atPath: segments)
+        }
+        let key = AlignmentSplitter.Key.custom { record in
+            record.auxiliaryData.string(forTag: .RG)
+        }
+        let options = AlignmentSplitter.Options(directory: directory, maxOpenOutputs: 1,
+                                                writer: .init(buildIndex: true, background: false),
+                                                temporaryDirectory: segments)
+        let (outputs, stats) = try split(key, options: options)
+        #expect(stats.peakOpenOutputs == 1)
+        #expect(stats.evictions > 0)
+        #expect(stats.mergedOutputs == 2)
+        #expect(try readNames(outputs[0].path).names == ["r1", "r3", "r5", "r8"])
+        #expect(try readNames(outputs[1].path).names == ["r2", "r4", "r6"])
+        #expect(FileManager.default.fileExists(atPath: outputs[1].path + ".bai"))
+
+        // Staged first parts and segments are removed once merged.
+        let written = Set(outputs.flatMap { [$0.path, $0.path + ".bai"] }.map { ($0 as NSString).lastPathComponent })
+        #expect(Set(try FileManager.default.contentsOfDirectory(atPath: directory)) == written)
+        #expect(try FileManager.default.contentsOfDirectory(atPath: segments).isEmpty)
+    }
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Testing
+@testable import Htslib
+
+@Suite("AlignmentStats")
+struct AlignmentStatsTests {
+    // p1 is a proper pair with a 310 bp insert; p2's read2 fails QC and is a duplicate; s1
+    // is a singleton with an unmapped mate; x1 has its mate on chr2; a1 is a secondary.
+    private static let sam = """
+        @HD\tVN:1.6\tSO:coordinate
+        @SQ\tSN:chr1\tLN:10000
+        @SQ\tSN:chr2\tLN:10000
+        p1\t99\tchr1\t100\t60\t10M\t=\t400\t310\tACGTACGTAC\tIIIIIIIIII
+        p2\t99\tchr1\t150\t30\t10M\t=\t450\t310\tACGTACGTAC\t##########
+        s1\t73\tchr1\t200\t20\t10M\t=\t200\t0\tACGTACGTAC\tIIIIIIIIII
+        s1\t133\tchr1\t200\t0\t*\t=\t200\t0\tACGTAC\tIIIIII
+        x1\t65\tchr1\t300\t10\t10M\tchr2\t100\t0\tACGTACGTAC\tIIIIIIIIII
+        p1\t147\tchr1\t400\t60\t10M\t=\t100\t-310\tACGTACGTAC\tIIIIIIIIII
+        a1\t256\tchr1\t420\t0\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII
+        p2\t1683\tchr1\t450\t30\t10M\t=\t150\t-310\tACGTACGTAC\t##########
+
+        """
+
+    private func collect(_ collectors: AlignmentStats.Collectors = .all) throws -> AlignmentStats {
+        let path = tempFilePath("stats-\(UInt32.random(in: 0...UInt32.max)).sam")
+        try Self.sam.write(toFile: path, atomically: true, encoding: .utf8)
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        return try AlignmentStats.collect(file.samIterator(header: header), collectors: collectors)
+    }
+
+    @Test func flagCountsMatchFlagstat() throws {
+        let stats = try collect()
+        #expect(stats.passed.total == 7)
+        #expect(stats.failed.total == 1)
+        #expect(stats.passed.secondary == 1)
+        #expect(stats.passed.primary == 6)
+        #expect(stats.passed.mapped == 6)
+        #expect(stats.passed.paired == 6)
+        #expect(stats.passed.properlyPaired == 3)
+        #expect(stats.passed.singletons == 1)
+        #expect(stats.passed.bothMapped == 4)
+        #expect(stats.passed.mateOnDifferentContig == 1)
+        #expect(stats.passed.mateOnDifferentContigMapQ5 == 1)
+        #expect(stats.failed.duplicates == 1)
+        #expect(stats.failed.primaryDuplicates == 1)
+        #expect(stats.failed.read2 == 1)
+    }
+
+    @Test func histogramsCountPrimaryReads() throws {
+        let stats = try collect()
+        #expect(stats.insertSize.nonEmptyBins.map(\.0) == [310])
+        #expect(stats.insertSize.total == 2)
+        #expect(stats.mappingQuality.total == 6)
+        #expect(stats.mappingQuality.counts[60] == 2)
+        #expect(stats.readLength.counts[6] == 1)
+        #expect(stats.readLength.total == 7)
+        #expect(stats.baseQuality.counts[40] == 46)
+        #expect(stats.baseQuality.counts[2] == 20)
+        #expect(stats.readLength.percentile(0.5) == 10)
+    }
+
+    @Test func onlySelectedCollectorsRun() throws {
+        let stats = try collect([.mappingQuality])
+        #expect(stats.passed.total == 0)
+        #expect(stats.insertSize.total == 0)
+        #expect(stats.baseQuality.total == 0)
+        #expect(stats.mappingQuality.total == 6)
+        let text = stats.tsv()
+        #expect(!text.contains("FS\t"))
+        #expect(text.contains("MAPQ\t60\t2\n"))
+    }
+
+    @Test func reportsAreMachineReadable() throws {
+        let stats = try collect([.flags, .insertSize])
+        let text = stats.tsv()
+        #expect(text.contains("FS\ttotal\t7\t1\n"))
+        #expect(text.contains("IS\t310\t2\n"))
+        #expect(text.contains("SN\tIS overflow\t0\n"))
+
+        let json = try JSONSerialization.jsonObject(with: Data(stats.json().utf8)) as? [String: Any]
+        let flags = json?["flags"] as? [String: Any]
+        let passed = flags?["passed"] as? [String: Int]
+        #expect(passed?["properly_paired"] == 3)
+        let insert = json?["insert_size"] as? [String: Any]
+        #expect((insert?["counts"] as? [[Int]]) == [[310, 2]])
+        #expect(json?["base_quality"] == nil)
+    }
+
+    @Test func shardedScanMatchesSequential() async throws {
+        let path = testDataPath("range.bam")
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let sequential = try AlignmentStats.collect(file.samIterator(header: header))
+
+        let scanner = ParallelBAMScanner(path: path, shardCount: 4, windowSize: 1000)
+        let sharded = try await AlignmentStats.collect(scanner)
+        #expect(sharded.passed == sequential.passed)
+        #expect(sharded.failed == sequential.failed)
+        #expect(sharded.insertSize == sequential.insertSize)
+        #expect(sharded.mappingQuality == sequential.mappingQuality)
+        #expect(sharded.readLength == sequential.readLength)
+        #expect(sharded.baseQuality == sequential.baseQuality)
+        #expect(sequential.passed.total + sequential.failed.total == 112)
+    }
+
+    @Test func indexStatisticsMatchRecordCounts() throws {
+        let path = testDataPath("range.bam")
+        let idxstats = try AlignmentStats.indexStatistics(path: path)
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let stats = try AlignmentStats.collect(file.samIterator(header: header), collectors: .flags)
+
+        #expect(idxstats.contigs.count == Int(header.nTargets))
+        #expect(idxstats.mapped == stats.passed.mapped + stats.failed.mapped)
+        #expect(idxstats.mapped + idxstats.unmapped == 112)
+        let chrII = idxstats.contigs.first { $0.name == "CHROMOSOME_II" }
+        #expect(chrII.map { $0.mapped + $0.unmapped } == 34)
+        #expect(idxstats.tsv().hasSuffix("*\t0\t0\t\(idxstats.unplaced)\n"))
+    }
+}
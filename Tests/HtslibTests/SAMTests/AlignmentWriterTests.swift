@@ -0,0 +1,88 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Testing
+@testable import Htslib
+
+@Suite("AlignmentWriter")
+struct AlignmentWriterTests {
+    private func copyRange(to output: String, options: WriterOptions, threads: Int32 = 0) throws -> WriterStatistics {
+        let input = try HTSFile(path: testDataPath("range.bam"), mode: "r")
+        let header = try input.samHeader()
+        let iterator = input.samIterator(header: header)
+        if threads > 0 {
+            let pool = try ThreadPool(threads: threads)
+            let writer = try AlignmentWriter(path: output, header: header, options: options, pool: pool)
+            try iterator.forEach { try writer.write($0) }
+            return try writer.close()
+        }
+        let writer = try AlignmentWriter(path: output, header: header, options: options)
+        try iterator.forEach { try writer.write($0) }
+        return try writer.close()
+    }
+
+    private func countRecords(_ path: String) throws -> Int {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        var count = 0
+        try file.samIterator(header: header).forEach { _ in count += 1 }
+        return count
+    }
+
+    @Test func writesAndIndexesOnTheFly() throws {
+        let output = tempFilePath("writer-indexed.bam")
+        defer {
+            try? FileManager.default.removeItem(atPath: output)
+            try? FileManager.default.removeItem(atPath: output + ".bai")
+        }
+        let stats = try copyRange(to: output, options: .init(buildIndex: true, batchSize: 16, queueDepth: 2), threads: 2)
+        #expect(stats.records == 112)
+        #expect(stats.indexPath == output + ".bai")
+
+        let file = try HTSFile(path: output, mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: output)
+        let iter = try file.samQueryIterator(header: header, index: index, region: "CHROMOSOME_II")
+        var count = 0
+        while iter.next() != nil { count += 1 }
+        #expect(count == 34)
+    }
+
+    @Test func csiIndexWithMinShift() throws {
+        let output = tempFilePath("writer-csi.bam")
+        defer {
+            try? FileManager.default.removeItem(atPath: output)
+            try? FileManager.default.removeItem(atPath: output + ".csi")
+        }
+        let stats = try copyRange(to: output, options: .init(buildIndex: true, minShift: 14))
+        #expect(stats.indexPath == output + ".csi")
+        _ = try HTSIndex(path: output, format: .csi)
+    }
+
+    @Test func synchronousModeWritesEveryRecord() throws {
+        let output = tempFilePath("writer-sync.bam")
+        defer { try? FileManager.default.removeItem(atPath: output) }
+        let stats = try copyRange(to: output, options: .init(background: false))
+        #expect(stats.records == 112)
+        #expect(stats.indexPath == nil)
+        #expect(try countRecords(output) == 112)
+    }
+
+    @Test func writesBatches() throws {
+        let output = tempFilePath("writer-batches.bam")
+        defer { try? FileManager.default.removeItem(atPath: output) }
+        let input = try HTSFile(path: testDataPath("range.bam"), mode: "r")
+        let header = try input.samHeader()
+        let iterator = input.samIterator(header: header)
+        let writer = try AlignmentWriter(path: output, header: header, options: .init(batchSize: 8))
+        let batch = BAMRecordBatch(capacity: 25)
+        while try iterator.readBatch(into: batch) > 0 {
+            try writer.write(batch)
+        }
+        try writer.flush()
+        #expect(writer.recordsWritten == 112)
+        try writer.close()
+        #expect(try countRecords(output) == 112)
+    }
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Testing
+@testable import Htslib
+
+@Suite("AuxiliaryIndex")
+struct AuxiliaryIndexTests {
+    @Test func auxTagLiterals() {
+        let nm: AuxTag = "NM"
+        #expect(nm == .NM)
+        #expect(nm.description == "NM")
+        #expect(AuxTag("RG") == .RG)
+        #expect(AuxTag("RGX") == nil)
+        #expect(AuxTag.MM.rawValue == UInt16(UInt8(ascii: "M")) * 0x101)
+    }
+
+    @Test func typedTagAccessors() throws {
+        let file = try HTSFile(path: testDataPath("auxf#values.sam"), mode: "r")
+        let header = try SAMHeader(from: file)
+        let iter = SAMRecordIterator(file: file.pointer, header: header.pointer)
+        guard let record = iter.next() else {
+            Issue.record("Expected a record"); return
+        }
+
+        let aux = record.auxiliaryData
+        #expect(aux.string(forTag: .RG) == "ID")
+        #expect(aux.integer(forTag: "IA" as AuxTag) == 2147483647)
+        #expect(aux.character(forTag: "Ac" as AuxTag) == "c")
+        #expect(!aux.contains(.NM))
+    }
+
+    @Test func indexMatchesLookups() throws {
+        let file = try HTSFile(path: testDataPath("auxf#values.sam"), mode: "r")
+        let header = try SAMHeader(from: file)
+        let iter = SAMRecordIterator(file: file.pointer, header: header.pointer)
+        guard let record = iter.next() else {
+            Issue.record("Expected a record"); return
+        }
+
+        let index = AuxiliaryIndex(capacity: 2)
+        index.load(record)
+        #expect(!index.isTruncated)
+        #expect(index.count == 38)
+        #expect(index.tags.first == .RG)
+        #expect(index.string(forTag: .RG) == "ID")
+        #expect(index.integer(forTag: "iB") == -2147483648)
+        #expect(index.float(forTag: "F2") == 1.0)
+        #expect(index.character(forTag: "AC") == "C")
+        #expect(index.string(forTag: "Zn") == "")
+        #expect(index.type(ofTag: "I5") == "S")
+        #expect(index.integer(forTag: "ZZ") == nil)
+        let aux = record.auxiliaryData
+        for tag in index.tags where index.type(ofTag: tag) == "i" {
+            #expect(index.integer(forTag: tag) == aux.integer(forTag: tag))
+        }
+    }
+
+    @Test func zeroCopyArrays() throws {
+        let file = try HTSFile(path: testDataPath("auxf#values.sam"), mode: "r")
+        let header = try SAMHeader(from: file)
+        let iter = SAMRecordIterator(file: file.pointer, header: header.pointer)
+        _ = iter.next() // skip first record
+        guard let record = iter.next() else {
+            Issue.record("Expected second record"); return
+        }
+
+        let aux = record.auxiliaryData
+        #expect(aux.array(forTag: "BC", as: UInt8.self).map(Array.init) == [0, 127, 128, 255])
+        #expect(aux.array(forTag: "Bs", as: Int16.self).map(Array.init) == [-32768, -32767, 0, 32767])
+        #expect(aux.array(forTag: "BI", as: UInt32.self).map(Array.init) == [0, 2147483647, 2147483648, 4294967295])
+        // Subtype must match exactly.
+        #expect(aux.array(forTag: "BC", as: Int8.self) == nil)
+
+        let index = AuxiliaryIndex()
+        index.load(record)
+        #expect(!index.isTruncated)
+        guard let bi = index.array(forTag: "Bi", as: Int32.self) else {
+            Issue.record("Expected Bi array"); return
+        }
+        var copy = [Int32](repeating: 0, count: bi.count)
+        let n = copy.withUnsafeMutableBufferPointer { bi.copy(into: $0) }
+        #expect(n == 4)
+        #expect(copy == [-2147483648, -2147483647, 0, 2147483647])
+    }
+}
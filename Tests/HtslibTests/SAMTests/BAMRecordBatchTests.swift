@@ -0,0 +1,102 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Testing
+@testable import Htslib
+
+@Suite("BAMRecordBatch")
+struct BAMRecordBatchTests {
+    @Test func readWholeFileIntoOneBatch() throws {
+        let file = try HTSFile(path: testDataPath("auxf#values.sam"), mode: "r")
+        let header = try file.samHeader()
+        let iter = file.samIterator(header: header)
+
+        let batch = BAMRecordBatch(capacity: 16)
+        let n = try iter.readBatch(into: batch)
+        #expect(n == 2)
+        #expect(batch.count == 2)
+        #expect(batch[0].queryName == "Fred")
+        #expect(batch[1].queryName == "Jim")
+        #expect(try iter.readBatch(into: batch) == 0)
+        #expect(batch.count == 0)
+    }
+
+    @Test func columnsMatchRecords() throws {
+        let file = try HTSFile(path: testDataPath("ce#1.sam"), mode: "r")
+        let header = try file.samHeader()
+        let iter = file.samIterator(header: header)
+
+        let batch = BAMRecordBatch(capacity: 4)
+        try iter.readBatch(into: batch)
+        #expect(batch.count == 1)
+        #expect(batch.positions[0] == 1)
+        #expect(batch.contigIDs[0] == 0)
+        #expect(batch.mappingQualities[0] == 1)
+        #expect(batch.endPositions[0] == batch.positions[0] + 101)
+        #expect(batch.sequenceLengths[0] == 100)
+        #expect(AlignmentFlag(rawValue: batch.flags[0]).contains(.reverse))
+
+        let view = batch[0]
+        #expect(view.queryName == "SRR065390.14978392")
+        #expect(view.cigar.count == 3)
+        #expect(view.sequence.count == 100)
+        #expect(view.qualities.count == 100)
+    }
+
+    @Test func smallCapacitySplitsIntoBatches() throws {
+        let file = try HTSFile(path: testDataPath("auxf#values.sam"), mode: "r")
+        let header = try file.samHeader()
+        let iter = file.samIterator(header: header)
+
+        let batch = BAMRecordBatch(capacity: 1, arenaCapacity: 8)
+        var names: [String] = []
+        while try iter.readBatch(into: batch) > 0 {
+            names.append(batch[0].queryName)
+        }
+        #expect(names == ["Fred", "Jim"])
+    }
+
+    @Test func auxDataSurvivesArenaGrowth() throws {
+        let file = try HTSFile(path: testDataPath("auxf#values.sam"), mode: "r")
+        let header = try file.samHeader()
+        let iter = file.samIterator(header: header)
+
+        let batch = BAMRecordBatch(capacity: 8, arenaCapacity: 8)
+        try iter.readBatch(into: batch)
+        #expect(batch.count == 2)
+        #expect(batch[0].queryName == "Fred")
+        #expect(batch[0].auxiliaryData.contains("RG"))
+        #expect(batch.variableData(at: 0).count > 0)
+    }
+
+    @Test func copyRecordOutlivesBatch() throws {
+        let file = try HTSFile(path: testDataPath("auxf#values.sam"), mode: "r")
+        let header = try file.samHeader()
+        let iter = file.samIterator(header: header)
+
+        let batch = BAMRecordBatch(capacity: 8)
+        try iter.readBatch(into: batch)
+        let owned = try batch.copyRecord(at: 1)
+        batch.reset()
+        #expect(owned.queryName == "Jim")
+    }
+
+    @Test func queryBatchMatchesIterator() throws {
+        let path = testDataPath("range.bam")
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: path)
+
+        let expected = try file.samQueryIterator(header: header, index: index, region: "CHROMOSOME_I")
+        var positions: [Int64] = []
+        while let record = expected.next() { positions.append(record.position) }
+
+        let query = try file.samQueryIterator(header: header, index: index, region: "CHROMOSOME_I")
+        let batch = BAMRecordBatch(capacity: 64)
+        var batched: [Int64] = []
+        while try query.readBatch(into: batch) > 0 {
+            batched.append(contentsOf: batch.positions)
+        }
+        #expect(batched == positions)
+    }
+}
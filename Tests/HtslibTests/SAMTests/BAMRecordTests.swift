@@ -161,4 +161,54 @@ struct BAMRecordTests {
         #expect(record2.queryName == origName)
         #expect(record2.position == origPos)
     }
+
+    @Test func bulkDecodeMatchesPerBase() throws {
+        var record = try BAMRecord()
+        let bases = String((0..<157).map { i in Array("ACGTNRYKM")[(i * 7) % 9] })
+        try record.set(qname: "r", flag: 0, tid: -1, pos: -1, mapq: 0, cigar: [],
+                       mtid: -1, mpos: -1, isize: 0, seq: bases, qual: nil)
+        let sequence = record.sequence
+        #expect(sequence.string == String(sequence.map { $0 }))
+        #expect(sequence.string == bases)
+
+        // Odd start and length exercise the unaligned head and tail.
+        var buffer = [UInt8](repeating: 0, count: 64)
+        let n = buffer.withUnsafeMutableBufferPointer { sequence.decode(into: $0, range: 3..<58) }
+        #expect(n == 55)
+        #expect(String(decoding: buffer[0..<55], as: UTF8.self) == String(Array(bases)[3..<58]))
+    }
+
+    @Test func reverseComplementDecode() throws {
+        var record = try BAMRecord()
+        let bases = String(repeating: "AACGTTGCAN", count: 7) + "ACG"
+        try record.set(qname: "r", flag: 0, tid: -1, pos: -1, mapq: 0, cigar: [],
+                       mtid: -1, mpos: -1, isize: 0, seq: bases, qual: nil)
+        let complement: [Character: Character] = ["A": "T", "C": "G", "G": "C", "T": "A", "N": "N"]
+        let expected = String(bases.reversed().map { complement[$0]! })
+        #expect(record.sequence.reverseComplementString == expected)
+    }
+
+    @Test func setSequenceInPlace() throws {
+        var record = try BAMRecord()
+        try record.set(qname: "r", flag: 0, tid: -1, pos: -1, mapq: 0, cigar: [],
+                       mtid: -1, mpos: -1, isize: 0, seq: "NNNNNNN", qual: "!!!!!!!")
+        let bases = Array("GATTACA".utf8)
+        let quals: [UInt8] = [10, 20, 30, 40, 30, 20, 10]
+        try bases.withUnsafeBufferPointer { b in
+            try quals.withUnsafeBufferPointer { q in
+                try record.setSequence(b, qualities: q)
+            }
+        }
+        #expect(record.sequence.string == "GATTACA")
+        #expect(Array(record.qualities) == quals)
+
+        let short = Array("GAT".utf8)
+        var threw = false
+        do {
+            try short.withUnsafeBufferPointer { try record.setSequence($0) }
+        } catch {
+            threw = true
+        }
+        #expect(threw)
+    }
 }
@@ -0,0 +1,225 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Testing
+@testable import Htslib
+
+@Suite("BAMSorter")
+struct BAMSorterTests {
+    private struct Key: Equatable {
+        var contigID: Int32
+        var position: Int64
+        var name: String
+    }
+
+    private func sort(_ input: String, to output: String, options: BAMSorter.Options,
+                      threads: Int = 0) throws -> BAMSorter.Statistics {
+        let file = try HTSFile(path: input, mode: "r")
+        let header = try file.samHeader()
+        if threads > 0 {
+            let pool = try ThreadPool(threads: Int32(threads))
+            let sorter = BAMSorter(header: header, options: options, pool: pool)
+            try sorter.add(contentsOf: file.samIterator(header: header))
+            return try sorter.finish(to: output)
+        }
+        let sorter = BAMSorter(header: header, options: options)
+        try sorter.add(contentsOf: file.samIterator(header: header))
+        return try sorter.finish(to: output)
+    }
+
+    private func readKeys(_ path: String) throws -> (keys: [Key], sortOrder: String?) {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        var keys: [Key] = []
+        try file.samIterator(header: header).forEach { record in
+            keys.append(Key(contigID: record.contigID, position: record.position, name: record.queryName))
+        }
+        return (keys, header.sortOrder)
+    }
+
+    /// htslib's natural name order, written independently of the sort kernel: digit
+    /// runs compare by value, other bytes by code.
+    private func naturalOrder(_ a: String, _ b: String) -> Int {
+        let x = Array(a.utf8), y = Array(b.utf8)
+        func isDigit(_ c: UInt8) -> Bool { c >= UInt8(ascii: "0") && c <= UInt8(ascii: "9") }
+        var i = 0, j = 0
+        while i < x.count && j < y.count {
+            guard isDigit(x[i]) && isDigit(y[j]) else {
+                if x[i] != y[j] { return x[i] < y[j] ? -1 : 1 }
+                i += 1
+                j += 1
+                continue
+            }
+            while i < x.count && x[i] == UInt8(ascii: "0") { i += 1 }
+            while j < y.count && y[j] == UInt8(ascii: "0") { j += 1 }
+            var ei = i, ej = j
+            while ei < x.count && isDigit(x[ei]) { ei += 1 }
+            while ej < y.count && isDigit(y[ej]) { ej += 1 }
+            if ei - i != ej - j { return ei - i < ej - j ? -1 : 1 }
+            if x[i..<ei] != y[j..<ej] { return x[i..<ei].lexicographicallyPrecedes(y[j..<ej]) ? -1 : 1 }
+            i = ei
+            j = ej
+        }
+        return i < x.count ? 1 : j < y.count ? -1 : 0
+    }
+
+    /// A SAM file of `count` single-contig reads in scrambled position and name order.
+    private func writeScrambledSAM(count: Int) throws -> String {
+        let path = tempFilePath("sort-input-\(UInt32.random(in: 0...UInt32.max)).sam")
+        var text = "@HD\tVN:1.6\tSO:unsorted\n@SQ\tSN:chr1\tLN:10000000\n"
+        for i in 0..<count {
+            // 7919 is prime, so positions and names are a permutation of 0..<count.
+            let k = (i * 7919) % count
+            let flag = k % 3 == 0 ? 16 : 0
+            text += "q\((k * 31) % count)\t\(flag)\tchr1\t\(k * 10 + 1)\t60\t4M\t*\t0\t0\tACGT\tIIII\n"
+        }
+        try text.write(toFile: path, atomically: true, encoding: .utf8)
+        return path
+    }
+
+    @Test func coordinateSortInMemory() throws {
+        let output = tempFilePath("sort-memory.bam")
+        defer { try? FileManager.default.removeItem(atPath: output) }
+        let stats = try sort(testDataPath("range.bam"), to: output, options: .init(order: .coordinate))
+        #expect(stats.records == 112)
+        #expect(stats.spilledRuns == 0)
+        #expect(stats.chunks == 1)
+
+        let (keys, sortOrder) = try readKeys(output)
+        #expect(keys.count == 112)
+        #expect(sortOrder == "coordinate")
+        for (a, b) in zip(keys, keys.dropFirst()) {
+            let tidA = UInt32(bitPattern: a.contigID), tidB = UInt32(bitPattern: b.contigID)
+            #expect(tidA < tidB || (tidA == tidB && a.position <= b.position))
+        }
+    }
+
+    @Test func queryNameSortSpillsAndMerges() throws {
+        let output = tempFilePath("sort-name.bam")
+        defer { try? FileManager.default.removeItem(atPath: output) }
+        let options = BAMSorter.Options(order: .queryName, memoryBudget: 4096,
+                                        temporaryDirectory: NSTemporaryDirectory(), mergeFanIn: 3)
+        let stats = try sort(testDataPath("range.bam"), to: output, options: options)
+        #expect(stats.records == 112)
+        #expect(stats.spilledRuns > 3)
+        #expect(stats.intermediateMerges > 0)
+        #expect(stats.peakArenaBytes <= 4096)
+
+        let (keys, sortOrder) = try readKeys(output)
+        #expect(keys.count == 112)
+        #expect(sortOrder == "queryname")
+        // Names follow natural order, which differs from byte order for these names.
+        for (a, b) in zip(keys, keys.dropFirst()) {
+            #expect(naturalOrder(a.name, b.name) <= 0)
+        }
+        #expect(keys.map(\.name) != keys.map(\.name).sorted())
+    }
+
+    @Test func queryNameSortUsesNaturalOrder() throws {
+        let input = tempFilePath("sort-names-\(UInt32.random(in: 0...UInt32.max)).sam")
+        let output = tempFilePath("sort-names-\(UInt32.random(in: 0...UInt32.max)).bam")
+        defer {
+            try? FileManager.default.removeItem(atPath: input)
+            try? FileManager.default.removeItem(atPath: output)
+        }
+        // r9's second mate comes first in the input; mates sort READ1 before READ2.
+        let reads: [(name: String, flag: Int, pos: Int)] = [
+            ("r10", 0, 10), ("s1", 0, 20), ("r9", 129, 30), ("r100", 0, 40), ("r1a", 0, 50),
+            ("R5", 0, 60), ("r9", 65, 70), ("r1", 0, 80), ("r010", 0, 90), ("r2", 0, 100),
+        ]
+        var text = "@HD\tVN:1.6\tSO:unsorted\n@SQ\tSN:chr1\tLN:1000\n"
+        for read in reads {
+            text += "\(read.name)\t\(read.flag)\tchr1\t\(read.pos)\t60\t4M\t*\t0\t0\tACGT\tIIII\n"
+        }
+        try text.write(toFile: input, atomically: true, encoding: .utf8)
+
+        _ = try sort(input, to: output, options: .init(order: .queryName))
+        let keys = try readKeys(output).keys
+        #expect(keys.map(\.name) == ["R5", "r1", "r1a", "r2", "r9", "r9", "r10", "r010", "r100", "s1"])
+        // "r10" and "r010" compare equal, so they keep their input order.
+        #expect(keys.map(\.position) == [59, 79, 49, 99, 69, 29, 9, 89, 39, 19])
+    }
+
+    @Test(arguments: [BAMSortOrder.coordinate, .queryName])
+    func parallelChunkSortMatchesSerialSort(order: BAMSortOrder) throws {
+        // The kernel splits a chunk across threads only with at least 64 records per part.
+        let input = try writeScrambledSAM(count: 4000)
+        let serial = tempFilePath("sort-serial-\(UInt32.random(in: 0...UInt32.max)).bam")
+        let parallel = tempFilePath("sort-parallel-\(UInt32.random(in: 0...UInt32.max)).bam")
+        defer {
+            for path in [input, serial, parallel] { try? FileManager.default.removeItem(atPath: path) }
+        }
+        _ = try sort(input, to: serial, options: .init(order: order, sortThreads: 1))
+        let stats = try sort(input, to: parallel, options: .init(order: order, sortThreads: 4), threads: 4)
+        #expect(stats.records == 4000)
+        #expect(stats.chunks == 1)
+        #expect(stats.spilledRuns == 0)
+
+        let keys = try readKeys(parallel).keys
+        #expect(keys == readKeys(serial).keys)
+        for (a, b) in zip(keys, keys.dropFirst()) {
+            if order == .coordinate {
+                #expect(a.position < b.position)
+            } else {
+                #expect(naturalOrder(a.name, b.name) < 0)
+            }
+        }
+    }
+
+    @Test func spilledSortMatchesInMemorySort() throws {
+        let inMemory = tempFilePath("sort-a.bam")
+        let spilled = tempFilePath("sort-b.bam")
+        defer {
+            try? FileManager.default.removeItem(atPath: inMemory)
+            try? FileManager.default.removeItem(atPath: spilled)
+        }
+        _ = try sort(testDataPath("range.bam"), to: inMemory, options: .init(order: .coordinate))
+        let stats = try sort(testDataPath("range.bam"), to: spilled,
+                             options: .init(order: .coordinate, memoryBudget: 8192, sortThreads: 2,
+                                            temporaryDirectory: NSTemporaryDirectory()),
+                             threads: 2)
+        #expect(stats.spilledRuns > 0)
+        #expect(try readKeys(inMemory).keys == readKeys(spilled).keys)
+    }
+
+    @Test func tagSortWritesUnknownOrder() throws {
+        let output = tempFilePath("sort-tag.bam")
+        defer { try? FileManager.default.removeItem(atPath: output) }
+        let stats = try sort(testDataPath("range.bam"), to: output, options: .init(order: .tag("RG")))
+        #expect(stats.records == 112)
+        #expect(try readKeys(output).sortOrder == "unknown")
+    }
+
+    @Test func tagSortOrdersByTagValue() throws {
+        let input = tempFilePath("sort-tags-\(UInt32.random(in: 0...UInt32.max)).sam")
+        let output = tempFilePath("sort-tags-\(UInt32.random(in: 0...UInt32.max)).bam")
+        defer {
+            try? FileManager.default.removeItem(atPath: input)
+            try? FileManager.default.removeItem(atPath: output)
+        }
+        let reads: [(name: String, pos: Int, readGroup: String?)] = [
+            ("t1", 50, "b"), ("t2", 10, nil), ("t3", 40, "a"), ("t4", 20, "b"),
+            ("t5", 30, nil), ("t6", 5, "a10"), ("t7", 60, "a"),
+        ]
+        var text = "@HD\tVN:1.6\tSO:unsorted\n@SQ\tSN:chr1\tLN:1000\n"
+        for read in reads {
+            text += "\(read.name)\t0\tchr1\t\(read.pos)\t60\t4M\t*\t0\t0\tACGT\tIIII"
+            text += read.readGroup.map { "\tRG:Z:\($0)\n" } ?? "\n"
+        }
+        try text.write(toFile: input, atomically: true, encoding: .utf8)
+
+        _ = try sort(input, to: output, options: .init(order: .tag("RG")))
+        // Untagged records first, then values in byte order; ties keep coordinate order.
+        #expect(try readKeys(output).keys.map(\.name) == ["t2", "t5", "t3", "t7", "t6", "t4", "t1"])
+    }
+
+    @Test func setSortOrderAddsHeaderLine() throws {
+        let header = try SAMHeader(text: "@SQ\tSN:chr1\tLN:100\n")
+        #expect(header.sortOrder == nil)
+        try header.setSortOrder("queryname", subSort: "queryname:natural")
+        #expect(header.sortOrder == "queryname")
+        try header.setSortOrder("coordinate")
+        #expect(header.sortOrder == "coordinate")
+    }
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Testing
+@testable import Htslib
+
+@Suite("CIGARWalker")
+struct CIGARWalkerTests {
+    /// 3H5S10M2I10M4D6M at position 100 (33 query bases).
+    private func makeRecord() throws -> BAMRecord {
+        var record = try BAMRecord()
+        let cigar: [UInt32] = [
+            CIGAROperation.make(length: 3, op: .hardClip).rawValue,
+            CIGAROperation.make(length: 5, op: .softClip).rawValue,
+            CIGAROperation.make(length: 10, op: .match).rawValue,
+            CIGAROperation.make(length: 2, op: .insertion).rawValue,
+            CIGAROperation.make(length: 10, op: .match).rawValue,
+            CIGAROperation.make(length: 4, op: .deletion).rawValue,
+            CIGAROperation.make(length: 6, op: .match).rawValue,
+        ]
+        try record.set(qname: "w", flag: 0, tid: 0, pos: 100, mapq: 60, cigar: cigar,
+                       mtid: -1, mpos: -1, isize: 0,
+                       seq: String(repeating: "A", count: 33), qual: nil)
+        return record
+    }
+
+    @Test func blocksSkipHardClips() throws {
+        let record = try makeRecord()
+        var blocks: [AlignedBlock] = []
+        record.forEachAlignedBlock { blocks.append($0) }
+        #expect(blocks.map(\.op) == [.softClip, .match, .insertion, .match, .deletion, .match])
+        #expect(blocks.map(\.queryStart) == [0, 5, 15, 17, 27, 27])
+        #expect(blocks.map(\.referenceStart) == [100, 100, 110, 110, 120, 124])
+    }
+
+    @Test func queryToReference() throws {
+        let record = try makeRecord()
+        let walker = CIGARWalker(capacity: 1)
+        walker.load(record)
+        #expect(walker.count == 6)
+        #expect(walker.referencePosition(forQuery: 0) == nil)   // soft clip
+        #expect(walker.referencePosition(forQuery: 5) == 100)
+        #expect(walker.referencePosition(forQuery: 15) == nil)  // insertion
+        #expect(walker.referencePosition(forQuery: 17) == 110)
+        #expect(walker.referencePosition(forQuery: 27) == 124)  // first base after deletion
+        #expect(walker.referencePosition(forQuery: 32) == 129)
+        #expect(walker.referencePosition(forQuery: 33) == nil)
+    }
+
+    @Test func referenceToQuery() throws {
+        let record = try makeRecord()
+        let walker = CIGARWalker()
+        walker.load(record)
+        #expect(walker.queryPosition(forReference: 99) == nil)
+        #expect(walker.queryPosition(forReference: 100) == 5)
+        #expect(walker.queryPosition(forReference: 110) == 17)  // after insertion
+        #expect(walker.queryPosition(forReference: 121) == nil) // deletion
+        #expect(walker.queryPosition(forReference: 129) == 32)
+        #expect(walker.queryPosition(forReference: 130) == nil)
+    }
+
+    @Test func alignedPairsRoundTrip() throws {
+        let file = try HTSFile(path: testDataPath("ce#1.sam"), mode: "r")
+        let header = try file.samHeader()
+        let walker = CIGARWalker()
+        var pairs = 0
+        try file.samIterator(header: header).forEach { record in
+            walker.load(record)
+            walker.forEachAlignedPair { q, r in
+                pairs += 1
+                #expect(walker.referencePosition(forQuery: q) == r)
+                #expect(walker.queryPosition(forReference: r) == q)
+            }
+        }
+        // 27M1D73M
+        #expect(pairs == 100)
+        #expect(walker.queryPosition(forReference: 1 + 27) == nil)
+    }
+}
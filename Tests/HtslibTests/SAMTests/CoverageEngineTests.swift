@@ -0,0 +1,102 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Testing
+@testable import Htslib
+
+@Suite("CoverageEngine")
+struct CoverageEngineTests {
+    /// Naive depth: +1 per aligned base of every record passing the default flag filter.
+    private func naiveDepth(_ path: String, contigID: Int32) throws -> [Int32] {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        var depth = [Int32](repeating: 0, count: Int(header.targetLength(at: contigID)))
+        let excluded = CoverageEngine.Options.defaultExcludedFlags
+        try file.samIterator(header: header).forEach { record in
+            guard record.contigID == contigID, record.flag.isDisjoint(with: excluded) else { return }
+            record.forEachAlignedBlock { block in
+                guard block.isAligned else { return }
+                for r in block.referenceStart..<block.referenceEnd where r < depth.count {
+                    depth[Int(r)] += 1
+                }
+            }
+        }
+        return depth
+    }
+
+    @Test func accumulatorMatchesSingleRecord() throws {
+        let file = try HTSFile(path: testDataPath("ce#1.sam"), mode: "r")
+        let header = try file.samHeader()
+        let withDeletions = DepthAccumulator(countDeletions: true)
+        let withoutDeletions = DepthAccumulator()
+        withDeletions.reset(contigID: 0, length: 200)
+        withoutDeletions.reset(contigID: 0, length: 200)
+        try file.samIterator(header: header).forEach { record in
+            withDeletions.add(record)
+            withoutDeletions.add(record)
+        }
+        // 27M1D73M at position 1.
+        let a = withDeletions.finish()
+        let b = withoutDeletions.finish()
+        #expect(a[0] == 0 && a[1] == 1 && a[28] == 1 && a[101] == 1 && a[102] == 0)
+        #expect(b[27] == 1 && b[28] == 0 && b[29] == 1)
+        #expect(a.reduce(0, +) == 101)
+        #expect(b.reduce(0, +) == 100)
+    }
+
+    @Test func engineMatchesNaiveDepth() async throws {
+        let path = testDataPath("range.bam")
+        let engine = CoverageEngine(path: path, options: .init(workers: 3))
+        for tid: Int32 in 0..<4 {
+            let expected = try naiveDepth(path, contigID: tid)
+            let depth = try await engine.depth(contigID: tid)
+            #expect(depth == expected)
+        }
+    }
+
+    @Test func windowsAndIntervals() async throws {
+        let path = testDataPath("range.bam")
+        let engine = CoverageEngine(path: path)
+        let expected = try naiveDepth(path, contigID: 1)
+
+        let windows = try await engine.windowMeans(windowSize: 1000).filter { $0.contigID == 1 }
+        #expect(windows.count == 5)
+        let first = Double(expected[0..<1000].reduce(0) { $0 + Int64($1) }) / 1000
+        #expect(abs(windows[0].meanDepth - first) < 1e-9)
+
+        let covered = try await engine.intervals(minimumDepth: 1).filter { $0.contigID == 1 }
+        let coveredBases = covered.reduce(Int64(0)) { $0 + $1.end - $1.start }
+        #expect(coveredBases == Int64(expected.filter { $0 >= 1 }.count))
+    }
+
+    @Test func targetSummaries() async throws {
+        let path = testDataPath("range.bam")
+        let engine = CoverageEngine(path: path)
+        let expected = try naiveDepth(path, contigID: 1)
+        let targets = [
+            try #require(try BEDRegion.parse(line: "CHROMOSOME_II\t100\t600\tt1")),
+            BEDRegion(contig: "CHROMOSOME_II", start: 0, end: 5000),
+        ]
+        let summaries = try await engine.summarize(targets: targets, thresholds: [1, 5])
+        #expect(summaries.count == 2)
+        #expect(summaries[0].region.name == "t1")
+        let slice = expected[100..<600]
+        #expect(summaries[0].maximumDepth == slice.max())
+        #expect(summaries[0].minimumDepth == slice.min())
+        #expect(summaries[0].basesAtOrAbove == [Int64(slice.filter { $0 >= 1 }.count),
+                                                Int64(slice.filter { $0 >= 5 }.count)])
+
+        await #expect(throws: HTSError.self) {
+            _ = try await engine.summarize(targets: [BEDRegion(contig: "nope", start: 0, end: 1)])
+        }
+    }
+
+    @Test func bedParsing() throws {
+        #expect(try BEDRegion.parse(line: "# comment") == nil)
+        #expect(try BEDRegion.parse(line: "track name=x") == nil)
+        let region = try BEDRegion.parse(line: "chr1\t10\t20\r")
+        #expect(region == BEDRegion(contig: "chr1", start: 10, end: 20))
+        #expect(region?.length == 10)
+        #expect(throws: HTSError.self) { try BEDRegion.parse(line: "chr1\t20\t10") }
+    }
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Testing
+@testable import Htslib
+
+@Suite("DuplicateMarker")
+struct DuplicateMarkerTests {
+    // Pairs A, B and C share both unclipped 5' ends (C through a 2S soft clip); A scores
+    // highest. B sits within 100 pixels of A on the same tile, C on another tile. D is an
+    // unpaired read on a pair's end; E and F are unpaired reads sharing an end.
+    private static let sam = """
+        @HD\tVN:1.6\tSO:coordinate
+        @SQ\tSN:chr1\tLN:10000
+        @RG\tID:rg1\tLB:lib1
+        M1:1:FC:1:1101:1000:2000\t99\tchr1\t101\t60\t10M\t=\t301\t210\tACGTACGTAC\tIIIIIIIIII\tMC:Z:10M\tRG:Z:rg1
+        M1:1:FC:1:1101:1050:2050\t99\tchr1\t101\t60\t10M\t=\t301\t210\tACGTACGTAC\t5555555555\tMC:Z:10M\tRG:Z:rg1
+        D\t0\tchr1\t101\t60\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII\tRG:Z:rg1
+        M1:1:FC:1:1102:1000:2000\t99\tchr1\t103\t60\t2S8M\t=\t301\t208\tACGTACGTAC\t5555555555\tMC:Z:10M\tRG:Z:rg1
+        M1:1:FC:1:1101:1000:2000\t147\tchr1\t301\t60\t10M\t=\t101\t-210\tACGTACGTAC\tIIIIIIIIII\tMC:Z:10M\tRG:Z:rg1
+        M1:1:FC:1:1101:1050:2050\t147\tchr1\t301\t60\t10M\t=\t101\t-210\tACGTACGTAC\t5555555555\tMC:Z:10M\tRG:Z:rg1
+        M1:1:FC:1:1102:1000:2000\t147\tchr1\t301\t60\t10M\t=\t103\t-208\tACGTACGTAC\t5555555555\tMC:Z:2S8M\tRG:Z:rg1
+        E\t16\tchr1\t501\t60\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII\tRG:Z:rg1
+        F\t16\tchr1\t501\t60\t10M\t*\t0\t0\tACGTACGTAC\t5555555555\tRG:Z:rg1
+
+        """
+
+    private struct Marked: Equatable {
+        var name: String
+        var position: Int64
+        var duplicate: Bool
+    }
+
+    private func mark(_ options: DuplicateMarker.Options = .init()) throws
+        -> (records: [Marked], stats: DuplicateMarker.Statistics) {
+        let path = tempFilePath("markdup-\(UInt32.random(in: 0...UInt32.max)).sam")
+        try Self.sam.write(toFile: path, atomically: true, encoding: .utf8)
+        defer { try? FileManager.default.removeItem(atPath: path) }
+
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let marker = try DuplicateMarker(header: header, options: options)
+        var records: [Marked] = []
+        let collect = { (record: borrowing BAMRecord) in
+            records.append(Marked(name: record.queryName, position: record.position,
+                                  duplicate: record.flag.contains(.duplicate)))
+        }
+        try file.samIterator(header: header).forEach { record in
+            try marker.add(record, emit: collect)
+        }
+        let stats = try marker.finish(emit: collect)
+        return (records, stats)
+    }
+
+    @Test func marksPairsFragmentsAndMates() throws {
+        let (records, stats) = try mark()
+        #expect(records.count == 10)
+        let duplicates = records.filter(\.duplicate).map(\.name)
+        #expect(duplicates.sorted() == [
+            "D", "F",
+            "M1:1:FC:1:1101:1050:2050", "M1:1:FC:1:1101:1050:2050",
+            "M1:1:FC:1:1102:1000:2000", "M1:1:FC:1:1102:1000:2000",
+        ])
+        #expect(stats.pairDuplicates == 2)
+        #expect(stats.mateDuplicates == 2)
+        #expect(stats.fragmentDuplicates == 2)
+        #expect(stats.duplicates == 6)
+        #expect(stats.opticalDuplicates == 2)
+        #expect(stats.unmatchedMates == 0)
+    }
+
+    @Test func keepsInputOrder() throws {
+        let (records, _) = try mark()
+        let positions = records.map(\.position)
+        #expect(positions == positions.sorted())
+    }
+
+    @Test func spilledMateTableGivesSameResult() throws {
+        let inMemory = try mark().records
+        let (spilled, stats) = try mark(.init(mateTableCapacity: 1, temporaryDirectory: NSTemporaryDirectory()))
+        #expect(stats.spilledMateRuns > 0)
+        #expect(spilled == inMemory)
+    }
+
+    @Test func removesDuplicates() throws {
+        let (records, stats) = try mark(.init(removeDuplicates: true))
+        #expect(records.count == 4)
+        #expect(stats.removed == 6)
+        #expect(!records.contains { $0.duplicate })
+    }
+
+    @Test func rejectsUnsortedInput() throws {
+        let path = tempFilePath("markdup-unsorted-\(UInt32.random(in: 0...UInt32.max)).sam")
+        try """
+            @SQ\tSN:chr1\tLN:10000
+            late\t0\tchr1\t501\t60\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII
+            early\t0\tchr1\t101\t60\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII
+
+            """.write(toFile: path, atomically: true, encoding: .utf8)
+        defer { try? FileManager.default.removeItem(atPath: path) }
+
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let marker = try DuplicateMarker(header: header)
+        var late = try BAMRecord()
+        var early = try BAMRecord()
+        let iterator = file.samIterator(header: header)
+        let readLate = try iterator.read(into: &late)
+        let readEarly = try iterator.read(into: &early)
+        #expect(readLate && readEarly)
+        try marker.add(late) { _ in }
+        #expect(throws: HTSError.self) { try marker.add(early) { _ in } }
+    }
+}
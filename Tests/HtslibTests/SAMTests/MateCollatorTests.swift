@@ -0,0 +1,103 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Testing
+@testable import Htslib
+
+@Suite("MateCollator")
+struct MateCollatorTests {
+    // Pairs p1–p4 in coordinate order, so each read waits for its mate. p2's mate arrives
+    // second-read first. s1 is a supplementary alignment of p1, u1 is unpaired and o1's
+    // mate is missing.
+    private static let sam = """
+        @HD\tVN:1.6\tSO:coordinate
+        @SQ\tSN:chr1\tLN:10000
+        p1\t99\tchr1\t100\t60\t10M\t=\t400\t310\tACGTACGTAC\tIIIIIIIIII
+        p2\t163\tchr1\t150\t60\t10M\t=\t450\t310\tACGTACGTAC\tIIIIIIIIII
+        u1\t0\tchr1\t180\t60\t10M\t*\t0\t0\tACGTACGTAC\tIIIIIIIIII
+        p3\t99\tchr1\t200\t60\t10M\t=\t500\t310\tACGTACGTAC\tIIIIIIIIII
+        o1\t99\tchr1\t250\t60\t10M\t=\t900\t660\tACGTACGTAC\tIIIIIIIIII
+        p4\t99\tchr1\t300\t60\t10M\t=\t320\t30\tACGTACGTAC\tIIIIIIIIII
+        p4\t147\tchr1\t320\t60\t10M\t=\t300\t-30\tACGTACGTAC\tIIIIIIIIII
+        p1\t147\tchr1\t400\t60\t10M\t=\t100\t-310\tACGTACGTAC\tIIIIIIIIII
+        p2\t83\tchr1\t450\t60\t10M\t=\t150\t-310\tACGTACGTAC\tIIIIIIIIII
+        p3\t147\tchr1\t500\t60\t10M\t=\t200\t-310\tACGTACGTAC\tIIIIIIIIII
+        s1\t2145\tchr1\t600\t60\t5M\t=\t400\t0\tACGTA\tIIIII
+
+        """
+
+    private struct Result {
+        var pairs: [(first: String, second: String, firstIsRead1: Bool)] = []
+        var singles: [String] = []
+        var stats = MateCollator.Statistics()
+    }
+
+    private func collate(_ options: MateCollator.Options = .init()) throws -> Result {
+        let path = tempFilePath("collate-\(UInt32.random(in: 0...UInt32.max)).sam")
+        try Self.sam.write(toFile: path, atomically: true, encoding: .utf8)
+        defer { try? FileManager.default.removeItem(atPath: path) }
+
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let collator = try MateCollator(header: header, options: options)
+        var result = Result()
+        result.stats = try collator.run(file.samIterator(header: header)) { first, second in
+            result.pairs.append((first.queryName, second.queryName, first.flag.contains(.read1)))
+        } single: { record in
+            result.singles.append(record.queryName)
+        }
+        #expect(collator.bufferedRecords == 0)
+        return result
+    }
+
+    @Test func pairsMatesInAnyOrder() throws {
+        let result = try collate()
+        #expect(result.pairs.map(\.first).sorted() == ["p1", "p2", "p3", "p4"])
+        for pair in result.pairs {
+            #expect(pair.first == pair.second)
+            #expect(pair.firstIsRead1)
+        }
+        #expect(result.singles.sorted() == ["o1", "s1", "u1"])
+        #expect(result.stats.records == 11)
+        #expect(result.stats.pairs == 4)
+        #expect(result.stats.singles == 2)
+        #expect(result.stats.orphans == 1)
+        #expect(result.stats.spills == 0)
+        #expect(result.stats.peakBufferedRecords == 5)
+        #expect(result.stats.peakBufferedBytes > 0)
+    }
+
+    @Test func dropsNonPrimaryWhenAsked() throws {
+        let result = try collate(.init(keepNonPrimary: false))
+        #expect(result.singles.sorted() == ["o1", "u1"])
+        #expect(result.stats.skipped == 1)
+    }
+
+    @Test func spilledBucketsGiveSamePairs() throws {
+        let result = try collate(.init(memoryBudget: 1, spillBuckets: 3,
+                                       temporaryDirectory: NSTemporaryDirectory()))
+        #expect(result.stats.spills > 0)
+        #expect(result.stats.spilledRecords > 0)
+        #expect(result.stats.peakBufferedRecords == 1)
+        #expect(result.pairs.map(\.first).sorted() == ["p1", "p2", "p3", "p4"])
+        for pair in result.pairs {
+            #expect(pair.first == pair.second)
+            #expect(pair.firstIsRead1)
+        }
+        #expect(result.singles.sorted() == ["o1", "s1", "u1"])
+        #expect(result.stats.orphans == 1)
+    }
+
+    @Test func queryNameHashMatchesForMates() throws {
+        let file = try HTSFile(path: testDataPath("range.bam"), mode: "r")
+        let header = try file.samHeader()
+        var hashes: [String: UInt64] = [:]
+        try file.samIterator(header: header).forEach { record in
+            let hash = record.queryNameHash
+            if let seen = hashes[record.queryName] { #expect(seen == hash) }
+            hashes[record.queryName] = hash
+        }
+        #expect(Set(hashes.values).count == hashes.count)
+    }
+}
@@ -0,0 +1,97 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Testing
+@testable import Htslib
+
+@Suite("MultiRegionQueryIterator")
+struct MultiRegionQueryIteratorTests {
+    private func singleQueryCount(_ region: String) throws -> Int {
+        let file = try HTSFile(path: testDataPath("range.bam"), mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: testDataPath("range.bam"))
+        let iter = try file.samQueryIterator(header: header, index: index, region: region)
+        var count = 0
+        while iter.next() != nil { count += 1 }
+        return count
+    }
+
+    @Test func disjointContigs() throws {
+        let file = try HTSFile(path: testDataPath("range.bam"), mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: testDataPath("range.bam"))
+        let iter = try file.samQueryIterator(header: header, index: index,
+                                             regions: ["CHROMOSOME_III", "CHROMOSOME_II"])
+        #expect(iter.intervals.count == 2)
+        var perRegion = [0, 0]
+        try iter.forEach { record, regions in
+            #expect(regions.count == 1)
+            // Input order is kept: region 0 is CHROMOSOME_III (tid 2).
+            let contig = record.contigID
+            #expect(contig == (regions[0] == 0 ? 2 : 1))
+            perRegion[regions[0]] += 1
+        }
+        #expect(perRegion[1] == 34)
+        #expect(perRegion[0] == 41)
+    }
+
+    @Test func overlappingRegionsReturnRecordsOnce() throws {
+        let union = try singleQueryCount("CHROMOSOME_II:1-3000")
+            + singleQueryCount("CHROMOSOME_II:2001-5000")
+            - singleQueryCount("CHROMOSOME_II:2001-3000")
+
+        let file = try HTSFile(path: testDataPath("range.bam"), mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: testDataPath("range.bam"))
+        let iter = try file.samQueryIterator(header: header, index: index, regions: [
+            BEDRegion(contig: "CHROMOSOME_II", start: 0, end: 3000),
+            BEDRegion(contig: "CHROMOSOME_II", start: 2000, end: 5000),
+        ])
+        var total = 0
+        var both = 0
+        var record = try BAMRecord()
+        while try iter.read(into: &record) {
+            total += 1
+            if iter.overlappingRegions == [0, 1] { both += 1 }
+        }
+        #expect(total == union)
+        #expect(both == (try singleQueryCount("CHROMOSOME_II:2001-3000")))
+    }
+
+    @Test func filterApplies() throws {
+        let file = try HTSFile(path: testDataPath("range.bam"), mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: testDataPath("range.bam"))
+        let iter = try file.samQueryIterator(header: header, index: index,
+                                             regions: ["CHROMOSOME_II", "CHROMOSOME_III"])
+        iter.setFilter(RecordFilter().contig(2))
+        var count = 0
+        while let record = iter.next() {
+            let contig = record.contigID
+            #expect(contig == 2)
+            count += 1
+        }
+        #expect(count == 41)
+    }
+
+    @Test func invalidRegions() throws {
+        let file = try HTSFile(path: testDataPath("range.bam"), mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: testDataPath("range.bam"))
+        #expect(throws: HTSError.self) {
+            _ = try file.samQueryIterator(header: header, index: index, regions: [String]())
+        }
+        #expect(throws: HTSError.self) {
+            _ = try file.samQueryIterator(header: header, index: index,
+                                          regions: [BEDRegion(contig: "nope", start: 0, end: 10)])
+        }
+    }
+
+    @Test func asyncReaderMultiRegionQuery() async throws {
+        let reader = try AsyncBAMReader(path: testDataPath("range.bam"), loadIndex: true)
+        try await reader.query(regions: ["CHROMOSOME_II", "CHROMOSOME_III"])
+        var count = 0
+        while let _ = try await reader.next() { count += 1 }
+        #expect(count == 75)
+    }
+}
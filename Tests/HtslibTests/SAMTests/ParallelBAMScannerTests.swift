@@ -0,0 +1,62 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Testing
+@testable import Htslib
+
+@Suite("ParallelBAMScanner")
+struct ParallelBAMScannerTests {
+    struct Key: Hashable, Sendable {
+        let name: String
+        let contigID: Int32
+        let position: Int64
+        let flag: UInt16
+    }
+
+    private func sequentialKeys(_ path: String) throws -> [Key] {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        var keys: [Key] = []
+        try file.samIterator(header: header).forEach { record in
+            keys.append(Key(name: record.queryName, contigID: record.contigID,
+                            position: record.position, flag: record.flag.rawValue))
+        }
+        return keys
+    }
+
+    @Test func planCoversAllContigs() throws {
+        let scanner = ParallelBAMScanner(path: testDataPath("range.bam"), shardCount: 3, windowSize: 1000)
+        let shards = try scanner.plan()
+        #expect(!shards.isEmpty)
+        #expect(shards.count <= 3)
+        let contigs = Set(shards.flatMap { $0.spans.map(\.contigID) })
+        #expect(contigs.isSuperset(of: [0, 1, 2, 3]))
+    }
+
+    @Test func everyRecordProcessedOnce() async throws {
+        let path = testDataPath("range.bam")
+        let expected = try sequentialKeys(path)
+
+        let scanner = ParallelBAMScanner(path: path, shardCount: 4, windowSize: 1000)
+        let keys = try await scanner.scan(
+            initial: { [Key]() },
+            process: { keys, record in
+                keys.append(Key(name: record.queryName, contigID: record.contigID,
+                                position: record.position, flag: record.flag.rawValue))
+            },
+            merge: { total, part in total.append(contentsOf: part) })
+
+        #expect(keys.count == expected.count)
+        #expect(keys == expected)
+    }
+
+    @Test func singleShardMatchesSequential() async throws {
+        let path = testDataPath("range.bam")
+        let scanner = ParallelBAMScanner(path: path, shardCount: 1)
+        let count = try await scanner.scan(
+            initial: { 0 },
+            process: { count, _ in count += 1 },
+            merge: { $0 += $1 })
+        #expect(count == 112)
+    }
+}
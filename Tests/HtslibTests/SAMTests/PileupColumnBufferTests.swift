@@ -0,0 +1,71 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Testing
+@testable import Htslib
+
+@Suite("PileupColumnBuffer")
+struct PileupColumnBufferTests {
+    @Test func matchesEntryPileup() throws {
+        let file = try HTSFile(path: testDataPath("ce#1.sam"), mode: "r")
+        let header = try SAMHeader(from: file)
+        let legacy = PileupIterator(file: file.pointer, header: header.pointer)
+        var expected: [PileupColumn] = []
+        while let column = legacy.next() { expected.append(column) }
+
+        let file2 = try HTSFile(path: testDataPath("ce#1.sam"), mode: "r")
+        let header2 = try SAMHeader(from: file2)
+        let pileup = PileupIterator(file: file2.pointer, header: header2.pointer)
+        var index = 0
+        pileup.forEachColumn { column in
+            let reference = expected[index]
+            #expect(column.position == reference.position)
+            #expect(column.depth == reference.depth)
+            let entry = reference.entries[0]
+            #expect(Character(UnicodeScalar(column.base(at: 0))) == entry.base)
+            #expect(column.qualities[0] == entry.baseQuality)
+            #expect(column.queryPositions[0] == entry.queryPosition)
+            #expect(column.indels[0] == entry.indel)
+            #expect(column.state(at: 0).contains(.deletion) == entry.isDeletion)
+            #expect((column.strands[0] != 0) == entry.isReverse)
+            index += 1
+        }
+        #expect(index == 101)
+    }
+
+    @Test func perColumnCounts() throws {
+        let file = try HTSFile(path: testDataPath("ce#1.sam"), mode: "r")
+        let header = try SAMHeader(from: file)
+        let pileup = PileupIterator(file: file.pointer, header: header.pointer)
+        let column = PileupColumnBuffer(capacity: 1)
+
+        // First base is C on a reverse-strand read (flag 16).
+        #expect(pileup.next(into: column))
+        #expect(column.count(of: .c, reverse: true) == 1)
+        #expect(column.count(of: .c, reverse: false) == 0)
+        #expect(column.count(of: .c) == 1)
+        #expect(column.reverseCount == 1)
+        #expect(column.state(at: 0).contains(.head))
+        #expect(column.flags[0] == 16)
+
+        // 27M1D73M: the 28th column is the deletion.
+        for _ in 1..<28 { _ = pileup.next(into: column) }
+        #expect(column.state(at: 0).contains(.deletion))
+        #expect(column.count(of: .deletion) == 1)
+        #expect(column.baseCodes[0] == 0)
+        #expect(column.base(at: 0) == UInt8(ascii: "*"))
+    }
+
+    @Test func multiPileupColumns() throws {
+        let file = try HTSFile(path: testDataPath("ce#1.sam"), mode: "r")
+        let header = try SAMHeader(from: file)
+        let mplp = MultiPileupIterator(files: [(file: file.pointer, header: header.pointer)])
+        var count = 0
+        mplp.forEachColumn { columns in
+            #expect(columns.count == 1)
+            #expect(columns[0].depth == 1)
+            count += 1
+        }
+        #expect(count == 101)
+    }
+}
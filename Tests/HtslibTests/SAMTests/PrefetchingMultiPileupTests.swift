@@ -0,0 +1,62 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Testing
+@testable import Htslib
+
+@Suite("PrefetchingMultiPileup")
+struct PrefetchingMultiPileupTests {
+    @Test func twoSamplesOfOneRead() throws {
+        let pool = try ThreadPool(threads: 2)
+        let path = testDataPath("ce#1.sam")
+        let pileup = try PrefetchingMultiPileup(paths: [path, path], pool: pool, batchSize: 1, queueDepth: 2)
+        #expect(pileup.sampleCount == 2)
+        #expect(pileup.headers.count == 2)
+
+        var columns = 0
+        pileup.forEachColumn { samples in
+            #expect(samples[0].depth == 1)
+            #expect(samples[1].depth == 1)
+            #expect(samples[0].position == samples[1].position)
+            columns += 1
+        }
+        #expect(columns == 101)
+    }
+
+    @Test func matchesMultiPileupIterator() throws {
+        let path = testDataPath("range.bam")
+        let fileA = try HTSFile(path: path, mode: "r")
+        let headerA = try SAMHeader(from: fileA)
+        let fileB = try HTSFile(path: path, mode: "r")
+        let headerB = try SAMHeader(from: fileB)
+        let legacy = MultiPileupIterator(files: [(fileA.pointer, headerA.pointer), (fileB.pointer, headerB.pointer)])
+        legacy.setFilter(RecordFilter().excludingFlags(.reverse), forSample: 1)
+        var expected: [(Int32, Int64, Int, Int)] = []
+        while let column = legacy.next() {
+            expected.append((column.contigID, column.position,
+                             column.depth(forSample: 0), column.depth(forSample: 1)))
+        }
+
+        let pool = try ThreadPool(threads: 4)
+        let pileup = try PrefetchingMultiPileup(paths: [path, path], pool: pool, batchSize: 8)
+        pileup.setFilter(RecordFilter().excludingFlags(.reverse), forSample: 1)
+        var index = 0
+        pileup.forEachColumn { samples in
+            guard index < expected.count else { index += 1; return }
+            let (tid, pos, depth0, depth1) = expected[index]
+            #expect(samples[0].contigID == tid)
+            #expect(samples[0].position == pos)
+            #expect(samples[0].depth == depth0)
+            #expect(samples[1].depth == depth1)
+            index += 1
+        }
+        #expect(index == expected.count)
+    }
+
+    @Test func missingFileThrows() throws {
+        let pool = try ThreadPool(threads: 1)
+        #expect(throws: HTSError.self) {
+            _ = try PrefetchingMultiPileup(paths: [testDataPath("ce#1.sam"), "/nonexistent.bam"], pool: pool)
+        }
+    }
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Testing
+@testable import Htslib
+
+@Suite("QualityScores")
+struct QualityScoresTests {
+    /// Build an unmapped record whose qualities are `quals` (raw Phred values).
+    private func makeRecord(_ quals: [UInt8]) throws -> BAMRecord {
+        var record = try BAMRecord()
+        let qualString = String(quals.map { Character(UnicodeScalar($0 + 33)) })
+        try record.set(qname: "q", flag: 4, tid: -1, pos: -1, mapq: 0, cigar: [],
+                       mtid: -1, mpos: -1, isize: 0,
+                       seq: String(repeating: "A", count: quals.count), qual: qualString)
+        return record
+    }
+
+    @Test func statisticsMatchScalar() throws {
+        let quals: [UInt8] = (0..<75).map { UInt8(($0 * 13) % 42) }
+        let record = try makeRecord(quals)
+        guard let stats = record.qualities.statistics(threshold: 20) else {
+            Issue.record("Expected qualities"); return
+        }
+        #expect(stats.count == quals.count)
+        #expect(stats.sum == quals.reduce(0) { $0 + UInt64($1) })
+        #expect(stats.minimum == quals.min())
+        #expect(stats.maximum == quals.max())
+        #expect(stats.belowThreshold == quals.filter { $0 < 20 }.count)
+        #expect(record.qualities.count(below: 20) == stats.belowThreshold)
+    }
+
+    @Test func missingQualities() throws {
+        var record = try BAMRecord()
+        try record.set(qname: "q", flag: 4, tid: -1, pos: -1, mapq: 0, cigar: [],
+                       mtid: -1, mpos: -1, isize: 0, seq: "ACGT", qual: nil)
+        #expect(!record.qualities.isAvailable)
+        #expect(record.qualities.statistics() == nil)
+        #expect(record.qualities.mean == nil)
+    }
+
+    @Test func illuminaBinningInPlace() throws {
+        var record = try makeRecord([0, 5, 12, 21, 27, 31, 38, 41])
+        record.binQualities(.illumina8)
+        #expect(Array(record.qualities) == [0, 6, 15, 22, 27, 33, 37, 40])
+    }
+
+    @Test func customBinning() throws {
+        var record = try makeRecord([3, 17, 30])
+        record.binQualities(QualityBinning(bins: [(0...19, 2), (20...60, 30)]))
+        #expect(Array(record.qualities) == [2, 2, 30])
+    }
+
+    @Test func trimming() throws {
+        let record = try makeRecord([30, 30, 30, 30, 30, 2, 30, 2, 2, 2])
+        #expect(record.qualities.trimmedLength(threshold: 20) == 5)
+
+        let both = try makeRecord([2, 2, 30, 30, 30, 30, 2])
+        #expect(both.qualities.trimmedRange(threshold: 20) == 2..<6)
+    }
+
+    @Test func batchMeans() throws {
+        let file = try HTSFile(path: testDataPath("ce#1.sam"), mode: "r")
+        let header = try file.samHeader()
+        let batch = BAMRecordBatch(capacity: 8)
+        try file.samIterator(header: header).readBatch(into: batch)
+
+        var stats: [QualityStatistics?] = []
+        batch.qualityStatistics(into: &stats)
+        #expect(stats.count == 1)
+
+        var means = [Float](repeating: 0, count: 8)
+        means.withUnsafeMutableBufferPointer { batch.meanQualities(into: $0) }
+        let expected = batch[0].qualities.mean
+        #expect(expected != nil)
+        #expect(abs(Double(means[0]) - (expected ?? 0)) < 1e-3)
+    }
+}
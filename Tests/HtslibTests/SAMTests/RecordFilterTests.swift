@@ -0,0 +1,121 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Testing
+@testable import Htslib
+
+@Suite("RecordFilter")
+struct RecordFilterTests {
+    struct Core: Sendable {
+        let tid: Int32
+        let pos: Int64
+        let end: Int64
+        let flag: UInt16
+        let mapq: UInt8
+    }
+
+    private func allRecords(_ path: String) throws -> [Core] {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        var cores: [Core] = []
+        try file.samIterator(header: header).forEach { record in
+            cores.append(Core(tid: record.contigID, pos: record.position, end: record.endPosition,
+                              flag: record.flag.rawValue, mapq: record.mappingQuality))
+        }
+        return cores
+    }
+
+    @Test func coreFieldsPushedIntoIterator() throws {
+        let path = testDataPath("range.bam")
+        let cores = try allRecords(path)
+        let expected = cores.filter { $0.flag & 0x10 == 0 && $0.mapq >= 10 && $0.tid == 1 }.count
+
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let iterator = file.samIterator(header: header)
+        let compiled = iterator.setFilter(RecordFilter()
+            .excludingFlags(.reverse)
+            .mappingQuality(atLeast: 10)
+            .contig(1))
+        var seen = 0
+        try iterator.forEach { record in
+            seen += 1
+            #expect(!record.isReverse)
+            #expect(record.contigID == 1)
+        }
+        #expect(seen == expected)
+
+        let stats = compiled.statistics
+        #expect(stats.examined == cores.count)
+        #expect(stats.passed == expected)
+        #expect(stats.steps.reduce(0) { $0 + $1.rejected } == cores.count - expected)
+        // Flag masks fuse into a single step evaluated first.
+        #expect(stats.steps.first?.rejected == cores.filter { $0.flag & 0x10 != 0 }.count)
+    }
+
+    @Test func overlapAndNextRespectFilter() throws {
+        let path = testDataPath("range.bam")
+        let cores = try allRecords(path)
+        let expected = cores.filter { $0.tid == 0 && $0.pos < 2000 && $0.end > 1000 }.count
+
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let iterator = file.samIterator(header: header)
+        iterator.setFilter(RecordFilter().overlapping(contigID: 0, 1000..<2000))
+        var seen = 0
+        while let record = iterator.next() {
+            seen += 1
+            #expect(record.contigID == 0)
+        }
+        #expect(seen == expected)
+    }
+
+    @Test func emptyRangeIntersectionRejectsAll() throws {
+        let compiled = RecordFilter([.mappingQuality(0...10), .mappingQuality(20...30)]).compile()
+        var record = try BAMRecord()
+        try record.set(qname: "r", flag: 0, tid: 0, pos: 0, mapq: 20, cigar: [],
+                       mtid: -1, mpos: -1, isize: 0, seq: "ACGT", qual: nil)
+        #expect(!compiled.accepts(record))
+        try record.set(qname: "r", flag: 0, tid: 0, pos: 0, mapq: 5, cigar: [],
+                       mtid: -1, mpos: -1, isize: 0, seq: "ACGT", qual: nil)
+        #expect(!compiled.accepts(record))
+        #expect(compiled.statistics.examined == 2)
+        #expect(compiled.statistics.passed == 0)
+    }
+
+    @Test func auxTagClauses() throws {
+        let file = try HTSFile(path: testDataPath("auxf#values.sam"), mode: "r")
+        let header = try file.samHeader()
+        let iterator = file.samIterator(header: header)
+        let compiled = iterator.setFilter(RecordFilter()
+            .readGroups(["ID"])
+            .tag("I5", in: 200...300)
+            .lacksTag(.NM))
+        var names: [String] = []
+        try iterator.forEach { names.append($0.queryName) }
+        #expect(names == ["Fred"])
+        #expect(compiled.statistics.examined == 2)
+        #expect(compiled.statistics.steps[0].rejected == 1)
+    }
+
+    @Test func queryIteratorAndPileup() throws {
+        let path = testDataPath("range.bam")
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: path)
+        let query = try file.samQueryIterator(header: header, index: index, region: "CHROMOSOME_I")
+        let none = query.setFilter(RecordFilter().matching("never") { _ in false })
+        var record = try BAMRecord()
+        let got = try query.read(into: &record)
+        #expect(!got)
+        #expect(none.statistics.steps.first?.name == "never")
+        #expect(none.statistics.passed == 0)
+
+        let pfile = try HTSFile(path: testDataPath("ce#1.sam"), mode: "r")
+        let pheader = try SAMHeader(from: pfile)
+        let pileup = PileupIterator(file: pfile.pointer, header: pheader.pointer)
+        let mapq = pileup.setFilter(RecordFilter().mappingQuality(atLeast: 30))
+        #expect(pileup.next() == nil)
+        #expect(mapq.statistics.examined == 1)
+    }
+}
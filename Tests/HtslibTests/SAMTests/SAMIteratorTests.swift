@@ -57,4 +57,66 @@ struct SAMIteratorTests {
         }
         #expect(second.queryName == "Jim")
     }
+
+    @Test func forEachVisitsAllRecords() throws {
+        let file = try HTSFile(path: testDataPath("auxf#values.sam"), mode: "r")
+        let header = try SAMHeader(from: file)
+        let iter = SAMRecordIterator(file: file.pointer, header: header.pointer)
+
+        var names: [String] = []
+        try iter.forEach { record in
+            names.append(record.queryName)
+        }
+        #expect(names == ["Fred", "Jim"])
+        let hasMore = iter.next() != nil
+        #expect(!hasMore)
+    }
+
+    @Test func readIntoReusesRecord() throws {
+        let file = try HTSFile(path: testDataPath("auxf#values.sam"), mode: "r")
+        let header = try SAMHeader(from: file)
+        let iter = SAMRecordIterator(file: file.pointer, header: header.pointer)
+
+        var record = try BAMRecord()
+        let storage = record.pointer
+        let readFirst = try iter.read(into: &record)
+        #expect(readFirst)
+        #expect(record.queryName == "Fred")
+        let readSecond = try iter.read(into: &record)
+        #expect(readSecond)
+        #expect(record.queryName == "Jim")
+        #expect(record.pointer == storage)
+        let readPastEnd = try iter.read(into: &record)
+        #expect(!readPastEnd)
+    }
+
+    @Test func copyOutlivesBorrowedRecord() throws {
+        let file = try HTSFile(path: testDataPath("auxf#values.sam"), mode: "r")
+        let header = try SAMHeader(from: file)
+        let iter = SAMRecordIterator(file: file.pointer, header: header.pointer)
+
+        var kept: BAMRecord? = nil
+        try iter.forEach { record in
+            if kept == nil { kept = try record.copy() }
+        }
+        let name = kept?.queryName
+        #expect(name == "Fred")
+    }
+
+    @Test func queryForEach() throws {
+        let path = testDataPath("range.bam")
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.samHeader()
+        let index = try HTSIndex(path: path)
+
+        let expected = try file.samQueryIterator(header: header, index: index, region: "CHROMOSOME_I")
+        var expectedCount = 0
+        while expected.next() != nil { expectedCount += 1 }
+
+        let query = try file.samQueryIterator(header: header, index: index, region: "CHROMOSOME_I")
+        var count = 0
+        try query.forEach { _ in count += 1 }
+        #expect(count == expectedCount)
+        #expect(count > 0)
+    }
 }
@@ -0,0 +1,142 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Testing
+@testable import Htslib
+
+@Suite("GenotypeMatrix")
+struct GenotypeMatrixTests {
+
+    /// Expected summary computed from the per-sample ``Genotype`` path.
+    private func expectedSummary(_ genotypes: [Genotype], alleles: Int) -> GenotypeMatrix.Summary {
+        var counts = [Int](repeating: 0, count: max(alleles, 2))
+        var homRef = 0, het = 0, homAlt = 0, missing = 0
+        for gt in genotypes {
+            for allele in gt.alleles.compactMap({ $0 }) where allele < counts.count { counts[allele] += 1 }
+            if gt.isMissing { missing += 1 }
+            if gt.isHeterozygous { het += 1 }
+            if gt.isHomozygous {
+                if gt.alleles.compactMap({ $0 }).first == 0 { homRef += 1 } else { homAlt += 1 }
+            }
+        }
+        return GenotypeMatrix.Summary(samples: genotypes.count, alleleNumber: counts.reduce(0, +),
+                                      alleleCounts: Array(counts.prefix(alleles)), homRef: homRef,
+                                      het: het, homAlt: homAlt, missing: missing)
+    }
+
+    @Test func matchesInfoCountsAndGenotypes() throws {
+        let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: file)
+        let iter = VCFRecordIterator(file: file.pointer, header: header.pointer)
+        let matrix = GenotypeMatrix()
+
+        var sites = 0
+        while var record = iter.next() {
+            try record.unpack(.all)
+            #expect(matrix.decode(record, header: header))
+            let summary = matrix.summary()
+            let an = record.infoInt32(forKey: "AN", header: header)?.first
+            #expect(an.map(Int.init) == summary.alleleNumber)
+            if let ac = record.infoInt32(forKey: "AC", header: header), ac.count == record.nAlleles - 1,
+               matrix.encoding != .wide {
+                #expect(ac.map(Int.init) == Array(summary.alleleCounts.dropFirst()))
+            }
+
+            let genotypes = record.genotypes(header: header) ?? []
+            #expect((0..<matrix.sampleCount).map { matrix.genotype(sample: $0) } == genotypes)
+            #expect(summary == expectedSummary(genotypes, alleles: record.nAlleles))
+            sites += 1
+        }
+        #expect(sites == 15)
+    }
+
+    @Test func chooseEncodingByAlleleCount() throws {
+        let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: file)
+        let iter = VCFRecordIterator(file: file.pointer, header: header.pointer)
+        let matrix = GenotypeMatrix()
+
+        var encodings: [GenotypeMatrix.Encoding] = []
+        while let record = iter.next() {
+            matrix.decode(record, header: header)
+            encodings.append(matrix.encoding)
+        }
+        #expect(encodings.first == .twoBit)
+        #expect(encodings.contains(.byte))
+        // The last site has hundreds of ALT alleles and calls such as 0/300.
+        #expect(encodings.last == .wide)
+        #expect(matrix.allele(sample: 0, slot: 1) == 300)
+        #expect(matrix.summary().alleleCounts[300] == 1)
+    }
+
+    @Test func haploidCallInDiploidRecord() throws {
+        let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: file)
+        let iter = VCFRecordIterator(file: file.pointer, header: header.pointer)
+        let matrix = GenotypeMatrix()
+        // Fourth record: A = 0/1, B = 2 (haploid).
+        for _ in 0..<3 { _ = iter.next() }
+        guard let record = iter.next() else { Issue.record("Expected a record"); return }
+        #expect(matrix.decode(record, header: header))
+        #expect(matrix.ploidy == 2)
+        #expect(matrix.allele(sample: 1, slot: 0) == 2)
+        #expect(matrix.allele(sample: 1, slot: 1) == nil)
+        #expect(matrix.genotype(sample: 1).ploidy == 1)
+        let summary = matrix.summary()
+        #expect(summary.alleleNumber == 3)
+        #expect(summary.het == 1)
+        #expect(summary.homAlt == 0)
+    }
+
+    @Test func packedDiploidSummaryMatchesPerSample() throws {
+        // 70 samples spans several 64-bit words and a partial mask word.
+        let samples = (0..<70).map { "S\($0)" }
+        let calls = ["0/0", "0/1", "1/1", "./.", "0|1", "1|0", "./1", "1"]
+        var text = "##fileformat=VCFv4.2\n##contig=<ID=1,length=1000>\n"
+        text += "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">\n"
+        text += "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\t" + samples.joined(separator: "\t") + "\n"
+        for site in 0..<4 {
+            let gts = (0..<70).map { calls[($0 * 7 + site * 3) % calls.count] }
+            text += "1\t\(100 + site)\t.\tA\tG\t.\tPASS\t.\tGT\t" + gts.joined(separator: "\t") + "\n"
+        }
+        let path = tempFilePath("matrix-\(UInt32.random(in: 0...UInt32.max)).vcf")
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        try text.write(toFile: path, atomically: true, encoding: .utf8)
+
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try VCFHeader(from: file)
+        let iter = VCFRecordIterator(file: file.pointer, header: header.pointer)
+        let matrix = GenotypeMatrix()
+        while var record = iter.next() {
+            try record.unpack(.all)
+            #expect(matrix.decode(record, header: header))
+            #expect(matrix.encoding == .twoBit)
+            let genotypes = record.genotypes(header: header) ?? []
+            let summary = matrix.summary()
+            #expect(summary == expectedSummary(genotypes, alleles: 2))
+            #expect(summary.callRate == Double(70 - summary.missing) / 70)
+            for (s, gt) in genotypes.enumerated() {
+                #expect(matrix.isMissing(sample: s) == gt.isMissing)
+                #expect(matrix.isPhased(sample: s) == (gt.ploidy >= 2 && gt.phased.dropFirst().allSatisfy { $0 }))
+            }
+        }
+    }
+
+    @Test func recordWithoutGenotypesIsRejected() throws {
+        let path = tempFilePath("matrix-nogt-\(UInt32.random(in: 0...UInt32.max)).vcf")
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        try """
+            ##fileformat=VCFv4.2
+            ##contig=<ID=1,length=1000>
+            #CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO
+            1\t100\t.\tA\tG\t.\tPASS\t.
+
+            """.write(toFile: path, atomically: true, encoding: .utf8)
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try VCFHeader(from: file)
+        let iter = VCFRecordIterator(file: file.pointer, header: header.pointer)
+        guard let record = iter.next() else { Issue.record("Expected a record"); return }
+        #expect(!GenotypeMatrix().decode(record, header: header))
+    }
+}
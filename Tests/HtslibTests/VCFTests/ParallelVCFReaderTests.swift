@@ -0,0 +1,177 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Testing
+@testable import Htslib
+
+@Suite("ParallelVCFReader")
+struct ParallelVCFReaderTests {
+
+    /// Position, alleles and genotypes of every record, read serially.
+    private func serialRead(_ path: String) throws -> [(pos: Int64, alleles: [String], gts: [Genotype]?)] {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.vcfHeader()
+        let iter = file.vcfIterator(header: header)
+        var out: [(pos: Int64, alleles: [String], gts: [Genotype]?)] = []
+        while var record = iter.next() {
+            try record.unpack(.all)
+            out.append((record.position, record.alleles, record.genotypes(header: header)))
+        }
+        return out
+    }
+
+    private func parallelRead(_ reader: ParallelVCFReader) throws -> [(pos: Int64, alleles: [String], gts: [Genotype]?)] {
+        var out: [(pos: Int64, alleles: [String], gts: [Genotype]?)] = []
+        while var record = try reader.next() {
+            try record.unpack(.all)
+            out.append((record.position, record.alleles, record.genotypes(header: reader.header)))
+        }
+        return out
+    }
+
+    private func writeVCF(_ text: String) throws -> String {
+        let path = tempFilePath("parallel-\(UInt32.random(in: 0...UInt32.max)).vcf")
+        try text.write(toFile: path, atomically: true, encoding: .utf8)
+        return path
+    }
+
+    @Test func matchesSerialIterator() throws {
+        let path = testDataPath("vcf_file.vcf")
+        let expected = try serialRead(path)
+        let pool = try ThreadPool(threads: 4)
+        // Two lines per chunk puts consecutive records in different parse jobs.
+        let reader = try ParallelVCFReader(path: path, pool: pool, linesPerChunk: 2, chunksInFlight: 3)
+        let actual = try parallelRead(reader)
+        #expect(actual.count == expected.count)
+        for (a, e) in zip(actual, expected) {
+            #expect(a.pos == e.pos)
+            #expect(a.alleles == e.alleles)
+            #expect(a.gts == e.gts)
+        }
+        #expect(try reader.next()?.position == nil)
+    }
+
+    @Test func readIntoReusesOneRecord() throws {
+        let path = testDataPath("vcf_file.vcf")
+        let expected = try serialRead(path)
+        let pool = try ThreadPool(threads: 4)
+        let reader = try ParallelVCFReader(path: path, pool: pool, linesPerChunk: 2, chunksInFlight: 3)
+        var record = try VCFRecord()
+        var actual: [(pos: Int64, alleles: [String], gts: [Genotype]?)] = []
+        while try reader.read(into: &record) {
+            try record.unpack(.all)
+            actual.append((record.position, record.alleles, record.genotypes(header: reader.header)))
+        }
+        #expect(actual.count == expected.count)
+        for (a, e) in zip(actual, expected) {
+            #expect(a.pos == e.pos)
+            #expect(a.alleles == e.alleles)
+            #expect(a.gts == e.gts)
+        }
+        #expect(try !reader.read(into: &record))
+    }
+
+    @Test func readerKeepsPoolAlive() throws {
+        let reader: ParallelVCFReader
+        do {
+            let pool = try ThreadPool(threads: 2)
+            reader = try ParallelVCFReader(path: testDataPath("vcf_file.vcf"), pool: pool, linesPerChunk: 2)
+        }
+        var count = 0
+        while try reader.next() != nil { count += 1 }
+        #expect(count == 15)
+    }
+
+    @Test func manyChunksStayInOrder() throws {
+        let samples = (0..<40).map { "S\($0)" }
+        let calls = ["0/0", "0/1", "1/1", "./.", "0|1"]
+        var text = "##fileformat=VCFv4.2\n##contig=<ID=1,length=100000>\n"
+        text += "##INFO=<ID=DP,Number=1,Type=Integer,Description=\"Depth\">\n"
+        text += "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">\n"
+        text += "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\t" + samples.joined(separator: "\t") + "\n"
+        for site in 0..<3000 {
+            let gts = (0..<40).map { calls[($0 + site) % calls.count] }
+            text += "1\t\(site + 1)\t.\tA\tG\t.\tPASS\tDP=\(site)\tGT\t" + gts.joined(separator: "\t") + "\n"
+        }
+        let path = try writeVCF(text)
+        defer { try? FileManager.default.removeItem(atPath: path) }
+
+        let expected = try serialRead(path)
+        let pool = try ThreadPool(threads: 4)
+        let reader = try ParallelVCFReader(path: path, pool: pool, linesPerChunk: 64)
+        let actual = try parallelRead(reader)
+        #expect(actual.map(\.pos) == (0..<3000).map { Int64($0) })
+        #expect(actual.map(\.gts) == expected.map(\.gts))
+    }
+
+    @Test func undeclaredNamesAreAddedInOrder() throws {
+        var text = "##fileformat=VCFv4.2\n##contig=<ID=1,length=1000>\n"
+        text += "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\n"
+        for site in 0..<200 {
+            let chrom = site < 100 ? "1" : "2"
+            let info = site % 50 == 7 ? "XX=\(site)" : "."
+            text += "\(chrom)\t\(site + 1)\t.\tA\tG\t.\tPASS\t\(info)\n"
+        }
+        let path = try writeVCF(text)
+        defer { try? FileManager.default.removeItem(atPath: path) }
+
+        let pool = try ThreadPool(threads: 4)
+        let reader = try ParallelVCFReader(path: path, pool: pool, linesPerChunk: 8)
+        var positions: [Int64] = []
+        var contigIDs: [Int32] = []
+        while let record = try reader.next() {
+            positions.append(record.position)
+            contigIDs.append(record.contigID)
+        }
+        #expect(positions == (0..<200).map { Int64($0) })
+        #expect(contigIDs == Array(repeating: 0, count: 100) + Array(repeating: 1, count: 100))
+        #expect(reader.header.sequenceNames == ["1", "2"])
+        #expect(bcf_hdr_id2int(reader.header.pointer, Int32(BCF_DT_ID), "XX") >= 0)
+    }
+
+    @Test func sitesOnlySelection() throws {
+        let path = testDataPath("vcf_file.vcf")
+        let expected = try serialRead(path)
+        let pool = try ThreadPool(threads: 2)
+        let reader = try ParallelVCFReader(path: path, pool: pool, linesPerChunk: 4,
+                                           fields: VCFFieldSelection(alleles: true))
+        #expect(reader.header.nSamples == 0)
+        var alleles: [[String]] = []
+        while let record = try reader.next() {
+            #expect(record.nSamples == 0)
+            alleles.append(record.alleles)
+        }
+        #expect(alleles == expected.map(\.alleles))
+    }
+
+    @Test func invalidLineThrows() throws {
+        let path = try writeVCF("""
+            ##fileformat=VCFv4.2
+            ##contig=<ID=1,length=1000>
+            #CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO
+            1\t100\t.\tA\tG\t.\tPASS\t.
+            1\tabc\t.\tA\tG\t.\tPASS\t.
+
+            """)
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        let pool = try ThreadPool(threads: 2)
+        let reader = try ParallelVCFReader(path: path, pool: pool)
+        #expect(try reader.next()?.position == 99)
+        #expect(throws: HTSError.self) { _ = try reader.next() }
+        // Errors are sticky.
+        #expect(throws: HTSError.self) { _ = try reader.next() }
+    }
+
+    @Test func rejectsBCF() throws {
+        let output = tempFilePath("parallel-\(UInt32.random(in: 0...UInt32.max)).bcf")
+        defer { try? FileManager.default.removeItem(atPath: output) }
+        let input = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: input)
+        let writer = try VariantWriter(path: output, header: header, mode: "wb")
+        _ = try writer.close()
+
+        let pool = try ThreadPool(threads: 2)
+        #expect(throws: HTSError.self) { _ = try ParallelVCFReader(path: output, pool: pool) }
+    }
+}
@@ -0,0 +1,174 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Testing
+@testable import Htslib
+
+@Suite("VCFFieldSelection")
+struct VCFFieldSelectionTests {
+
+    /// Alleles, AN and genotypes of every record, read with everything unpacked.
+    private func fullRead(_ path: String) throws -> [(alleles: [String], an: [Int32]?, gts: [Genotype]?)] {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.vcfHeader()
+        let iter = file.vcfIterator(header: header)
+        var out: [(alleles: [String], an: [Int32]?, gts: [Genotype]?)] = []
+        while var record = iter.next() {
+            try record.unpack(.all)
+            out.append((record.alleles, record.infoInt32(forKey: "AN", header: header),
+                        record.genotypes(header: header)))
+        }
+        return out
+    }
+
+    private func writeBCF(buildIndex: Bool = false) throws -> String {
+        let output = tempFilePath("selection-\(UInt32.random(in: 0...UInt32.max)).bcf")
+        let input = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: input)
+        let iter = VCFRecordIterator(file: input.pointer, header: header.pointer)
+        let writer = try VariantWriter(path: output, header: header, mode: "wb", options: .init(buildIndex: buildIndex))
+        while let record = iter.next() {
+            try writer.write(record)
+        }
+        _ = try writer.close()
+        return output
+    }
+
+    @Test func unpackLevelsFollowSelection() {
+        #expect(VCFFieldSelection().unpackFlags == 0)
+        #expect(VCFFieldSelection(alleles: true).unpackFlags == VCFRecord.UnpackLevel.str.rawValue)
+        #expect(VCFFieldSelection(filters: true, info: ["AF"]).unpackFlags == 6)
+        #expect(VCFFieldSelection(format: ["GT"]).unpackFlags == VCFRecord.UnpackLevel.fmt.rawValue)
+        // FORMAT keys are moot once every sample is dropped.
+        #expect(VCFFieldSelection(format: ["GT"], samples: VCFFieldSelection.Samples.none).unpackFlags == 0)
+        #expect(VCFFieldSelection.all.unpackFlags == VCFRecord.UnpackLevel.all.rawValue)
+        #expect(VCFFieldSelection(info: ["AF"]).samples == VCFFieldSelection.Samples.none)
+        #expect(VCFFieldSelection(format: ["GT"]).samples == .all)
+    }
+
+    @Test(arguments: ["vcf", "bcf"])
+    func sitesOnlySkipsSamples(kind: String) throws {
+        let path = try kind == "vcf" ? testDataPath("vcf_file.vcf") : writeBCF()
+        defer { if kind == "bcf" { try? FileManager.default.removeItem(atPath: path) } }
+        let expected = try fullRead(path)
+
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.vcfHeader()
+        let iter = try file.vcfIterator(header: header, fields: VCFFieldSelection(alleles: true, info: ["AN"]))
+        #expect(header.nSamples == 0)
+        var i = 0
+        while let record = iter.next() {
+            // Already unpacked: no unpack(_:) call before reading ALT and INFO.
+            #expect(record.nSamples == 0)
+            #expect(record.alleles == expected[i].alleles)
+            #expect(record.infoInt32(forKey: "AN", header: header) == expected[i].an)
+            #expect(record.genotypes(header: header) == nil)
+            i += 1
+        }
+        #expect(i == expected.count)
+    }
+
+    @Test func formatSelectionKeepsGenotypes() throws {
+        let expected = try fullRead(testDataPath("vcf_file.vcf"))
+        let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try file.vcfHeader()
+        let iter = try file.vcfIterator(header: header, fields: VCFFieldSelection(format: ["GT"]))
+        var i = 0
+        while let record = iter.next() {
+            #expect(record.genotypes(header: header) == expected[i].gts)
+            i += 1
+        }
+        #expect(i == 15)
+    }
+
+    @Test func sampleSubset() throws {
+        let expected = try fullRead(testDataPath("vcf_file.vcf"))
+        let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try file.vcfHeader()
+        let fields = VCFFieldSelection(format: ["GT"], samples: .only(["B"]))
+        let iter = try file.vcfIterator(header: header, fields: fields)
+        #expect(header.nSamples == 1)
+        var i = 0
+        while let record = iter.next() {
+            #expect(record.nSamples == 1)
+            #expect(record.genotypes(header: header)?.first == expected[i].gts?.last)
+            i += 1
+        }
+        #expect(i == 15)
+    }
+
+    @Test func unknownKeysAndSamplesThrow() throws {
+        let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try file.vcfHeader()
+        #expect(throws: HTSError.self) {
+            _ = try file.vcfIterator(header: header, fields: VCFFieldSelection(info: ["NOPE"]))
+        }
+        #expect(throws: HTSError.self) {
+            _ = try file.vcfIterator(header: header, fields: VCFFieldSelection(format: ["GT"], samples: .only(["Z"])))
+        }
+    }
+
+    @Test func asyncReaderAppliesSelection() async throws {
+        let reader = try AsyncVCFReader(path: testDataPath("vcf_file.vcf"),
+                                        fields: VCFFieldSelection(id: true, info: ["AN"]))
+        #expect(reader.header.nSamples == 0)
+        var count = 0, withID = 0
+        while let record = try await reader.next() {
+            #expect(record.nSamples == 0)
+            if record.id != nil && record.id != "." { withID += 1 }
+            count += 1
+        }
+        #expect(count == 15)
+        #expect(withID > 0)
+    }
+
+    @Test func asyncRegionQuerySubsetsSamples() async throws {
+        let path = try writeBCF(buildIndex: true)
+        defer {
+            try? FileManager.default.removeItem(atPath: path)
+            try? FileManager.default.removeItem(atPath: path + ".csi")
+        }
+        let expected = try fullRead(path)
+
+        // Contig IDs in file order, so querying each contig in turn reads the whole file.
+        var contigs: [Int32] = []
+        let file = try HTSFile(path: path, mode: "r")
+        let iter = file.vcfIterator(header: try file.vcfHeader())
+        while let record = iter.next() {
+            if contigs.last != record.contigID { contigs.append(record.contigID) }
+        }
+
+        let reader = try AsyncVCFReader(path: path, loadIndex: true,
+                                        fields: VCFFieldSelection(format: ["GT"], samples: .only(["B"])))
+        #expect(reader.header.nSamples == 1)
+        var i = 0
+        for tid in contigs {
+            try await reader.query(tid: tid, start: 0, end: htsPosMax)
+            while let record = try await reader.next() {
+                #expect(record.nSamples == 1)
+                #expect(record.genotypes(header: reader.header)?.first == expected[i].gts?.last)
+                i += 1
+            }
+        }
+        #expect(i == expected.count)
+    }
+
+    @Test func syncedReaderAppliesSelection() throws {
+        let reader = try SyncedBCFReader()
+        reader.allowNoIndex()
+        try reader.selectFields(VCFFieldSelection(alleles: true))
+        try reader.addReader(path: testDataPath("vcf_file.vcf"))
+        #expect(reader.getHeader(at: 0)?.nSamples == 0)
+        var count = 0
+        while reader.nextLine() > 0 {
+            if let record = reader.getRecord(at: 0) {
+                #expect(record.nSamples == 0)
+                #expect(!record.alleles.isEmpty)
+                count += 1
+            }
+        }
+        #expect(count == 15)
+        #expect(throws: HTSError.self) { try reader.selectFields(.all) }
+    }
+}
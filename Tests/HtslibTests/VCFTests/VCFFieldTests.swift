@@ -0,0 +1,96 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Testing
+@testable import Htslib
+
+@Suite("VCFField")
+struct VCFFieldTests {
+
+    @Test func infoFieldsMatchKeyedAccessors() throws {
+        let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: file)
+        let iter = VCFRecordIterator(file: file.pointer, header: header.pointer)
+        let ac = try InfoField<Int32>("AC", header: header)
+        let dp4 = try InfoField<Int32>("DP4", header: header)
+        let str = try InfoField<UInt8>("STR", header: header)
+
+        var sites = 0, withDP4 = 0
+        while let record = iter.next() {
+            #expect(ac.values(in: record) == record.infoInt32(forKey: "AC", header: header))
+            #expect(dp4.values(in: record) == record.infoInt32(forKey: "DP4", header: header))
+            #expect(str.string(in: record) == record.infoString(forKey: "STR", header: header))
+            if dp4.isPresent(in: record) { withDP4 += 1 }
+            sites += 1
+        }
+        #expect(sites == 15)
+        #expect(withDP4 > 0)
+    }
+
+    @Test func formatFieldsMatchKeyedAccessors() throws {
+        let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: file)
+        let iter = VCFRecordIterator(file: file.pointer, header: header.pointer)
+        let gq = try FormatField<Int32>("GQ", header: header)
+        let gl = try FormatField<Float>("GL", header: header)
+
+        while let record = iter.next() {
+            #expect(gq.values(in: record) == record.formatInt32(forKey: "GQ", header: header))
+            let expected = record.formatFloat(forKey: "GL", header: header)
+            let values = gl.values(in: record)
+            #expect(values?.count == expected?.count)
+            // Compare bit patterns: missing and vector-end sentinels are NaNs.
+            #expect(values?.map(\.bitPattern) == expected?.map(\.bitPattern))
+        }
+    }
+
+    @Test func formatValuesArePerSample() throws {
+        let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: file)
+        let iter = VCFRecordIterator(file: file.pointer, header: header.pointer)
+        let gl = try FormatField<Float>("GL", header: header)
+        // Fourth record: sample A has six GL values, haploid sample B only three.
+        for _ in 0..<3 { _ = iter.next() }
+        guard let record = iter.next() else { Issue.record("Expected a record"); return }
+        let shape = gl.withValues(in: record) { values, perSample in (values.count, perSample) }
+        #expect(shape?.0 == 12)
+        #expect(shape?.1 == 6)
+        let values = gl.values(in: record) ?? []
+        #expect(values.first == -20)
+        #expect(values[6..<9] == [-20, -5, -20])
+        #expect(values[9...].allSatisfy(\.isBCFVectorEnd))
+    }
+
+    @Test func scratchBufferIsReused() throws {
+        let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: file)
+        let iter = VCFRecordIterator(file: file.pointer, header: header.pointer)
+        let an = try InfoField<Int32>("AN", header: header)
+
+        var addresses = Set<UnsafeRawPointer?>()
+        while let record = iter.next() {
+            _ = an.withValues(in: record) { addresses.insert(UnsafeRawPointer($0.baseAddress)) }
+        }
+        #expect(addresses.count == 1)
+    }
+
+    @Test func missingFieldReturnsNil() throws {
+        let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: file)
+        let iter = VCFRecordIterator(file: file.pointer, header: header.pointer)
+        let test = try InfoField<Int32>("TEST", header: header)
+        guard let record = iter.next() else { Issue.record("Expected a record"); return }
+        #expect(test.first(in: record) == nil)
+        #expect(!test.isPresent(in: record))
+    }
+
+    @Test func resolutionChecksHeader() throws {
+        let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: file)
+        #expect(throws: HTSError.self) { _ = try InfoField<Int32>("NOPE", header: header) }
+        // GQ is a FORMAT field, not INFO.
+        #expect(throws: HTSError.self) { _ = try InfoField<Int32>("GQ", header: header) }
+        // GL is declared Float.
+        #expect(throws: HTSError.self) { _ = try FormatField<Int32>("GL", header: header) }
+    }
+}
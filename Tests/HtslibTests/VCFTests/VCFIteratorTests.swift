@@ -1,6 +1,7 @@
 // Copyright (c) 2026 James Kane. All rights reserved.
 // Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
 
+import Foundation
 import Testing
 @testable import Htslib
 
@@ -28,6 +29,32 @@ struct VCFIteratorTests {
         #expect(!hasMore)
     }
 
+    @Test func invalidLineEndsIterationLikeEOF() throws {
+        let path = tempFilePath("invalid-\(UInt32.random(in: 0...UInt32.max)).vcf")
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        try """
+            ##fileformat=VCFv4.2
+            ##contig=<ID=1,length=1000>
+            #CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO
+            1\t100\t.\tA\tG\t.\tPASS\t.
+            1\tabc\t.\tA\tG\t.\tPASS\t.
+            1\t300\t.\tC\tT\t.\tPASS\t.
+
+            """.write(toFile: path, atomically: true, encoding: .utf8)
+
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try file.vcfHeader()
+        let iter = try file.vcfIterator(header: header, fields: VCFFieldSelection(alleles: true))
+        var positions: [Int64] = []
+        while let record = iter.next() {
+            positions.append(record.position)
+        }
+        // The failure is indistinguishable from end-of-file, and the record after it is never read.
+        #expect(positions == [99])
+        let hasMore = iter.next() != nil
+        #expect(!hasMore)
+    }
+
     @Test func recordsOnMultipleContigs() throws {
         let file = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
         let header = try VCFHeader(from: file)
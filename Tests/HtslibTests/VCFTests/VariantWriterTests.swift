@@ -0,0 +1,80 @@
+// Copyright (c) 2026 James Kane. All rights reserved.
+// Licensed under the BSD 3-Clause License. See LICENSE.md in the project root.
+
+import Foundation
+import Testing
+@testable import Htslib
+
+@Suite("VariantWriter")
+struct VariantWriterTests {
+    private func countRecords(_ path: String) throws -> Int {
+        let file = try HTSFile(path: path, mode: "r")
+        let header = try VCFHeader(from: file)
+        let iter = VCFRecordIterator(file: file.pointer, header: header.pointer)
+        var count = 0
+        while iter.next() != nil { count += 1 }
+        return count
+    }
+
+    @Test func writesIndexedBCF() throws {
+        let output = tempFilePath("writer.bcf")
+        defer {
+            try? FileManager.default.removeItem(atPath: output)
+            try? FileManager.default.removeItem(atPath: output + ".csi")
+        }
+        let input = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: input)
+        let iter = VCFRecordIterator(file: input.pointer, header: header.pointer)
+        let pool = try ThreadPool(threads: 2)
+        let writer = try VariantWriter(path: output, header: header, mode: "wb",
+                                       options: .init(buildIndex: true, batchSize: 4, queueDepth: 2), pool: pool)
+        while let record = iter.next() {
+            try writer.write(record)
+        }
+        let stats = try writer.close()
+        #expect(stats.records == 15)
+        #expect(stats.indexPath == output + ".csi")
+
+        #expect(try countRecords(output) == 15)
+        let index = try HTSIndex(path: output)
+        #expect(index.nSequences() == 4)
+    }
+
+    @Test func writesBgzippedVCFWithTabixIndex() throws {
+        let output = tempFilePath("writer.vcf.gz")
+        defer {
+            try? FileManager.default.removeItem(atPath: output)
+            try? FileManager.default.removeItem(atPath: output + ".tbi")
+        }
+        let input = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: input)
+        let iter = VCFRecordIterator(file: input.pointer, header: header.pointer)
+        let writer = try VariantWriter(path: output, header: header, mode: "wz", options: .init(buildIndex: true))
+        while let record = iter.next() {
+            try writer.write(record)
+        }
+        let stats = try writer.close()
+        #expect(stats.records == 15)
+        #expect(stats.indexPath == output + ".tbi")
+        #expect(try countRecords(output) == 15)
+    }
+
+    @Test func queueFailureClosesFileOnce() throws {
+        let output = tempFilePath("writer-\(UInt32.random(in: 0...UInt32.max)).bcf")
+        defer {
+            try? FileManager.default.removeItem(atPath: output)
+            try? FileManager.default.removeItem(atPath: output + ".csi")
+        }
+        let input = try HTSFile(path: testDataPath("vcf_file.vcf"), mode: "r")
+        let header = try VCFHeader(from: input)
+        #expect(throws: HTSError.self) {
+            _ = try RecordWriterCore(path: output, mode: "wb", kind: .variant, options: .init(buildIndex: true),
+                                     pool: nil, header: UnsafeMutableRawPointer(header.pointer),
+                                     writeHeader: { bcf_hdr_write($0, header.pointer) },
+                                     makeQueue: { _, _, _, _, _, _ in nil })
+        }
+        // The file was closed by the failed writer, with its header but no index.
+        #expect(try countRecords(output) == 0)
+        #expect(!FileManager.default.fileExists(atPath: output + ".csi"))
+    }
+}